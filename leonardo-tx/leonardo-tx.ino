@@ -30,6 +30,7 @@
 #include <avr/wdt.h>
 
 #include "src/WallBatterySystem.h"
+#include "src/ReaderBench.h"
 #include "src/Config.h"
 
 // ----- MAIN RFID HARDWARE INSTANCES -----
@@ -40,10 +41,18 @@ MFRC522 reader{ driver };
 WallBatterySystem wallSystem;
 
 void setup() {
-  wdt_enable(WDTO_4S);  // 4-second watchdog timeout
   Serial.begin(9600);
   delay(10);
 
+  // the reader bench runs far longer than the watchdog timeout, so it goes
+  // before the watchdog is armed (a watchdog reset leaves it armed on AVR)
+  wdt_disable();
+  if (readerBenchRequested()) {
+    runReaderBench();
+  }
+
+  wdt_enable(WDTO_4S);  // 4-second watchdog timeout
+
   if (!wallSystem.initializeSystem(reader)) {
     // if system initialization failed - wallSystem object handles error state
     return;
@@ -3,6 +3,7 @@
 #include "Battery.h"
 #include "Config.h"
 #include "Debug.h"
+#include "Marker.h"
 #include "MuxController.h"
 
 /*
@@ -11,7 +12,9 @@
  * @return Successful initialization
  */
 bool Battery::initialize(MFRC522 &reader) {
-  // Test MUX communication first
+  // Test MUX communication first. the mux may have been power cycled since
+  // the cache last saw it, so the first select always goes out
+  MuxController::invalidate(getMuxAddr());
   Wire.beginTransmission(getMuxAddr());
   byte result = Wire.endTransmission();
   if (result != 0) {
@@ -50,13 +53,17 @@ bool Battery::initialize(MFRC522 &reader) {
 void Battery::updateReaders(MFRC522 &reader) {
   // update positive terminal
   MuxController::selectChannel(muxAddr, config::POSITIVE_TERMINAL_CHANNEL);
+  MARKER_HIGH(config::MARKER_PROBE_PIN);
   reader.PCD_Init();
   positive.update(reader);
+  MARKER_LOW(config::MARKER_PROBE_PIN);
 
   // update negative terminal
   MuxController::selectChannel(muxAddr, config::NEGATIVE_TERMINAL_CHANNEL);
+  MARKER_HIGH(config::MARKER_PROBE_PIN);
   reader.PCD_Init();
   negative.update(reader);
+  MARKER_LOW(config::MARKER_PROBE_PIN);
 
   MuxController::disableChannel(muxAddr);
 }
@@ -23,6 +23,25 @@ static constexpr uint16_t POLL_INTERVAL_MS =
 static constexpr uint8_t GREEN_LED_PIN = 6;
 static constexpr uint8_t RED_LED_PIN = 7;
 
+// ----- LOGIC ANALYZER MARKERS (only with MARKERS_ENABLED, see Marker.h) -----
+static constexpr uint8_t MARKER_PROBE_PIN = A0;
+static constexpr uint8_t MARKER_PACKET_TX_PIN = A1;
+
+// ----- READER BENCH (ReaderBench.h) -----
+// runs once before the normal start when READER_BENCH_STRAP_PIN is jumpered
+// to GND. with READER_BENCH_SERIAL_TRIGGER set, 'r' over USB serial within
+// READER_BENCH_SERIAL_WAIT_MS also starts it, but that window is then added
+// to every boot, so leave it false on the exhibit
+static constexpr uint8_t READER_BENCH_STRAP_PIN = 8;
+static constexpr bool READER_BENCH_SERIAL_TRIGGER = false;
+static constexpr uint16_t READER_BENCH_SERIAL_WAIT_MS = 1000;
+static constexpr uint8_t READER_BENCH_ROUNDS = 50; // probes per reader per run
+static constexpr uint32_t READER_BENCH_CLOCKS_HZ[] = {100000, 400000};
+// tag trace: every reader's raw sightings for this many passes, one pass
+// every TAG_TRACE_PASS_MS at most, printed for tools/host/sweep
+static constexpr uint8_t TAG_TRACE_POLLS = 128;
+static constexpr uint16_t TAG_TRACE_PASS_MS = POLL_INTERVAL_MS;
+
 // ----- RS-485 -----
 static constexpr uint32_t RS485_BAUD_RATE = 9600;
 static constexpr uint8_t RS485_DE_PIN = 5; // driver enable pin (DE/RE toggle)
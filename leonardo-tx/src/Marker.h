@@ -0,0 +1,27 @@
+#pragma once
+/**
+ * Marker.h
+ *
+ * Optional GPIO markers for timing the wall side with a logic analyzer,
+ * pins are MARKER_*_PIN in Config.h:
+ *  - MARKER_PROBE_PIN high while one terminal reader is probed
+ *    (PCD_Init + TerminalReader::update)
+ *  - MARKER_PACKET_TX_PIN high from Serial1.write() until the packet has left
+ *    the UART (flush)
+ *
+ * Set MARKERS_ENABLED to 1 to compile them in. At 0 every MARKER_* macro is
+ * empty and the build is the same as without them. A digitalWrite is a few
+ * us on the 32U4, small next to a reader probe.
+ */
+
+#define MARKERS_ENABLED 0
+
+#if MARKERS_ENABLED
+#define MARKER_INIT(pin) pinMode(pin, OUTPUT)
+#define MARKER_HIGH(pin) digitalWrite(pin, HIGH)
+#define MARKER_LOW(pin) digitalWrite(pin, LOW)
+#else
+#define MARKER_INIT(pin)
+#define MARKER_HIGH(pin)
+#define MARKER_LOW(pin)
+#endif
@@ -2,29 +2,102 @@
 /**
  * MuxController.h
  *
- * Centralized logic for switching channels on I2C mux
+ * Centralized logic for switching channels on I2C mux, with a per-mux cache
+ * of the current channel mask so redundant writes are skipped
  */
 #include <Arduino.h>
 
 #include "Config.h"
 #include "Wire.h"
 
+// running totals so the savings of the channel cache can be reported
+struct MuxStats {
+  uint32_t writes;        // I2C transactions actually sent to a mux
+  uint32_t skippedWrites; // requests that matched the cached channel mask
+  uint32_t settleMsSaved; // CHANNEL_SWITCH_SETTLE_MS delays not waited out
+};
+
+/*
+ * Stateful helper: remembers the last channel mask written to every
+ * TCA9548A (addresses 0x70-0x77) and skips writes + settle delays when the
+ * mux is already in the requested state. A failed write forgets the cached
+ * mask so the next request always goes out.
+ */
 class MuxController {
 public:
   static void selectChannel(uint8_t muxAddress, uint8_t channel) {
     if (channel > 7)
       return;
-    Wire.beginTransmission(muxAddress);
-    Wire.write(1 << channel);
-    Wire.endTransmission();
-
-    delay(config::CHANNEL_SWITCH_SETTLE_MS);
+    if (writeMask(muxAddress, 1 << channel)) {
+      delay(config::CHANNEL_SWITCH_SETTLE_MS);
+    }
   }
   static void disableChannel(uint8_t muxAddress) {
+    if (writeMask(muxAddress, 0)) {
+      delay(config::CHANNEL_SWITCH_SETTLE_MS);
+    }
+  }
+  // turns every listed mux off, settling once for the whole batch
+  static void disableAll(const uint8_t *muxAddresses, uint8_t count) {
+    uint8_t written = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (writeMask(muxAddresses[i], 0))
+        written++;
+    }
+    if (written > 0) {
+      delay(config::CHANNEL_SWITCH_SETTLE_MS);
+      cache().stats.settleMsSaved +=
+          uint32_t(written - 1) * config::CHANNEL_SWITCH_SETTLE_MS;
+    }
+  }
+  // forget the cached mask, for a failed write or a mux that may have been
+  // reset behind our back
+  static void invalidate(uint8_t muxAddress) {
+    if (isTracked(muxAddress))
+      cache().knownBits &= ~(1 << slot(muxAddress));
+  }
+  static const MuxStats &getStats() { return cache().stats; }
+
+private:
+  struct MuxCache {
+    uint8_t masks[8];
+    uint8_t knownBits; // bit n set -> masks[n] reflects the hardware
+    MuxStats stats;
+  };
+
+  // function-local static so this can stay header-only
+  static MuxCache &cache() {
+    static MuxCache c = {};
+    return c;
+  }
+  static bool isTracked(uint8_t muxAddress) {
+    return (muxAddress & 0xF8) == 0x70;
+  }
+  static uint8_t slot(uint8_t muxAddress) { return muxAddress & 0x07; }
+
+  // returns true if an I2C write went out (caller settles afterwards)
+  static bool writeMask(uint8_t muxAddress, uint8_t mask) {
+    MuxCache &c = cache();
+    bool tracked = isTracked(muxAddress);
+    uint8_t bit = tracked ? (1 << slot(muxAddress)) : 0;
+
+    if (tracked && (c.knownBits & bit) && c.masks[slot(muxAddress)] == mask) {
+      c.stats.skippedWrites++;
+      c.stats.settleMsSaved += config::CHANNEL_SWITCH_SETTLE_MS;
+      return false;
+    }
+
     Wire.beginTransmission(muxAddress);
-    Wire.write(0);
-    Wire.endTransmission();
+    Wire.write(mask);
+    uint8_t result = Wire.endTransmission();
+    c.stats.writes++;
 
-    delay(config::CHANNEL_SWITCH_SETTLE_MS);
+    if (result != 0) {
+      invalidate(muxAddress);
+    } else if (tracked) {
+      c.masks[slot(muxAddress)] = mask;
+      c.knownBits |= bit;
+    }
+    return true;
   }
 };
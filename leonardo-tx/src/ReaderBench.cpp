@@ -0,0 +1,294 @@
+#include "ReaderBench.h"
+#include "Config.h"
+#include "MuxController.h"
+#include "TerminalReader.h"
+#include <Arduino.h>
+#include <MFRC522DriverI2C.h>
+#include <MFRC522v2.h>
+#include <Wire.h>
+
+namespace {
+enum ProbeInit : uint8_t { INIT_FULL, INIT_ANTENNA, INIT_NONE };
+const char *const INIT_NAMES[] = {"full", "antenna", "none"};
+constexpr uint8_t NUM_INIT_STRATEGIES = 3;
+
+/*
+ * MFRC522DriverI2C that counts the bus transactions it issues: one per
+ * register write, two per register read (address write + requestFrom)
+ */
+class CountingDriverI2C : public MFRC522DriverI2C {
+public:
+  CountingDriverI2C(uint8_t address, TwoWire &wire)
+      : MFRC522DriverI2C(address, wire) {}
+
+  void PCD_WriteRegister(const PCD_Register reg, const byte value) override {
+    transactions++;
+    MFRC522DriverI2C::PCD_WriteRegister(reg, value);
+  }
+  void PCD_WriteRegister(const PCD_Register reg, const byte count,
+                         byte *const values) override {
+    transactions++;
+    MFRC522DriverI2C::PCD_WriteRegister(reg, count, values);
+  }
+  byte PCD_ReadRegister(const PCD_Register reg) override {
+    transactions += 2;
+    return MFRC522DriverI2C::PCD_ReadRegister(reg);
+  }
+  void PCD_ReadRegister(const PCD_Register reg, const byte count,
+                        byte *const values, const byte rxAlign = 0) override {
+    transactions += 2;
+    MFRC522DriverI2C::PCD_ReadRegister(reg, count, values, rxAlign);
+  }
+
+  uint32_t transactions = 0;
+};
+
+struct ProbeStats {
+  uint16_t probes;
+  uint16_t detections;
+  uint32_t totalUs;
+  uint32_t maxUs;
+  uint32_t readerTx;
+  uint32_t muxTx;
+};
+
+struct BenchTarget {
+  uint8_t muxAddr;
+  TerminalReader terminal;
+  ProbeStats stats;
+};
+
+// same order as WallBatterySystem polls them
+constexpr uint8_t NUM_TARGETS = config::NUM_BATTERIES * 2;
+
+void selectTarget(const BenchTarget &t) {
+  MuxController::selectChannel(t.muxAddr, t.terminal.getChannel());
+}
+
+// two muxes with a channel open would put two readers on 0x28, so a mux is
+// switched off before the next one is used, like Battery::updateReaders does
+void leaveTarget(BenchTarget *targets, uint8_t i) {
+  if (i + 1 == NUM_TARGETS || targets[i + 1].muxAddr != targets[i].muxAddr)
+    MuxController::disableChannel(targets[i].muxAddr);
+}
+
+void probe(MFRC522 &reader, CountingDriverI2C &driver, BenchTarget *targets,
+           uint8_t i, ProbeInit init) {
+  BenchTarget &t = targets[i];
+  uint32_t txBefore = driver.transactions;
+  uint32_t muxBefore = MuxController::getStats().writes;
+  unsigned long startUs = micros();
+
+  selectTarget(t);
+  if (init == INIT_FULL) {
+    reader.PCD_Init();
+  } else if (init == INIT_ANTENNA) {
+    reader.PCD_AntennaOff();
+    reader.PCD_AntennaOn();
+  }
+  t.terminal.update(reader);
+  leaveTarget(targets, i);
+
+  uint32_t probeUs = micros() - startUs;
+  t.stats.probes++;
+  if (t.terminal.sawTagLastUpdate())
+    t.stats.detections++;
+  t.stats.totalUs += probeUs;
+  if (probeUs > t.stats.maxUs)
+    t.stats.maxUs = probeUs;
+  t.stats.readerTx += driver.transactions - txBefore;
+  t.stats.muxTx += MuxController::getStats().writes - muxBefore;
+}
+
+void printProbeStats(const char *name, bool ok, uint32_t clockHz,
+                     ProbeInit init, const ProbeStats &s) {
+  Serial.print(F("bench board=leonardo name=rfid_probe reader="));
+  Serial.print(name);
+  Serial.print(F(" ok="));
+  Serial.print(ok ? 1 : 0);
+  Serial.print(F(" i2c_hz="));
+  Serial.print(clockHz);
+  Serial.print(F(" init="));
+  Serial.print(INIT_NAMES[init]);
+  Serial.print(F(" settle_ms="));
+  Serial.print(config::CHANNEL_SWITCH_SETTLE_MS);
+  Serial.print(F(" probes="));
+  Serial.print(s.probes);
+  Serial.print(F(" total_us="));
+  Serial.print(s.totalUs);
+  Serial.print(F(" probes_per_s="));
+  Serial.print(s.totalUs ? (1000000.0f * s.probes) / s.totalUs : 0.0f, 1);
+  Serial.print(F(" detect_pct="));
+  Serial.print(s.probes ? (100.0f * s.detections) / s.probes : 0.0f, 1);
+  Serial.print(F(" probe_us_mean="));
+  Serial.print(s.probes ? s.totalUs / s.probes : 0);
+  Serial.print(F(" probe_us_max="));
+  Serial.print(s.maxUs);
+  Serial.print(F(" i2c_tx="));
+  Serial.print(s.readerTx);
+  Serial.print(F(" mux_tx="));
+  Serial.println(s.muxTx);
+}
+
+void runConfig(MFRC522 &reader, CountingDriverI2C &driver,
+               BenchTarget *targets, uint32_t clockHz, ProbeInit init) {
+  Wire.setClock(clockHz);
+
+  // every run starts from freshly initialized chips, not timed
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    targets[i].stats = {};
+    selectTarget(targets[i]);
+    reader.PCD_Init();
+    leaveTarget(targets, i);
+  }
+
+  unsigned long startUs = micros();
+  for (uint8_t round = 0; round < config::READER_BENCH_ROUNDS; round++) {
+    for (uint8_t i = 0; i < NUM_TARGETS; i++)
+      probe(reader, driver, targets, i, init);
+  }
+  uint32_t totalUs = micros() - startUs;
+
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    printProbeStats(targets[i].terminal.getName(),
+                    targets[i].terminal.getReaderStatus(), clockHz, init,
+                    targets[i].stats);
+  }
+  Serial.print(F("bench board=leonardo name=rfid_pass i2c_hz="));
+  Serial.print(clockHz);
+  Serial.print(F(" init="));
+  Serial.print(INIT_NAMES[init]);
+  Serial.print(F(" rounds="));
+  Serial.print(config::READER_BENCH_ROUNDS);
+  Serial.print(F(" total_us="));
+  Serial.print(totalUs);
+  Serial.print(F(" pass_us_mean="));
+  Serial.println(totalUs / config::READER_BENCH_ROUNDS);
+}
+
+// ----- tag trace -----
+// raw sightings for tools/host/sweep, which replays them through the tag state
+// machine with other timings. a pass is printed after its probes so the
+// printing doesn't move them
+struct TraceEntry {
+  unsigned long ms;
+  bool seen;
+  MFRC522::Uid uid;
+};
+
+void printTraceEntry(const char *name, uint8_t poll, const TraceEntry &e) {
+  Serial.print(F("bench board=leonardo name=tag_trace reader="));
+  Serial.print(name);
+  Serial.print(F(" poll="));
+  Serial.print(poll);
+  Serial.print(F(" t_ms="));
+  Serial.print(e.ms);
+  Serial.print(F(" seen="));
+  Serial.print(e.seen ? 1 : 0);
+  Serial.print(F(" uid="));
+  if (!e.seen)
+    Serial.print('-');
+  for (uint8_t b = 0; e.seen && b < e.uid.size; b++) {
+    if (e.uid.uidByte[b] < 0x10)
+      Serial.print('0');
+    Serial.print(e.uid.uidByte[b], HEX);
+  }
+  Serial.println();
+}
+
+void runTagTrace(MFRC522 &reader, CountingDriverI2C &driver,
+                 BenchTarget *targets) {
+  TraceEntry pass[NUM_TARGETS];
+  unsigned long traceStartMs = millis();
+  for (uint8_t poll = 0; poll < config::TAG_TRACE_POLLS; poll++) {
+    unsigned long passStartMs = millis();
+    for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+      probe(reader, driver, targets, i, INIT_FULL);
+      pass[i].ms = millis() - traceStartMs;
+      pass[i].seen = targets[i].terminal.sawTagLastUpdate();
+      pass[i].uid = reader.uid;
+    }
+    for (uint8_t i = 0; i < NUM_TARGETS; i++)
+      printTraceEntry(targets[i].terminal.getName(), poll, pass[i]);
+    while (millis() - passStartMs < config::TAG_TRACE_PASS_MS) {
+    }
+  }
+}
+} // namespace
+
+/*
+ * @brief True if the strap pin is pulled low, or, in READER_BENCH_SERIAL_TRIGGER
+ * builds only, if 'r' arrives over USB serial within
+ * READER_BENCH_SERIAL_WAIT_MS
+ */
+bool readerBenchRequested() {
+  pinMode(config::READER_BENCH_STRAP_PIN, INPUT_PULLUP);
+  delay(1); // let the pull-up charge the pin
+  if (digitalRead(config::READER_BENCH_STRAP_PIN) == LOW)
+    return true;
+  if (!config::READER_BENCH_SERIAL_TRIGGER)
+    return false; // a normal boot doesn't wait for the serial window
+
+  // USB serial takes a moment to come back after a reset, so the whole window
+  // is waited out even with no monitor attached
+  bool prompted = false;
+  unsigned long startMs = millis();
+  while (millis() - startMs < config::READER_BENCH_SERIAL_WAIT_MS) {
+    if (!Serial)
+      continue;
+    if (!prompted) {
+      Serial.println(F("send 'r' to run the reader bench"));
+      prompted = true;
+    }
+    if (Serial.available() && Serial.read() == 'r')
+      return true;
+  }
+  return false;
+}
+
+/*
+ * @brief Probes every reader with a fixed pattern for each I2C clock and init
+ * strategy and prints the results, then records the tag trace. Puts the bus
+ * back the way the normal start expects it
+ */
+void runReaderBench() {
+  CountingDriverI2C driver{config::RFID2_WS1850S_ADDR, Wire};
+  MFRC522 reader{driver};
+  const uint8_t addr = config::RFID2_WS1850S_ADDR;
+  BenchTarget targets[NUM_TARGETS] = {
+      {config::TCA9548A_6V_ADDR,
+       {addr, "6V_pos", config::POSITIVE_TERMINAL_CHANNEL}, {}},
+      {config::TCA9548A_6V_ADDR,
+       {addr, "6V_neg", config::NEGATIVE_TERMINAL_CHANNEL}, {}},
+      {config::TCA9548A_12V_ADDR,
+       {addr, "12V_pos", config::POSITIVE_TERMINAL_CHANNEL}, {}},
+      {config::TCA9548A_12V_ADDR,
+       {addr, "12V_neg", config::NEGATIVE_TERMINAL_CHANNEL}, {}},
+      {config::TCA9548A_16V_ADDR,
+       {addr, "16V_pos", config::POSITIVE_TERMINAL_CHANNEL}, {}},
+      {config::TCA9548A_16V_ADDR,
+       {addr, "16V_neg", config::NEGATIVE_TERMINAL_CHANNEL}, {}},
+  };
+
+  Serial.print(F("bench board=leonardo begin cpu_hz="));
+  Serial.println(F_CPU);
+
+  Wire.begin();
+  Wire.setClock(config::I2C_CLOCK_SPEED);
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    selectTarget(targets[i]);
+    targets[i].terminal.init(reader);
+    leaveTarget(targets, i);
+  }
+
+  for (uint8_t c = 0;
+       c < sizeof(config::READER_BENCH_CLOCKS_HZ) / sizeof(uint32_t); c++) {
+    for (uint8_t s = 0; s < NUM_INIT_STRATEGIES; s++)
+      runConfig(reader, driver, targets, config::READER_BENCH_CLOCKS_HZ[c],
+                ProbeInit(s));
+  }
+
+  Wire.setClock(config::I2C_CLOCK_SPEED);
+  runTagTrace(reader, driver, targets);
+  Serial.println(F("bench board=leonardo end"));
+}
@@ -0,0 +1,47 @@
+#pragma once
+/**
+ * ReaderBench.h
+ *
+ * On-device RFID throughput benchmark. Selected at boot by jumpering
+ * READER_BENCH_STRAP_PIN to GND, or by sending 'r' over USB serial in builds
+ * with READER_BENCH_SERIAL_TRIGGER set (see Config.h). It runs once before the
+ * normal start.
+ *
+ * Every reader is probed READER_BENCH_ROUNDS times in the same round-robin
+ * order as the poll loop (mux switch, reader init, TerminalReader::update), for
+ * each I2C clock in READER_BENCH_CLOCKS_HZ and each init strategy:
+ *   full     PCD_Init before every probe (what the poll loop does)
+ *   antenna  antenna off/on only, resets the tag without re-initializing the
+ *            chip
+ *   none     the chip is initialized once, then just polled
+ *
+ * One line per reader per run, plus one per run for the whole pass:
+ *
+ *   bench board=leonardo name=rfid_probe reader=<r> ok=<0|1> i2c_hz=<hz>
+ *     init=<s> settle_ms=<ms> probes=<n> total_us=<t> probes_per_s=<x>
+ *     detect_pct=<x> probe_us_mean=<x> probe_us_max=<x> i2c_tx=<n> mux_tx=<n>
+ *   bench board=leonardo name=rfid_pass i2c_hz=<hz> init=<s> rounds=<n>
+ *     total_us=<t> pass_us_mean=<x>
+ *
+ * (each on one line). i2c_tx counts reader bus transactions: a register write
+ * is one, a register read is two (address write + read). mux_tx counts the mux
+ * channel writes that actually went out. The format is stable so runs from
+ * two firmware versions can be diffed. Leave tags on the terminals whose
+ * detection rate you want to see.
+ *
+ * Then the tag trace: every reader is polled TAG_TRACE_POLLS times the way the
+ * poll loop does it (mux switch, PCD_Init, update) and each probe's raw
+ * sighting is printed, before any debounce:
+ *
+ *   bench board=leonardo name=tag_trace reader=<r> poll=<n> t_ms=<ms>
+ *     seen=<0|1> uid=<hex|->
+ *
+ * t_ms is when the probe finished, from the start of the trace. Capture the
+ * output to a file and give it to tools/host/sweep, which replays it through
+ * the tag state machine for a grid of timings (see Host Tools in the README).
+ * Record once with tags left on the terminals and once without, so misses
+ * and phantom sightings are both covered.
+ */
+
+bool readerBenchRequested(); // strap pin, or 'r' on USB serial if enabled
+void runReaderBench();
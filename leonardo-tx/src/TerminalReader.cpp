@@ -43,103 +43,146 @@ void TerminalReader::update(MFRC522 &reader) {
 
   unsigned long currentTime = millis();
   bool tagDetected = false;
+  bool isSameTag = false;
 
   // try to detect tag without halting it
   if (reader.PICC_IsNewCardPresent() && reader.PICC_ReadCardSerial()) {
     tagDetected = true;
 
     // check if this is the same tag or a different one
-    bool isSameTag = (lastUIDLength == reader.uid.size) &&
-                     compareUID(lastUID, reader.uid.uidByte, reader.uid.size);
+    isSameTag = (lastUIDLength == reader.uid.size) &&
+                compareUID(lastUID, reader.uid.uidByte, reader.uid.size);
 
     // update UID
     memcpy(lastUID, reader.uid.uidByte, reader.uid.size);
     lastUIDLength = reader.uid.size;
+  }
+
+  lastUpdateSawTag = tagDetected;
+
+  switch (tags.step(tagDetected, isSameTag, currentTime)) {
+  case TAG_EVENT_NONE:
+    break;
+  case TAG_EVENT_NEW:
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": New tag detected!");
+    break;
+  case TAG_EVENT_CONFIRMED:
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": Tag confirmed present");
+    readTagData(reader);
+    break;
+  case TAG_EVENT_DIFFERENT:
+    clearTagData();
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": Different tag detected!");
+    break;
+  case TAG_EVENT_RETURNED:
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": Tag returned!");
+    break;
+  case TAG_EVENT_DETECT_FAILED:
+    clearTagData();
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": Tag detection failed");
+    break;
+  case TAG_EVENT_REMOVED:
+    clearTagData();
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": Tag removed!");
+    break;
+  case TAG_EVENT_GONE:
+    DEBUG_PRINT(name);
+    DEBUG_PRINTLN(": Tag removal confirmed");
+    break;
+  }
+}
 
+/*
+ * @brief Advances the tag state machine by one poll, also handles absence
+ * detection
+ *
+ * @param seen the reader saw a tag on this poll
+ * @param sameTag it has the UID seen before
+ * @param now millis() of the poll (or replayed trace time)
+ * @return the transition taken, TAG_EVENT_NONE if the state didn't change
+ */
+TagEvent TagStateMachine::step(bool seen, bool sameTag, unsigned long now) {
+  if (seen) {
     // update timing
-    lastSeenTime = currentTime;
+    lastSeenTime = now;
     consecutiveFails = 0;
 
-    // state transitions from previous tagState to new tagState now that one has
+    // state transitions from previous state to new state now that one has
     // been detected
-    switch (tagState) {
+    switch (state) {
     case TAG_ABSENT:
-      tagState = TAG_DETECTED;
-      firstSeenTime = currentTime; // start debounce timer
-      DEBUG_PRINT(name);
-      DEBUG_PRINTLN(": New tag detected!");
-      break;
+      state = TAG_DETECTED;
+      firstSeenTime = now; // start debounce timer
+      return TAG_EVENT_NEW;
 
     case TAG_DETECTED:
       // check if enough time has passed for debouncing
-      if (currentTime - firstSeenTime > config::TAG_DEBOUNCE_TIME) {
-        tagState = TAG_PRESENT;
-        DEBUG_PRINT(name);
-        DEBUG_PRINTLN(": Tag confirmed present");
-        readTagData(reader);
+      if (now - firstSeenTime > timing.debounceMs) {
+        state = TAG_PRESENT;
+        return TAG_EVENT_CONFIRMED;
       }
-      break;
+      return TAG_EVENT_NONE;
 
     case TAG_PRESENT:
-      if (!isSameTag) {
+      if (!sameTag) {
         // different tag detected
-        tagState = TAG_DETECTED;
-        firstSeenTime = currentTime;
-        clearTagData();
-        DEBUG_PRINT(name);
-        DEBUG_PRINTLN(": Different tag detected!");
+        state = TAG_DETECTED;
+        firstSeenTime = now;
+        return TAG_EVENT_DIFFERENT;
       }
       // otherwise same tag still present - no action needed (already read its
       // data)
-      break;
+      return TAG_EVENT_NONE;
 
     case TAG_REMOVED:
-      tagState = TAG_DETECTED;
-      firstSeenTime = currentTime;
-      DEBUG_PRINT(name);
-      DEBUG_PRINTLN(": Tag returned!");
-      break;
+      state = TAG_DETECTED;
+      firstSeenTime = now;
+      return TAG_EVENT_RETURNED;
     }
+    return TAG_EVENT_NONE;
   }
 
   // Handle absence detection
-  if (!tagDetected && tagState != TAG_ABSENT) {
-    consecutiveFails++;
-
-    // Use different logic based on current state
-    if (tagState == TAG_DETECTED) {
-      // Quick timeout for tags that were just detected
-      if (consecutiveFails >= 2) {
-        tagState = TAG_ABSENT;
-        clearTagData();
-        DEBUG_PRINT(name);
-        DEBUG_PRINTLN(": Tag detection failed");
-      }
-    } else if (tagState == TAG_PRESENT) {
-      // More lenient for established tags
-      if (consecutiveFails >= config::TAG_PRESENCE_THRESHOLD ||
-          (currentTime - lastSeenTime > config::TAG_ABSENCE_TIMEOUT)) {
-        tagState = TAG_REMOVED;
-        clearTagData();
-        DEBUG_PRINT(name);
-        DEBUG_PRINTLN(": Tag removed!");
-      }
-    } else if (tagState == TAG_REMOVED) {
-      // Confirm removal
-      if (currentTime - lastSeenTime > config::TAG_ABSENCE_TIMEOUT * 2) {
-        tagState = TAG_ABSENT;
-        DEBUG_PRINT(name);
-        DEBUG_PRINTLN(": Tag removal confirmed");
-      }
+  if (state == TAG_ABSENT)
+    return TAG_EVENT_NONE;
+  consecutiveFails++;
+
+  // Use different logic based on current state
+  if (state == TAG_DETECTED) {
+    // Quick timeout for tags that were just detected
+    if (consecutiveFails >= timing.detectFailThreshold) {
+      state = TAG_ABSENT;
+      return TAG_EVENT_DETECT_FAILED;
+    }
+  } else if (state == TAG_PRESENT) {
+    // More lenient for established tags
+    if (consecutiveFails >= timing.presenceThreshold ||
+        (now - lastSeenTime > timing.absenceTimeoutMs)) {
+      state = TAG_REMOVED;
+      return TAG_EVENT_REMOVED;
+    }
+  } else if (state == TAG_REMOVED) {
+    // Confirm removal
+    if (now - lastSeenTime >
+        timing.absenceTimeoutMs * timing.removalConfirmFactor) {
+      state = TAG_ABSENT;
+      return TAG_EVENT_GONE;
     }
   }
+  return TAG_EVENT_NONE;
 }
 
 /*
  * @brief Debugging output for tag states
  */
 void TerminalReader::printStatus() const {
-  switch (tagState) {
+  switch (tags.getState()) {
   case TAG_ABSENT:
     DEBUG_PRINTLN("No card");
     break;
@@ -176,7 +219,7 @@ void TerminalReader::clearTagData() {
  * @param reader MFRC522 rfid reader object
  */
 void TerminalReader::readTagData(MFRC522 &reader) {
-  if (!isReaderOK || tagState != TAG_PRESENT)
+  if (!isReaderOK || tags.getState() != TAG_PRESENT)
     return;
 
   DEBUG_PRINT(name);
@@ -9,6 +9,7 @@
  * - comprehensive tag reading function readTagData()
  */
 
+#include "Config.h"
 #include <Arduino.h>
 #include <MFRC522Debug.h>
 #include <MFRC522DriverI2C.h>
@@ -23,31 +24,78 @@ struct JumperCableTagData {
   uint8_t checksum; // simple validation
 };
 
+// timing of the tag state machine, passed in rather than read from Config.h
+// so tools/host/sweep can replay recorded sightings under other values
+struct TagTimingConfig {
+  unsigned long debounceMs;       // DETECTED -> PRESENT after this long
+  unsigned long absenceTimeoutMs; // PRESENT -> REMOVED after this long unseen
+  uint8_t presenceThreshold;      // ... or after this many missed polls
+  uint8_t detectFailThreshold;    // DETECTED -> ABSENT after this many misses
+  uint8_t removalConfirmFactor;   // REMOVED -> ABSENT after absenceTimeout * this
+};
+
+// the Config.h values
+constexpr TagTimingConfig defaultTagTiming() {
+  return {config::TAG_DEBOUNCE_TIME, config::TAG_ABSENCE_TIMEOUT,
+          config::TAG_PRESENCE_THRESHOLD, 2, 2};
+}
+
+// what a step() changed, TerminalReader logs it and reads/clears tag data
+enum TagEvent {
+  TAG_EVENT_NONE,
+  TAG_EVENT_NEW,           // ABSENT -> DETECTED
+  TAG_EVENT_CONFIRMED,     // DETECTED -> PRESENT
+  TAG_EVENT_DIFFERENT,     // PRESENT -> DETECTED, another UID
+  TAG_EVENT_RETURNED,      // REMOVED -> DETECTED
+  TAG_EVENT_DETECT_FAILED, // DETECTED -> ABSENT
+  TAG_EVENT_REMOVED,       // PRESENT -> REMOVED
+  TAG_EVENT_GONE,          // REMOVED -> ABSENT
+};
+
+// the tag state machine without the reader I/O, so recorded sightings can be
+// replayed through it with other timings
+class TagStateMachine {
+public:
+  explicit TagStateMachine(const TagTimingConfig &timing = defaultTagTiming())
+      : timing(timing) {}
+
+  // one poll: seen = the reader saw a tag, sameTag = the UID it saw before
+  TagEvent step(bool seen, bool sameTag, unsigned long now);
+  TagState getState() const { return state; }
+
+private:
+  TagTimingConfig timing;
+  TagState state = TAG_ABSENT;
+  unsigned long lastSeenTime = 0;
+  unsigned long firstSeenTime = 0;
+  uint8_t consecutiveFails = 0;
+};
+
 class TerminalReader {
 public:
   TerminalReader(uint8_t address, const char *name, uint8_t channel)
-      : address(address), name(name), channel(channel) {}
+      : name(name), address(address), channel(channel) {}
 
   void init(MFRC522 &reader);
   void update(MFRC522 &reader);
   void printStatus() const;
 
-  TagState getTagState() const { return tagState; }
+  TagState getTagState() const { return tags.getState(); }
   JumperCableTagData getTagData() const { return tagData; }
   uint8_t getChannel() const { return channel; }
+  const char *getName() const { return name; }
   bool getReaderStatus() const { return isReaderOK; }
   bool polarityOK() const { return isCorrectPolarity; }
+  bool sawTagLastUpdate() const { return lastUpdateSawTag; } // raw, no debounce
 
 private:
   const char *name;
   uint8_t address;
   uint8_t channel;
   bool isReaderOK = false;
-  TagState tagState = TAG_ABSENT;
-  unsigned long lastSeenTime = 0;
-  unsigned long firstSeenTime = 0;
-  uint8_t consecutiveFails = 0;
+  TagStateMachine tags;
   bool isCorrectPolarity = false;
+  bool lastUpdateSawTag = false;
   JumperCableTagData tagData{};
   byte lastUID[10]{};
   byte lastUIDLength = 0;
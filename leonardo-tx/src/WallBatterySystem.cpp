@@ -1,6 +1,7 @@
 #include "WallBatterySystem.h"
 #include "CommPacket.h"
 #include "Debug.h"
+#include "Marker.h"
 #include "MuxController.h"
 
 /*
@@ -35,6 +36,9 @@ bool WallBatterySystem::initializeSystem(MFRC522 &reader) {
   digitalWrite(config::GREEN_LED_PIN, LOW);
   digitalWrite(config::RED_LED_PIN, LOW);
 
+  MARKER_INIT(config::MARKER_PROBE_PIN);
+  MARKER_INIT(config::MARKER_PACKET_TX_PIN);
+
   currentLEDState = LED_OFF;
   lastLEDState = LED_OFF;
 
@@ -113,6 +117,14 @@ void WallBatterySystem::printSystemStatus() const {
   }
   DEBUG_PRINT("Overall System: ");
   DEBUG_PRINTLN(systemHealthy ? "HEALTHY" : "UNHEALTHY");
+
+  const MuxStats &muxStats = MuxController::getStats();
+  DEBUG_PRINT("Mux writes: ");
+  DEBUG_PRINT(muxStats.writes);
+  DEBUG_PRINT(", skipped: ");
+  DEBUG_PRINT(muxStats.skippedWrites);
+  DEBUG_PRINT(", settle ms saved: ");
+  DEBUG_PRINTLN(muxStats.settleMsSaved);
   DEBUG_PRINTLN("=====================");
 }
 
@@ -203,8 +215,10 @@ void WallBatterySystem::sendBatteryPacket(uint8_t batteryIndex,
   packet.POS_STATE = state.posPolarity ? 1 : 0;
   packet.CHK = xorChecksum(packet);
 
+  MARKER_HIGH(config::MARKER_PACKET_TX_PIN);
   Serial1.write((uint8_t *)&packet, sizeof(WallStatusPacket));
   Serial1.flush();
+  MARKER_LOW(config::MARKER_PACKET_TX_PIN);
 
   DEBUG_PRINT("📤 Packet sent for battery ");
   DEBUG_PRINTLN(batteries[batteryIndex].getName());
@@ -345,10 +359,13 @@ void WallBatterySystem::handleSystemFailure() const {
 }
 
 /*
- * @brief Utility function for diabling all mux channels
+ * @brief Utility function for diabling all mux channels in one batch (single
+ * settle delay, muxes already off are skipped)
  */
 void WallBatterySystem::disableAllMuxChannels() {
+  uint8_t muxAddrs[config::NUM_BATTERIES];
   for (int i = 0; i < config::NUM_BATTERIES; i++) {
-    MuxController::disableChannel(batteries[i].getMuxAddr());
+    muxAddrs[i] = batteries[i].getMuxAddr();
   }
+  MuxController::disableAll(muxAddrs, config::NUM_BATTERIES);
 }
@@ -19,6 +19,8 @@
 #include <Adafruit_SleepyDog.h>
 
 #include "src/ToyCarSystem.h"
+#include "src/HotPathBench.h"
+#include "src/ReaderBench.h"
 #include "src/Debug.h"
 
 // ----- MAIN RFID HARDWARE INSTANCES -----
@@ -34,6 +36,14 @@ void setup() {
 
   Wire.begin();
 
+  if (config::HOT_PATH_BENCH_ON_BOOT) {
+    while (!Serial);
+    runHotPathBench();
+  }
+  if (readerBenchRequested()) {
+    runReaderBench();
+  }
+
   DEBUG_PRINTLN("Toy Car MKRZero starting...");
   if (!toyCar.initialize(reader)) {
     DEBUG_PRINTLN("System failed to initialize");
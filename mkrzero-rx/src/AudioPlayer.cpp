@@ -18,13 +18,14 @@ bool AudioPlayer::begin() {
 
   delay(10);
 
-  DEBUG_PRINTLN("AudioPlayer: initialized (SD + I2S)");
+  DEBUG_PRINTLN("AudioPlayer: initialized (trigger mode)");
   return true;
 }
 
 void AudioPlayer::play(uint8_t triggerPin) {
   if (isPlaying) {
     DEBUG_PRINTLN("AudioPlayer: currently playing, cannot play");
+    busyRefusals++;
     return;
   }
 
@@ -49,6 +50,7 @@ void AudioPlayer::play(uint8_t triggerPin) {
   digitalWrite(triggerPin, LOW);
   isPlaying = true;
   playStartTime = millis();
+  plays++;
 
   return;
 }
@@ -66,3 +68,10 @@ void AudioPlayer::update() {
   }
   return;
 }
+
+void AudioPlayer::printStats() const {
+  DEBUG_PRINT("AudioPlayer: plays=");
+  DEBUG_PRINT(plays);
+  DEBUG_PRINT(" refused while busy=");
+  DEBUG_PRINTLN(busyRefusals);
+}
@@ -5,11 +5,14 @@
 class AudioPlayer {
 public:
   AudioPlayer();
-  bool begin();                  // initialize SD + I2S
-  void play(uint8_t triggerPin); // plays given wav file
+  bool begin();                  // set up trigger pins (idle HIGH)
+  void play(uint8_t triggerPin); // pulses given trigger pin LOW
   void update();
+  void printStats() const;
 
 private:
   bool isPlaying = false;
+  uint32_t plays = 0;
+  uint32_t busyRefusals = 0; // play() while the last pulse was still low
   unsigned long playStartTime = 0;
 };
@@ -12,6 +12,17 @@
 
 #include <Arduino.h>
 
+// ----- AUDIO BACKEND SELECTION -----
+// pick which AudioPlayer implementation ToyCarSystem compiles against
+// - TRIGGER: DY-HL30T in GPIO trigger mode (4 clips, one 100ms low pulse each)
+// - UART: DY-HL30T in UART command mode (queued, prioritized, any track index)
+// - I2S: WAV clips streamed from the onboard SD card to an I2S amp, mixed on
+//   the MKR Zero itself (no DY-HL30T)
+#define AUDIO_BACKEND_TRIGGER 0
+#define AUDIO_BACKEND_UART 1
+#define AUDIO_BACKEND_I2S 2
+#define AUDIO_BACKEND AUDIO_BACKEND_TRIGGER
+
 namespace config {
 // ----- RS-485 COMM -----
 static constexpr uint8_t RS485_DE_PIN = 6;
@@ -25,17 +36,90 @@ static constexpr uint8_t PACKET_START2 = 0x55;
 static constexpr unsigned long PACKET_READ_TIMEOUT_MS =
     100; // timeout between bytes while reading packet
 
+// ----- BENCHMARKS -----
+// true: wait for USB serial at boot, print the HotPathBench results, then
+// start normally. leave false on the exhibit
+static constexpr bool HOT_PATH_BENCH_ON_BOOT = false;
+
+// reader bench (ReaderBench.h): runs at boot when READER_BENCH_STRAP_PIN is
+// jumpered to GND. with READER_BENCH_SERIAL_TRIGGER set, 'r' over USB serial
+// within READER_BENCH_SERIAL_WAIT_MS also starts it, but that window is then
+// added to every boot, so leave it false on the exhibit
+static constexpr uint8_t READER_BENCH_STRAP_PIN = 7;
+static constexpr bool READER_BENCH_SERIAL_TRIGGER = false;
+static constexpr uint16_t READER_BENCH_SERIAL_WAIT_MS = 1000;
+static constexpr uint8_t READER_BENCH_ROUNDS = 50; // probes per reader per run
+static constexpr uint32_t READER_BENCH_CLOCKS_HZ[] = {100000, 400000};
+// tag trace: every reader's raw sightings for this many passes, one pass
+// every TAG_TRACE_PASS_MS at most, printed for tools/host/sweep
+static constexpr uint8_t TAG_TRACE_POLLS = 128;
+static constexpr uint16_t TAG_TRACE_PASS_MS = 100; // ToyCarSystem's RFID cadence
+
+// ----- DEBUG -----
+static constexpr unsigned long STATUS_REPORT_MS =
+    10000; // subsystem counters over USB serial (DEBUG_LEVEL >= 1 only)
+
 // ----- LED / UI -----
 static constexpr uint8_t ONBOARD_LED_PIN = 32;
 static constexpr uint16_t LED_PULSE_MS = 200;
 
+// ----- LOGIC ANALYZER MARKERS (only with MARKERS_ENABLED, see Marker.h) -----
+static constexpr uint8_t MARKER_PACKET_RX_PIN = A3;
+static constexpr uint8_t MARKER_AUDIO_PIN = A4;
+static constexpr uint8_t MARKER_LED_CMD_PIN = A5;
+
 // ----- AUDIO -----
 static constexpr const uint8_t SPUTTER_AUDIO_TRIGGER = 5;      // 6V
 static constexpr const uint8_t ENGINE_START_AUDIO_TRIGGER = 4; // 12V
 static constexpr const uint8_t ZAP_AUDIO_TRIGGER = 3;          // 16V
 static constexpr const uint8_t WRONG_CHOICE_AUDIO_TRIGGER = 2;
 static constexpr unsigned long PULSE_SEND_TIME_MS = 100;
-// static constexpr uint8_t AUDIO_VOLUME_PERCENT = 50;
+static constexpr uint8_t AUDIO_VOLUME_PERCENT = 50;
+
+// ----- AUDIO (UART MODE) -----
+// DY-HL30T CON pins strapped for UART, module IO0/IO1 wired to MKR pins 0/1
+// (SERCOM3, leaves Serial1 free for RS-485)
+static constexpr uint8_t AUDIO_UART_TX_PIN = 0; // SERCOM3 PAD[0]
+static constexpr uint8_t AUDIO_UART_RX_PIN = 1; // SERCOM3 PAD[1]
+static constexpr uint32_t AUDIO_UART_BAUD_RATE = 9600;
+static constexpr uint8_t AUDIO_UART_QUEUE_LEN = 4;
+static constexpr unsigned long AUDIO_UART_CMD_GAP_MS =
+    10; // min spacing between frames so the module can digest each one
+static constexpr unsigned long AUDIO_UART_STATUS_POLL_MS =
+    250; // how often to ask the module if it is still playing
+// fallbacks for a lost STOPPED reply (or an unwired module TX line), either
+// one counts the clip as finished so a lower priority cue isn't refused forever
+static constexpr unsigned long AUDIO_UART_MAX_TRACK_MS =
+    8000; // longest clip on the module, with some slack
+static constexpr uint8_t AUDIO_UART_MAX_UNANSWERED_POLLS = 4;
+static constexpr uint8_t AUDIO_MAX_VOLUME = 30; // module volume range 0-30
+
+// track indexes on the module's storage (00001.mp3, 00002.mp3, ...)
+static constexpr uint16_t SPUTTER_AUDIO_TRACK = 1;
+static constexpr uint16_t ENGINE_START_AUDIO_TRACK = 2;
+static constexpr uint16_t ZAP_AUDIO_TRACK = 3;
+static constexpr uint16_t WRONG_CHOICE_AUDIO_TRACK = 4;
+
+// higher priority preempts lower (queued or playing), equal replaces
+static constexpr uint8_t AUDIO_PRIORITY_WRONG_CHOICE = 1;
+static constexpr uint8_t AUDIO_PRIORITY_SUCCESS = 2;
+
+// ----- AUDIO (I2S MODE) -----
+// fixed MKR Zero I2S pins: SCK = 2, FS = 3, SD = A6, so the trigger pins above
+// are unused in this mode. clips must be 16-bit mono PCM at AUDIO_SAMPLE_RATE
+static constexpr uint32_t AUDIO_SAMPLE_RATE = 22050;
+static constexpr uint8_t AUDIO_BITS_PER_SAMPLE = 16;
+static constexpr uint16_t AUDIO_BLOCK_FRAMES =
+    64; // ~2.9ms per block, bounds play() -> first sample latency
+static constexpr uint8_t AUDIO_NUM_VOICES = 2;
+static constexpr uint8_t AUDIO_VOICE_BLOCKS =
+    32; // per-voice SD read-ahead (~93ms), ToyCarSystem refills between
+        // reader probes, so this has to outlast one probe (PCD_Init alone
+        // blocks >= 50ms) plus an SD read, not the whole ~150ms pass
+static constexpr const char *SPUTTER_AUDIO_FILE = "SPUTTER.WAV";
+static constexpr const char *ENGINE_START_AUDIO_FILE = "ENGINE.WAV";
+static constexpr const char *ZAP_AUDIO_FILE = "ZAP.WAV";
+static constexpr const char *WRONG_CHOICE_AUDIO_FILE = "WRONG.WAV";
 
 // ----- I2C Addresses -----
 static constexpr uint8_t MUX_ADDR = 0x70;
@@ -59,6 +143,20 @@ static constexpr uint8_t TAG_PRESENCE_THRESHOLD =
 static constexpr uint8_t TAG_START_READ_PAGE =
     4; // page # to begin reading data from in Tag
 
+// ----- REACTION TIMELINE -----
+// audio and LED animation are scheduled against one start time (sound onset)
+static constexpr unsigned long AUDIO_START_LATENCY_MS =
+    20; // trigger -> audible sound on the DY-HL30T (measure with a scope/mic)
+static constexpr unsigned long REACTION_MIN_LED_LEAD_MS =
+    5; // time the LED command needs to get to the RP2040 and be acted on
+// measured skew: read the RP2040's start report this long after the LED
+// target (first frame is due within a frame of it), retry until the timeout
+static constexpr unsigned long LED_START_REPORT_DELAY_MS = 40;
+static constexpr unsigned long LED_START_REPORT_RETRY_MS = 20;
+static constexpr unsigned long LED_START_REPORT_TIMEOUT_MS = 500;
+// input -> first LED frame histogram, 64 bins (~250ms, last one open-ended)
+static constexpr unsigned long END_TO_END_BIN_MS = 4;
+
 // ----- LED DRIVER (rp2040) CONSTANTS -----
 static constexpr uint8_t LED_CONTROLLER_ADDR = 0x20;
 static constexpr uint8_t CMD_6V_ANIMATION = 0x01;
@@ -66,5 +164,25 @@ static constexpr uint8_t CMD_12V_ANIMATION = 0x02;
 static constexpr uint8_t CMD_16V_ANIMATION = 0x03;
 static constexpr uint8_t CMD_DEFAULT_ANIMATION = 0x04;
 static constexpr uint8_t CMD_WRONG_ANIMATION = 0x05;
+static constexpr uint8_t LED_ACK_BYTES = 2; // [last accepted cmd, sequence #]
+static constexpr uint8_t LED_QUEUE_LEN = 4;
+static constexpr uint8_t LED_MAX_ATTEMPTS = 5;
+static constexpr unsigned long LED_RETRY_BASE_MS =
+    10; // backoff doubles every failed attempt (10, 20, 40, 80ms)
+// RP2040 register map (see rp2040/Config.h), one read from LED_REG_STATUS
+// returns status .. estimated strip current
+static constexpr uint8_t LED_REG_STATUS = 0x82;
+static constexpr uint8_t LED_STATUS_BYTES = 14;
+// [ack sequence # of the command, first frame - its start target, u16 LE us]
+static constexpr uint8_t LED_REG_START_SEQ = 0x91;
+static constexpr uint8_t LED_START_REPORT_BYTES = 3;
+// AnimationVM programs (rp2040 ProgramStore, see LEDPrograms.h)
+static constexpr uint8_t CMD_PROGRAM_BEGIN = 0x10;  // [slot, len lo, len hi]
+static constexpr uint8_t CMD_PROGRAM_DATA = 0x11;   // [offset lo, offset hi, bytes...]
+static constexpr uint8_t CMD_PROGRAM_COMMIT = 0x12; // [xor of all program bytes]
+static constexpr uint8_t CMD_PROGRAM_BASE = 0x20;   // play slot n with 0x20 + n
+static constexpr uint8_t PROGRAM_SLOTS = 4;
+static constexpr uint16_t PROGRAM_MAX_BYTES = 256;
+static constexpr uint8_t PROGRAM_CHUNK_BYTES = 30; // RP2040 reads 32 bytes after the cmd
 
 } // namespace config
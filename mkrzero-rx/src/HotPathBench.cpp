@@ -0,0 +1,140 @@
+#include "HotPathBench.h"
+#include "CommPacket.h"
+#include "Config.h"
+#include "RS485Receiver.h"
+#include "ToyCarSystem.h"
+#include <Arduino.h>
+
+namespace {
+constexpr uint16_t XOR_ITERS = 10000;
+constexpr uint8_t PARSE_PACKETS = 250; // 2000 bytes
+constexpr uint16_t NOISE_BYTES = 2000;
+constexpr uint8_t WALL_BATTERIES = 3; // 6V, 12V, 16V
+
+volatile uint32_t sink; // keeps results alive so the loops aren't optimized out
+uint32_t packetsSeen = 0;
+
+void countPacket(const WallStatusPacket &, void *) { packetsSeen++; }
+
+void printResult(const char *name, uint32_t iters, uint32_t totalUs) {
+  Serial.print("bench board=mkrzero name=");
+  Serial.print(name);
+  Serial.print(" iters=");
+  Serial.print(iters);
+  Serial.print(" total_us=");
+  Serial.print(totalUs);
+  Serial.print(" ns_per_op=");
+  Serial.print(iters ? (totalUs * 1000UL) / iters : 0);
+}
+
+WallStatusPacket makePacket(uint8_t i) {
+  WallStatusPacket pkt = {config::PACKET_START1, config::PACKET_START2,
+                          uint8_t(i % WALL_BATTERIES),
+                          uint8_t(i & 1), uint8_t((i >> 1) & 1),
+                          uint8_t((i >> 2) & 1), uint8_t((i >> 3) & 1), 0};
+  pkt.CHK = xorChecksum(pkt);
+  return pkt;
+}
+
+void benchXorChecksum() {
+  WallStatusPacket pkt = makePacket(0);
+  uint32_t acc = 0;
+  unsigned long startUs = micros();
+  for (uint16_t i = 0; i < XOR_ITERS; i++) {
+    pkt.BAT_ID = i;
+    acc += xorChecksum(pkt);
+  }
+  uint32_t totalUs = micros() - startUs;
+  sink = acc;
+  printResult("xor_checksum", XOR_ITERS, totalUs);
+  Serial.println();
+}
+
+// parse cost per byte, against the byte period of the RS-485 line
+void benchParse(const char *name, const uint8_t *bytes, uint16_t count,
+                uint32_t expectedPackets) {
+  RS485Receiver rx(Serial1);
+  rx.setPacketHandler(countPacket, nullptr);
+  packetsSeen = 0;
+
+  unsigned long startUs = micros();
+  rx.feed(bytes, count);
+  uint32_t totalUs = micros() - startUs;
+
+  // 10 bits per byte on the wire (8N1)
+  const uint32_t byteSlotUs = 10000000UL / config::RS485_BAUD_RATE;
+  printResult(name, count, totalUs);
+  Serial.print(" packets=");
+  Serial.print(packetsSeen);
+  Serial.print(" expected=");
+  Serial.print(expectedPackets);
+  Serial.print(" resyncs=");
+  Serial.print(rx.getStats().resyncs);
+  Serial.print(" line_budget_pct=");
+  Serial.println(count ? (100.0f * totalUs) / (count * byteSlotUs) : 0.0f, 3);
+}
+
+// every wall battery state against every toy car terminal state
+void benchEvaluateReaction() {
+  uint32_t evaluations = 0;
+  uint32_t acc = 0;
+  unsigned long startUs = micros();
+  for (uint8_t id = 0; id < WALL_BATTERIES; id++) {
+    for (uint8_t w = 0; w < 16; w++) {
+      BatteryState wall = {id, bool(w & 1), bool(w & 2), bool(w & 4),
+                           bool(w & 8)};
+      for (uint8_t c = 0; c < 64; c++) {
+        TerminalState car = {bool(c & 1),  bool(c & 2),  bool(c & 4),
+                             bool(c & 8),  bool(c & 16), bool(c & 32)};
+        Reaction r = evaluateReaction(wall, car);
+        acc += uint8_t(r.mode) + r.audioCue;
+        evaluations++;
+      }
+    }
+  }
+  uint32_t totalUs = micros() - startUs;
+  sink = acc;
+  printResult("evaluate_reaction", evaluations, totalUs);
+  Serial.println();
+}
+} // namespace
+
+void runHotPathBench() {
+  Serial.print("bench board=mkrzero begin cpu_hz=");
+  Serial.println(F_CPU);
+
+  benchXorChecksum();
+
+  static uint8_t stream[PARSE_PACKETS * sizeof(WallStatusPacket)];
+  for (uint8_t i = 0; i < PARSE_PACKETS; i++) {
+    WallStatusPacket pkt = makePacket(i);
+    memcpy(stream + i * sizeof(pkt), &pkt, sizeof(pkt));
+  }
+  benchParse("rs485_parse_clean", stream, sizeof(stream), PARSE_PACKETS);
+
+  // every 4th frame cut short after 5 bytes: each one should only cost
+  // itself, the frame after it has to come through
+  static uint8_t cut[sizeof(stream)];
+  uint16_t cutLength = 0;
+  uint32_t whole = 0;
+  for (uint8_t i = 0; i < PARSE_PACKETS; i++) {
+    uint8_t keep = (i % 4 == 3) ? 5 : sizeof(WallStatusPacket);
+    memcpy(cut + cutLength, stream + i * sizeof(WallStatusPacket), keep);
+    cutLength += keep;
+    if (keep == sizeof(WallStatusPacket))
+      whole++;
+  }
+  benchParse("rs485_parse_truncated", cut, cutLength, whole);
+
+  // line noise: pseudo-random bytes, with the odd start byte in there
+  static uint8_t noise[NOISE_BYTES];
+  uint16_t lfsr = 0xACE1;
+  for (uint16_t i = 0; i < NOISE_BYTES; i++) {
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1) & 0xB400);
+    noise[i] = lfsr;
+  }
+  benchParse("rs485_parse_noise", noise, NOISE_BYTES, 0);
+
+  benchEvaluateReaction();
+  Serial.println("bench board=mkrzero end");
+}
@@ -0,0 +1,15 @@
+#pragma once
+/**
+ * HotPathBench.h
+ *
+ * On-device timing of the code that runs on every byte / every state change,
+ * enabled with HOT_PATH_BENCH_ON_BOOT in Config.h. Runs once before the
+ * system starts and prints one line per case over USB serial:
+ *
+ *   bench board=mkrzero name=<case> iters=<n> total_us=<t> ns_per_op=<x>
+ *
+ * plus a few case-specific keys. The format is stable so two runs (before /
+ * after a change) can be diffed or parsed by a script.
+ */
+
+void runHotPathBench();
@@ -0,0 +1,45 @@
+#include "I2CBus.h"
+#include "Debug.h"
+#include "MuxController.h"
+#include <Wire.h>
+
+bool I2CBus::begin() {
+  DEBUG_PRINT("Testing mux communication - ");
+  // the mux may have been power cycled since the cache last saw it
+  MuxController::invalidate(muxAddr);
+  Wire.beginTransmission(muxAddr);
+  byte result = Wire.endTransmission();
+  if (result != 0) {
+    DEBUG_PRINTLN("FAILED");
+    return false;
+  }
+
+  DEBUG_PRINTLN("SUCCESS");
+  release();
+  return true;
+}
+
+void I2CBus::selectReader(uint8_t channel) {
+  MuxController::selectChannel(muxAddr, channel);
+}
+
+void I2CBus::acquireForLed() {
+  // the RP2040 sits on the main bus, just make sure no reader is attached
+  // (free when the mux is already off, MuxController caches its state)
+  MuxController::disableChannel(muxAddr);
+}
+
+void I2CBus::release() {
+  MuxController::disableChannel(muxAddr);
+}
+
+void I2CBus::printStats() const {
+  const MuxStats &stats = MuxController::getStats();
+  (void)stats; // only read by DEBUG_PRINT
+  DEBUG_PRINT("I2CBus: mux writes=");
+  DEBUG_PRINT(stats.writes);
+  DEBUG_PRINT(" skipped=");
+  DEBUG_PRINT(stats.skippedWrites);
+  DEBUG_PRINT(" settle ms saved=");
+  DEBUG_PRINTLN(stats.settleMsSaved);
+}
@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * I2CBus.h
+ *
+ * Arbiter for the MKR Zero's single I2C bus. The mux, the three RFID readers
+ * (all at 0x28 behind the mux) and the RP2040 LED driver share it, so:
+ *   - this is the only place that touches the TCA9548A, nobody else calls
+ *     MuxController directly
+ *   - whoever uses the bus claims it first (selectReader() / acquireForLed())
+ *     and the arbiter puts the mux into the right state for that use
+ *   - everything runs from the one loop, so there is no owner to check: LED
+ *     traffic just has to go out after the RFID pass has release()d the bus,
+ *     and acquireForLed() makes sure no reader channel is still open
+ */
+
+#include <Arduino.h>
+
+class I2CBus {
+public:
+  explicit I2CBus(uint8_t muxAddr) : muxAddr(muxAddr) {}
+
+  bool begin(); // probe the mux and leave every channel off
+
+  void selectReader(uint8_t channel); // claim for RFID, route mux to channel
+  void acquireForLed();               // claim for LED, mux channels off
+  void release();                     // mux channels off, bus free
+
+  void printStats() const; // mux writes issued vs skipped by the cache
+
+private:
+  uint8_t muxAddr;
+};
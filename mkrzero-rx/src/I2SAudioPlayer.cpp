@@ -0,0 +1,274 @@
+#include "Config.h"
+
+// only build (and pull in the SD/I2S libraries) when this backend is selected
+#if AUDIO_BACKEND == AUDIO_BACKEND_I2S
+#include "Debug.h"
+#include "I2SAudioPlayer.h"
+#include "PcmMixer.h"
+#include <I2S.h>
+
+I2SAudioPlayer *I2SAudioPlayer::instance = nullptr;
+
+I2SAudioPlayer::I2SAudioPlayer() {
+  for (uint8_t v = 0; v < config::AUDIO_NUM_VOICES; v++) {
+    voices[v].active = false;
+    gains[v] = percentToGainQ15(config::AUDIO_VOLUME_PERCENT);
+  }
+}
+
+bool I2SAudioPlayer::begin() {
+  if (!SD.begin(SDCARD_SS_PIN)) {
+    DEBUG_PRINTLN("AudioPlayer: SD card init failed");
+    return false;
+  }
+
+  bool allOK = loadClip(clips[0], config::SPUTTER_AUDIO_FILE);
+  allOK &= loadClip(clips[1], config::ENGINE_START_AUDIO_FILE);
+  allOK &= loadClip(clips[2], config::ZAP_AUDIO_FILE);
+  allOK &= loadClip(clips[3], config::WRONG_CHOICE_AUDIO_FILE);
+
+  if (!I2S.begin(I2S_PHILIPS_MODE, config::AUDIO_SAMPLE_RATE,
+                 config::AUDIO_BITS_PER_SAMPLE)) {
+    DEBUG_PRINTLN("AudioPlayer: I2S init failed");
+    return false;
+  }
+
+  instance = this;
+  I2S.onTransmit(onTransmitStatic);
+
+  // prime both DMA halves with silence, from here on the callback keeps them
+  // fed on its own
+  noInterrupts();
+  fillOutput();
+  interrupts();
+
+  DEBUG_PRINTLN("AudioPlayer: initialized (SD + I2S)");
+  return allOK;
+}
+
+void I2SAudioPlayer::play(uint8_t triggerPin) {
+  uint8_t clipIndex;
+  uint8_t priority = config::AUDIO_PRIORITY_SUCCESS;
+
+  DEBUG_PRINT("AudioPlayer: playing ");
+  switch (triggerPin) {
+  case (config::SPUTTER_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("6V sputter audio");
+    clipIndex = 0;
+    break;
+  case (config::ENGINE_START_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("12V engine start audio");
+    clipIndex = 1;
+    break;
+  case (config::ZAP_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("16V zap audio");
+    clipIndex = 2;
+    break;
+  case (config::WRONG_CHOICE_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("Wrong choice audio");
+    clipIndex = 3;
+    priority = config::AUDIO_PRIORITY_WRONG_CHOICE;
+    break;
+  default:
+    return;
+  }
+
+  if (!clips[clipIndex].ok) {
+    DEBUG_PRINTLN("AudioPlayer: clip not loaded, skipping");
+    return;
+  }
+
+  // free voice first, otherwise steal the lowest priority (oldest on ties)
+  Voice *target = nullptr;
+  for (uint8_t v = 0; v < config::AUDIO_NUM_VOICES; v++) {
+    Voice &candidate = voices[v];
+    if (!candidate.active) {
+      target = &candidate;
+      break;
+    }
+    if (candidate.priority > priority)
+      continue;
+    if (!target || candidate.priority < target->priority ||
+        (candidate.priority == target->priority &&
+         candidate.startMillis < target->startMillis)) {
+      target = &candidate;
+    }
+  }
+
+  if (!target) {
+    DEBUG_PRINTLN("AudioPlayer: all voices busy with higher priority");
+    stats.dropped++;
+    return;
+  }
+
+  startVoice(*target, clipIndex, priority);
+}
+
+void I2SAudioPlayer::update() {
+  for (uint8_t v = 0; v < config::AUDIO_NUM_VOICES; v++) {
+    if (voices[v].active && !voices[v].endOfFile) {
+      refillVoice(voices[v]);
+    }
+  }
+
+  // safety net: if the DMA ever ran dry (callback missed) this restarts it
+  noInterrupts();
+  fillOutput();
+  interrupts();
+}
+
+void I2SAudioPlayer::printStats() const {
+  DEBUG_PRINT("AudioPlayer: blocks=");
+  DEBUG_PRINT(stats.blocksMixed);
+  DEBUG_PRINT(" underruns=");
+  DEBUG_PRINT(stats.underruns);
+  DEBUG_PRINT(" dropped=");
+  DEBUG_PRINT(stats.dropped);
+  DEBUG_PRINT(" start latency us last/max=");
+  DEBUG_PRINT(stats.lastStartLatencyUs);
+  DEBUG_PRINT("/");
+  DEBUG_PRINTLN(stats.maxStartLatencyUs);
+}
+
+// ========== CLIP / VOICE HELPERS ==========
+bool I2SAudioPlayer::loadClip(Clip &clip, const char *path) {
+  clip.ok = false;
+  clip.file = SD.open(path, FILE_READ);
+  if (!clip.file) {
+    DEBUG_PRINT("AudioPlayer: missing ");
+    DEBUG_PRINTLN(path);
+    return false;
+  }
+
+  uint8_t header[WAV_HEADER_SCAN_BYTES];
+  int n = clip.file.read(header, sizeof(header));
+  if (n <= 0 || !parseWavHeader(header, n, clip.info) ||
+      clip.info.sampleRate != config::AUDIO_SAMPLE_RATE) {
+    DEBUG_PRINT("AudioPlayer: unsupported format ");
+    DEBUG_PRINTLN(path);
+    return false;
+  }
+
+  // cache the start of the clip so play() doesn't have to touch the SD card
+  clip.file.seek(clip.info.dataOffset);
+  clip.primedBlocks = 0;
+  uint32_t left = clip.info.dataLength;
+  while (clip.primedBlocks < PRIME_BLOCKS && left > 0) {
+    int16_t *block = clip.primed[clip.primedBlocks];
+    uint16_t bytes = (left < BLOCK_BYTES) ? left : BLOCK_BYTES;
+    clip.file.read(block, bytes);
+    memset(reinterpret_cast<uint8_t *>(block) + bytes, 0, BLOCK_BYTES - bytes);
+    left -= bytes;
+    clip.primedBlocks++;
+  }
+
+  clip.ok = true;
+  return true;
+}
+
+void I2SAudioPlayer::startVoice(Voice &voice, uint8_t clipIndex,
+                                uint8_t priority) {
+  const Clip &clip = clips[clipIndex];
+
+  // take the voice away from the callback while it's rebuilt
+  noInterrupts();
+  voice.active = false;
+  interrupts();
+
+  for (uint8_t b = 0; b < clip.primedBlocks; b++) {
+    memcpy(voice.blocks[b], clip.primed[b], BLOCK_BYTES);
+  }
+
+  uint32_t primedBytes = uint32_t(clip.primedBlocks) * BLOCK_BYTES;
+  voice.readCount = 0;
+  voice.writeCount = clip.primedBlocks;
+  voice.clip = clipIndex;
+  voice.priority = priority;
+  voice.filePos = clip.info.dataOffset + primedBytes;
+  voice.bytesLeft = (clip.info.dataLength > primedBytes)
+                        ? clip.info.dataLength - primedBytes
+                        : 0;
+  voice.endOfFile = (voice.bytesLeft == 0);
+  voice.started = false;
+  voice.requestMicros = micros();
+  voice.startMillis = millis();
+
+  noInterrupts();
+  voice.active = true;
+  interrupts();
+}
+
+void I2SAudioPlayer::refillVoice(Voice &voice) {
+  Clip &clip = clips[voice.clip];
+
+  while (uint8_t(voice.writeCount - voice.readCount) <
+             config::AUDIO_VOICE_BLOCKS &&
+         voice.bytesLeft > 0) {
+    int16_t *block =
+        voice.blocks[voice.writeCount % config::AUDIO_VOICE_BLOCKS];
+    uint16_t bytes =
+        (voice.bytesLeft < BLOCK_BYTES) ? voice.bytesLeft : BLOCK_BYTES;
+
+    // two voices can share a clip file, so always seek to our own position
+    if (clip.file.position() != voice.filePos) {
+      clip.file.seek(voice.filePos);
+    }
+    clip.file.read(block, bytes);
+    memset(reinterpret_cast<uint8_t *>(block) + bytes, 0, BLOCK_BYTES - bytes);
+
+    voice.filePos += bytes;
+    voice.bytesLeft -= bytes;
+    voice.writeCount++; // publish the block only once it's fully written
+  }
+
+  voice.endOfFile = (voice.bytesLeft == 0);
+}
+
+/*
+ * @brief Mixes one block per free I2S half and hands it to the DMA driver.
+ * Runs in the I2S DMA interrupt (or with interrupts off from the main loop).
+ */
+void I2SAudioPlayer::fillOutput() {
+  while (I2S.availableForWrite() >= int(sizeof(outBlock))) {
+    const int16_t *blocks[config::AUDIO_NUM_VOICES];
+
+    for (uint8_t v = 0; v < config::AUDIO_NUM_VOICES; v++) {
+      Voice &voice = voices[v];
+      blocks[v] = nullptr;
+      if (!voice.active)
+        continue;
+
+      if (voice.writeCount != voice.readCount) {
+        blocks[v] = voice.blocks[voice.readCount % config::AUDIO_VOICE_BLOCKS];
+        if (!voice.started) {
+          voice.started = true;
+          stats.lastStartLatencyUs = micros() - voice.requestMicros;
+          if (stats.lastStartLatencyUs > stats.maxStartLatencyUs)
+            stats.maxStartLatencyUs = stats.lastStartLatencyUs;
+        }
+      } else if (voice.endOfFile) {
+        voice.active = false; // clip finished
+      } else {
+        stats.underruns++; // SD fell behind, this voice is silent for a block
+      }
+    }
+
+    mixPcmBlock(outBlock, config::AUDIO_BLOCK_FRAMES, blocks, gains,
+                config::AUDIO_NUM_VOICES);
+    I2S.write(outBlock, sizeof(outBlock));
+    stats.blocksMixed++;
+
+    // only release ring slots after they've been mixed
+    for (uint8_t v = 0; v < config::AUDIO_NUM_VOICES; v++) {
+      if (blocks[v])
+        voices[v].readCount++;
+    }
+  }
+}
+
+void I2SAudioPlayer::onTransmitStatic() {
+  if (instance)
+    instance->fillOutput();
+}
+
+#endif // AUDIO_BACKEND == AUDIO_BACKEND_I2S
@@ -0,0 +1,95 @@
+#pragma once
+/**
+ * I2SAudioPlayer.h
+ *
+ * Alternative AudioPlayer backend that streams WAV clips from the MKR Zero's
+ * SD card straight to an I2S amplifier. Selected with AUDIO_BACKEND in
+ * Config.h.
+ *
+ * Why this doesn't stall like the old I2S path did:
+ *   - the SAMD I2S library clocks samples out of a DMA ping-pong buffer pair,
+ *     and calls us back (DMA interrupt) every time one half frees up. Mixing
+ *     happens in that callback, so output never waits on the main loop
+ *   - the main loop only tops up a per-voice read-ahead ring from SD in
+ *     update(). ToyCarSystem::update calls it between reader probes, and the
+ *     ring (AUDIO_VOICE_BLOCKS) is deep enough to ride out one probe, whose
+ *     PCD_Init() soft reset blocks for 50ms or more
+ *   - the first few blocks of every clip are cached in RAM at begin(), so
+ *     play() just points a voice at them, the next DMA half already has it
+ *
+ * Mixing is fixed-point (see PcmMixer.h), up to AUDIO_NUM_VOICES at once.
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+
+#include "Config.h"
+#include "WavFormat.h"
+
+struct I2SAudioStats {
+  uint32_t blocksMixed;
+  uint32_t underruns; // a voice had no SD data ready when its block was due
+  uint32_t dropped;   // play() refused, every voice busy with higher priority
+  uint32_t lastStartLatencyUs; // play() -> first block handed to I2S DMA
+  uint32_t maxStartLatencyUs;
+};
+
+// ring counters are free running uint8_t, so the depth has to divide 256
+static_assert(256 % config::AUDIO_VOICE_BLOCKS == 0,
+              "AUDIO_VOICE_BLOCKS must be a power of two <= 128");
+
+class I2SAudioPlayer {
+public:
+  I2SAudioPlayer();
+  bool begin(); // mount SD, cache clip headers, start I2S
+  void play(uint8_t triggerPin);
+  void update(); // refill voices from SD, call often
+
+  const I2SAudioStats &getStats() const { return stats; }
+  void printStats() const;
+
+private:
+  static constexpr uint8_t NUM_CLIPS = 4;
+  static constexpr uint8_t PRIME_BLOCKS = 4;
+  static constexpr uint16_t BLOCK_BYTES =
+      config::AUDIO_BLOCK_FRAMES * sizeof(int16_t);
+
+  struct Clip {
+    File file;
+    WavInfo info;
+    bool ok;
+    uint8_t primedBlocks;
+    int16_t primed[PRIME_BLOCKS][config::AUDIO_BLOCK_FRAMES];
+  };
+
+  // ring written by update() (producer), read by the DMA callback (consumer)
+  struct Voice {
+    int16_t blocks[config::AUDIO_VOICE_BLOCKS][config::AUDIO_BLOCK_FRAMES];
+    volatile uint8_t readCount;  // free running, only the callback advances
+    volatile uint8_t writeCount; // free running, only update() advances
+    volatile bool active;
+    volatile bool started;
+    volatile bool endOfFile;
+    uint8_t clip;
+    uint8_t priority;
+    uint32_t filePos;
+    uint32_t bytesLeft;
+    unsigned long requestMicros;
+    unsigned long startMillis;
+  };
+
+  Clip clips[NUM_CLIPS];
+  Voice voices[config::AUDIO_NUM_VOICES];
+  uint16_t gains[config::AUDIO_NUM_VOICES];
+  int16_t outBlock[config::AUDIO_BLOCK_FRAMES * 2]; // interleaved stereo
+  I2SAudioStats stats{};
+
+  bool loadClip(Clip &clip, const char *path);
+  void startVoice(Voice &voice, uint8_t clipIndex, uint8_t priority);
+  void refillVoice(Voice &voice);
+  void fillOutput();
+
+  // I2S callback glue (same bridge idea as ToyCarSystem::packetHandlerStatic)
+  static I2SAudioPlayer *instance;
+  static void onTransmitStatic();
+};
@@ -1,9 +1,110 @@
 #include "LEDCommander.h"
 #include "Debug.h"
+#include "Marker.h"
 #include <Arduino.h>
-#include <FastLED.h>
 
-void LEDCommander::init() { sendCommand(config::CMD_DEFAULT_ANIMATION); }
+void LEDCommander::init(I2CBus &bus) {
+  queueCommand(config::CMD_DEFAULT_ANIMATION);
+  update(bus);
+}
+
+bool LEDCommander::queueCommand(uint8_t cmd) {
+  PendingCommand c{};
+  c.cmd = cmd;
+  c.hasStartTime = false;
+  return push(c);
+}
+
+bool LEDCommander::queueCommand(uint8_t cmd, unsigned long startAtUs) {
+  PendingCommand c{};
+  c.cmd = cmd;
+  c.hasStartTime = true;
+  c.startAtUs = startAtUs;
+  return push(c);
+}
+
+void LEDCommander::update(I2CBus &bus) {
+  if (count == 0)
+    return;
+
+  PendingCommand &c = queue[head];
+  unsigned long nowMs = millis();
+  if (c.attempts > 0 && long(nowMs - c.nextAttemptMs) < 0)
+    return; // still backing off
+
+  bus.acquireForLed();
+
+  // the last write went out but its ack got lost: if the RP2040 took the
+  // command its sequence has moved, and re-sending would restart the
+  // animation a second time
+  if (c.ackMissing) {
+    c.ackMissing = false;
+    if (readAck(c.cmd) == ACK_OK) {
+      bus.release();
+      delivered(c, micros());
+      return;
+    }
+  }
+
+  uint8_t params[1];
+  uint8_t paramCount = 0;
+  if (c.hasStartTime) {
+    // "start in N ms" relative to this write landing on the RP2040
+    long remainingUs = long(c.startAtUs - micros());
+    unsigned long ms = (remainingUs > 0) ? (remainingUs + 500) / 1000 : 0;
+    params[paramCount++] = (ms > 255) ? 255 : ms;
+  }
+
+  c.attempts++;
+  stats.attempts++;
+  bool sent = sendCommand(c.cmd, params, paramCount);
+  c.sentUs = micros(); // the RP2040 counts the delay from here
+  c.startDelayMs = paramCount ? params[0] : 0;
+  AckResult ack = sent ? readAck(c.cmd) : ACK_MISMATCH;
+  unsigned long doneUs = micros();
+
+  bus.release();
+
+  if (ack == ACK_OK) {
+    delivered(c, doneUs);
+    return;
+  }
+  c.ackMissing = sent && ack == ACK_MISSING;
+
+  if (c.attempts >= config::LED_MAX_ATTEMPTS) {
+    DEBUG_PRINTLN("LEDCommander: giving up on command");
+    stats.dropped++;
+    pop();
+    return;
+  }
+
+  stats.retries++;
+  c.nextAttemptMs = nowMs + (config::LED_RETRY_BASE_MS << (c.attempts - 1));
+}
+
+void LEDCommander::delivered(const PendingCommand &c, unsigned long doneUs) {
+  stats.acked++;
+  stats.lastLatencyUs = doneUs - c.queuedUs;
+  if (stats.lastLatencyUs > stats.maxLatencyUs)
+    stats.maxLatencyUs = stats.lastLatencyUs;
+
+  deliveryFresh = true;
+  deliveredCmd = c.cmd;
+  deliveredTargetUs = c.sentUs + uint32_t(c.startDelayMs) * 1000UL;
+  deliveredSequence = lastSequence;
+  pop();
+}
+
+bool LEDCommander::pollDelivery(uint8_t &cmd, unsigned long &targetUs,
+                                uint8_t &sequence) {
+  if (!deliveryFresh)
+    return false;
+  deliveryFresh = false;
+  cmd = deliveredCmd;
+  targetUs = deliveredTargetUs;
+  sequence = deliveredSequence;
+  return true;
+}
 
 bool LEDCommander::sendCommand(uint8_t cmd, uint8_t *params,
                                uint8_t paramCount) {
@@ -16,7 +117,9 @@ bool LEDCommander::sendCommand(uint8_t cmd, uint8_t *params,
     Wire.write(params[i]);
   }
 
+  MARKER_HIGH(config::MARKER_LED_CMD_PIN);
   uint8_t error = Wire.endTransmission();
+  MARKER_LOW(config::MARKER_LED_CMD_PIN);
 
   DEBUG_PRINTLN("I²C result: ");
   switch (error) {
@@ -42,3 +145,215 @@ bool LEDCommander::sendCommand(uint8_t cmd, uint8_t *params,
   }
   return false;
 }
+
+void LEDCommander::printStats() const {
+  DEBUG_PRINT("LEDCommander: depth=");
+  DEBUG_PRINT(stats.queueDepth);
+  DEBUG_PRINT(" (max ");
+  DEBUG_PRINT(stats.maxQueueDepth);
+  DEBUG_PRINT(") attempts=");
+  DEBUG_PRINT(stats.attempts);
+  DEBUG_PRINT(" acked=");
+  DEBUG_PRINT(stats.acked);
+  DEBUG_PRINT(" retries=");
+  DEBUG_PRINT(stats.retries);
+  DEBUG_PRINT(" dropped=");
+  DEBUG_PRINT(stats.dropped);
+  DEBUG_PRINT(" latency us last/max=");
+  DEBUG_PRINT(stats.lastLatencyUs);
+  DEBUG_PRINT("/");
+  DEBUG_PRINTLN(stats.maxLatencyUs);
+}
+
+/*
+ * @brief Reads the RP2040 status block (register pointer + one read)
+ *
+ * @return false if the RP2040 didn't answer
+ */
+bool LEDCommander::readStatus(I2CBus &bus, LEDStatus &status) {
+  bus.acquireForLed();
+  Wire.beginTransmission(config::LED_CONTROLLER_ADDR);
+  Wire.write(config::LED_REG_STATUS);
+  bool ok = Wire.endTransmission(false) == 0 &&
+            Wire.requestFrom(config::LED_CONTROLLER_ADDR,
+                             config::LED_STATUS_BYTES) ==
+                config::LED_STATUS_BYTES;
+
+  uint8_t raw[config::LED_STATUS_BYTES];
+  for (uint8_t i = 0; ok && i < config::LED_STATUS_BYTES; i++) {
+    raw[i] = Wire.read();
+  }
+  bus.release();
+
+  if (!ok) {
+    DEBUG_PRINTLN("LEDCommander: status read failed");
+    return false;
+  }
+
+  status.flags = raw[0];
+  status.queueDepth = raw[1];
+  status.queueDropped = raw[2];
+  status.animation = raw[3];
+  status.frames = raw[4] | (raw[5] << 8);
+  status.maxFrameUs = raw[6] | (raw[7] << 8);
+  status.droppedFrames = raw[8] | (raw[9] << 8);
+  status.idlePercent = raw[10];
+  status.fwMajor = raw[11];
+  status.fwMinor = raw[12];
+  status.maxCurrentMa = raw[13] * 10;
+  return true;
+}
+
+/*
+ * @brief Reads the RP2040's start report (LED_REG_START_SEQ onwards)
+ *
+ * @return false if the RP2040 didn't answer
+ */
+bool LEDCommander::readStartReport(I2CBus &bus, uint8_t &sequence,
+                                   uint16_t &startErrorUs) {
+  bus.acquireForLed();
+  Wire.beginTransmission(config::LED_CONTROLLER_ADDR);
+  Wire.write(config::LED_REG_START_SEQ);
+  bool ok = Wire.endTransmission(false) == 0 &&
+            Wire.requestFrom(config::LED_CONTROLLER_ADDR,
+                             config::LED_START_REPORT_BYTES) ==
+                config::LED_START_REPORT_BYTES;
+
+  uint8_t raw[config::LED_START_REPORT_BYTES];
+  for (uint8_t i = 0; ok && i < config::LED_START_REPORT_BYTES; i++) {
+    raw[i] = Wire.read();
+  }
+  bus.release();
+
+  if (!ok) {
+    DEBUG_PRINTLN("LEDCommander: start report read failed");
+    return false;
+  }
+
+  sequence = raw[0];
+  startErrorUs = raw[1] | (raw[2] << 8);
+  return true;
+}
+
+/*
+ * @brief Uploads an AnimationVM program into one of the RP2040's slots
+ *
+ * The RP2040 doesn't ack a chunk it rejects and forgets the half finished
+ * upload, so any failure starts over from BEGIN, up to LED_MAX_ATTEMPTS
+ * times with the usual backoff. Blocks (~3ms per chunk at 100kHz).
+ *
+ * @return false if the program doesn't fit or the RP2040 never took it
+ */
+bool LEDCommander::uploadProgram(I2CBus &bus, uint8_t slot,
+                                 const uint8_t *code, uint16_t len) {
+  if (slot >= config::PROGRAM_SLOTS || len == 0 ||
+      len > config::PROGRAM_MAX_BYTES) {
+    return false;
+  }
+
+  uint8_t checksum = 0;
+  for (uint16_t i = 0; i < len; i++) {
+    checksum ^= code[i];
+  }
+
+  for (uint8_t attempt = 1; attempt <= config::LED_MAX_ATTEMPTS; attempt++) {
+    bus.acquireForLed();
+    bool ok = sendProgram(slot, code, len, checksum);
+    bus.release();
+    if (ok)
+      return true;
+    delay(config::LED_RETRY_BASE_MS << (attempt - 1));
+  }
+
+  DEBUG_PRINTLN("LEDCommander: program upload failed");
+  return false;
+}
+
+// one pass BEGIN -> DATA... -> COMMIT, false at the first write not acked
+bool LEDCommander::sendProgram(uint8_t slot, const uint8_t *code,
+                               uint16_t len, uint8_t checksum) {
+  uint8_t params[2 + config::PROGRAM_CHUNK_BYTES];
+  params[0] = slot;
+  params[1] = len & 0xFF;
+  params[2] = len >> 8;
+  if (!sendCommand(config::CMD_PROGRAM_BEGIN, params, 3) ||
+      readAck(config::CMD_PROGRAM_BEGIN) != ACK_OK) {
+    return false;
+  }
+
+  for (uint16_t offset = 0; offset < len;
+       offset += config::PROGRAM_CHUNK_BYTES) {
+    uint16_t left = len - offset;
+    uint8_t n = (left < config::PROGRAM_CHUNK_BYTES) ? left
+                                                     : config::PROGRAM_CHUNK_BYTES;
+    params[0] = offset & 0xFF;
+    params[1] = offset >> 8;
+    memcpy(params + 2, code + offset, n);
+    if (!sendCommand(config::CMD_PROGRAM_DATA, params, 2 + n) ||
+        readAck(config::CMD_PROGRAM_DATA) != ACK_OK) {
+      return false;
+    }
+  }
+
+  params[0] = checksum;
+  return sendCommand(config::CMD_PROGRAM_COMMIT, params, 1) &&
+         readAck(config::CMD_PROGRAM_COMMIT) == ACK_OK;
+}
+
+// ========== QUEUE HELPERS ==========
+bool LEDCommander::push(const PendingCommand &c) {
+  if (count >= config::LED_QUEUE_LEN) {
+    // newest command wins, the oldest one is stale by now anyway
+    DEBUG_PRINTLN("LEDCommander: queue full, dropping oldest");
+    stats.dropped++;
+    pop();
+  }
+
+  PendingCommand &slot = queue[(head + count) % config::LED_QUEUE_LEN];
+  slot = c;
+  slot.queuedUs = micros();
+  slot.attempts = 0;
+  slot.nextAttemptMs = 0;
+  slot.ackMissing = false;
+  count++;
+
+  stats.queueDepth = count;
+  if (count > stats.maxQueueDepth)
+    stats.maxQueueDepth = count;
+  return true;
+}
+
+void LEDCommander::pop() {
+  head = (head + 1) % config::LED_QUEUE_LEN;
+  count--;
+  stats.queueDepth = count;
+}
+
+/*
+ * @brief Reads [last accepted cmd, sequence #] back from the RP2040
+ *
+ * @return ACK_OK if the RP2040 reports our command as the newest one it
+ * took, ACK_MISSING if it didn't answer (the write may still have landed)
+ */
+LEDCommander::AckResult LEDCommander::readAck(uint8_t cmd) {
+  uint8_t n = Wire.requestFrom(config::LED_CONTROLLER_ADDR,
+                               config::LED_ACK_BYTES);
+  if (n < config::LED_ACK_BYTES) {
+    DEBUG_PRINTLN("LEDCommander: no ack from RP2040");
+    return ACK_MISSING;
+  }
+
+  uint8_t ackCmd = Wire.read();
+  uint8_t sequence = Wire.read();
+
+  // sequence must have moved, otherwise the write never made it
+  bool fresh = !haveSequence || sequence != lastSequence;
+  haveSequence = true;
+  lastSequence = sequence;
+
+  if (ackCmd != cmd || !fresh) {
+    DEBUG_PRINTLN("LEDCommander: ack mismatch");
+    return ACK_MISMATCH;
+  }
+  return ACK_OK;
+}
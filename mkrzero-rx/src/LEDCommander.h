@@ -1,15 +1,120 @@
 #ifndef LED_CONTROLLER_H
 #define LED_CONTROLLER_H
 
+/**
+ * LEDCommander.h
+ *
+ * Sends animation commands to the RP2040 LED driver.
+ *
+ * - commands go into a small bounded queue, update() sends the head and is
+ *   called after the RFID pass has released the bus (see I2CBus)
+ * - after every write the RP2040 is read back ([last cmd, sequence #]), a
+ *   command only counts as delivered once that ack matches. if the write
+ *   went through but the ack read came back short, the ack is read again
+ *   before the retry, a command the RP2040 already took is not re-sent
+ * - NACKs / bad acks are retried with exponential backoff
+ *   (LED_RETRY_BASE_MS * 2^n) up to LED_MAX_ATTEMPTS, then dropped
+ * - commands can carry a start time (reaction timeline), the "start in N ms"
+ *   param is worked out at the moment of each attempt
+ * - readStatus() pulls the RP2040's status registers (queue, animation,
+ *   frame stats, firmware version, strip current) in one read
+ * - uploadProgram() puts an AnimationVM program into one of the RP2040's
+ *   slots (BEGIN, DATA chunks, COMMIT, each acked), blocking, for setup
+ * - readStartReport() asks when the last started animation showed its first
+ *   frame, relative to the start time it was given (ReactionTimeline skew)
+ */
+
 #include "Config.h"
+#include "I2CBus.h"
 #include <Arduino.h>
 #include <Wire.h>
 
+// mirror of the RP2040 status registers (LED_REG_STATUS onwards)
+struct LEDStatus {
+  uint8_t flags; // RP2040 LED_STATUS_* bits
+  uint8_t queueDepth;
+  uint8_t queueDropped;
+  uint8_t animation;
+  uint16_t frames; // last RP2040 stats window
+  uint16_t maxFrameUs;
+  uint16_t droppedFrames;
+  uint8_t idlePercent;
+  uint8_t fwMajor;
+  uint8_t fwMinor;
+  uint16_t maxCurrentMa; // RP2040's strip current estimate, 10mA steps
+};
+
+struct LEDCommandStats {
+  uint8_t queueDepth;
+  uint8_t maxQueueDepth;
+  uint32_t attempts;
+  uint32_t acked;
+  uint32_t retries;
+  uint32_t dropped; // gave up after LED_MAX_ATTEMPTS or queue overflow
+  uint32_t lastLatencyUs; // queued -> acked
+  uint32_t maxLatencyUs;
+};
+
 class LEDCommander {
 public:
-  void init();
+  void init(I2CBus &bus);
+  bool queueCommand(uint8_t cmd);
+  bool queueCommand(uint8_t cmd, unsigned long startAtUs);
+  void update(I2CBus &bus); // call often, sends at most one attempt per call
+
+  // true once per acked command, with the start time the RP2040 was given
+  // and the sequence # it acked the command with
+  bool pollDelivery(uint8_t &cmd, unsigned long &targetUs, uint8_t &sequence);
+
+  bool readStatus(I2CBus &bus, LEDStatus &status);
+  // [sequence # of the last started command, its first frame - target in us]
+  bool readStartReport(I2CBus &bus, uint8_t &sequence, uint16_t &startErrorUs);
+
+  bool uploadProgram(I2CBus &bus, uint8_t slot, const uint8_t *code,
+                     uint16_t len);
+
   bool sendCommand(uint8_t cmd, uint8_t *params = nullptr,
                    uint8_t paramCount = 0);
+
+  const LEDCommandStats &getStats() const { return stats; }
+  void printStats() const;
+
+private:
+  struct PendingCommand {
+    uint8_t cmd;
+    bool hasStartTime;
+    unsigned long startAtUs;
+    unsigned long queuedUs;
+    uint8_t attempts;
+    unsigned long nextAttemptMs;
+    bool ackMissing;       // last write landed, its ack read came back short
+    unsigned long sentUs;  // that write, for the delivery's target time
+    uint8_t startDelayMs;
+  };
+  enum AckResult : uint8_t { ACK_OK, ACK_MISSING, ACK_MISMATCH };
+
+  PendingCommand queue[config::LED_QUEUE_LEN];
+  uint8_t head = 0;
+  uint8_t count = 0;
+
+  // RP2040 ack tracking
+  bool haveSequence = false;
+  uint8_t lastSequence = 0;
+
+  // last delivery, handed out once through pollDelivery()
+  bool deliveryFresh = false;
+  uint8_t deliveredCmd = 0;
+  unsigned long deliveredTargetUs = 0;
+  uint8_t deliveredSequence = 0;
+
+  LEDCommandStats stats{};
+
+  bool push(const PendingCommand &c);
+  void pop();
+  void delivered(const PendingCommand &c, unsigned long doneUs);
+  AckResult readAck(uint8_t cmd);
+  bool sendProgram(uint8_t slot, const uint8_t *code, uint16_t len,
+                   uint8_t checksum);
 };
 
 #endif
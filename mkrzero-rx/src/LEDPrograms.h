@@ -0,0 +1,39 @@
+#pragma once
+/**
+ * LEDPrograms.h
+ *
+ * AnimationVM programs uploaded to the RP2040 at startup
+ * (LEDCommander::uploadProgram), played with CMD_PROGRAM_BASE + slot. The
+ * RP2040 keeps them in RAM only, so they go out again after every reset.
+ *
+ * Generated from tools/host/animvm/examples, don't edit the bytes by hand:
+ *   tools/host/build/animvm asm green_bar.s --c PROGRAM_GREEN_BAR
+ * `animvm run` shows what a program draws and how many instructions a
+ * frame costs before it goes on the strip.
+ */
+
+#include <Arduino.h>
+
+struct LEDProgram {
+  uint8_t slot; // < config::PROGRAM_SLOTS
+  const uint8_t *code;
+  uint16_t len;
+};
+
+// green_bar.s
+static const uint8_t PROGRAM_GREEN_BAR[] = {
+    0x08, 0x00, 0x00, 0x00, 0x07, 0x60, 0x05, 0x00, 0x03, 0x00, 0xFF, 0x00,
+    0x09, 0x00, 0x80, 0x00, 0x0E, 0x0B, 0x00, 0x00, 0x46, 0x04, 0x00, 0x0A,
+    0x00, 0x00,
+};
+// rainbow_sparks.s
+static const uint8_t PROGRAM_RAINBOW_SPARKS[] = {
+    0x08, 0x00, 0x00, 0x00, 0x03, 0x00, 0xC8, 0x3C, 0x06, 0x40, 0x03, 0x00,
+    0x28, 0x09, 0x00, 0x00, 0x01, 0x08, 0x01, 0x04, 0x00, 0x0E, 0x07, 0x28,
+    0x06, 0x20, 0x01, 0x00, 0x28, 0x0D, 0x01, 0x15, 0x00, 0x0A, 0x04, 0x00,
+};
+
+static const LEDProgram LED_PROGRAMS[] = {
+    {0, PROGRAM_GREEN_BAR, sizeof(PROGRAM_GREEN_BAR)},
+    {1, PROGRAM_RAINBOW_SPARKS, sizeof(PROGRAM_RAINBOW_SPARKS)},
+};
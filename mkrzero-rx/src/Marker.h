@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * Marker.h
+ *
+ * Optional GPIO markers for latency measurements on the toy car side (same
+ * idea as the Leonardo's Marker.h). Pins are MARKER_*_PIN in Config.h:
+ *  - MARKER_PACKET_RX_PIN pulses when a valid RS-485 packet is handed off
+ *  - MARKER_AUDIO_PIN pulses when the audio cue is fired
+ *  - MARKER_LED_CMD_PIN is high during the I2C write of an LED command
+ *
+ * MARKERS_ENABLED 0 compiles them all out.
+ */
+
+#define MARKERS_ENABLED 0
+
+#if MARKERS_ENABLED
+#define MARKER_INIT(pin) pinMode(pin, OUTPUT)
+#define MARKER_HIGH(pin) digitalWrite(pin, HIGH)
+#define MARKER_LOW(pin) digitalWrite(pin, LOW)
+// a point in time, ~2us wide so the analyzer can't miss it
+#define MARKER_PULSE(pin)                                                      \
+  do {                                                                         \
+    digitalWrite(pin, HIGH);                                                   \
+    delayMicroseconds(2);                                                      \
+    digitalWrite(pin, LOW);                                                    \
+  } while (0)
+#else
+#define MARKER_INIT(pin)
+#define MARKER_HIGH(pin)
+#define MARKER_LOW(pin)
+#define MARKER_PULSE(pin)
+#endif
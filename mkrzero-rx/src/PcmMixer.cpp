@@ -0,0 +1,27 @@
+#include "PcmMixer.h"
+
+namespace {
+inline int16_t saturate16(int32_t v) {
+  if (v > INT16_MAX)
+    return INT16_MAX;
+  if (v < INT16_MIN)
+    return INT16_MIN;
+  return int16_t(v);
+}
+} // namespace
+
+void mixPcmBlock(int16_t *outStereo, uint16_t frames,
+                 const int16_t *const *voiceBlocks, const uint16_t *gainsQ15,
+                 uint8_t numVoices) {
+  for (uint16_t i = 0; i < frames; i++) {
+    int32_t acc = 0;
+    for (uint8_t v = 0; v < numVoices; v++) {
+      if (voiceBlocks[v]) {
+        acc += (int32_t(voiceBlocks[v][i]) * gainsQ15[v]) >> 15;
+      }
+    }
+    int16_t s = saturate16(acc);
+    outStereo[2 * i] = s;
+    outStereo[2 * i + 1] = s;
+  }
+}
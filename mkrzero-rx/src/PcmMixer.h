@@ -0,0 +1,27 @@
+#pragma once
+/**
+ * PcmMixer.h
+ *
+ * Fixed-point mixer for the I2S audio backend. No floats (the SAMD21 has no
+ * FPU) and no Arduino dependencies.
+ *
+ * - voices are 16-bit mono blocks, gains are Q15 (32768 = unity)
+ * - each voice is scaled into a 32-bit accumulator, then the sum is
+ *   saturated back to 16-bit
+ * - output is interleaved stereo (same sample on L and R) for I2S
+ */
+
+#include <stdint.h>
+
+static constexpr uint16_t PCM_GAIN_UNITY_Q15 = 32768;
+
+// voiceBlocks[i] may be nullptr for a silent/idle voice
+void mixPcmBlock(int16_t *outStereo, uint16_t frames,
+                 const int16_t *const *voiceBlocks, const uint16_t *gainsQ15,
+                 uint8_t numVoices);
+
+inline uint16_t percentToGainQ15(uint8_t percent) {
+  if (percent >= 100)
+    return PCM_GAIN_UNITY_Q15;
+  return uint16_t((uint32_t(percent) * PCM_GAIN_UNITY_Q15) / 100);
+}
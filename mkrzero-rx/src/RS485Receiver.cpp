@@ -1,6 +1,7 @@
 #include "RS485Receiver.h"
 #include "Config.h"
 #include "Debug.h"
+#include "Marker.h"
 
 RS485Receiver::RS485Receiver(HardwareSerial &serial, uint8_t dePin)
     : uart(serial), dePin(dePin), rxState(WAIT_START1), packetIndex(0),
@@ -47,6 +48,9 @@ void RS485Receiver::handleByte(uint8_t b) {
       buffer[1] = b;
       packetIndex = 2;
       rxState = READ_DATA;
+    } else if (b == config::PACKET_START1) {
+      // 0xAA 0xAA 0x55: the second 0xAA may be the real start, stay here
+      buffer[0] = b;
     } else {
       // bad second start byte -> resync
       rxState = WAIT_START1;
@@ -61,32 +65,58 @@ void RS485Receiver::handleByte(uint8_t b) {
       WallStatusPacket pkt;
       memcpy(&pkt, buffer, sizeof(WallStatusPacket));
 
-      // validate framing bytes just in case
-      if (pkt.START1 != config::PACKET_START1 ||
-          pkt.START2 != config::PACKET_START2) {
-        DEBUG_PRINTLN("Framing bytes mismatch after full read");
+      // validate packet again with xor checksum check
+      uint8_t expected = xorChecksum(pkt);
+      if (expected == pkt.CHK) {
+        // valid packet received here -> now call handler to "hand off" the
+        // packet
+        stats.packets++;
+        MARKER_PULSE(config::MARKER_PACKET_RX_PIN);
+        if (handler)
+          handler(pkt, handlerCtx);
+        resetState();
       } else {
-        // validate packet again with xor checksum check
-        uint8_t expected = xorChecksum(pkt);
-        if (expected == pkt.CHK) {
-          // valid packet received here -> now call handler to "hand off" the
-          // packet
-          if (handler)
-            handler(pkt, handlerCtx);
-        } else {
-          DEBUG_PRINT("Checksum invalid. expected=");
-          DEBUG_PRINT(expected);
-          DEBUG_PRINT(" got=");
-          DEBUG_PRINTLN(pkt.CHK);
-        }
+        DEBUG_PRINT("Checksum invalid. expected=");
+        DEBUG_PRINT(expected);
+        DEBUG_PRINT(" got=");
+        DEBUG_PRINTLN(pkt.CHK);
+        stats.checksumErrors++;
+        // a truncated frame swallows the start of the next one, look for it
+        resyncFrom(1);
       }
-      // always reset for next packet
-      resetState();
     }
     break;
   }
 }
 
+/*
+ * @brief Drops buffer bytes before the first 0xAA 0x55 at or after `start`
+ * (or a 0xAA in the last slot) and carries on from there, as if the bytes
+ * before it never arrived
+ */
+void RS485Receiver::resyncFrom(uint8_t start) {
+  for (uint8_t i = start; i < packetIndex; i++) {
+    if (buffer[i] != config::PACKET_START1)
+      continue;
+    bool last = (i + 1 == packetIndex);
+    if (!last && buffer[i + 1] != config::PACKET_START2)
+      continue;
+
+    packetIndex -= i;
+    memmove(buffer, buffer + i, packetIndex);
+    rxState = last ? WAIT_START2 : READ_DATA;
+    stats.resyncs++;
+    return;
+  }
+  resetState();
+}
+
+void RS485Receiver::feed(const uint8_t *bytes, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    handleByte(bytes[i]);
+  }
+}
+
 void RS485Receiver::update() {
   // timeout protection: if data stream stalled, reset state to avoid getting
   // stuck
@@ -10,6 +10,10 @@
  *   - Read bytes off a HardwareSerial instance (Serial1).
  *   - Maintain small state-machine to re-sync on framing bytes and to handle
  *     inter-byte timeouts (to recover on errors).
+ *   - On a bad frame, slide to the next 0xAA 0x55 already in the buffer
+ *     instead of dropping all 8 bytes, so a truncated frame or a 0xAA in
+ *     the payload costs only that frame: the packet that follows it is
+ *     still parsed, with no 100ms timeout in between.
  *   - Validate checksum using CommPacket::xorChecksum.
  *
  * Usage:
@@ -23,6 +27,12 @@
 #include "Config.h"
 #include <Arduino.h>
 
+struct RS485RxStats {
+  uint32_t packets;        // valid frames handed to the handler
+  uint32_t checksumErrors; // full frames that failed the checksum
+  uint32_t resyncs;        // bad frames recovered from a later start pair
+};
+
 class RS485Receiver {
 public:
   // C-style callback: handler(pkt, context)
@@ -33,6 +43,9 @@ public:
   void begin(uint32_t baud = config::RS485_BAUD_RATE);
   void setPacketHandler(PacketHandlerFn handler, void *ctx);
   void update(); // must be called often from loop()
+  // parse bytes as if they came off the UART (used by HotPathBench)
+  void feed(const uint8_t *bytes, uint16_t count);
+  const RS485RxStats &getStats() const { return stats; }
 
 private:
   enum RxState { WAIT_START1, WAIT_START2, READ_DATA };
@@ -45,7 +58,9 @@ private:
   unsigned long lastByteMillis;
   PacketHandlerFn handler;
   void *handlerCtx;
+  RS485RxStats stats{};
 
   void resetState();
   void handleByte(uint8_t b);
+  void resyncFrom(uint8_t start);
 };
@@ -0,0 +1,214 @@
+#include "ReactionTimeline.h"
+#include "Config.h"
+#include "Debug.h"
+
+void ReactionTimeline::schedule(uint8_t audioCue, uint8_t ledCmd,
+                                unsigned long inputUs) {
+  this->audioCue = audioCue;
+  this->ledCmd = ledCmd;
+  this->inputUs = inputUs;
+  audioFired = false;
+  ledQueued = false;
+  ledSent = false;
+
+  // with no sound to line up with, the animation just starts right away
+  unsigned long leadMs = 0;
+  if (audioCue != NO_AUDIO) {
+    leadMs = config::AUDIO_START_LATENCY_MS;
+    if (ledCmd != NO_LED && leadMs < config::REACTION_MIN_LED_LEAD_MS) {
+      leadMs = config::REACTION_MIN_LED_LEAD_MS;
+    }
+  }
+
+  scheduledUs = micros();
+  startUs = scheduledUs + leadMs * 1000UL;
+  // sound needs AUDIO_START_LATENCY_MS after the trigger to be heard
+  audioFireUs = startUs - ((audioCue != NO_AUDIO)
+                                ? config::AUDIO_START_LATENCY_MS * 1000UL
+                                : 0);
+}
+
+bool ReactionTimeline::audioDue() const {
+  if (audioCue == NO_AUDIO || audioFired)
+    return false;
+  return long(micros() - audioFireUs) >= 0;
+}
+
+void ReactionTimeline::markAudioFired() {
+  audioFired = true;
+  // sound onset is fixed by when the trigger actually fired
+  startUs = micros() + config::AUDIO_START_LATENCY_MS * 1000UL;
+  finishIfComplete();
+}
+
+void ReactionTimeline::markLedDelivered(uint8_t cmd, unsigned long targetUs,
+                                        uint8_t sequence) {
+  // a delivery for an older reaction (still retrying) doesn't count
+  if (cmd != ledCmd || !ledQueued || ledSent)
+    return;
+  ledSent = true;
+  ledTargetUs = targetUs;
+  ledSequence = sequence;
+  finishIfComplete();
+}
+
+bool ReactionTimeline::ledStartReportDue() const {
+  return awaitingLedStart && long(micros() - nextReportUs) >= 0;
+}
+
+/*
+ * @brief Records the skew between the RP2040's first frame and T0, and the
+ * end-to-end latency from the input change to that frame
+ *
+ * @param sequence ack sequence # the start report is for, anything but the
+ * command being measured means it has not started yet
+ */
+void ReactionTimeline::markLedStarted(uint8_t sequence,
+                                      uint16_t startErrorUs) {
+  if (!awaitingLedStart || sequence != skewSequence) {
+    ledStartReportMissing();
+    return;
+  }
+  awaitingLedStart = false;
+
+  // the RP2040's target is our skewTargetUs (both count from the command
+  // write), so this is its first frame on our clock
+  unsigned long firstFrameUs = skewTargetUs + startErrorUs;
+
+  stats.lastEndToEndUs = firstFrameUs - skewInputUs;
+  if (stats.lastEndToEndUs > stats.maxEndToEndUs)
+    stats.maxEndToEndUs = stats.lastEndToEndUs;
+  stats.endToEndSamples++;
+  uint32_t bin = stats.lastEndToEndUs / (config::END_TO_END_BIN_MS * 1000UL);
+  if (bin >= END_TO_END_BINS)
+    bin = END_TO_END_BINS - 1;
+  if (endToEndCounts[bin] < 0xFFFF)
+    endToEndCounts[bin]++;
+
+  DEBUG_PRINT("Reaction: input->first frame us=");
+  DEBUG_PRINTLN(stats.lastEndToEndUs);
+
+  if (!skewHasAudio)
+    return;
+  stats.lastSkewUs = long(firstFrameUs - skewStartUs);
+  uint32_t absSkew =
+      (stats.lastSkewUs < 0) ? -stats.lastSkewUs : stats.lastSkewUs;
+  if (absSkew > stats.maxAbsSkewUs)
+    stats.maxAbsSkewUs = absSkew;
+  stats.skewSamples++;
+
+  DEBUG_PRINT("Reaction: measured skew us=");
+  DEBUG_PRINT(stats.lastSkewUs);
+  DEBUG_PRINT(" max |skew| us=");
+  DEBUG_PRINTLN(stats.maxAbsSkewUs);
+}
+
+void ReactionTimeline::ledStartReportMissing() {
+  if (!awaitingLedStart)
+    return;
+  if (long(micros() - skewTargetUs) >=
+      long(config::LED_START_REPORT_TIMEOUT_MS * 1000UL)) {
+    awaitingLedStart = false;
+    stats.skewMissing++;
+    DEBUG_PRINTLN("Reaction: no start report from the RP2040");
+    return;
+  }
+  nextReportUs = micros() + config::LED_START_REPORT_RETRY_MS * 1000UL;
+}
+
+void ReactionTimeline::finishIfComplete() {
+  bool audioDone = (audioCue == NO_AUDIO) || audioFired;
+  bool ledDone = (ledCmd == NO_LED) || ledSent;
+  if (!audioDone || !ledDone)
+    return;
+
+  stats.reactions++;
+  stats.lastDispatchUs = micros() - scheduledUs;
+  stats.lastInputToStartUs = startUs - inputUs;
+  latencyUs[latencyNext] = stats.lastInputToStartUs;
+  latencyNext = (latencyNext + 1) % LATENCY_SAMPLES;
+  if (latencyCount < LATENCY_SAMPLES)
+    latencyCount++;
+
+  DEBUG_PRINT("Reaction: input->start us=");
+  DEBUG_PRINT(stats.lastInputToStartUs);
+  DEBUG_PRINT(" p50/p95/p99=");
+  DEBUG_PRINT(latencyPercentileUs(50));
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(latencyPercentileUs(95));
+  DEBUG_PRINT("/");
+  DEBUG_PRINTLN(latencyPercentileUs(99));
+
+  if (audioCue != NO_AUDIO && ledCmd != NO_LED) {
+    DEBUG_PRINT("Reaction: dispatch us=");
+    DEBUG_PRINTLN(stats.lastDispatchUs);
+  }
+
+  // the first frame lands around ledTargetUs, ask for it a little later.
+  // DEFAULT is only acked by the RP2040, it never starts anything
+  if (ledCmd != NO_LED && ledCmd != config::CMD_DEFAULT_ANIMATION) {
+    awaitingLedStart = true;
+    skewHasAudio = audioCue != NO_AUDIO;
+    skewInputUs = inputUs;
+    skewStartUs = startUs;
+    skewTargetUs = ledTargetUs;
+    skewSequence = ledSequence;
+    nextReportUs = ledTargetUs + config::LED_START_REPORT_DELAY_MS * 1000UL;
+  }
+
+  audioCue = NO_AUDIO;
+  ledCmd = NO_LED;
+}
+
+// nearest-rank percentile, sorts a copy (64 samples, only on a reaction)
+uint32_t ReactionTimeline::latencyPercentileUs(uint8_t percent) const {
+  if (latencyCount == 0)
+    return 0;
+  uint32_t sorted[LATENCY_SAMPLES];
+  for (uint8_t i = 0; i < latencyCount; i++) {
+    uint32_t v = latencyUs[i];
+    uint8_t j = i;
+    for (; j > 0 && sorted[j - 1] > v; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = v;
+  }
+  uint8_t rank = (uint16_t(percent) * latencyCount + 99) / 100;
+  return sorted[rank ? rank - 1 : 0];
+}
+
+uint32_t ReactionTimeline::endToEndPercentileUs(uint8_t percent) const {
+  if (stats.endToEndSamples == 0)
+    return 0;
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < END_TO_END_BINS; i++) {
+    total += endToEndCounts[i];
+  }
+  uint32_t rank = (uint32_t(percent) * total + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i + 1 < END_TO_END_BINS; i++) {
+    seen += endToEndCounts[i];
+    if (seen >= rank)
+      return (i + 1) * config::END_TO_END_BIN_MS * 1000UL;
+  }
+  return stats.maxEndToEndUs;
+}
+
+void ReactionTimeline::printStats() const {
+  DEBUG_PRINT("ReactionTimeline: reactions=");
+  DEBUG_PRINT(stats.reactions);
+  DEBUG_PRINT(" input->first frame us p50/p95/p99/max=");
+  DEBUG_PRINT(endToEndPercentileUs(50));
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(endToEndPercentileUs(95));
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(endToEndPercentileUs(99));
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(stats.maxEndToEndUs);
+  DEBUG_PRINT(" (n=");
+  DEBUG_PRINT(stats.endToEndSamples);
+  DEBUG_PRINT(") max |skew| us=");
+  DEBUG_PRINT(stats.maxAbsSkewUs);
+  DEBUG_PRINT(" no report=");
+  DEBUG_PRINTLN(stats.skewMissing);
+}
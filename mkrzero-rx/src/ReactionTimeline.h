@@ -0,0 +1,117 @@
+#pragma once
+/**
+ * ReactionTimeline.h
+ *
+ * Schedules the two halves of a reaction (sound + LED animation) against one
+ * common start time so the animation lands with the sound instead of after it.
+ *
+ * Timeline for one reaction (t = 0 when schedule() is called):
+ *   T0 = max(AUDIO_START_LATENCY_MS, REACTION_MIN_LED_LEAD_MS)
+ *   - audio trigger fires at T0 - AUDIO_START_LATENCY_MS (usually right away)
+ *   - LED command goes out right away carrying "start in N ms", so the RP2040
+ *     shows its first frame of the new animation at T0
+ *
+ * Only keeps time, the caller does the actual audio.play() / LED queueing and
+ * reports back with markAudioFired() / markLedDelivered(). For reactions with
+ * both halves the RP2040 is then asked when its first frame actually went out
+ * (start report, see LEDCommander::readStartReport), and the skew is that
+ * measured first frame against T0. T0 itself is still trigger time +
+ * AUDIO_START_LATENCY_MS, the sound onset is not measured.
+ *
+ * Also keeps the last LATENCY_SAMPLES input -> T0 latencies (input = the
+ * packet or RFID pass that changed the state, so the Leonardo's share of the
+ * path is not in it) for p50/p95/p99, and a histogram of the measured
+ * end-to-end latency: input -> the RP2040's first frame of the new animation,
+ * from the same start report as the skew. printStats() gives its percentiles.
+ *
+ * Usage (from ToyCarSystem::update):
+ *   timeline.schedule(audioCue, ledCmd, inputUs);
+ *   if (timeline.audioDue())   { audio.play(cue); timeline.markAudioFired(); }
+ *   if (timeline.ledPending()) { leds.queueCommand(cmd, timeline.startTimeUs());
+ *                                timeline.markLedQueued(); }
+ *   -> once the RP2040 acks: timeline.markLedDelivered(cmd, targetUs, seq);
+ *   -> if (timeline.ledStartReportDue()) read the start report, then
+ *      markLedStarted(seq, startErrorUs) or ledStartReportMissing()
+ */
+
+#include <Arduino.h>
+
+struct ReactionStats {
+  uint32_t reactions;
+  int32_t lastSkewUs; // RP2040's reported first frame - T0 (sound onset)
+  uint32_t maxAbsSkewUs;
+  uint32_t skewSamples;
+  uint32_t skewMissing; // no start report for the command in time
+  uint32_t lastDispatchUs; // schedule() -> sound fired and LED acked
+  uint32_t lastInputToStartUs; // input change -> T0
+  uint32_t lastEndToEndUs; // input change -> RP2040's first frame, measured
+  uint32_t maxEndToEndUs;
+  uint32_t endToEndSamples;
+};
+
+class ReactionTimeline {
+public:
+  static constexpr uint8_t NO_AUDIO = 0xFF;
+  static constexpr uint8_t NO_LED = 0xFF;
+  static constexpr uint8_t LATENCY_SAMPLES = 64;
+  static constexpr uint8_t END_TO_END_BINS = 64; // END_TO_END_BIN_MS each
+
+  // inputUs: micros() when the state change behind this reaction was seen
+  void schedule(uint8_t audioCue, uint8_t ledCmd, unsigned long inputUs);
+
+  bool audioDue() const;
+  bool ledPending() const { return ledCmd != NO_LED && !ledQueued; }
+  uint8_t getAudioCue() const { return audioCue; }
+  uint8_t getLedCommand() const { return ledCmd; }
+  unsigned long startTimeUs() const { return startUs; } // T0
+
+  void markAudioFired();
+  void markLedQueued() { ledQueued = true; }
+  // targetUs: when the RP2040 was told to start, on our clock. sequence: the
+  // RP2040's ack sequence # for the command
+  void markLedDelivered(uint8_t cmd, unsigned long targetUs, uint8_t sequence);
+
+  // waiting on the RP2040 to say when the animation really started
+  bool ledStartReportDue() const;
+  // startErrorUs: RP2040's first frame - the target it was given
+  void markLedStarted(uint8_t sequence, uint16_t startErrorUs);
+  void ledStartReportMissing(); // report not there (yet), try again later
+
+  const ReactionStats &getStats() const { return stats; }
+  uint32_t latencyPercentileUs(uint8_t percent) const; // over the kept samples
+  // upper edge of the histogram bin the percentile falls in (max if in the
+  // open-ended last bin)
+  uint32_t endToEndPercentileUs(uint8_t percent) const;
+  void printStats() const;
+
+private:
+  uint8_t audioCue = NO_AUDIO;
+  uint8_t ledCmd = NO_LED;
+  bool audioFired = false;
+  bool ledQueued = false;
+  bool ledSent = false; // acked by the RP2040
+
+  unsigned long inputUs = 0;
+  unsigned long scheduledUs = 0;
+  unsigned long startUs = 0;    // T0, expected sound onset / first LED frame
+  unsigned long audioFireUs = 0;
+  unsigned long ledTargetUs = 0; // when the RP2040 was told to start
+  uint8_t ledSequence = 0;
+
+  // start report (skew + end-to-end), outlives the reaction itself
+  bool awaitingLedStart = false;
+  bool skewHasAudio = false; // LED-only reactions have nothing to skew against
+  unsigned long skewInputUs = 0;  // input change of the reaction being measured
+  unsigned long skewStartUs = 0;  // its T0
+  unsigned long skewTargetUs = 0; // its LED target
+  uint8_t skewSequence = 0;
+  unsigned long nextReportUs = 0;
+
+  ReactionStats stats{};
+  uint32_t latencyUs[LATENCY_SAMPLES] = {};
+  uint8_t latencyCount = 0;
+  uint8_t latencyNext = 0;
+  uint16_t endToEndCounts[END_TO_END_BINS] = {};
+
+  void finishIfComplete();
+};
@@ -0,0 +1,273 @@
+#include "ReaderBench.h"
+#include "Config.h"
+#include "I2CBus.h"
+#include "MuxController.h"
+#include "TerminalReader.h"
+#include <Arduino.h>
+#include <MFRC522DriverI2C.h>
+#include <MFRC522v2.h>
+#include <Wire.h>
+
+namespace {
+constexpr uint32_t WIRE_DEFAULT_HZ = 100000; // ToyCarSystem never changes it
+
+enum ProbeInit : uint8_t { INIT_FULL, INIT_ANTENNA, INIT_NONE };
+const char *const INIT_NAMES[] = {"full", "antenna", "none"};
+constexpr uint8_t NUM_INIT_STRATEGIES = 3;
+
+/*
+ * MFRC522DriverI2C that counts the bus transactions it issues: one per
+ * register write, two per register read (address write + requestFrom)
+ */
+class CountingDriverI2C : public MFRC522DriverI2C {
+public:
+  CountingDriverI2C(uint8_t address, TwoWire &wire)
+      : MFRC522DriverI2C(address, wire) {}
+
+  void PCD_WriteRegister(const PCD_Register reg, const byte value) override {
+    transactions++;
+    MFRC522DriverI2C::PCD_WriteRegister(reg, value);
+  }
+  void PCD_WriteRegister(const PCD_Register reg, const byte count,
+                         byte *const values) override {
+    transactions++;
+    MFRC522DriverI2C::PCD_WriteRegister(reg, count, values);
+  }
+  byte PCD_ReadRegister(const PCD_Register reg) override {
+    transactions += 2;
+    return MFRC522DriverI2C::PCD_ReadRegister(reg);
+  }
+  void PCD_ReadRegister(const PCD_Register reg, const byte count,
+                        byte *const values, const byte rxAlign = 0) override {
+    transactions += 2;
+    MFRC522DriverI2C::PCD_ReadRegister(reg, count, values, rxAlign);
+  }
+
+  uint32_t transactions = 0;
+};
+
+struct ProbeStats {
+  uint16_t probes;
+  uint16_t detections;
+  uint32_t totalUs;
+  uint32_t maxUs;
+  uint32_t readerTx;
+  uint32_t muxTx;
+};
+
+// same order as ToyCarSystem::update polls them
+constexpr uint8_t NUM_TARGETS = 3;
+
+void probe(MFRC522 &reader, CountingDriverI2C &driver, I2CBus &bus,
+           TerminalReader &terminal, ProbeStats &stats, ProbeInit init) {
+  uint32_t txBefore = driver.transactions;
+  uint32_t muxBefore = MuxController::getStats().writes;
+  unsigned long startUs = micros();
+
+  bus.selectReader(terminal.getChannel());
+  if (init == INIT_FULL) {
+    reader.PCD_Init();
+  } else if (init == INIT_ANTENNA) {
+    reader.PCD_AntennaOff();
+    reader.PCD_AntennaOn();
+  }
+  terminal.update(reader);
+
+  uint32_t probeUs = micros() - startUs;
+  stats.probes++;
+  if (terminal.sawTagLastUpdate())
+    stats.detections++;
+  stats.totalUs += probeUs;
+  if (probeUs > stats.maxUs)
+    stats.maxUs = probeUs;
+  stats.readerTx += driver.transactions - txBefore;
+  stats.muxTx += MuxController::getStats().writes - muxBefore;
+}
+
+void printProbeStats(const char *name, bool ok, uint32_t clockHz,
+                     ProbeInit init, const ProbeStats &s) {
+  Serial.print("bench board=mkrzero name=rfid_probe reader=");
+  Serial.print(name);
+  Serial.print(" ok=");
+  Serial.print(ok ? 1 : 0);
+  Serial.print(" i2c_hz=");
+  Serial.print(clockHz);
+  Serial.print(" init=");
+  Serial.print(INIT_NAMES[init]);
+  Serial.print(" settle_ms=");
+  Serial.print(config::CHANNEL_SWITCH_SETTLE_MS);
+  Serial.print(" probes=");
+  Serial.print(s.probes);
+  Serial.print(" total_us=");
+  Serial.print(s.totalUs);
+  Serial.print(" probes_per_s=");
+  Serial.print(s.totalUs ? (1000000.0f * s.probes) / s.totalUs : 0.0f, 1);
+  Serial.print(" detect_pct=");
+  Serial.print(s.probes ? (100.0f * s.detections) / s.probes : 0.0f, 1);
+  Serial.print(" probe_us_mean=");
+  Serial.print(s.probes ? s.totalUs / s.probes : 0);
+  Serial.print(" probe_us_max=");
+  Serial.print(s.maxUs);
+  Serial.print(" i2c_tx=");
+  Serial.print(s.readerTx);
+  Serial.print(" mux_tx=");
+  Serial.println(s.muxTx);
+}
+
+void runConfig(MFRC522 &reader, CountingDriverI2C &driver, I2CBus &bus,
+               TerminalReader *terminals, uint32_t clockHz, ProbeInit init) {
+  Wire.setClock(clockHz);
+
+  // every run starts from freshly initialized chips, not timed
+  ProbeStats stats[NUM_TARGETS] = {};
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    bus.selectReader(terminals[i].getChannel());
+    reader.PCD_Init();
+  }
+  bus.release();
+
+  unsigned long startUs = micros();
+  for (uint8_t round = 0; round < config::READER_BENCH_ROUNDS; round++) {
+    for (uint8_t i = 0; i < NUM_TARGETS; i++)
+      probe(reader, driver, bus, terminals[i], stats[i], init);
+    bus.release(); // once per pass, like the poll loop
+  }
+  uint32_t totalUs = micros() - startUs;
+
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    printProbeStats(terminals[i].getName(), terminals[i].getReaderStatus(),
+                    clockHz, init, stats[i]);
+  }
+  Serial.print("bench board=mkrzero name=rfid_pass i2c_hz=");
+  Serial.print(clockHz);
+  Serial.print(" init=");
+  Serial.print(INIT_NAMES[init]);
+  Serial.print(" rounds=");
+  Serial.print(config::READER_BENCH_ROUNDS);
+  Serial.print(" total_us=");
+  Serial.print(totalUs);
+  Serial.print(" pass_us_mean=");
+  Serial.println(totalUs / config::READER_BENCH_ROUNDS);
+}
+
+// ----- tag trace -----
+// raw sightings for tools/host/sweep, which replays them through the tag state
+// machine with other timings. a pass is printed after its probes so the
+// printing doesn't move them
+struct TraceEntry {
+  unsigned long ms;
+  bool seen;
+  MFRC522::Uid uid;
+};
+
+void printTraceEntry(const char *name, uint8_t poll, const TraceEntry &e) {
+  Serial.print("bench board=mkrzero name=tag_trace reader=");
+  Serial.print(name);
+  Serial.print(" poll=");
+  Serial.print(poll);
+  Serial.print(" t_ms=");
+  Serial.print(e.ms);
+  Serial.print(" seen=");
+  Serial.print(e.seen ? 1 : 0);
+  Serial.print(" uid=");
+  if (!e.seen)
+    Serial.print('-');
+  for (uint8_t b = 0; e.seen && b < e.uid.size; b++) {
+    if (e.uid.uidByte[b] < 0x10)
+      Serial.print('0');
+    Serial.print(e.uid.uidByte[b], HEX);
+  }
+  Serial.println();
+}
+
+void runTagTrace(MFRC522 &reader, CountingDriverI2C &driver, I2CBus &bus,
+                 TerminalReader *terminals) {
+  TraceEntry pass[NUM_TARGETS];
+  ProbeStats scratch = {}; // probe() wants one, not printed
+  unsigned long traceStartMs = millis();
+  for (uint8_t poll = 0; poll < config::TAG_TRACE_POLLS; poll++) {
+    unsigned long passStartMs = millis();
+    for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+      probe(reader, driver, bus, terminals[i], scratch, INIT_FULL);
+      pass[i].ms = millis() - traceStartMs;
+      pass[i].seen = terminals[i].sawTagLastUpdate();
+      pass[i].uid = reader.uid;
+    }
+    bus.release();
+    for (uint8_t i = 0; i < NUM_TARGETS; i++)
+      printTraceEntry(terminals[i].getName(), poll, pass[i]);
+    while (millis() - passStartMs < config::TAG_TRACE_PASS_MS) {
+    }
+  }
+}
+} // namespace
+
+/*
+ * @brief True if the strap pin is pulled low, or, in READER_BENCH_SERIAL_TRIGGER
+ * builds only, if 'r' arrives over USB serial within
+ * READER_BENCH_SERIAL_WAIT_MS
+ */
+bool readerBenchRequested() {
+  pinMode(config::READER_BENCH_STRAP_PIN, INPUT_PULLUP);
+  delay(1); // let the pull-up charge the pin
+  if (digitalRead(config::READER_BENCH_STRAP_PIN) == LOW)
+    return true;
+  if (!config::READER_BENCH_SERIAL_TRIGGER)
+    return false; // a normal boot doesn't wait for the serial window
+
+  // USB serial takes a moment to come back after a reset, so the whole window
+  // is waited out even with no monitor attached
+  bool prompted = false;
+  unsigned long startMs = millis();
+  while (millis() - startMs < config::READER_BENCH_SERIAL_WAIT_MS) {
+    if (!Serial)
+      continue;
+    if (!prompted) {
+      Serial.println("send 'r' to run the reader bench");
+      prompted = true;
+    }
+    if (Serial.available() && Serial.read() == 'r')
+      return true;
+  }
+  return false;
+}
+
+/*
+ * @brief Probes every reader with a fixed pattern for each I2C clock and init
+ * strategy and prints the results, then records the tag trace. Puts the bus
+ * back the way the normal start expects it. Needs Wire.begin() first
+ */
+void runReaderBench() {
+  CountingDriverI2C driver{config::RFID2_WS1850S_ADDR, Wire};
+  MFRC522 reader{driver};
+  I2CBus bus(config::MUX_ADDR);
+  TerminalReader terminals[NUM_TARGETS] = {
+      {config::RFID2_WS1850S_ADDR, "pos", config::POSITIVE_TERMINAL_CHANNEL},
+      {config::RFID2_WS1850S_ADDR, "neg", config::NEGATIVE_TERMINAL_CHANNEL},
+      {config::RFID2_WS1850S_ADDR, "frame", config::GND_FRAME_CHANNEL},
+  };
+
+  Serial.print("bench board=mkrzero begin cpu_hz=");
+  Serial.println(F_CPU);
+
+  if (!bus.begin()) {
+    Serial.println("bench board=mkrzero end error=mux");
+    return;
+  }
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    bus.selectReader(terminals[i].getChannel());
+    terminals[i].init(reader);
+  }
+  bus.release();
+
+  for (uint8_t c = 0;
+       c < sizeof(config::READER_BENCH_CLOCKS_HZ) / sizeof(uint32_t); c++) {
+    for (uint8_t s = 0; s < NUM_INIT_STRATEGIES; s++)
+      runConfig(reader, driver, bus, terminals,
+                config::READER_BENCH_CLOCKS_HZ[c], ProbeInit(s));
+  }
+
+  Wire.setClock(WIRE_DEFAULT_HZ);
+  runTagTrace(reader, driver, bus, terminals);
+  Serial.println("bench board=mkrzero end");
+}
@@ -1,12 +1,13 @@
 #include "ToyCarSystem.h"
 #include "Config.h"
 #include "Debug.h"
-#include "MuxController.h"
+#include "LEDPrograms.h"
+#include "Marker.h"
 #include <Arduino.h>
 #include <Wire.h>
 
 ToyCarSystem::ToyCarSystem(HardwareSerial &serialPort)
-    : rs485(serialPort, config::RS485_DE_PIN), muxAddr(config::MUX_ADDR),
+    : rs485(serialPort, config::RS485_DE_PIN), bus(config::MUX_ADDR),
       positive(config::RFID2_WS1850S_ADDR, "Positive",
                config::POSITIVE_TERMINAL_CHANNEL),
       negative(config::RFID2_WS1850S_ADDR, "Negative",
@@ -23,13 +24,16 @@ bool ToyCarSystem::initialize(MFRC522 &reader) {
   // ----- setup LED -----
   pinMode(config::ONBOARD_LED_PIN, OUTPUT);
   digitalWrite(config::ONBOARD_LED_PIN, LOW);
+  MARKER_INIT(config::MARKER_PACKET_RX_PIN);
+  MARKER_INIT(config::MARKER_AUDIO_PIN);
+  MARKER_INIT(config::MARKER_LED_CMD_PIN);
 
   // ----- setup RS485 -----
   // start RS485 receiver and register the callback function
   rs485.begin(config::RS485_BAUD_RATE);
   rs485.setPacketHandler(packetHandlerStatic, this);
 
-  // ----- start audio system (SD + I2S) -----
+  // ----- start audio system -----
   if (!audio.begin()) {
     DEBUG_PRINTLN(
         "ToyCarSystem: audio initialization failed (continuing without audio)");
@@ -37,33 +41,25 @@ bool ToyCarSystem::initialize(MFRC522 &reader) {
   }
 
   // ----- test MUX communication -----
-  DEBUG_PRINT("Testing mux communication - ");
-  Wire.beginTransmission(muxAddr);
-  byte result = Wire.endTransmission();
-  if (result != 0) {
-    DEBUG_PRINTLN("FAILED");
-    muxCommunicationOK = false;
+  if (!bus.begin()) {
     return false;
-  } else {
-    DEBUG_PRINTLN("SUCCESS");
-    muxCommunicationOK = true;
   }
 
   // ----- Initialize the RFID readers -----
   DEBUG_PRINT("Initializing readers");
-  MuxController::selectChannel(muxAddr, config::POSITIVE_TERMINAL_CHANNEL);
+  bus.selectReader(config::POSITIVE_TERMINAL_CHANNEL);
   delay(config::CHANNEL_SWITCH_SETTLE_MS);
   positive.init(reader);
 
-  MuxController::selectChannel(muxAddr, config::NEGATIVE_TERMINAL_CHANNEL);
+  bus.selectReader(config::NEGATIVE_TERMINAL_CHANNEL);
   delay(config::CHANNEL_SWITCH_SETTLE_MS);
   negative.init(reader);
 
-  MuxController::selectChannel(muxAddr, config::GND_FRAME_CHANNEL);
+  bus.selectReader(config::GND_FRAME_CHANNEL);
   delay(config::CHANNEL_SWITCH_SETTLE_MS);
   gnd_frame.init(reader);
 
-  MuxController::disableChannel(muxAddr);
+  bus.release();
 
   if (!positive.getReaderStatus() || !negative.getReaderStatus()) {
     DEBUG_PRINT("Warning: Battery ");
@@ -71,8 +67,25 @@ bool ToyCarSystem::initialize(MFRC522 &reader) {
     DEBUG_PRINTLN(" has failed terminal(s)");
   }
 
+  // --- programs first, the RP2040 forgets them on every reset ---
+  for (const LEDProgram &program : LED_PROGRAMS) {
+    if (!ledCommander.uploadProgram(bus, program.slot, program.code,
+                                    program.len)) {
+      DEBUG_PRINT("ToyCarSystem: LED program upload failed, slot ");
+      DEBUG_PRINTLN(program.slot);
+    }
+  }
+
   // --- send default command to led driver ---
-  ledCommander.init();
+  ledCommander.init(bus);
+
+  LEDStatus ledStatus;
+  if (ledCommander.readStatus(bus, ledStatus)) {
+    DEBUG_PRINT("ToyCarSystem: LED driver firmware ");
+    DEBUG_PRINT(ledStatus.fwMajor);
+    DEBUG_PRINT(".");
+    DEBUG_PRINTLN(ledStatus.fwMinor);
+  }
 
   DEBUG_PRINTLN("ToyCarSystem: system started");
   return true;
@@ -85,136 +98,188 @@ void ToyCarSystem::update(MFRC522 &reader) {
 
   if (now - lastRFIDCheck >= rfidCheckIntervalMs) {
     lastRFIDCheck = now;
+    // every PCD_Init() soft-resets the reader and blocks for 50ms or more, so
+    // the audio read-ahead is topped up between probes rather than once per
+    // pass (none of the backends touch the I2C bus in update())
+
     // update positive terminal
-    MuxController::selectChannel(muxAddr, config::POSITIVE_TERMINAL_CHANNEL);
+    bus.selectReader(config::POSITIVE_TERMINAL_CHANNEL);
     reader.PCD_Init();
     positive.update(reader);
+    audio.update();
 
     // update negative terminal
-    MuxController::selectChannel(muxAddr, config::NEGATIVE_TERMINAL_CHANNEL);
+    bus.selectReader(config::NEGATIVE_TERMINAL_CHANNEL);
     reader.PCD_Init();
     negative.update(reader);
+    audio.update();
 
     // update gnd frame terminal
-    MuxController::selectChannel(muxAddr, config::GND_FRAME_CHANNEL);
+    bus.selectReader(config::GND_FRAME_CHANNEL);
     reader.PCD_Init();
     gnd_frame.update(reader);
 
-    MuxController::disableChannel(muxAddr);
+    bus.release();
 
-    toyCarTerminalState = getCurrentState();
+    TerminalState current = getCurrentState();
+    if (current != toyCarTerminalState)
+      lastInputChangeUs = micros();
+    toyCarTerminalState = current;
   }
 
   bool stateChange = (toyCarTerminalState != prevToyCarTerminalState) ||
                      (wallBatteryState != prevWallBatteryState);
 
-  // handle audio playing + LED strip animation logic here
-  // NOTE:
-  // - only play successful engine startup sound when 12V wall battery is
-  //  chosen (with correct configuration) and GND Frame and Positive terminal of
-  //  toy car is chosen
-  // - only play "incorrect" sound when jumper cables are placed on both
-  // terminals of one wall battery and both terminals of toy car battery
+  uint8_t audioCue = ReactionTimeline::NO_AUDIO;
   if (stateChange) {
-    // default animation mode to none
-    mode = AnimationMode::None;
-    if (wallBatteryState.successfulConnection()) {
-      // wall battery side has successfull connection, check which one was
-      // chosen AND check state of toy car terminals
-      switch (wallBatteryState.id) {
-      // 6V
-      case 0:
-        if ((toyCarTerminalState.posPolarity &&
-             toyCarTerminalState.framePolarity) ||
-            (toyCarTerminalState.posPolarity &&
-             toyCarTerminalState.negPolarity)) {
-          DEBUG_PRINTLN("6V Battery Connected!");
-          audio.play(config::SPUTTER_AUDIO_TRIGGER);
-          mode = AnimationMode::SixV;
-        } else if ((toyCarTerminalState.posPresent &&
-                    toyCarTerminalState.negPresent) ||
-                   (toyCarTerminalState.posPresent &&
-                    toyCarTerminalState.framePresent)) {
-          DEBUG_PRINTLN("Wrong Connection!");
-          audio.play(config::WRONG_CHOICE_AUDIO_TRIGGER);
-          mode = AnimationMode::Wrong;
-        }
-        break;
-      // 12V
-      case 1:
-        if (toyCarTerminalState.posPolarity &&
-            toyCarTerminalState.framePolarity) {
-          DEBUG_PRINTLN("12V Battery Connected!");
-          audio.play(config::ENGINE_START_AUDIO_TRIGGER);
-          mode = AnimationMode::TwelveV;
-        } else if ((toyCarTerminalState.posPresent &&
-                    toyCarTerminalState.negPresent) ||
-                   (toyCarTerminalState.posPresent &&
-                    toyCarTerminalState.framePresent)) {
-          DEBUG_PRINTLN("Wrong Connection!");
-          audio.play(config::WRONG_CHOICE_AUDIO_TRIGGER);
-          mode = AnimationMode::Wrong;
-        }
-        break;
-        // 16V
-      case 2:
-        if ((toyCarTerminalState.posPolarity &&
-             toyCarTerminalState.framePolarity) ||
-            (toyCarTerminalState.posPolarity &&
-             toyCarTerminalState.negPolarity)) {
-          DEBUG_PRINTLN("16V Battery Connected!");
-          audio.play(config::ZAP_AUDIO_TRIGGER);
-          mode = AnimationMode::SixteenV;
-        } else if ((toyCarTerminalState.posPresent &&
-                    toyCarTerminalState.negPresent) ||
-                   (toyCarTerminalState.posPresent &&
-                    toyCarTerminalState.framePresent)) {
-          DEBUG_PRINTLN("Wrong Connection!");
-          audio.play(config::WRONG_CHOICE_AUDIO_TRIGGER);
-          mode = AnimationMode::Wrong;
-        }
-        break;
-      }
-    } else if ((wallBatteryState.negPresent && wallBatteryState.posPresent) &&
-               ((toyCarTerminalState.negPresent &&
-                 toyCarTerminalState.posPresent) ||
-                (toyCarTerminalState.framePresent &&
-                 toyCarTerminalState.posPresent))) {
-      DEBUG_PRINTLN("Wrong Connection!");
-      audio.play(config::WRONG_CHOICE_AUDIO_TRIGGER);
-      mode = AnimationMode::Wrong;
-    }
-    prevToyCarTerminalState = toyCarTerminalState;
-    prevWallBatteryState = wallBatteryState;
-  }
-  audio.update();
-
-  // only send I2C command for animation when the animation mode CHANGES
-  if (prevMode != mode) {
-    // free the i2c bus
-    MuxController::disableChannel(muxAddr);
-    delay(5);
+    Reaction reaction = evaluateReaction(wallBatteryState, toyCarTerminalState);
+    mode = reaction.mode;
+    audioCue = reaction.audioCue;
     switch (mode) {
-    case AnimationMode::None:
-      ledCommander.sendCommand(config::CMD_DEFAULT_ANIMATION);
-      break;
     case AnimationMode::SixV:
-      ledCommander.sendCommand(config::CMD_6V_ANIMATION);
+      DEBUG_PRINTLN("6V Battery Connected!");
       break;
     case AnimationMode::TwelveV:
-      ledCommander.sendCommand(config::CMD_12V_ANIMATION);
+      DEBUG_PRINTLN("12V Battery Connected!");
       break;
     case AnimationMode::SixteenV:
-      ledCommander.sendCommand(config::CMD_16V_ANIMATION);
+      DEBUG_PRINTLN("16V Battery Connected!");
       break;
     case AnimationMode::Wrong:
-      ledCommander.sendCommand(config::CMD_WRONG_ANIMATION);
+      DEBUG_PRINTLN("Wrong Connection!");
       break;
     default:
       break;
     }
+    prevToyCarTerminalState = toyCarTerminalState;
+    prevWallBatteryState = wallBatteryState;
+  }
+
+  // only send I2C command for animation when the animation mode CHANGES
+  uint8_t ledCmd = ReactionTimeline::NO_LED;
+  if (prevMode != mode) {
+    ledCmd = commandForMode(mode);
     prevMode = mode;
   }
+
+  // line up sound and animation on one start time (see ReactionTimeline.h)
+  if (audioCue != ReactionTimeline::NO_AUDIO ||
+      ledCmd != ReactionTimeline::NO_LED) {
+    timeline.schedule(audioCue, ledCmd, lastInputChangeUs);
+  }
+
+  // the trigger has the longer path to an audible result, so fire it first
+  if (timeline.audioDue()) {
+    MARKER_PULSE(config::MARKER_AUDIO_PIN);
+    audio.play(timeline.getAudioCue());
+    timeline.markAudioFired();
+  }
+
+  if (timeline.ledPending()) {
+    ledCommander.queueCommand(timeline.getLedCommand(), timeline.startTimeUs());
+    timeline.markLedQueued();
+  }
+
+  // LED traffic goes out between RFID passes, retried until the RP2040 acks
+  ledCommander.update(bus);
+  uint8_t deliveredCmd;
+  unsigned long deliveredTargetUs;
+  uint8_t deliveredSequence;
+  if (ledCommander.pollDelivery(deliveredCmd, deliveredTargetUs,
+                                deliveredSequence)) {
+    timeline.markLedDelivered(deliveredCmd, deliveredTargetUs,
+                              deliveredSequence);
+  }
+
+  // skew: ask the RP2040 when the first frame really went out
+  if (timeline.ledStartReportDue()) {
+    uint8_t startSequence;
+    uint16_t startErrorUs;
+    if (ledCommander.readStartReport(bus, startSequence, startErrorUs))
+      timeline.markLedStarted(startSequence, startErrorUs);
+    else
+      timeline.ledStartReportMissing();
+  }
+
+  audio.update();
+
+  if (now - lastStatusReport >= config::STATUS_REPORT_MS) {
+    lastStatusReport = now;
+    printStatus();
+  }
+}
+
+/*
+ * @brief Dumps the subsystem counters, compiles to nothing unless DEBUG_LEVEL
+ * is set
+ */
+void ToyCarSystem::printStatus() const {
+  DEBUG_PRINTLN("--- ToyCarSystem status ---");
+  audio.printStats();
+  timeline.printStats();
+  ledCommander.printStats();
+  bus.printStats();
+}
+
+// handle audio playing + LED strip animation logic here
+// NOTE:
+// - only play successful engine startup sound when 12V wall battery is
+//  chosen (with correct configuration) and GND Frame and Positive terminal of
+//  toy car is chosen
+// - only play "incorrect" sound when jumper cables are placed on both
+// terminals of one wall battery and both terminals of toy car battery
+Reaction evaluateReaction(const BatteryState &wall, const TerminalState &car) {
+  const Reaction none = {AnimationMode::None, ReactionTimeline::NO_AUDIO};
+  const Reaction wrong = {AnimationMode::Wrong,
+                          config::WRONG_CHOICE_AUDIO_TRIGGER};
+  // both cables on the car, just not a working combination
+  bool carClamped = (car.posPresent && car.negPresent) ||
+                    (car.posPresent && car.framePresent);
+
+  if (wall.successfulConnection()) {
+    // wall battery side has successfull connection, check which one was
+    // chosen AND check state of toy car terminals
+    switch (wall.id) {
+    // 6V
+    case 0:
+      if ((car.posPolarity && car.framePolarity) ||
+          (car.posPolarity && car.negPolarity))
+        return {AnimationMode::SixV, config::SPUTTER_AUDIO_TRIGGER};
+      return carClamped ? wrong : none;
+    // 12V
+    case 1:
+      if (car.posPolarity && car.framePolarity)
+        return {AnimationMode::TwelveV, config::ENGINE_START_AUDIO_TRIGGER};
+      return carClamped ? wrong : none;
+    // 16V
+    case 2:
+      if ((car.posPolarity && car.framePolarity) ||
+          (car.posPolarity && car.negPolarity))
+        return {AnimationMode::SixteenV, config::ZAP_AUDIO_TRIGGER};
+      return carClamped ? wrong : none;
+    }
+    return none;
+  }
+
+  if (wall.negPresent && wall.posPresent && carClamped)
+    return wrong;
+  return none;
+}
+
+uint8_t ToyCarSystem::commandForMode(AnimationMode m) const {
+  switch (m) {
+  case AnimationMode::SixV:
+    return config::CMD_6V_ANIMATION;
+  case AnimationMode::TwelveV:
+    return config::CMD_12V_ANIMATION;
+  case AnimationMode::SixteenV:
+    return config::CMD_16V_ANIMATION;
+  case AnimationMode::Wrong:
+    return config::CMD_WRONG_ANIMATION;
+  case AnimationMode::None:
+  default:
+    return config::CMD_DEFAULT_ANIMATION;
+  }
 }
 
 // BRIDGE FUNCTION
@@ -240,11 +305,15 @@ void ToyCarSystem::onPacketReceived(const WallStatusPacket &pkt) {
   DEBUG_PRINTLN(pkt.POS_STATE);
 
   // update state:
-  wallBatteryState.id = pkt.BAT_ID;
-  wallBatteryState.posPresent = pkt.POS_PRESENT;
-  wallBatteryState.negPresent = pkt.NEG_PRESENT;
-  wallBatteryState.posPolarity = pkt.POS_STATE;
-  wallBatteryState.negPolarity = pkt.NEG_STATE;
+  BatteryState received;
+  received.id = pkt.BAT_ID;
+  received.posPresent = pkt.POS_PRESENT;
+  received.negPresent = pkt.NEG_PRESENT;
+  received.posPolarity = pkt.POS_STATE;
+  received.negPolarity = pkt.NEG_STATE;
+  if (received != wallBatteryState || received.id != wallBatteryState.id)
+    lastInputChangeUs = micros();
+  wallBatteryState = received;
 }
 
 TerminalState ToyCarSystem::getCurrentState() const {
@@ -14,12 +14,27 @@
 #include <Arduino.h>
 #include <MFRC522v2.h>
 
-#include "AudioPlayer.h"
 #include "CommPacket.h"
+#include "Config.h"
+#include "I2CBus.h"
 #include "LEDCommander.h"
 #include "RS485Receiver.h"
+#include "ReactionTimeline.h"
 #include "TerminalReader.h"
 
+// audio backend chosen at compile time (see AUDIO_BACKEND in Config.h), all
+// of them expose begin() / play(triggerPin) / update() / printStats()
+#if AUDIO_BACKEND == AUDIO_BACKEND_UART
+#include "UartAudioPlayer.h"
+using AudioBackend = UartAudioPlayer;
+#elif AUDIO_BACKEND == AUDIO_BACKEND_I2S
+#include "I2SAudioPlayer.h"
+using AudioBackend = I2SAudioPlayer;
+#else
+#include "AudioPlayer.h"
+using AudioBackend = AudioPlayer;
+#endif
+
 struct BatteryState {
   uint8_t id;
   bool posPresent;
@@ -59,6 +74,15 @@ struct TerminalState {
 
 enum class AnimationMode { None, SixV, TwelveV, SixteenV, Wrong };
 
+// what a wall battery + toy car terminal combination should trigger
+struct Reaction {
+  AnimationMode mode;
+  uint8_t audioCue; // ReactionTimeline::NO_AUDIO for none
+};
+
+// pure decision table, no I/O and no state, so it can be checked on its own
+Reaction evaluateReaction(const BatteryState &wall, const TerminalState &car);
+
 class ToyCarSystem {
 public:
   ToyCarSystem(HardwareSerial &serialPort);
@@ -66,8 +90,7 @@ public:
   void update(MFRC522 &reader); // call frequently from loop()
 
 private:
-  bool muxCommunicationOK;
-  uint8_t muxAddr;
+  I2CBus bus;
   uint8_t id;
   TerminalReader positive;
   TerminalReader negative;
@@ -75,20 +98,26 @@ private:
   unsigned long lastRFIDCheck = 0;
   const uint16_t rfidCheckIntervalMs = 100;
   RS485Receiver rs485;
-  AudioPlayer audio;
+  AudioBackend audio;
   LEDCommander ledCommander;
+  ReactionTimeline timeline;
   TerminalState prevToyCarTerminalState;
   BatteryState prevWallBatteryState;
   TerminalState toyCarTerminalState;
   BatteryState wallBatteryState;
   AnimationMode mode = AnimationMode::None;
   AnimationMode prevMode = AnimationMode::None;
+  unsigned long lastInputChangeUs = 0; // last packet/RFID pass that changed state
+  unsigned long lastStatusReport = 0;
+
+  void printStatus() const; // periodic counters, debug builds only
 
   // state helper
   TerminalState getCurrentState() const;
 
-  // LED helper
+  // LED helpers
   void pulseLed(uint16_t durationMs);
+  uint8_t commandForMode(AnimationMode m) const;
 
   // packet callback glue
   // static means "not tied to any specific object"
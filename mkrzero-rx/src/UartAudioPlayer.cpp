@@ -0,0 +1,312 @@
+#include "UartAudioPlayer.h"
+#include "Config.h"
+#include "Debug.h"
+
+#if AUDIO_BACKEND == AUDIO_BACKEND_UART
+#include "wiring_private.h" // pinPeripheral()
+
+// MKR Zero only exposes Serial1 by default (taken by RS-485), so build a
+// second UART on SERCOM3 for the sound module
+Uart AudioSerial(&sercom3, config::AUDIO_UART_RX_PIN, config::AUDIO_UART_TX_PIN,
+                 SERCOM_RX_PAD_1, UART_TX_PAD_0);
+
+void SERCOM3_Handler() { AudioSerial.IrqHandler(); }
+#endif
+
+// ----- DY-HL30T UART PROTOCOL -----
+// frame: 0xAA | cmd | data length | data... | sum (low byte of all previous)
+namespace {
+constexpr uint8_t DY_FRAME_START = 0xAA;
+constexpr uint8_t DY_CMD_QUERY_STATUS = 0x01;
+constexpr uint8_t DY_CMD_STOP = 0x04;
+constexpr uint8_t DY_CMD_PLAY_TRACK = 0x07;
+constexpr uint8_t DY_CMD_SET_VOLUME = 0x13;
+constexpr uint8_t DY_STATUS_STOPPED = 0x00;
+} // namespace
+
+UartAudioPlayer::UartAudioPlayer(HardwareSerial &serial) : uart(serial) {}
+
+bool UartAudioPlayer::begin() {
+  uart.begin(config::AUDIO_UART_BAUD_RATE);
+#if AUDIO_BACKEND == AUDIO_BACKEND_UART
+  // hand the pins over to SERCOM3 (must come after begin())
+  pinPeripheral(config::AUDIO_UART_TX_PIN, PIO_SERCOM);
+  pinPeripheral(config::AUDIO_UART_RX_PIN, PIO_SERCOM);
+#endif
+
+  head = 0;
+  count = 0;
+  activePriority = 0;
+  unansweredPolls = 0;
+  rxState = WAIT_HEADER;
+  memset(&stats, 0, sizeof(stats));
+
+  setVolume(config::AUDIO_VOLUME_PERCENT);
+  stop();
+
+  DEBUG_PRINTLN("AudioPlayer: initialized (DY-HL30T UART mode)");
+  return true;
+}
+
+void UartAudioPlayer::play(uint8_t triggerPin) {
+  DEBUG_PRINT("AudioPlayer: playing ");
+  switch (triggerPin) {
+  case (config::SPUTTER_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("6V sputter audio");
+    playTrack(config::SPUTTER_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+    break;
+  case (config::ENGINE_START_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("12V engine start audio");
+    playTrack(config::ENGINE_START_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+    break;
+  case (config::ZAP_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("16V zap audio");
+    playTrack(config::ZAP_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+    break;
+  case (config::WRONG_CHOICE_AUDIO_TRIGGER):
+    DEBUG_PRINTLN("Wrong choice audio");
+    playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+              config::AUDIO_PRIORITY_WRONG_CHOICE);
+    break;
+  default:
+    DEBUG_PRINTLN("unknown cue");
+    break;
+  }
+}
+
+/*
+ * @brief Queues a track, preempting anything of lower priority
+ *
+ * @param track 1-based index of the file on the module
+ * @param priority higher wins, equal replaces
+ * @return true if the request was accepted
+ */
+bool UartAudioPlayer::playTrack(uint16_t track, uint8_t priority) {
+  if (activePriority > priority) {
+    DEBUG_PRINTLN("AudioPlayer: higher priority clip playing, dropping");
+    stats.dropped++;
+    return false;
+  }
+
+  // resolve against plays still waiting in the queue
+  for (uint8_t i = 0; i < count;) {
+    const AudioCommand &pending =
+        queue[(head + i) % config::AUDIO_UART_QUEUE_LEN];
+    if (pending.type != CMD_PLAY) {
+      i++;
+      continue;
+    }
+    if (pending.priority > priority) {
+      DEBUG_PRINTLN("AudioPlayer: higher priority clip queued, dropping");
+      stats.dropped++;
+      return false;
+    }
+    if (pending.priority < priority)
+      stats.preempted++;
+    removeAt(i);
+  }
+
+  if (activePriority != 0 && activePriority < priority) {
+    // a play track frame interrupts the current clip on the module itself
+    stats.preempted++;
+  }
+
+  uint8_t data[2] = {uint8_t(track >> 8), uint8_t(track & 0xFF)};
+  if (!enqueue(CMD_PLAY, DY_CMD_PLAY_TRACK, data, sizeof(data), priority)) {
+    return false;
+  }
+
+  // try to get it on the wire right away rather than waiting for update()
+  sendNext();
+  return true;
+}
+
+void UartAudioPlayer::stop() {
+  for (uint8_t i = 0; i < count;) {
+    if (queue[(head + i) % config::AUDIO_UART_QUEUE_LEN].type == CMD_PLAY) {
+      removeAt(i);
+    } else {
+      i++;
+    }
+  }
+  enqueue(CMD_STOP, DY_CMD_STOP, nullptr, 0, 0);
+}
+
+void UartAudioPlayer::setVolume(uint8_t percent) {
+  if (percent > 100)
+    percent = 100;
+  uint8_t volume = (uint16_t(percent) * config::AUDIO_MAX_VOLUME) / 100;
+  enqueue(CMD_VOLUME, DY_CMD_SET_VOLUME, &volume, 1, 0);
+}
+
+void UartAudioPlayer::update() {
+  // consume status responses
+  while (uart.available()) {
+    handleByte(static_cast<uint8_t>(uart.read()));
+  }
+
+  // while something is playing, periodically ask whether it finished so a
+  // lower priority cue is not refused forever. no answer for too long, or a
+  // clip longer than any on the module, counts as finished too
+  unsigned long now = millis();
+  if (activePriority != 0 &&
+      (unansweredPolls >= config::AUDIO_UART_MAX_UNANSWERED_POLLS ||
+       now - playStartMillis >= config::AUDIO_UART_MAX_TRACK_MS)) {
+    DEBUG_PRINTLN("AudioPlayer: no STOPPED reply, assuming clip ended");
+    activePriority = 0;
+  }
+  if (activePriority != 0 && count == 0 &&
+      now - lastStatusPoll >= config::AUDIO_UART_STATUS_POLL_MS) {
+    lastStatusPoll = now;
+    enqueue(CMD_QUERY, DY_CMD_QUERY_STATUS, nullptr, 0, 0);
+  }
+
+  sendNext();
+}
+
+void UartAudioPlayer::printStats() const {
+  DEBUG_PRINT("AudioPlayer: sent=");
+  DEBUG_PRINT(stats.commandsSent);
+  DEBUG_PRINT(" preempted=");
+  DEBUG_PRINT(stats.preempted);
+  DEBUG_PRINT(" dropped=");
+  DEBUG_PRINT(stats.dropped);
+  DEBUG_PRINT(" latency us last/max/avg=");
+  DEBUG_PRINT(stats.lastLatencyUs);
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(stats.maxLatencyUs);
+  DEBUG_PRINT("/");
+  DEBUG_PRINTLN(stats.commandsSent ? stats.totalLatencyUs / stats.commandsSent
+                                   : 0);
+}
+
+// ========== QUEUE HELPERS ==========
+bool UartAudioPlayer::enqueue(CommandType type, uint8_t cmd,
+                              const uint8_t *data, uint8_t dataLen,
+                              uint8_t priority) {
+  if (count >= config::AUDIO_UART_QUEUE_LEN) {
+    DEBUG_PRINTLN("AudioPlayer: command queue full, dropping");
+    stats.dropped++;
+    return false;
+  }
+
+  AudioCommand &c = queue[(head + count) % config::AUDIO_UART_QUEUE_LEN];
+  c.type = type;
+  c.priority = priority;
+  c.requestMicros = micros();
+
+  uint8_t sum = 0;
+  uint8_t n = 0;
+  c.frame[n++] = DY_FRAME_START;
+  c.frame[n++] = cmd;
+  c.frame[n++] = dataLen;
+  for (uint8_t i = 0; i < dataLen; i++) {
+    c.frame[n++] = data[i];
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    sum += c.frame[i];
+  }
+  c.frame[n++] = sum;
+  c.len = n;
+
+  count++;
+  return true;
+}
+
+void UartAudioPlayer::removeAt(uint8_t index) {
+  // shift everything behind the removed entry one slot forward
+  for (uint8_t i = index; i + 1 < count; i++) {
+    queue[(head + i) % config::AUDIO_UART_QUEUE_LEN] =
+        queue[(head + i + 1) % config::AUDIO_UART_QUEUE_LEN];
+  }
+  count--;
+}
+
+void UartAudioPlayer::sendNext() {
+  if (count == 0)
+    return;
+
+  unsigned long now = millis();
+  if (now - lastSendMillis < config::AUDIO_UART_CMD_GAP_MS)
+    return;
+
+  AudioCommand &c = queue[head];
+  uart.write(c.frame, c.len);
+  lastSendMillis = now;
+
+  switch (c.type) {
+  case CMD_PLAY: {
+    uint32_t latency = micros() - c.requestMicros;
+    stats.commandsSent++;
+    stats.lastLatencyUs = latency;
+    stats.totalLatencyUs += latency;
+    if (latency > stats.maxLatencyUs)
+      stats.maxLatencyUs = latency;
+    activePriority = c.priority;
+    playStartMillis = now;
+    unansweredPolls = 0;
+    lastStatusPoll = now;
+
+    DEBUG_PRINT("AudioPlayer: play frame sent, trigger-to-command us=");
+    DEBUG_PRINTLN(latency);
+    break;
+  }
+  case CMD_STOP:
+    activePriority = 0;
+    break;
+  case CMD_QUERY:
+    unansweredPolls++; // cleared by any good status reply
+    break;
+  default:
+    break;
+  }
+
+  head = (head + 1) % config::AUDIO_UART_QUEUE_LEN;
+  count--;
+}
+
+// ========== STATUS RESPONSE PARSER ==========
+void UartAudioPlayer::handleByte(uint8_t b) {
+  switch (rxState) {
+  case WAIT_HEADER:
+    if (b == DY_FRAME_START) {
+      rxSum = b;
+      rxState = WAIT_CMD;
+    }
+    break;
+
+  case WAIT_CMD:
+    rxCmd = b;
+    rxSum += b;
+    rxState = WAIT_LEN;
+    break;
+
+  case WAIT_LEN:
+    rxLen = b;
+    rxSum += b;
+    rxIndex = 0;
+    if (rxLen > sizeof(rxData)) {
+      // not a frame we know, resync on next header
+      rxState = WAIT_HEADER;
+    } else {
+      rxState = (rxLen == 0) ? WAIT_SUM : READ_DATA;
+    }
+    break;
+
+  case READ_DATA:
+    rxData[rxIndex++] = b;
+    rxSum += b;
+    if (rxIndex >= rxLen)
+      rxState = WAIT_SUM;
+    break;
+
+  case WAIT_SUM:
+    if (b == rxSum && rxCmd == DY_CMD_QUERY_STATUS && rxLen >= 1) {
+      unansweredPolls = 0;
+      if (rxData[0] == DY_STATUS_STOPPED)
+        activePriority = 0;
+    }
+    rxState = WAIT_HEADER;
+    break;
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+/**
+ * UartAudioPlayer.h
+ *
+ * Alternative AudioPlayer backend that drives the DY-HL30T in UART command
+ * mode instead of pulsing its trigger pins. Selected with AUDIO_BACKEND in
+ * Config.h.
+ *
+ * Responsibilities:
+ *   - Build DY protocol frames (0xAA, cmd, len, data..., sum) for play track,
+ *     stop, volume and status query.
+ *   - Keep a small outgoing command queue so play() never blocks, frames are
+ *     spaced AUDIO_UART_CMD_GAP_MS apart from update().
+ *   - Priority preemption: a higher priority request drops any lower priority
+ *     play still waiting in the queue and interrupts one that is playing.
+ *     The module's STOPPED reply ends a clip, AUDIO_UART_MAX_TRACK_MS or
+ *     AUDIO_UART_MAX_UNANSWERED_POLLS ends it if that reply never comes.
+ *   - Measure trigger-to-command latency (play() call -> frame handed to the
+ *     UART) so it can be compared against the 100ms trigger pulse.
+ *
+ * Usage:
+ *   UartAudioPlayer audio;               // defaults to AudioSerial (SERCOM3)
+ *   audio.begin();
+ *   audio.play(config::ENGINE_START_AUDIO_TRIGGER); // legacy cue
+ *   audio.playTrack(7, config::AUDIO_PRIORITY_SUCCESS);
+ *   -> in loop(): audio.update();
+ */
+
+#include <Arduino.h>
+
+#include "Config.h"
+
+// second hardware UART on SERCOM3 (pins 0/1), only defined when
+// AUDIO_BACKEND == AUDIO_BACKEND_UART
+extern Uart AudioSerial;
+
+struct AudioLatencyStats {
+  uint32_t commandsSent;
+  uint32_t preempted; // queued/playing requests replaced by higher priority
+  uint32_t dropped;   // requests refused (lower priority or queue full)
+  uint32_t lastLatencyUs;
+  uint32_t maxLatencyUs;
+  uint32_t totalLatencyUs; // for the running mean (total / commandsSent)
+};
+
+class UartAudioPlayer {
+public:
+  explicit UartAudioPlayer(HardwareSerial &serial = AudioSerial);
+  bool begin();
+  void play(uint8_t triggerPin); // maps the legacy trigger cues onto tracks
+  bool playTrack(uint16_t track, uint8_t priority);
+  void stop();
+  void setVolume(uint8_t percent);
+  void update();
+
+  bool playing() const { return activePriority != 0; }
+  const AudioLatencyStats &getStats() const { return stats; }
+  void printStats() const;
+
+private:
+  enum CommandType : uint8_t { CMD_PLAY, CMD_STOP, CMD_VOLUME, CMD_QUERY };
+
+  struct AudioCommand {
+    CommandType type;
+    uint8_t priority;
+    uint8_t len;
+    uint8_t frame[6];
+    unsigned long requestMicros;
+  };
+
+  enum RxState { WAIT_HEADER, WAIT_CMD, WAIT_LEN, READ_DATA, WAIT_SUM };
+
+  HardwareSerial &uart;
+
+  // outgoing ring buffer
+  AudioCommand queue[config::AUDIO_UART_QUEUE_LEN];
+  uint8_t head = 0;
+  uint8_t count = 0;
+  unsigned long lastSendMillis = 0;
+  unsigned long lastStatusPoll = 0;
+
+  // what the module is doing (0 = idle)
+  uint8_t activePriority = 0;
+  unsigned long playStartMillis = 0;
+  uint8_t unansweredPolls = 0;
+
+  // status response parser
+  RxState rxState = WAIT_HEADER;
+  uint8_t rxCmd = 0;
+  uint8_t rxLen = 0;
+  uint8_t rxIndex = 0;
+  uint8_t rxSum = 0;
+  uint8_t rxData[4];
+
+  AudioLatencyStats stats{};
+
+  bool enqueue(CommandType type, uint8_t cmd, const uint8_t *data,
+               uint8_t dataLen, uint8_t priority);
+  void removeAt(uint8_t index);
+  void sendNext();
+  void handleByte(uint8_t b);
+};
@@ -0,0 +1,61 @@
+#include "WavFormat.h"
+
+#include <string.h>
+
+namespace {
+constexpr uint16_t WAV_FORMAT_PCM = 1;
+
+uint16_t readLE16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+
+uint32_t readLE32(const uint8_t *p) {
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) |
+         (uint32_t(p[3]) << 24);
+}
+} // namespace
+
+/*
+ * @brief Walks the RIFF chunk list looking for "fmt " and "data"
+ *
+ * @param buf first bytes of the file
+ * @param len number of valid bytes in buf
+ * @param info filled in on success
+ * @return true if the file is 16-bit mono PCM and its data chunk was found
+ */
+bool parseWavHeader(const uint8_t *buf, size_t len, WavInfo &info) {
+  if (len < 12 || memcmp(buf, "RIFF", 4) != 0 ||
+      memcmp(buf + 8, "WAVE", 4) != 0) {
+    return false;
+  }
+
+  bool haveFormat = false;
+  size_t pos = 12;
+  while (pos + 8 <= len) {
+    const uint8_t *chunk = buf + pos;
+    uint32_t chunkSize = readLE32(chunk + 4);
+
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      if (pos + 8 + 16 > len)
+        return false;
+      if (readLE16(chunk + 8) != WAV_FORMAT_PCM)
+        return false;
+      info.channels = readLE16(chunk + 10);
+      info.sampleRate = readLE32(chunk + 12);
+      info.bitsPerSample = readLE16(chunk + 22);
+      haveFormat = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (!haveFormat)
+        return false;
+      info.dataOffset = pos + 8;
+      info.dataLength = chunkSize;
+      return info.channels == 1 && info.bitsPerSample == 16;
+    }
+
+    // a chunk running past the buffer means "data" isn't in it either, and
+    // a corrupt size would wrap pos back over earlier bytes
+    if (chunkSize > len - pos - 8)
+      return false;
+    // chunks are word aligned
+    pos += 8 + chunkSize + (chunkSize & 1);
+  }
+  return false;
+}
@@ -0,0 +1,26 @@
+#pragma once
+/**
+ * WavFormat.h
+ *
+ * Minimal RIFF/WAVE header parser for the I2S audio backend. Works on a plain
+ * byte buffer (no SD/Arduino dependencies) so the same code can run anywhere.
+ *
+ * Only what the mixer can play is accepted: uncompressed PCM, 16-bit, mono.
+ * The "data" chunk has to start within the buffer handed in (clips exported
+ * from Audacity put it well inside the first WAV_HEADER_SCAN_BYTES).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+static constexpr size_t WAV_HEADER_SCAN_BYTES = 256;
+
+struct WavInfo {
+  uint16_t channels;
+  uint32_t sampleRate;
+  uint16_t bitsPerSample;
+  uint32_t dataOffset; // byte offset of the first sample in the file
+  uint32_t dataLength; // bytes of sample data
+};
+
+bool parseWavHeader(const uint8_t *buf, size_t len, WavInfo &info);
@@ -0,0 +1,212 @@
+#include "AnimationVM.h"
+#include "Config.h"
+#include "PixelOps.h"
+#include <Arduino.h>
+#include <FastLED.h>
+
+namespace {
+enum Opcode : uint8_t {
+  OP_END = 0x00,
+  OP_FILL = 0x01,
+  OP_FILL_HSV = 0x02,
+  OP_HUE_REG = 0x03,
+  OP_GRADIENT = 0x04,
+  OP_BAR = 0x05,
+  OP_SPARKS = 0x06,
+  OP_FADE = 0x07,
+  OP_SET = 0x08,
+  OP_ADD = 0x09,
+  OP_JMP = 0x0A,
+  OP_JLT = 0x0B,
+  OP_JGE = 0x0C,
+  OP_DJNZ = 0x0D,
+  OP_YIELD = 0x0E,
+};
+
+// operand bytes per opcode, indexed by opcode
+const uint8_t OPERAND_BYTES[] = {0, 3, 3, 3, 8, 5, 4, 1, 3, 3, 2, 5, 5, 3, 0};
+} // namespace
+
+void AnimationVM::load(const uint8_t *program, uint16_t len) {
+  codeLen = (len < config::PROGRAM_MAX_BYTES) ? len : config::PROGRAM_MAX_BYTES;
+  memcpy(code, program, codeLen);
+  pc = 0;
+  memset(regs, 0, sizeof(regs));
+  fault = (codeLen == 0);
+}
+
+/*
+ * @brief Runs the program until it ends or yields the frame
+ *
+ * @param leds frame to draw into, left as is between frames so FADE trails work
+ * @param numLEDs pixels in the frame
+ */
+void AnimationVM::run(CRGB *leds, uint16_t numLEDs) {
+  if (fault) {
+    fill_solid(leds, numLEDs, CRGB::Black);
+    return;
+  }
+
+  uint16_t ops = 0;
+  bool frameDone = false;
+  while (!frameDone) {
+    if (ops >= config::VM_MAX_STEPS_PER_FRAME || pc >= codeLen) {
+      halt(leds, numLEDs);
+      return;
+    }
+    uint8_t op = code[pc++];
+    ops++;
+    if (op >= sizeof(OPERAND_BYTES) || !operands(OPERAND_BYTES[op])) {
+      halt(leds, numLEDs);
+      return;
+    }
+
+    switch (op) {
+    case OP_END:
+      pc = 0;
+      frameDone = true;
+      break;
+
+    case OP_YIELD:
+      frameDone = true;
+      break;
+
+    case OP_FILL: {
+      uint8_t r = u8(), g = u8(), b = u8();
+      fillFrame(leds, numLEDs, CRGB(r, g, b));
+      break;
+    }
+
+    case OP_FILL_HSV: {
+      uint8_t h = u8(), s = u8(), v = u8();
+      fillFrame(leds, numLEDs, CHSV(h, s, v));
+      break;
+    }
+
+    case OP_HUE_REG: {
+      uint8_t reg = u8() % NUM_REGS;
+      uint8_t s = u8(), v = u8();
+      fillFrame(leds, numLEDs, CHSV(uint16_t(regs[reg]) >> 8, s, v));
+      break;
+    }
+
+    case OP_GRADIENT: {
+      uint16_t start = u8(), len = u8();
+      // operands read one statement at a time: the order function arguments
+      // are evaluated in is unspecified, CRGB(u8(), u8(), u8()) can come out
+      // as b g r
+      uint8_t r1 = u8(), g1 = u8(), b1 = u8();
+      uint8_t r2 = u8(), g2 = u8(), b2 = u8();
+      CRGB from(r1, g1, b1);
+      CRGB to(r2, g2, b2);
+      for (uint16_t i = 0; i < len && start + i < numLEDs; i++) {
+        uint8_t amount = (len > 1) ? (i * 255) / (len - 1) : 0;
+        leds[start + i] = blend(from, to, amount);
+      }
+      break;
+    }
+
+    case OP_BAR: {
+      uint8_t reg = u8() % NUM_REGS;
+      uint8_t len = u8();
+      uint8_t r = u8(), g = u8(), b = u8();
+      CRGB color(r, g, b);
+      int16_t first = regs[reg] >> 8;
+      for (int16_t p = first; p < first + len; p++) {
+        if (p >= 0 && p < int16_t(numLEDs))
+          leds[p] = color;
+      }
+      break;
+    }
+
+    case OP_SPARKS: {
+      uint8_t chance = u8(), count = u8(), hue = u8(), sat = u8();
+      if (random8() < chance) {
+        for (uint8_t i = 0; i < count; i++) {
+          leds[random16(numLEDs)] =
+              CHSV(hue + random8(10), sat, random8(180, 255));
+        }
+      }
+      break;
+    }
+
+    case OP_FADE:
+      fadeFrame(leds, numLEDs, u8());
+      break;
+
+    case OP_SET: {
+      uint8_t reg = u8() % NUM_REGS;
+      regs[reg] = i16();
+      break;
+    }
+
+    case OP_ADD: {
+      uint8_t reg = u8() % NUM_REGS;
+      regs[reg] = int16_t(uint16_t(regs[reg]) + uint16_t(i16()));
+      break;
+    }
+
+    case OP_JMP:
+      if (!jump(uint16_t(i16()))) {
+        halt(leds, numLEDs);
+        return;
+      }
+      break;
+
+    case OP_JLT:
+    case OP_JGE: {
+      uint8_t reg = u8() % NUM_REGS;
+      int16_t imm = i16();
+      uint16_t addr = uint16_t(i16());
+      bool less = regs[reg] < imm;
+      if ((op == OP_JLT) == less && !jump(addr)) {
+        halt(leds, numLEDs);
+        return;
+      }
+      break;
+    }
+
+    case OP_DJNZ: {
+      uint8_t reg = u8() % NUM_REGS;
+      uint16_t addr = uint16_t(i16());
+      regs[reg]--;
+      if (regs[reg] != 0 && !jump(addr)) {
+        halt(leds, numLEDs);
+        return;
+      }
+      break;
+    }
+    }
+  }
+
+  stats.frames++;
+  stats.lastOps = ops;
+  if (ops > stats.maxOps)
+    stats.maxOps = ops;
+}
+
+// ========== HELPERS ==========
+bool AnimationVM::operands(uint8_t count) { return pc + count <= codeLen; }
+
+uint8_t AnimationVM::u8() { return code[pc++]; }
+
+int16_t AnimationVM::i16() {
+  uint16_t lo = code[pc++];
+  uint16_t hi = code[pc++];
+  return int16_t(lo | (hi << 8));
+}
+
+bool AnimationVM::jump(uint16_t addr) {
+  if (addr >= codeLen)
+    return false;
+  pc = addr;
+  return true;
+}
+
+void AnimationVM::halt(CRGB *leds, uint16_t numLEDs) {
+  fault = true;
+  stats.faults++;
+  fill_solid(leds, numLEDs, CRGB::Black);
+  Serial.print("AnimationVM: fault at pc ");
+  Serial.println(pc);
+}
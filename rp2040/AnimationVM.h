@@ -0,0 +1,83 @@
+#pragma once
+/**
+ * AnimationVM.h
+ *
+ * Tiny bytecode interpreter so new effects can be uploaded (see
+ * ProgramStore.h) instead of flashed as another stepAnimationX().
+ *
+ * Model:
+ *   - 8 int16 registers (r0-r7), they keep their value between frames.
+ *     positions/hues are Q8.8 (pixel or hue = reg >> 8)
+ *   - run() executes one frame: from pc until END (next frame starts over at
+ *     the top) or YIELD (next frame resumes after it, for timing loops)
+ *   - more than VM_MAX_STEPS_PER_FRAME instructions in a frame, a bad opcode,
+ *     a truncated operand or a jump out of range faults the program and
+ *     blanks the strip
+ *
+ * Encoding: opcode byte then operands, 16 bit values little endian.
+ *   0x00 END
+ *   0x01 FILL      r g b
+ *   0x02 FILL_HSV  h s v
+ *   0x03 HUE_REG   reg s v                 fill with hue = reg >> 8
+ *   0x04 GRADIENT  start len r1 g1 b1 r2 g2 b2
+ *   0x05 BAR       reg len r g b           len pixels from reg >> 8
+ *   0x06 SPARKS    chance count hue sat    if random8() < chance
+ *   0x07 FADE      amount                  fadeToBlackBy
+ *   0x08 SET       reg imm16
+ *   0x09 ADD       reg imm16               wraps
+ *   0x0A JMP       addr16
+ *   0x0B JLT       reg imm16 addr16        jump if reg < imm
+ *   0x0C JGE       reg imm16 addr16        jump if reg >= imm
+ *   0x0D DJNZ      reg addr16              reg--, jump if reg != 0
+ *   0x0E YIELD
+ *
+ * Example, green bar running up the strip with a fading trail:
+ *   08 00 00 00         SET r0 0
+ *   07 60               FADE 96             <- addr 4
+ *   05 00 03 00 FF 00   BAR r0 3 green
+ *   09 00 80 00         ADD r0 0x0080       half a pixel per frame
+ *   0E                  YIELD
+ *   0B 00 00 46 04 00   JLT r0 0x4600 4     until pixel 70
+ *   0A 00 00            JMP 0               back to the bottom
+ *
+ * Colour operands are always r g b in that order, e.g. a red to blue
+ * gradient over the first 70 pixels:
+ *   04 00 46 FF 00 00 00 00 FF   GRADIENT 0 70 red -> blue
+ */
+
+#include "Config.h"
+#include <Arduino.h>
+#include <FastLED.h>
+
+struct VMStats {
+  uint32_t frames;
+  uint16_t lastOps; // instructions executed in the last frame
+  uint16_t maxOps;
+  uint32_t faults;
+};
+
+class AnimationVM {
+public:
+  static constexpr uint8_t NUM_REGS = 8;
+
+  void load(const uint8_t *program, uint16_t len); // copies, resets state
+  void run(CRGB *leds, uint16_t numLEDs);          // one frame
+
+  bool faulted() const { return fault; }
+  const VMStats &getStats() const { return stats; }
+  void resetStats() { stats = {}; }
+
+private:
+  bool operands(uint8_t count); // count operand bytes available at pc
+  uint8_t u8();
+  int16_t i16();
+  bool jump(uint16_t addr);
+  void halt(CRGB *leds, uint16_t numLEDs);
+
+  uint8_t code[config::PROGRAM_MAX_BYTES];
+  uint16_t codeLen = 0;
+  uint16_t pc = 0;
+  int16_t regs[NUM_REGS] = {};
+  bool fault = true; // nothing loaded yet
+  VMStats stats{};
+};
@@ -0,0 +1,196 @@
+#pragma once
+/**
+ * ClipData.h
+ *
+ * Pre-rendered clips played with CMD_CLIP_BASE + index (see ClipPlayer.h for
+ * the format). const data stays in flash and is read through XIP, it never
+ * takes RAM.
+ *
+ * Add a clip: append its bytes here and its pointer to CLIPS. clips must be
+ * NUM_LEDS pixels wide. The bytes come from tools/host's clipgen, which
+ * renders a procedural effect (`clipgen effect comet` reproduces COMET) or
+ * converts a picture with one row per frame (`clipgen ppm`).
+ */
+
+#include "Config.h"
+#include <stdint.h>
+
+namespace clips {
+
+// 0: blue-white comet with a 12 pixel tail, 2 pixels per frame, loops
+inline constexpr uint8_t COMET[] = {
+    0x4C, 0x43, 0x01, 0x3C, 0x46, 0x00, 0x23, 0x00, 0x34, 0x00, 0x01, 0xC8,
+    0xDC, 0xFF, 0x3A, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06,
+    0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10,
+    0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x34, 0x00, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9,
+    0x01, 0xC8, 0xDC, 0xFF, 0x3A, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15,
+    0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55,
+    0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x34, 0x00, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x3A, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x34, 0x00, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4,
+    0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x3A, 0x00, 0x00, 0x00,
+    0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x34, 0x00, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21,
+    0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x3A, 0x00,
+    0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09,
+    0x1D, 0x3F, 0x34, 0x00, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F,
+    0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF,
+    0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF,
+    0x3A, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x38, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09,
+    0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13,
+    0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D,
+    0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8,
+    0xDC, 0xFF, 0x39, 0x00, 0x00, 0x00, 0x38, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F,
+    0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF,
+    0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF,
+    0x37, 0x00, 0x00, 0x00, 0x38, 0x00, 0x05, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21,
+    0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x35, 0x00,
+    0x00, 0x00, 0x38, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15,
+    0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55,
+    0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4,
+    0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x33, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06,
+    0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10,
+    0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x31, 0x00, 0x00, 0x00, 0x38, 0x00,
+    0x0B, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A,
+    0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A,
+    0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA,
+    0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9,
+    0x01, 0xC8, 0xDC, 0xFF, 0x2F, 0x00, 0x00, 0x00, 0x38, 0x00, 0x0D, 0x00,
+    0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09,
+    0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13,
+    0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D,
+    0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8,
+    0xDC, 0xFF, 0x2D, 0x00, 0x00, 0x00, 0x38, 0x00, 0x0F, 0x00, 0x00, 0x00,
+    0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F,
+    0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF,
+    0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF,
+    0x2B, 0x00, 0x00, 0x00, 0x38, 0x00, 0x11, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21,
+    0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x29, 0x00,
+    0x00, 0x00, 0x38, 0x00, 0x13, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15,
+    0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55,
+    0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4,
+    0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x27, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x15, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06,
+    0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10,
+    0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x25, 0x00, 0x00, 0x00, 0x38, 0x00,
+    0x17, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A,
+    0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A,
+    0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA,
+    0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9,
+    0x01, 0xC8, 0xDC, 0xFF, 0x23, 0x00, 0x00, 0x00, 0x38, 0x00, 0x19, 0x00,
+    0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09,
+    0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13,
+    0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D,
+    0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8,
+    0xDC, 0xFF, 0x21, 0x00, 0x00, 0x00, 0x38, 0x00, 0x1B, 0x00, 0x00, 0x00,
+    0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F,
+    0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF,
+    0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF,
+    0x1F, 0x00, 0x00, 0x00, 0x38, 0x00, 0x1D, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21,
+    0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x1D, 0x00,
+    0x00, 0x00, 0x38, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15,
+    0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55,
+    0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4,
+    0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x1B, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x21, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06,
+    0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10,
+    0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x19, 0x00, 0x00, 0x00, 0x38, 0x00,
+    0x23, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A,
+    0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A,
+    0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA,
+    0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9,
+    0x01, 0xC8, 0xDC, 0xFF, 0x17, 0x00, 0x00, 0x00, 0x38, 0x00, 0x25, 0x00,
+    0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09,
+    0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13,
+    0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D,
+    0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8,
+    0xDC, 0xFF, 0x15, 0x00, 0x00, 0x00, 0x38, 0x00, 0x27, 0x00, 0x00, 0x00,
+    0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F,
+    0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF,
+    0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF,
+    0x13, 0x00, 0x00, 0x00, 0x38, 0x00, 0x29, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21,
+    0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x11, 0x00,
+    0x00, 0x00, 0x38, 0x00, 0x2B, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15,
+    0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55,
+    0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4,
+    0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x0F, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x2D, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06,
+    0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10,
+    0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x0D, 0x00, 0x00, 0x00, 0x38, 0x00,
+    0x2F, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A,
+    0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A,
+    0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA,
+    0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9,
+    0x01, 0xC8, 0xDC, 0xFF, 0x0B, 0x00, 0x00, 0x00, 0x38, 0x00, 0x31, 0x00,
+    0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09,
+    0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13,
+    0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D,
+    0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8,
+    0xDC, 0xFF, 0x09, 0x00, 0x00, 0x00, 0x38, 0x00, 0x33, 0x00, 0x00, 0x00,
+    0x01, 0x03, 0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F,
+    0x01, 0x0D, 0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F,
+    0x01, 0x17, 0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF,
+    0x01, 0x21, 0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF,
+    0x07, 0x00, 0x00, 0x00, 0x38, 0x00, 0x35, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x09, 0x15, 0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D,
+    0x28, 0x55, 0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17,
+    0x45, 0x94, 0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21,
+    0x63, 0xD4, 0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x05, 0x00,
+    0x00, 0x00, 0x38, 0x00, 0x37, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15,
+    0x01, 0x06, 0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55,
+    0x01, 0x10, 0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94,
+    0x01, 0x1A, 0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4,
+    0x01, 0x24, 0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x03, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x39, 0x00, 0x00, 0x00, 0x01, 0x03, 0x09, 0x15, 0x01, 0x06,
+    0x13, 0x2A, 0x01, 0x09, 0x1D, 0x3F, 0x01, 0x0D, 0x28, 0x55, 0x01, 0x10,
+    0x31, 0x6A, 0x01, 0x13, 0x3B, 0x7F, 0x01, 0x17, 0x45, 0x94, 0x01, 0x1A,
+    0x50, 0xAA, 0x01, 0x1D, 0x59, 0xBF, 0x01, 0x21, 0x63, 0xD4, 0x01, 0x24,
+    0x6D, 0xE9, 0x01, 0xC8, 0xDC, 0xFF, 0x01, 0x00, 0x00, 0x00,
+};
+
+inline constexpr const uint8_t *CLIPS[] = {COMET};
+inline constexpr uint8_t NUM_CLIPS = sizeof(CLIPS) / sizeof(CLIPS[0]);
+static_assert(NUM_CLIPS <= config::MAX_CLIPS, "raise config::MAX_CLIPS");
+
+} // namespace clips
@@ -0,0 +1,89 @@
+#include "ClipPlayer.h"
+#include "Config.h"
+#include <Arduino.h>
+
+namespace {
+constexpr uint8_t CLIP_HEADER_BYTES = 8;
+constexpr uint8_t CLIP_VERSION = 1;
+
+inline uint16_t readU16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+} // namespace
+
+/*
+ * @brief Checks the header and walks every frame once so render() can trust
+ * the data
+ *
+ * @param numLEDs canvas width, the clip has to match it
+ */
+bool ClipPlayer::open(const uint8_t *data, uint16_t numLEDs,
+                      unsigned long nowMs) {
+  clip = nullptr;
+  if (!data || data[0] != 'L' || data[1] != 'C' || data[2] != CLIP_VERSION) {
+    Serial.println("ClipPlayer: bad clip header");
+    return false;
+  }
+
+  fps = data[3];
+  pixels = readU16(data + 4);
+  frameCount = readU16(data + 6);
+  if (fps == 0 || frameCount == 0 || pixels != numLEDs) {
+    Serial.println("ClipPlayer: clip doesn't fit the canvas");
+    return false;
+  }
+
+  const uint8_t *p = data + CLIP_HEADER_BYTES;
+  for (uint16_t f = 0; f < frameCount; f++) {
+    uint16_t length = readU16(p);
+    uint32_t covered = 0;
+    if (length % 4 != 0) {
+      Serial.println("ClipPlayer: truncated frame");
+      return false;
+    }
+    for (uint16_t i = 0; i < length; i += 4) {
+      covered += p[2 + i];
+    }
+    if (covered != pixels) {
+      Serial.println("ClipPlayer: frame runs don't cover the strip");
+      return false;
+    }
+    p += 2 + length;
+  }
+
+  clip = data;
+  frameIndex = 0;
+  framePtr = data + CLIP_HEADER_BYTES;
+  startMs = nowMs;
+  return true;
+}
+
+void ClipPlayer::render(CRGB *frame, unsigned long nowMs) {
+  if (!clip) {
+    fill_solid(frame, config::NUM_LEDS, CRGB::Black);
+    return;
+  }
+
+  uint16_t target = ((nowMs - startMs) * fps / 1000) % frameCount;
+  if (target < frameIndex) {
+    // wrapped around, back to the first frame
+    frameIndex = 0;
+    framePtr = clip + CLIP_HEADER_BYTES;
+  }
+  while (frameIndex < target) {
+    framePtr += 2 + readU16(framePtr);
+    frameIndex++;
+  }
+
+  decode(framePtr + 2, readU16(framePtr), frame);
+}
+
+bool ClipPlayer::decode(const uint8_t *data, uint16_t length, CRGB *frame) {
+  uint16_t pos = 0;
+  for (uint16_t i = 0; i < length; i += 4) {
+    uint8_t count = data[i];
+    CRGB color(data[i + 1], data[i + 2], data[i + 3]);
+    for (uint8_t n = 0; n < count; n++) {
+      frame[pos++] = color;
+    }
+  }
+  return pos == pixels;
+}
@@ -0,0 +1,42 @@
+#pragma once
+/**
+ * ClipPlayer.h
+ *
+ * Plays pre-rendered, RLE compressed frame sequences stored in flash
+ * (ClipData.h). Decoding reads the clip straight out of XIP flash, a frame is
+ * a few dozen runs so it costs the same handful of microseconds no matter how
+ * expensive the effect was to render.
+ *
+ * Format (little endian):
+ *   header: 'L' 'C' version(1) fps pixels(u16) frames(u16)
+ *   frame:  byteLength(u16) then runs of [count(1-255), r, g, b] that add up
+ *           to exactly `pixels`
+ * every frame is a keyframe, so skipping ahead (engine fps > clip fps or a
+ * late frame) is just hopping over byteLength.
+ */
+
+#include "Config.h"
+#include <Arduino.h>
+#include <FastLED.h>
+
+class ClipPlayer {
+public:
+  // false if malformed, playback starts at nowMs
+  bool open(const uint8_t *clip, uint16_t numLEDs, unsigned long nowMs);
+  void render(CRGB *frame, unsigned long nowMs);    // loops at the clip's fps
+
+  bool ok() const { return clip != nullptr; }
+
+private:
+  bool decode(const uint8_t *data, uint16_t length, CRGB *frame);
+
+  const uint8_t *clip = nullptr;
+  uint8_t fps = 0;
+  uint16_t pixels = 0;
+  uint16_t frameCount = 0;
+
+  // playhead, kept so the next frame is found without walking from the top
+  uint16_t frameIndex = 0;
+  const uint8_t *framePtr = nullptr;
+  unsigned long startMs = 0;
+};
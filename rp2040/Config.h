@@ -13,11 +13,56 @@
 #include <Arduino.h>
 
 namespace config {
-static constexpr uint16_t NUM_LEDS = 70;
+static constexpr uint16_t NUM_LEDS = 70; // logical canvas the animations draw on
 static constexpr uint8_t LED_DATA_PIN = D1;
+static constexpr uint8_t MARKER_FIRST_FRAME_PIN = D2; // see Marker.h
+
+// ----- physical strips -----
+// every output gets its own PIO state machine + DMA channel, all of them are
+// clocked out in parallel. segments say where the canvas lands on them
+struct LEDOutput {
+  uint8_t pin;
+  uint16_t pixels;
+};
+struct LEDSegment {
+  uint8_t output;  // index into LED_OUTPUTS
+  uint16_t offset; // first physical pixel on that output
+  uint16_t length; // canvas is stretched/squeezed to fit
+  bool reversed;   // canvas pixel 0 at the far end
+};
+static constexpr LEDOutput LED_OUTPUTS[] = {
+    {LED_DATA_PIN, NUM_LEDS}, // engine bay
+    // {D0, 300},             // e.g. underbody
+    // {D3, 240},             // e.g. dashboard
+};
+static constexpr LEDSegment LED_SEGMENTS[] = {
+    {0, 0, NUM_LEDS, false},
+    // {1, 0, 150, true}, {1, 150, 150, false}, // underbody, mirrored halves
+    // {2, 0, 240, false},
+};
+static constexpr uint8_t NUM_LED_OUTPUTS = sizeof(LED_OUTPUTS) / sizeof(LED_OUTPUTS[0]);
+static constexpr uint8_t NUM_LED_SEGMENTS = sizeof(LED_SEGMENTS) / sizeof(LED_SEGMENTS[0]);
+static constexpr uint16_t LED_MAX_OUTPUT_PIXELS = 512; // per output DMA buffer size
 static constexpr uint16_t LED_BRIGHTNESS = 10; // as a percentage (%)
 static constexpr unsigned long ANIMATION_DURATION_MS = 5000; // 5 seconds
 static constexpr uint16_t FPS = 60; // target frames per second of animation
+static constexpr uint16_t IDLE_FPS = 15; // default/attract animation, changes slowly
+static constexpr uint16_t CROSSFADE_MS = 250; // mode change blend, 0 = hard cut
+static constexpr uint16_t LED_MIN_REFRESH_MS = 100; // resend unchanged frames this often
+
+// ----- power budget -----
+// per-LED current model on the 12V rail: idle current plus every channel's
+// level / 255 * LED_CHANNEL_UA_FULL, summed over r, g and b, so full white
+// counts as 3 channels (errs high if white draws less on the real strip).
+// measured at the strip input with a clamp meter, re-check if the strip type
+// changes
+static constexpr uint32_t LED_IDLE_UA = 1000;          // driver IC, all off
+static constexpr uint32_t LED_CHANNEL_UA_FULL = 5000;  // one channel at 255
+static constexpr uint32_t LED_POWER_BUDGET_MA = 500;   // share of the rail we may use
+static constexpr uint32_t WS2815_BIT_HZ = 800000;     // data rate on the wire
+static constexpr uint32_t WS2815_BIT_US_X100 = 125;   // 1.25us per bit
+static constexpr uint32_t WS2815_RESET_US = 300;      // datasheet latch >280us
+static constexpr unsigned long STATS_REPORT_MS = 5000; // USB serial stats period
 
 static constexpr uint8_t LED_CONTROLLER_ADDR = 0x20;
 
@@ -26,5 +71,52 @@ static constexpr uint8_t CMD_12V_ANIMATION = 0x02;
 static constexpr uint8_t CMD_16V_ANIMATION = 0x03;
 static constexpr uint8_t CMD_DEFAULT_ANIMATION = 0x04;
 static constexpr uint8_t CMD_WRONG_ANIMATION = 0x05;
+static constexpr uint8_t LED_ACK_BYTES = 2; // [last accepted cmd, sequence #]
+
+// ----- I2C register map -----
+// a write starting with a byte < 0x80 is a legacy command, same as writing
+// [cmd, params...] to LED_REG_COMMAND. any other write of a register address
+// just moves the read pointer, which falls back to LED_REG_ACK_CMD after every
+// read, so a bare read always returns the 2 byte ack
+static constexpr uint8_t LED_REG_BASE = 0x80;
+static constexpr uint8_t LED_REG_ACK_CMD = 0x80;       // last accepted cmd
+static constexpr uint8_t LED_REG_ACK_SEQ = 0x81;       // bumps per accepted cmd
+static constexpr uint8_t LED_REG_STATUS = 0x82;        // LED_STATUS_* bits
+static constexpr uint8_t LED_REG_QUEUE_DEPTH = 0x83;   // commands not yet taken
+static constexpr uint8_t LED_REG_QUEUE_DROPPED = 0x84; // ring full, saturates
+static constexpr uint8_t LED_REG_ANIMATION = 0x85;     // animation on the strip
+static constexpr uint8_t LED_REG_FRAMES = 0x86;        // u16 LE, last stats window
+static constexpr uint8_t LED_REG_MAX_FRAME_US = 0x88;  // u16 LE, saturates
+static constexpr uint8_t LED_REG_DROPPED_FRAMES = 0x8A; // u16 LE
+static constexpr uint8_t LED_REG_IDLE_PCT = 0x8C;      // core1 idle %
+static constexpr uint8_t LED_REG_FW_MAJOR = 0x8D;
+static constexpr uint8_t LED_REG_FW_MINOR = 0x8E;
+static constexpr uint8_t LED_REG_MAX_CURRENT = 0x8F;   // 10mA units, saturates
+static constexpr uint8_t LED_REG_COMMAND = 0x90;       // write only: [cmd, params...], reads as 0
+static constexpr uint8_t LED_REG_START_SEQ = 0x91;     // ack sequence # of the last started command
+static constexpr uint8_t LED_REG_START_ERROR_US = 0x92; // u16 LE, its first frame - start target, saturates
+static constexpr uint8_t LED_REG_COUNT = 0x14;         // readable registers
+
+static constexpr uint8_t LED_STATUS_START_PENDING = 0x01;
+static constexpr uint8_t LED_STATUS_SPECIAL_ACTIVE = 0x02; // 6V/12V/... timer running
+static constexpr uint8_t LED_STATUS_QUEUE_FULL = 0x04;
+static constexpr uint8_t LED_STATUS_VM_FAULT = 0x08;
+
+static constexpr uint8_t LED_COMMAND_QUEUE_LEN = 8; // ISR -> loop ring, power of 2
+static constexpr uint8_t FW_VERSION_MAJOR = 1;
+static constexpr uint8_t FW_VERSION_MINOR = 1;
+
+// uploadable animation programs (see AnimationVM.h / ProgramStore.h)
+static constexpr uint8_t CMD_PROGRAM_BEGIN = 0x10;  // [slot, len lo, len hi]
+static constexpr uint8_t CMD_PROGRAM_DATA = 0x11;   // [offset lo, offset hi, bytes...]
+static constexpr uint8_t CMD_PROGRAM_COMMIT = 0x12; // [xor of all program bytes]
+static constexpr uint8_t CMD_PROGRAM_BASE = 0x20;   // play slot n with 0x20 + n
+static constexpr uint8_t PROGRAM_SLOTS = 4;
+static constexpr uint16_t PROGRAM_MAX_BYTES = 256;
+static constexpr uint16_t VM_MAX_STEPS_PER_FRAME = 1024;
+
+// pre-rendered clips in flash (see ClipData.h), play clip n with 0x30 + n
+static constexpr uint8_t CMD_CLIP_BASE = 0x30;
+static constexpr uint8_t MAX_CLIPS = 8;
 
 } // namespace config
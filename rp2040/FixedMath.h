@@ -0,0 +1,54 @@
+#pragma once
+/**
+ * FixedMath.h
+ *
+ * Small fixed-point layer for the animation kernels. The RP2040's M0+ cores
+ * have no FPU, so every float add/mul in a frame is a soft-float library call.
+ *
+ * - Q8.8 in a uint16_t: integer part in the high byte, 1/256 steps below
+ * - angles are a full turn in 16 bits (0x10000 = 2*pi), so wrap is free
+ * - tables are constexpr, they live in flash and cost nothing at boot
+ */
+
+#include <stdint.h>
+
+namespace fixed {
+
+typedef uint16_t q8_8;
+
+constexpr q8_8 toQ8_8(float value) { return q8_8(value * 256.0f + 0.5f); }
+constexpr uint8_t intPart(q8_8 value) { return value >> 8; }
+
+// (sin(2*pi*i/256) + 1) / 2 scaled to 0-255
+inline constexpr uint8_t SINE8_LUT[256] = {
+    128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+    176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+    176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+    128, 124, 121, 118, 115, 112, 109, 106, 103, 100, 97, 93, 90, 88, 85, 82,
+    79, 76, 73, 70, 67, 65, 62, 59, 57, 54, 52, 49, 47, 44, 42, 40,
+    37, 35, 33, 31, 29, 27, 25, 23, 21, 20, 18, 17, 15, 14, 12, 11,
+    10, 9, 7, 6, 5, 5, 4, 3, 2, 2, 1, 1, 1, 0, 0, 0,
+    0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 4, 5, 5, 6, 7, 9,
+    10, 11, 12, 14, 15, 17, 18, 20, 21, 23, 25, 27, 29, 31, 33, 35,
+    37, 40, 42, 44, 47, 49, 52, 54, 57, 59, 62, 65, 67, 70, 73, 76,
+    79, 82, 85, 88, 90, 93, 97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+};
+
+/*
+ * @brief sine of a 16 bit angle, remapped to 0-255. linear interpolation
+ * between LUT entries keeps slow sweeps (breathing) free of visible steps
+ */
+inline uint8_t sin8Lerp(uint16_t angle) {
+  uint8_t index = angle >> 8;
+  uint8_t frac = angle & 0xFF;
+  int16_t a = SINE8_LUT[index];
+  int16_t b = SINE8_LUT[uint8_t(index + 1)];
+  return uint8_t(a + (((b - a) * frac) >> 8));
+}
+
+} // namespace fixed
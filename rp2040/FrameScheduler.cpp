@@ -0,0 +1,61 @@
+#include "FrameScheduler.h"
+#include <Arduino.h>
+
+void TimingHistogram::add(uint32_t us) {
+  uint8_t bin = us ? 32 - __builtin_clz(us) : 0;
+  if (bin >= BINS)
+    bin = BINS - 1;
+  counts[bin]++;
+  if (us > maxUs)
+    maxUs = us;
+}
+
+FrameScheduler::FrameScheduler(uint16_t fps)
+    : fps(fps), periodUs(1000000UL / fps), periodRemainder(1000000UL % fps) {}
+
+void FrameScheduler::setFps(uint16_t newFps) {
+  fps = newFps;
+  periodUs = 1000000UL / newFps;
+  periodRemainder = 1000000UL % newFps;
+  remainderAcc = 0;
+}
+
+void FrameScheduler::restart(unsigned long nowUs) {
+  nextUs = nowUs;
+  remainderAcc = 0;
+}
+
+/*
+ * @brief Checks whether the current frame slot has come up
+ *
+ * @param nowUs micros() at the time of the call
+ * @param jitterUs how far past its slot this frame starts
+ * @param droppedSlots slots that passed entirely while the last frame ran
+ * @return true if a frame should be rendered now
+ */
+bool FrameScheduler::poll(unsigned long nowUs, uint32_t &jitterUs,
+                          uint32_t &droppedSlots) {
+  if ((long)(nowUs - nextUs) < 0) {
+    return false;
+  }
+
+  jitterUs = nowUs - nextUs;
+  droppedSlots = 0;
+  advance();
+
+  // stay on the grid: skip whole slots rather than rendering them back to back
+  while ((long)(nowUs - nextUs) >= 0) {
+    advance();
+    droppedSlots++;
+  }
+  return true;
+}
+
+void FrameScheduler::advance() {
+  nextUs += periodUs;
+  remainderAcc += periodRemainder;
+  if (remainderAcc >= fps) {
+    remainderAcc -= fps;
+    nextUs++;
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+/**
+ * FrameScheduler.h
+ *
+ * Fixed-timestep frame clock for the LED engine, in microseconds.
+ *
+ * - frame slots sit on a fixed grid (1e6 / fps us apart, the remainder is
+ *   spread over the second so 60 fps really is 60 and not 62.5)
+ * - a frame that starts late keeps the grid, so the next one comes sooner
+ *   (catch up). if whole slots were missed they are dropped and counted,
+ *   never rendered in a burst
+ * - restart() re-anchors the grid on an animation change
+ * - setFps() changes the rate on the fly (idle animations run slower)
+ *
+ * TimingHistogram is a log2 histogram cheap enough to fill every frame, used
+ * for compute time, show time and start jitter.
+ */
+
+#include <Arduino.h>
+
+struct TimingHistogram {
+  // bin 0 = 0us, bin n = [2^(n-1), 2^n) us, last bin takes everything above
+  static constexpr uint8_t BINS = 16;
+  uint32_t counts[BINS];
+  uint32_t maxUs;
+
+  void add(uint32_t us);
+  static uint32_t binLowUs(uint8_t bin) { return bin ? 1UL << (bin - 1) : 0; }
+};
+
+struct FrameTimingStats {
+  uint32_t frames;
+  uint32_t droppedFrames; // whole slots skipped because a frame ran long
+  uint32_t idleRateFrames; // frames rendered at IDLE_FPS
+  TimingHistogram computeUs; // rendering the animation step
+  TimingHistogram showUs;    // handing the frame to the strip
+  TimingHistogram jitterUs;  // actual frame start - scheduled slot
+};
+
+class FrameScheduler {
+public:
+  explicit FrameScheduler(uint16_t fps);
+  void setFps(uint16_t newFps); // takes effect from the next slot
+  uint16_t getFps() const { return fps; }
+  void restart(unsigned long nowUs); // next poll() fires right away
+  bool poll(unsigned long nowUs, uint32_t &jitterUs, uint32_t &droppedSlots);
+
+private:
+  void advance();
+
+  uint16_t fps;
+  uint32_t periodUs;
+  uint32_t periodRemainder; // 1e6 % fps, spread as +1us steps
+  uint32_t remainderAcc = 0;
+  unsigned long nextUs = 0;
+};
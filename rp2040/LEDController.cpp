@@ -1,103 +1,442 @@
 #include "LEDController.h"
 #include "Config.h"
+#include "ClipData.h"
+#include "PixelOps.h"
+#include "ProgramStore.h"
 #include <Arduino.h>
 #include <FastLED.h>
 
+namespace {
+// physical outputs are stored back to back in led::physical
+constexpr uint16_t outputStart(uint8_t output) {
+  uint16_t start = 0;
+  for (uint8_t o = 0; o < output; o++) {
+    start += config::LED_OUTPUTS[o].pixels;
+  }
+  return start;
+}
+constexpr uint16_t TOTAL_PHYSICAL_PIXELS = outputStart(config::NUM_LED_OUTPUTS);
+
+constexpr bool segmentsFit() {
+  for (const config::LEDSegment &seg : config::LED_SEGMENTS) {
+    if (seg.output >= config::NUM_LED_OUTPUTS ||
+        seg.offset + seg.length > config::LED_OUTPUTS[seg.output].pixels)
+      return false;
+  }
+  for (const config::LEDOutput &out : config::LED_OUTPUTS) {
+    if (out.pixels > config::LED_MAX_OUTPUT_PIXELS)
+      return false;
+  }
+  return true;
+}
+static_assert(segmentsFit(), "LED_SEGMENTS / LED_OUTPUTS don't fit, check Config.h");
+
+constexpr uint16_t RED_BAR_MAX = config::NUM_LEDS / 2;
+constexpr unsigned long BREATHE_PERIOD_MS = 3000;
+// default rainbow: 0.5 hue per frame at FPS, kept per second so it moves at
+// the same speed whatever rate it is rendered at
+constexpr uint32_t DEFAULT_HUE_Q8_PER_S = uint32_t(fixed::toQ8_8(0.5f)) * config::FPS;
+
+// 6V bar speed per whole LED of bar height, Q8.8. same curve as the old float
+// math, just worked out by the compiler instead of every frame
+struct BarSpeedTable {
+  fixed::q8_8 rising[RED_BAR_MAX + 1];
+  fixed::q8_8 falling[RED_BAR_MAX + 1];
+};
+
+constexpr BarSpeedTable makeBarSpeedTable() {
+  BarSpeedTable t{};
+  for (uint16_t pos = 0; pos <= RED_BAR_MAX; pos++) {
+    float frac = float(pos) / float(config::NUM_LEDS);
+    t.rising[pos] = fixed::toQ8_8(0.1f + (1.0f - frac) * 0.2f); // slows near top
+    t.falling[pos] = fixed::toQ8_8(0.3f + frac * 0.4f); // speeds near bottom
+  }
+  return t;
+}
+
+constexpr BarSpeedTable BAR_SPEED = makeBarSpeedTable();
+} // namespace
+
 namespace led {
-CRGB leds[config::NUM_LEDS];
+alignas(4) CRGB leds[config::NUM_LEDS]; // packed kernels want word alignment
+CRGB physical[TOTAL_PHYSICAL_PIXELS];
 }
 
 void LEDController::initialize() {
-  FastLED.addLeds<WS2815, config::LED_DATA_PIN, GRB>(led::leds, numLEDs);
-  FastLED.setBrightness((255UL * brightness) / 100UL);
+  // PIO + DMA output instead of FastLED.show(), which bit-bangs the strip
+  // with the CPU for the whole frame
+  for (uint8_t o = 0; o < config::NUM_LED_OUTPUTS; o++) {
+    if (!strips[o].begin(config::LED_OUTPUTS[o].pin,
+                         config::LED_OUTPUTS[o].pixels)) {
+      Serial.print("LEDController: strip output init failed, output ");
+      Serial.println(o);
+    }
+  }
+  brightnessScale = (255UL * brightness) / 100UL;
 
   // brief startup sequence
   fill_solid(led::leds, numLEDs, CRGB::Red);
-  FastLED.show();
+  show();
   delay(200);
   fill_solid(led::leds, numLEDs, CRGB::Green);
-  FastLED.show();
+  show();
   delay(200);
   fill_solid(led::leds, numLEDs, CRGB::Blue);
-  FastLED.show();
+  show();
   delay(200);
   fill_solid(led::leds, numLEDs, CRGB::White);
-  FastLED.show();
+  show();
   delay(200);
   fill_solid(led::leds, numLEDs, CRGB::Black);
-  FastLED.show();
+  show();
 
   randomSeed(millis());
+  // the scheduler's grid starts at 0us, anchor it to now or the first poll()
+  // sees every slot since boot as late and dropped
+  restartFrameClock();
+}
+
+bool LEDController::update(uint8_t animationMode) {
+  unsigned long now = micros();
+  // speeding up re-anchors the grid so the new mode doesn't wait out an idle
+  // slot, slowing down just stretches the next one
+  uint16_t fps = frameRateFor(animationMode);
+  if (fps != scheduler.getFps()) {
+    if (fps > scheduler.getFps())
+      forceNextFrame = true;
+    scheduler.setFps(fps);
+  }
+  if (forceNextFrame) {
+    forceNextFrame = false;
+    scheduler.restart(now);
+  }
+
+  uint32_t jitterUs, droppedSlots;
+  if (!scheduler.poll(now, jitterUs, droppedSlots)) {
+    return false;
+  }
+  timingStats.jitterUs.add(jitterUs);
+  timingStats.droppedFrames += droppedSlots;
+
+  unsigned long renderStartUs = micros();
+  compose(animationMode, micros());
+
+  unsigned long showStartUs = micros();
+  timingStats.computeUs.add(showStartUs - renderStartUs);
+  if (pushIfChanged(animationMode)) {
+    timingStats.showUs.add(micros() - showStartUs);
+  }
+  timingStats.frames++;
+  if (fps < FPS)
+    timingStats.idleRateFrames++;
+  return true;
+}
+
+/*
+ * @brief Renders `frames` frames of a mode from a clean start and prints a
+ * hash per frame plus one over the whole run
+ *
+ * the PRNGs are seeded and millis() is replaced by a virtual clock stepping
+ * 1000 / fps, so the same build and arguments always give the same hashes.
+ * nothing goes to the strip, the live animation restarts afterwards
+ *
+ * @param dumpPixels also print every frame as hex (r g b per pixel)
+ */
+void LEDController::renderGolden(uint8_t animationMode, uint16_t frames,
+                                 uint32_t seed, bool dumpPixels) {
+  resetAnimationState();
+  random16_set_seed(seed);
+  randomSeed(seed);
+  uint16_t fps = frameRateFor(animationMode);
+  scheduler.setFps(fps);
+  virtualClock = true;
+
+  uint32_t runHash = FNV_OFFSET;
+  uint32_t totalUs = 0;
+  uint32_t maxUs = 0;
+  for (uint16_t f = 0; f < frames; f++) {
+    virtualMs = uint32_t(f) * 1000UL / fps;
+    unsigned long startUs = micros();
+    compose(animationMode, virtualMs * 1000UL);
+    uint32_t frameUs = micros() - startUs;
+    totalUs += frameUs;
+    if (frameUs > maxUs)
+      maxUs = frameUs;
+
+    uint32_t hash = hashPixels(led::leds, numLEDs * sizeof(CRGB));
+    runHash = hashPixels(led::leds, numLEDs * sizeof(CRGB), runHash);
+    Serial.printf("golden frame=%u hash=%08lx us=%lu\n", f,
+                  (unsigned long)hash, (unsigned long)frameUs);
+    if (dumpPixels) {
+      Serial.print("golden pixels=");
+      const uint8_t *bytes = reinterpret_cast<const uint8_t *>(led::leds);
+      for (uint16_t i = 0; i < numLEDs * sizeof(CRGB); i++) {
+        Serial.printf("%02x", bytes[i]);
+      }
+      Serial.println();
+    }
+  }
+  virtualClock = false;
+
+  Serial.printf("golden mode=0x%02x frames=%u seed=%lu fps=%u hash=%08lx "
+                "us_avg=%lu us_max=%lu\n",
+                animationMode, frames, (unsigned long)seed, fps,
+                (unsigned long)runHash,
+                (unsigned long)(frames ? totalUs / frames : 0),
+                (unsigned long)maxUs);
+
+  resetAnimationState();
+  restartFrameClock();
 }
 
-void LEDController::update(uint8_t animationMode) {
-  unsigned long now = millis();
-  if (now - lastFrameTime < (1000 / FPS)) {
+// back to how a freshly booted controller starts every animation
+void LEDController::resetAnimationState() {
+  layerMode[0] = layerMode[1] = NO_LAYER;
+  activeLayer = 0;
+  fading = false;
+  redBarPos = 0;
+  redBarDir = 1;
+  electronOffset = 0;
+  hue = 0;
+  vmSlot = 0xFF;
+  clipIndex[0] = clipIndex[1] = 0xFF;
+}
+
+/*
+ * @brief Frame rate a mode needs to look smooth
+ *
+ * the default rainbow moves half a hue step per frame at full rate, most of
+ * those frames quantise to the same colour, so it runs at IDLE_FPS. anything
+ * else, or a crossfade in progress, gets the full rate. a mode change that
+ * compose() hasn't picked up yet counts as fading, its first blend frame is
+ * the one being scheduled
+ */
+uint16_t LEDController::frameRateFor(uint8_t animationMode) const {
+  bool fadeStarting = animationMode != layerMode[activeLayer] &&
+                      layerMode[activeLayer] != NO_LAYER &&
+                      config::CROSSFADE_MS > 0;
+  if (animationMode == config::CMD_DEFAULT_ANIMATION && !fading &&
+      !fadeStarting)
+    return config::IDLE_FPS;
+  return FPS;
+}
+
+// ---------------------------------------------------------
+// Layer compositor: a mode change doesn't cut, the outgoing animation keeps
+// running in its own buffer and is blended out over CROSSFADE_MS. each layer
+// keeps its buffer between frames since 16V and FADE programs build on the
+// previous frame
+// ---------------------------------------------------------
+void LEDController::compose(uint8_t animationMode, unsigned long nowUs) {
+  if (animationMode != layerMode[activeLayer]) {
+    if (layerMode[activeLayer] != NO_LAYER && config::CROSSFADE_MS > 0) {
+      activeLayer ^= 1;
+      fading = true;
+      fadeStartUs = nowUs;
+    }
+    layerMode[activeLayer] = animationMode;
+    clipIndex[activeLayer] = 0xFF;
+    fillFrame(layers[activeLayer], numLEDs, CRGB::Black);
+  }
+
+  CRGB *incoming = layers[activeLayer];
+  renderMode(animationMode, activeLayer);
+
+  uint32_t elapsedUs = nowUs - fadeStartUs;
+  if (!fading || elapsedUs >= config::CROSSFADE_MS * 1000UL) {
+    fading = false;
+    memcpy(led::leds, incoming, numLEDs * sizeof(CRGB));
     return;
-  };
-  lastFrameTime = now;
+  }
+
+  // the VM belongs to the incoming layer, an outgoing program fades out
+  // from its last frame
+  uint8_t outgoingMode = layerMode[activeLayer ^ 1];
+  CRGB *outgoing = layers[activeLayer ^ 1];
+  if (!isProgramMode(outgoingMode)) {
+    renderMode(outgoingMode, activeLayer ^ 1);
+  }
 
+  uint16_t amount = (elapsedUs * 256) / (config::CROSSFADE_MS * 1000UL);
+  blendFrames(led::leds, outgoing, incoming, numLEDs, amount);
+}
+
+void LEDController::renderMode(uint8_t animationMode, uint8_t layer) {
+  CRGB *frame = layers[layer];
   switch (animationMode) {
   case config::CMD_6V_ANIMATION:
-    stepAnimation6V();
+    stepAnimation6V(frame);
     break;
   case config::CMD_12V_ANIMATION:
-    stepAnimation12V();
+    stepAnimation12V(frame);
     break;
   case config::CMD_16V_ANIMATION:
-    stepAnimation16V();
+    stepAnimation16V(frame);
     break;
   case config::CMD_DEFAULT_ANIMATION:
-    stepAnimationDefault();
+    stepAnimationDefault(frame);
     break;
   case config::CMD_WRONG_ANIMATION:
-    stepAnimationWrong();
+    stepAnimationWrong(frame);
     break;
+  default:
+    if (isProgramMode(animationMode)) {
+      stepProgram(animationMode - config::CMD_PROGRAM_BASE, frame);
+    } else if (isClipMode(animationMode)) {
+      stepClip(animationMode - config::CMD_CLIP_BASE, layer, frame);
+    }
+    break;
+  }
+}
+
+bool LEDController::isProgramMode(uint8_t animationMode) {
+  return animationMode >= config::CMD_PROGRAM_BASE &&
+         animationMode < config::CMD_PROGRAM_BASE + config::PROGRAM_SLOTS;
+}
+
+bool LEDController::isClipMode(uint8_t animationMode) {
+  return animationMode >= config::CMD_CLIP_BASE &&
+         animationMode < config::CMD_CLIP_BASE + clips::NUM_CLIPS;
+}
+
+// hands the frame to the DMA and returns, rendering of the next frame
+// overlaps with this one going out on the wire
+void LEDController::show() {
+  mapSegments();
+  uint8_t scale = powerLimitedScale();
+  // each output has its own DMA, so these all clock out at the same time
+  for (uint8_t o = 0; o < config::NUM_LED_OUTPUTS; o++) {
+    strips[o].show(led::physical + outputStart(o), scale);
+  }
+  lastPushMs = millis();
+}
+
+// canvas -> physical pixels, every segment shows the whole canvas
+void LEDController::mapSegments() {
+  for (const config::LEDSegment &seg : config::LED_SEGMENTS) {
+    mapSegment(led::physical + outputStart(seg.output) + seg.offset, seg.length,
+               led::leds, numLEDs, seg.reversed);
+  }
+}
+
+/*
+ * @brief Pushes the frame only if it differs from the last one on the strip,
+ * or LED_MIN_REFRESH_MS has passed (the WS2815s latch whatever they got last,
+ * the periodic resend just covers a glitched transfer)
+ *
+ * @return true if the frame went out
+ */
+bool LEDController::pushIfChanged(uint8_t animationMode) {
+  uint32_t hash = hashPixels(led::leds, numLEDs * sizeof(CRGB));
+
+  uint8_t index = modeStatsIndex(animationMode);
+  if (index < MODE_STATS_SLOTS)
+    modeShows[index].frames++;
+
+  bool stale = millis() - lastPushMs >= config::LED_MIN_REFRESH_MS;
+  if (!forcePush && !stale && hash == lastPushHash) {
+    if (index < MODE_STATS_SLOTS)
+      modeShows[index].skipped++;
+    return false;
   }
 
-  FastLED.show();
+  forcePush = false;
+  lastPushHash = hash;
+  show();
+  return true;
+}
+
+/*
+ * @brief Estimates the frame's strip current and dims it if needed
+ *
+ * one pass adding up every channel byte of the physical pixels, the rest is
+ * a handful of integer ops
+ *
+ * @return brightness scale to send, never above brightnessScale
+ */
+uint8_t LEDController::powerLimitedScale() {
+  uint32_t sum = 0;
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(led::physical);
+  for (uint16_t i = 0; i < TOTAL_PHYSICAL_PIXELS * sizeof(CRGB); i++) {
+    sum += bytes[i];
+  }
+
+  const uint32_t idleUa = TOTAL_PHYSICAL_PIXELS * config::LED_IDLE_UA;
+  const uint32_t budgetUa = config::LED_POWER_BUDGET_MA * 1000UL;
+  // current of the channels at scale 255, then scaled down linearly
+  uint32_t fullUa = (sum / 255) * config::LED_CHANNEL_UA_FULL +
+                    ((sum % 255) * config::LED_CHANNEL_UA_FULL) / 255;
+
+  uint8_t scale = brightnessScale;
+  uint32_t drawUa = idleUa + (fullUa / 255) * scale;
+  if (drawUa > budgetUa && fullUa > 0) {
+    uint32_t headroomUa = (budgetUa > idleUa) ? budgetUa - idleUa : 0;
+    uint32_t fit = headroomUa / (fullUa / 255 + 1);
+    scale = (fit < scale) ? fit : scale;
+    drawUa = idleUa + (fullUa / 255) * scale;
+    powerStats.limitedFrames++;
+  }
+
+  powerStats.lastMa = drawUa / 1000;
+  if (powerStats.lastMa > powerStats.maxMa)
+    powerStats.maxMa = powerStats.lastMa;
+  if (scale < powerStats.minScale)
+    powerStats.minScale = scale;
+  return scale;
+}
+
+uint8_t modeStatsIndex(uint8_t animationMode) {
+  if (animationMode >= config::CMD_6V_ANIMATION &&
+      animationMode <= config::CMD_WRONG_ANIMATION)
+    return animationMode - config::CMD_6V_ANIMATION;
+  if (animationMode >= config::CMD_PROGRAM_BASE &&
+      animationMode < config::CMD_PROGRAM_BASE + config::PROGRAM_SLOTS)
+    return 5 + animationMode - config::CMD_PROGRAM_BASE;
+  if (animationMode >= config::CMD_CLIP_BASE &&
+      animationMode < config::CMD_CLIP_BASE + config::MAX_CLIPS)
+    return 5 + config::PROGRAM_SLOTS + animationMode - config::CMD_CLIP_BASE;
+  return 0xFF;
 }
 
 // ---------------------------------------------------------
 // 6V animation: rising and falling red "energy" bar
 // ---------------------------------------------------------
-void LEDController::stepAnimation6V() {
-  fill_solid(led::leds, config::NUM_LEDS, CRGB::Black);
+void LEDController::stepAnimation6V(CRGB *frame) {
+  fillFrame(frame, config::NUM_LEDS, CRGB::Black);
 
-  const int maxPos = config::NUM_LEDS / 2;
-  float speed = (redBarDir == 1)
-                    ? 0.1f + (1.0f - redBarPos / float(config::NUM_LEDS)) *
-                                 0.2f // slows near top
-                    : 0.3f + (redBarPos / float(config::NUM_LEDS)) *
-                                 0.4f; // speeds near bottom
+  const int32_t maxPos = int32_t(RED_BAR_MAX) << 8;
+  uint8_t barIndex = fixed::intPart(redBarPos);
+  int32_t speed = (redBarDir == 1) ? BAR_SPEED.rising[barIndex]
+                                   : BAR_SPEED.falling[barIndex];
 
-  redBarPos += redBarDir * speed;
+  int32_t pos = int32_t(redBarPos) + redBarDir * speed;
 
-  if (redBarPos >= maxPos) {
-    redBarPos = maxPos;
+  if (pos >= maxPos) {
+    pos = maxPos;
     redBarDir = -1;
-  } else if (redBarPos <= 0) {
-    redBarPos = 0;
+  } else if (pos <= 0) {
+    pos = 0;
     redBarDir = 1;
   }
+  redBarPos = pos;
 
-  int barTop = int(redBarPos);
+  int barTop = fixed::intPart(redBarPos);
   for (int i = 0; i <= barTop && i < config::NUM_LEDS; i++) {
-    led::leds[i] = CRGB::Red;
+    frame[i] = CRGB::Red;
   }
 
   if (barTop + 1 < config::NUM_LEDS) {
-    led::leds[barTop + 1] = CRGB(64, 0, 0);
+    frame[barTop + 1] = CRGB(64, 0, 0);
   }
 }
 
 // ---------------------------------------------------------
 // 12V animation: smooth electron flow (in green)
 // ---------------------------------------------------------
-void LEDController::stepAnimation12V() {
+void LEDController::stepAnimation12V(CRGB *frame) {
   for (int i = 0; i < numLEDs; i++) {
     uint8_t wave = sin8(i * 10 + electronOffset);
-    led::leds[i] = CHSV(96, 255, wave); // green hue
+    frame[i] = CHSV(96, 255, wave); // green hue
   }
   electronOffset -= 4;
 }
@@ -105,8 +444,8 @@ void LEDController::stepAnimation12V() {
 // ---------------------------------------------------------
 // 16V animation: blue sparks (arcing)
 // ---------------------------------------------------------
-void LEDController::stepAnimation16V() {
-  fadeToBlackBy(led::leds, numLEDs, 80);
+void LEDController::stepAnimation16V(CRGB *frame) {
+  fadeFrame(frame, numLEDs, 80);
 
   // random bursts
   if (random8() < 40) {
@@ -115,7 +454,7 @@ void LEDController::stepAnimation16V() {
       int pos = random(numLEDs);
       uint8_t hue = 160 + random8(10);
       uint8_t intensity = random8(180, 255);
-      led::leds[pos] = CHSV(hue, 200, intensity);
+      frame[pos] = CHSV(hue, 200, intensity);
     }
   }
 
@@ -125,49 +464,75 @@ void LEDController::stepAnimation16V() {
     for (int i = -2; i <= 2; i++) {
       int p = flashPos + i;
       if (p >= 0 && p < numLEDs)
-        led::leds[p] += CHSV(180, 100, 255);
+        frame[p] += CHSV(180, 100, 255);
     }
   }
 
   // dim background glow
   for (int i = 0; i < numLEDs; i++) {
-    if (led::leds[i].getAverageLight() < 10)
-      led::leds[i] = CRGB(0, 0, 5);
+    if (frame[i].getAverageLight() < 10)
+      frame[i] = CRGB(0, 0, 5);
   }
 }
 
 // ---------------------------------------------------------
 // Wrong animation: full strip glows red
 // ---------------------------------------------------------
-void LEDController::stepAnimationWrong() {
-  unsigned long now = millis();
+void LEDController::stepAnimationWrong(CRGB *frame) {
+  unsigned long now = clockMs();
 
-  // Slower breathing cycle: one full cycle about every 3 seconds
-  float t = now / 3000.0f; // adjust denominator for slower/faster breathing
+  // Slower breathing cycle: one full cycle about every 3 seconds, as a 16 bit
+  // angle (0x10000 = one turn) so the sine is a table lookup
+  uint16_t angle =
+      (uint32_t(now % BREATHE_PERIOD_MS) << 16) / BREATHE_PERIOD_MS;
 
-  // Compute smooth sine wave brightness between 0.0–1.0
-  float breathe = (sin(t * TWO_PI) + 1.0f) / 2.0f; // range 0–1
+  // smooth sine wave brightness between 0–255
+  uint8_t breathe = fixed::sin8Lerp(angle);
 
   // Map to brightness range (e.g., 40–255 for soft breathing)
-  uint8_t brightness = 40 + (uint8_t)(breathe * 215);
+  uint8_t brightness = 40 + (uint16_t(breathe) * 215) / 255;
 
-  // Fill strip with red at the current brightness
-  fill_solid(led::leds, config::NUM_LEDS, CRGB::Red);
-  fadeToBlackBy(led::leds, config::NUM_LEDS, 255 - brightness);
+  // Fill strip with red at the current brightness, scaling the one colour
+  // instead of the whole strip gives the same bytes as fill + fadeToBlackBy
+  fillFrame(frame, config::NUM_LEDS, CRGB(CRGB::Red).nscale8(brightness));
 }
 
 // ---------------------------------------------------------
-// Default animation
+// Uploaded program: copied out of the shared store when it (re)starts so a
+// new upload never changes bytes under the interpreter
 // ---------------------------------------------------------
-void LEDController::stepAnimationDefault() {
-  unsigned long now = millis();
-
-  // clear green strip in default mode
-  fill_solid(led::leds, config::NUM_LEDS, CRGB::Black);
+void LEDController::stepProgram(uint8_t slot, CRGB *frame) {
+  if (reloadProgram || slot != vmSlot) {
+    reloadProgram = false;
+    vmSlot = slot;
+    uint8_t program[config::PROGRAM_MAX_BYTES];
+    uint16_t len = 0;
+    programStore.read(slot, program, len);
+    vm.load(program, len);
+    fill_solid(frame, numLEDs, CRGB::Black);
+  }
+  vm.run(frame, numLEDs);
+}
 
-  // rainbow effect on red strip
-  fill_solid(led::leds, config::NUM_LEDS, CHSV(hue, 80, 180));
-  hue += 0.5; // Increment hue for rainbow cycling
+// ---------------------------------------------------------
+// Pre-rendered clip: decoded out of flash, costs the same whatever the effect
+// ---------------------------------------------------------
+void LEDController::stepClip(uint8_t index, uint8_t layer, CRGB *frame) {
+  bool restart = reloadClip && layer == activeLayer;
+  if (restart || index != clipIndex[layer]) {
+    if (layer == activeLayer)
+      reloadClip = false;
+    clipIndex[layer] = index;
+    clipPlayer[layer].open(clips::CLIPS[index], numLEDs, clockMs());
+  }
+  clipPlayer[layer].render(frame, clockMs());
+}
 
-  FastLED.show();
+// ---------------------------------------------------------
+// Default animation
+// ---------------------------------------------------------
+void LEDController::stepAnimationDefault(CRGB *frame) {
+  // rainbow effect, the whole strip is one colour
+  fillFrame(frame, config::NUM_LEDS, CHSV(fixed::intPart(hue), 80, 180));
+  hue += DEFAULT_HUE_Q8_PER_S / scheduler.getFps(); // rainbow cycling, wraps at 256
 }
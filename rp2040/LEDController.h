@@ -1,43 +1,134 @@
 #ifndef LED_CONTROLLER_H
 #define LED_CONTROLLER_H
 
+#include "AnimationVM.h"
+#include "ClipPlayer.h"
 #include "Config.h"
+#include "FixedMath.h"
+#include "FrameScheduler.h"
+#include "WS2815Driver.h"
 #include <Arduino.h>
 #include <FastLED.h>
 
 namespace led {
-extern CRGB leds[config::NUM_LEDS];
+extern CRGB leds[config::NUM_LEDS]; // logical canvas, composed frame
+extern CRGB physical[];             // every output back to back, after mapping
 }
 
+// per animation mode: frames rendered vs strip pushes skipped as unchanged
+struct ModeShowStats {
+  uint32_t frames;
+  uint32_t skipped;
+};
+// estimated strip current (see LED_*_UA in Config.h), after brightness
+struct PowerStats {
+  uint32_t lastMa;
+  uint32_t maxMa;
+  uint32_t limitedFrames; // frames dimmed to stay inside the budget
+  uint8_t minScale;       // lowest brightness scale the limiter used
+};
+
+static constexpr uint8_t MODE_STATS_SLOTS =
+    5 + config::PROGRAM_SLOTS + config::MAX_CLIPS;
+uint8_t modeStatsIndex(uint8_t animationMode); // 0xFF if not tracked
+
 class LEDController {
 public:
-  LEDController(uint8_t num = config::NUM_LEDS,
+  LEDController(uint16_t num = config::NUM_LEDS,
                 uint8_t brightness = config::LED_BRIGHTNESS,
                 uint16_t fps = config::FPS)
-      : numLEDs(num), brightness(brightness), FPS(fps) {};
+      : numLEDs(num), brightness(brightness), FPS(fps), scheduler(fps) {};
   void initialize();
-  void update(uint8_t animationMode);
+  bool update(uint8_t animationMode); // true if a frame was shown
+  bool idleRate() const { return scheduler.getFps() < FPS; }
+  void restartFrameClock() { // next update() renders and pushes right away
+    forceNextFrame = true;
+    forcePush = true;
+    reloadProgram = true;
+    reloadClip = true;
+  }
+  void renderGolden(uint8_t animationMode, uint16_t frames, uint32_t seed,
+                    bool dumpPixels);
+  WS2815Driver &output(uint8_t index) { return strips[index]; }
+  const FrameTimingStats &timing() const { return timingStats; }
+  AnimationVM &program() { return vm; }
+  void resetTiming() { timingStats = {}; }
+  const ModeShowStats *showStats() const { return modeShows; }
+  void resetShowStats() { memset(modeShows, 0, sizeof(modeShows)); }
+  const PowerStats &power() const { return powerStats; }
+  void resetPowerStats() { powerStats = {0, 0, 0, 255}; }
 
 private:
-  void stepAnimation6V();
-  void stepAnimation12V();
-  void stepAnimation16V();
-  void stepAnimationWrong();
-  void stepAnimationDefault();
+  void compose(uint8_t animationMode, unsigned long nowUs);
+  void renderMode(uint8_t animationMode, uint8_t layer);
+  static bool isProgramMode(uint8_t animationMode);
+  static bool isClipMode(uint8_t animationMode);
+  uint16_t frameRateFor(uint8_t animationMode) const;
+  void resetAnimationState();
+  // animations read time through this so golden runs can fake it
+  unsigned long clockMs() const { return virtualClock ? virtualMs : millis(); }
+
+  void stepAnimation6V(CRGB *frame);
+  void stepAnimation12V(CRGB *frame);
+  void stepAnimation16V(CRGB *frame);
+  void stepAnimationWrong(CRGB *frame);
+  void stepAnimationDefault(CRGB *frame);
+  void stepProgram(uint8_t slot, CRGB *frame);
+  void stepClip(uint8_t index, uint8_t layer, CRGB *frame);
 
-  uint8_t numLEDs;
+  void show();
+  void mapSegments();
+  uint8_t powerLimitedScale();
+  bool pushIfChanged(uint8_t animationMode);
+
+  uint16_t numLEDs;
   uint8_t brightness;
+  uint8_t brightnessScale = 0; // brightness % mapped to 0-255
+  WS2815Driver strips[config::NUM_LED_OUTPUTS];
+
+  // dirty-frame detection: hash of the last pushed frame
+  uint32_t lastPushHash = 0;
+  unsigned long lastPushMs = 0;
+  bool forcePush = true;
+  ModeShowStats modeShows[MODE_STATS_SLOTS] = {};
+  PowerStats powerStats = {0, 0, 0, 255};
 
   // shared timing
   const uint16_t FPS;
-  unsigned long lastFrameTime = 0;
+  FrameScheduler scheduler;
+  bool forceNextFrame = false;
+  FrameTimingStats timingStats{};
+  bool virtualClock = false;
+  unsigned long virtualMs = 0;
+
+  // compositor: two layers so the outgoing mode can fade out under the new one
+  // rows rounded up to whole words (4 pixels = 3 words) so both layers stay
+  // aligned for the packed kernels in PixelOps
+  static constexpr uint8_t NO_LAYER = 0xFF;
+  static constexpr uint16_t LAYER_PIXELS = (config::NUM_LEDS + 3) & ~3;
+  alignas(4) CRGB layers[2][LAYER_PIXELS];
+  uint8_t layerMode[2] = {NO_LAYER, NO_LAYER};
+  uint8_t activeLayer = 0;
+  bool fading = false;
+  unsigned long fadeStartUs = 0;
 
   // animation states
   const int maxRedBarPos = numLEDs / 2;
-  float redBarPos = 0.0f;
+  fixed::q8_8 redBarPos = 0; // fixed point, no FPU on the M0+
   int8_t redBarDir = 1;
   int8_t electronOffset = 0;
-  float hue = 0.0f;
+  fixed::q8_8 hue = 0;
+
+  // uploaded programs (CMD_PROGRAM_BASE + slot)
+  AnimationVM vm;
+  uint8_t vmSlot = 0xFF;
+  bool reloadProgram = false;
+
+  // pre-rendered clips (CMD_CLIP_BASE + index), a player per layer so a
+  // clip -> clip crossfade keeps both playheads
+  ClipPlayer clipPlayer[2];
+  uint8_t clipIndex[2] = {0xFF, 0xFF};
+  bool reloadClip = false; // restarts the incoming layer's clip
 };
 
 #endif
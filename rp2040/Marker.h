@@ -0,0 +1,26 @@
+#pragma once
+/**
+ * Marker.h
+ *
+ * Optional GPIO marker for the LED side of a latency measurement:
+ * MARKER_FIRST_FRAME_PIN (Config.h) pulses when core1 has handed the first
+ * frame of a new animation to the strip. Compare it with the MKR's LED
+ * command marker on the same logic analyzer capture.
+ *
+ * MARKERS_ENABLED 0 compiles it out.
+ */
+
+#define MARKERS_ENABLED 0
+
+#if MARKERS_ENABLED
+#define MARKER_INIT(pin) pinMode(pin, OUTPUT)
+#define MARKER_PULSE(pin)                                                      \
+  do {                                                                         \
+    digitalWrite(pin, HIGH);                                                   \
+    delayMicroseconds(2);                                                      \
+    digitalWrite(pin, LOW);                                                    \
+  } while (0)
+#else
+#define MARKER_INIT(pin)
+#define MARKER_PULSE(pin)
+#endif
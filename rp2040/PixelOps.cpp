@@ -0,0 +1,284 @@
+#include "PixelOps.h"
+#include "Config.h"
+#include <Arduino.h>
+#include <string.h>
+
+namespace {
+constexpr uint32_t EVEN_BYTES = 0x00FF00FFUL; // two 16-bit lanes for multiplies
+constexpr uint32_t HIGH_BITS = 0x80808080UL;
+constexpr uint32_t ONES = 0x01010101UL;
+
+// the M0+ faults on unaligned word access, and memcpy from an unknown
+// alignment compiles to byte loads. callers only pass aligned addresses
+inline uint32_t load32(const uint8_t *p) {
+  uint32_t w;
+  memcpy(&w, __builtin_assume_aligned(p, 4), 4);
+  return w;
+}
+inline void store32(uint8_t *p, uint32_t w) {
+  memcpy(__builtin_assume_aligned(p, 4), &w, 4);
+}
+
+/*
+ * @brief out[i] = op(a[i], b[i]) over n bytes, whole words in the middle when
+ * all three buffers share the same alignment, bytes for the rest
+ */
+template <typename WordOp, typename ByteOp>
+inline void packedLoop(uint8_t *out, const uint8_t *a, const uint8_t *b,
+                       uint16_t n, WordOp wordOp, ByteOp byteOp) {
+  uint16_t i = 0;
+  uintptr_t o = reinterpret_cast<uintptr_t>(out);
+  if ((((o ^ reinterpret_cast<uintptr_t>(a)) |
+        (o ^ reinterpret_cast<uintptr_t>(b))) & 3) == 0) {
+    for (; i < n && ((o + i) & 3); i++) {
+      out[i] = byteOp(a[i], b[i]);
+    }
+    for (; i + 4 <= n; i += 4) {
+      store32(out + i, wordOp(load32(a + i), load32(b + i)));
+    }
+  }
+  for (; i < n; i++) {
+    out[i] = byteOp(a[i], b[i]);
+  }
+}
+
+// (x * mul) >> 8 per byte, mul <= 256 so a lane never carries into the next
+inline uint32_t scaleWord(uint32_t w, uint32_t mul) {
+  uint32_t lo = (((w & EVEN_BYTES) * mul) >> 8) & EVEN_BYTES;
+  uint32_t hi = (((w >> 8) & EVEN_BYTES) * mul) & ~EVEN_BYTES;
+  return lo | hi;
+}
+} // namespace
+
+void fillFrame(CRGB *frame, uint16_t count, const CRGB &color) {
+  // 4 pixels = 3 words. pixels one by one until a pixel starts on a word
+  uint16_t i = 0;
+  for (; i < count && (reinterpret_cast<uintptr_t>(frame + i) & 3); i++) {
+    frame[i] = color;
+  }
+  const uint32_t r = color.r, g = color.g, b = color.b;
+  const uint32_t w0 = r | (g << 8) | (b << 16) | (r << 24);
+  const uint32_t w1 = g | (b << 8) | (r << 16) | (g << 24);
+  const uint32_t w2 = b | (r << 8) | (g << 16) | (b << 24);
+  for (; i + 4 <= count; i += 4) {
+    uint8_t *p = reinterpret_cast<uint8_t *>(frame + i);
+    store32(p, w0);
+    store32(p + 4, w1);
+    store32(p + 8, w2);
+  }
+  for (; i < count; i++) {
+    frame[i] = color;
+  }
+}
+
+void scaleFrame(CRGB *frame, uint16_t count, uint8_t scale) {
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(frame);
+  const uint32_t mul = uint32_t(scale) + 1;
+  packedLoop(
+      bytes, bytes, bytes, count * 3,
+      [mul](uint32_t w, uint32_t) { return scaleWord(w, mul); },
+      [mul](uint8_t x, uint8_t) { return uint8_t((x * mul) >> 8); });
+}
+
+void addFrames(CRGB *out, const CRGB *add, uint16_t count) {
+  uint8_t *o = reinterpret_cast<uint8_t *>(out);
+  const uint8_t *a = reinterpret_cast<const uint8_t *>(add);
+  packedLoop(
+      o, o, a, count * 3,
+      [](uint32_t x, uint32_t y) {
+        // add the low 7 bits, then fix up bit 7 and its carry out by hand
+        uint32_t sum = ((x & ~HIGH_BITS) + (y & ~HIGH_BITS)) ^
+                       ((x ^ y) & HIGH_BITS);
+        uint32_t carry = ((x & y) | ((x | y) & ~sum)) & HIGH_BITS;
+        return sum | ((carry >> 7) * 0xFF);
+      },
+      [](uint8_t x, uint8_t y) {
+        uint16_t sum = x + y;
+        return uint8_t(sum > 255 ? 255 : sum);
+      });
+}
+
+void thresholdFrame(CRGB *frame, uint16_t count, uint8_t level) {
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(frame);
+  const uint32_t t = level * ONES;
+  packedLoop(
+      bytes, bytes, bytes, count * 3,
+      [t](uint32_t w, uint32_t) {
+        // x >= t per byte: compare the low 7 bits with bit 7 set as a borrow
+        // stop, then settle it on bit 7 itself
+        uint32_t low = (w | HIGH_BITS) - (t & ~HIGH_BITS);
+        uint32_t ge = ((w & ~t) | (~(w ^ t) & low)) & HIGH_BITS;
+        return w & ((ge >> 7) * 0xFF);
+      },
+      [level](uint8_t x, uint8_t) { return uint8_t(x < level ? 0 : x); });
+}
+
+void blendFrames(CRGB *out, const CRGB *from, const CRGB *to, uint16_t count,
+                 uint16_t amount) {
+  const uint32_t keep = 256 - amount;
+  packedLoop(
+      reinterpret_cast<uint8_t *>(out),
+      reinterpret_cast<const uint8_t *>(from),
+      reinterpret_cast<const uint8_t *>(to), count * 3,
+      [keep, amount](uint32_t a, uint32_t b) {
+        // keep + amount = 256, so a lane tops out at 255 * 256
+        uint32_t lo = (((a & EVEN_BYTES) * keep + (b & EVEN_BYTES) * amount) >>
+                       8) & EVEN_BYTES;
+        uint32_t hi = (((a >> 8) & EVEN_BYTES) * keep +
+                       ((b >> 8) & EVEN_BYTES) * amount) & ~EVEN_BYTES;
+        return lo | hi;
+      },
+      [keep, amount](uint8_t a, uint8_t b) {
+        return uint8_t((a * keep + b * amount) >> 8);
+      });
+}
+
+void mapSegment(CRGB *out, uint16_t length, const CRGB *canvas,
+                uint16_t canvasLength, bool reversed) {
+  if (length == 0)
+    return;
+  uint32_t step = (uint32_t(canvasLength) << 16) / length;
+  uint32_t src = 0;
+  for (uint16_t i = 0; i < length; i++) {
+    out[reversed ? length - 1 - i : i] = canvas[src >> 16];
+    src += step;
+  }
+}
+
+uint32_t hashPixels(const void *data, uint16_t bytes, uint32_t hash) {
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  for (uint16_t i = 0; i < bytes; i++) {
+    hash = (hash ^ p[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+// ========== BENCH ==========
+namespace {
+constexpr uint16_t BENCH_SIZES[] = {config::NUM_LEDS, 300, 1000};
+constexpr uint16_t BENCH_MAX_PIXELS = 1000;
+constexpr uint8_t BENCH_ROUNDS = 20;
+
+alignas(4) CRGB benchA[BENCH_MAX_PIXELS];
+alignas(4) CRGB benchB[BENCH_MAX_PIXELS];
+alignas(4) CRGB benchOut[BENCH_MAX_PIXELS];
+alignas(4) CRGB benchRef[BENCH_MAX_PIXELS];
+
+// scalar versions the packed kernels replaced, for timing and to check the
+// packed ones give the same bytes
+void scalarFill(CRGB *out, uint16_t n) { fill_solid(out, n, CRGB(12, 34, 56)); }
+void packedFill(CRGB *out, uint16_t n) { fillFrame(out, n, CRGB(12, 34, 56)); }
+void scalarScale(CRGB *out, uint16_t n) { nscale8(out, n, 200); }
+void packedScale(CRGB *out, uint16_t n) { scaleFrame(out, n, 200); }
+void scalarFade(CRGB *out, uint16_t n) { fadeToBlackBy(out, n, 80); }
+void packedFade(CRGB *out, uint16_t n) { fadeFrame(out, n, 80); }
+void scalarAdd(CRGB *out, uint16_t n) {
+  for (uint16_t i = 0; i < n; i++) {
+    out[i] += benchB[i];
+  }
+}
+void packedAdd(CRGB *out, uint16_t n) { addFrames(out, benchB, n); }
+void scalarBlend(CRGB *out, uint16_t n) {
+  const uint8_t *a = reinterpret_cast<const uint8_t *>(benchA);
+  const uint8_t *b = reinterpret_cast<const uint8_t *>(benchB);
+  uint8_t *o = reinterpret_cast<uint8_t *>(out);
+  for (uint16_t i = 0; i < n * 3; i++) {
+    o[i] = (a[i] * 156 + b[i] * 100) >> 8;
+  }
+}
+void packedBlend(CRGB *out, uint16_t n) {
+  blendFrames(out, benchA, benchB, n, 100);
+}
+void scalarThreshold(CRGB *out, uint16_t n) {
+  uint8_t *o = reinterpret_cast<uint8_t *>(out);
+  for (uint16_t i = 0; i < n * 3; i++) {
+    if (o[i] < 90)
+      o[i] = 0;
+  }
+}
+void packedThreshold(CRGB *out, uint16_t n) { thresholdFrame(out, n, 90); }
+
+struct BenchKernel {
+  const char *name;
+  void (*scalar)(CRGB *, uint16_t);
+  void (*packed)(CRGB *, uint16_t);
+};
+const BenchKernel BENCH_KERNELS[] = {
+    {"fill", scalarFill, packedFill},
+    {"scale", scalarScale, packedScale},
+    {"fade", scalarFade, packedFade},
+    {"add", scalarAdd, packedAdd},
+    {"blend", scalarBlend, packedBlend},
+    {"threshold", scalarThreshold, packedThreshold},
+};
+
+// per call, averaged over BENCH_ROUNDS calls on the same buffer
+float timeKernel(void (*kernel)(CRGB *, uint16_t), CRGB *buf, uint16_t n) {
+  memcpy(buf, benchA, n * sizeof(CRGB));
+  unsigned long startUs = micros();
+  for (uint8_t round = 0; round < BENCH_ROUNDS; round++) {
+    kernel(buf, n);
+  }
+  return float(micros() - startUs) / BENCH_ROUNDS;
+}
+} // namespace
+
+void benchPixelOps() {
+  for (uint16_t i = 0; i < BENCH_MAX_PIXELS; i++) {
+    benchA[i] = CRGB(i, i * 3, i * 7);
+    benchB[i] = CRGB(255 - i, i * 5, i * 11);
+  }
+
+  const uint32_t budgetUs = 1000000UL / config::FPS;
+  for (const BenchKernel &k : BENCH_KERNELS) {
+    for (uint16_t pixels : BENCH_SIZES) {
+      // one call each from the same input, the outputs have to match
+      memcpy(benchRef, benchA, pixels * sizeof(CRGB));
+      memcpy(benchOut, benchA, pixels * sizeof(CRGB));
+      k.scalar(benchRef, pixels);
+      k.packed(benchOut, pixels);
+      bool match = memcmp(benchRef, benchOut, pixels * sizeof(CRGB)) == 0;
+
+      float scalarUs = timeKernel(k.scalar, benchRef, pixels);
+      float packedUs = timeKernel(k.packed, benchOut, pixels);
+
+      Serial.print("bench kernel=");
+      Serial.print(k.name);
+      Serial.print(" pixels=");
+      Serial.print(pixels);
+      Serial.print(" scalar_us=");
+      Serial.print(scalarUs, 1);
+      Serial.print(" packed_us=");
+      Serial.print(packedUs, 1);
+      Serial.print(" speedup=");
+      Serial.print(packedUs > 0 ? scalarUs / packedUs : 0.0f, 2);
+      Serial.print(" budget_pct=");
+      Serial.print((100.0f * packedUs) / budgetUs, 1);
+      Serial.print(" match=");
+      Serial.println(match ? 1 : 0);
+    }
+  }
+
+  // segment mapping of the real canvas onto strips of growing length, plus
+  // the wire time of that many pixels (split across outputs they overlap)
+  for (uint16_t pixels : BENCH_SIZES) {
+    unsigned long startUs = micros();
+    for (uint8_t round = 0; round < BENCH_ROUNDS; round++) {
+      mapSegment(benchOut, pixels, benchA, config::NUM_LEDS, round & 1);
+    }
+    uint32_t perFrameUs = (micros() - startUs) / BENCH_ROUNDS;
+    uint32_t wireUs = pixels * config::WS2815_BIT_US_X100 * 24 / 100 +
+                      config::WS2815_RESET_US;
+
+    Serial.print("bench kernel=map pixels=");
+    Serial.print(pixels);
+    Serial.print(" us=");
+    Serial.print(perFrameUs);
+    Serial.print(" budget_pct=");
+    Serial.print((100.0f * perFrameUs) / budgetUs, 1);
+    Serial.print(" wire_us_one_output=");
+    Serial.print(wireUs);
+    Serial.print(" fps_ceiling_one_output=");
+    Serial.println(1000000UL / wireUs);
+  }
+}
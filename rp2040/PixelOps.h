@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * PixelOps.h
+ *
+ * Whole-frame pixel kernels used by the LEDController compositor, plus an
+ * on-device bench ("b" on USB serial) that times them at several strip
+ * lengths against the frame budget.
+ *
+ * The fill/scale/fade/add/blend/threshold kernels are packed (SWAR): the frame
+ * is treated as a plain byte stream and 4 channel bytes are handled per 32-bit
+ * word, two 16-bit lanes at a time where a multiply is needed. They give the
+ * exact same bytes as the FastLED call or scalar loop they replace. Word access
+ * needs every buffer at the same offset mod 4 (4-byte aligned buffers with
+ * whole-word rows, see LEDController::layers), otherwise they fall back to
+ * one byte at a time.
+ */
+
+#include "Config.h"
+#include <Arduino.h>
+#include <FastLED.h>
+
+// = fill_solid()
+void fillFrame(CRGB *frame, uint16_t count, const CRGB &color);
+// = nscale8(): channel * (scale + 1) >> 8
+void scaleFrame(CRGB *frame, uint16_t count, uint8_t scale);
+// = fadeToBlackBy()
+inline void fadeFrame(CRGB *frame, uint16_t count, uint8_t fadeBy) {
+  scaleFrame(frame, count, 255 - fadeBy);
+}
+// out += add, saturating at 255 per channel (= CRGB +=)
+void addFrames(CRGB *out, const CRGB *add, uint16_t count);
+// channels below `level` go to 0, the rest are kept
+void thresholdFrame(CRGB *frame, uint16_t count, uint8_t level);
+
+/*
+ * @brief out = from * (256 - amount) + to * amount, per 8-bit channel
+ *
+ * @param amount 0 = all `from`, 256 = all `to`
+ */
+void blendFrames(CRGB *out, const CRGB *from, const CRGB *to, uint16_t count,
+                 uint16_t amount);
+
+/*
+ * @brief Stretches/squeezes `canvas` onto `length` physical pixels
+ * (nearest neighbour, 16.16 step), optionally back to front
+ */
+void mapSegment(CRGB *out, uint16_t length, const CRGB *canvas,
+                uint16_t canvasLength, bool reversed);
+
+/*
+ * @brief FNV-1a over raw bytes, ~1 multiply per byte. pass the previous result
+ * as `hash` to chain several buffers
+ */
+static constexpr uint32_t FNV_OFFSET = 2166136261UL;
+uint32_t hashPixels(const void *data, uint16_t bytes, uint32_t hash = FNV_OFFSET);
+
+void benchPixelOps(); // prints results to Serial, takes ~100ms
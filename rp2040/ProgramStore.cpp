@@ -0,0 +1,70 @@
+#include "ProgramStore.h"
+#include "Config.h"
+#include <Arduino.h>
+
+ProgramStore programStore;
+
+bool ProgramStore::beginUpload(uint8_t slot, uint16_t len) {
+  if (slot >= config::PROGRAM_SLOTS || len == 0 ||
+      len > config::PROGRAM_MAX_BYTES) {
+    uploading = false;
+    return false;
+  }
+  stagedSlot = slot;
+  stagedLen = len;
+  memset(staged, 0, sizeof(staged));
+  uploading = true;
+  return true;
+}
+
+bool ProgramStore::writeChunk(uint16_t offset, const uint8_t *data,
+                              uint8_t n) {
+  if (!uploading || offset + n > stagedLen)
+    return false;
+  memcpy(staged + offset, data, n);
+  return true;
+}
+
+bool ProgramStore::commit(uint8_t checksum) {
+  if (!uploading)
+    return false;
+  uploading = false;
+
+  uint8_t sum = 0;
+  for (uint16_t i = 0; i < stagedLen; i++) {
+    sum ^= staged[i];
+  }
+  if (sum != checksum)
+    return false;
+
+  // single writer, so plain load+store on the version is enough
+  uint32_t v = version.load(std::memory_order_relaxed);
+  version.store(v + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(slots[stagedSlot].code, staged, stagedLen);
+  slots[stagedSlot].len = stagedLen;
+  version.store(v + 2, std::memory_order_release);
+  return true;
+}
+
+bool ProgramStore::valid(uint8_t slot) const {
+  return slot < config::PROGRAM_SLOTS && slots[slot].len != 0;
+}
+
+bool ProgramStore::read(uint8_t slot, uint8_t *dst, uint16_t &len) const {
+  if (slot >= config::PROGRAM_SLOTS)
+    return false;
+
+  uint32_t before, after;
+  do {
+    before = version.load(std::memory_order_acquire);
+    len = slots[slot].len;
+    if (len > config::PROGRAM_MAX_BYTES)
+      len = 0;
+    memcpy(dst, slots[slot].code, len);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = version.load(std::memory_order_relaxed);
+  } while ((before & 1) || before != after);
+
+  return len != 0;
+}
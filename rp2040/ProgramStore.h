@@ -0,0 +1,48 @@
+#pragma once
+/**
+ * ProgramStore.h
+ *
+ * RAM slots for uploaded AnimationVM programs, shared between the two cores.
+ *
+ * Upload (I2C chunks from receiveEvent, or one USB serial line on core0):
+ *   beginUpload(slot, len) -> writeChunk(offset, bytes, n)... -> commit(xor)
+ *   the program is staged and only copied into its slot once the checksum
+ *   matches, so a half uploaded program never runs
+ *
+ * Slots are written by core0 only and read by core1 with read(). A version
+ * counter (seqlock) lets core1 copy without a lock: it retries if a commit
+ * happened mid-copy. Programs are lost on reset (RAM only).
+ */
+
+#include "Config.h"
+#include <Arduino.h>
+#include <atomic>
+
+class ProgramStore {
+public:
+  // ---- core0 (ISR or loop with interrupts off) ----
+  bool beginUpload(uint8_t slot, uint16_t len);
+  bool writeChunk(uint16_t offset, const uint8_t *data, uint8_t n);
+  bool commit(uint8_t checksum); // xor of every program byte
+
+  // ---- any core ----
+  bool valid(uint8_t slot) const;
+  // copy a slot out, false if it is empty
+  bool read(uint8_t slot, uint8_t *dst, uint16_t &len) const;
+
+private:
+  struct Slot {
+    uint8_t code[config::PROGRAM_MAX_BYTES];
+    uint16_t len; // 0 = empty
+  };
+
+  Slot slots[config::PROGRAM_SLOTS] = {};
+  std::atomic<uint32_t> version{0}; // odd while a commit is copying
+
+  uint8_t staged[config::PROGRAM_MAX_BYTES];
+  uint16_t stagedLen = 0;
+  uint8_t stagedSlot = 0;
+  bool uploading = false;
+};
+
+extern ProgramStore programStore;
@@ -0,0 +1,128 @@
+#include "WS2815Driver.h"
+#include "Config.h"
+#include <Arduino.h>
+#include <hardware/clocks.h>
+
+// ----- PIO PROGRAM -----
+// the standard ws2812 program from pico-examples (pioasm output), 10 PIO
+// cycles per bit: T1=2 low, T2=5 high (long for a 1, short for a 0), T3=3
+//   .side_set 1
+//   bitloop:
+//     out x, 1        side 0 [2]
+//     jmp !x do_zero  side 1 [1]
+//     jmp bitloop     side 1 [4]
+//   do_zero:
+//     nop             side 0 [4]
+namespace {
+constexpr uint8_t WS2815_CYCLES_PER_BIT = 10;
+const uint16_t ws2815Instructions[] = {0x6221, 0x1123, 0x1400, 0xa442};
+const pio_program ws2815Program = {ws2815Instructions, 4, -1};
+
+/*
+ * @brief same idea as FastLED's scale8_video: anything lit stays at least 1 so
+ * the dim background glows don't disappear at low brightness
+ */
+inline uint32_t scaleChannel(uint8_t c, uint8_t scale) {
+  return ((uint16_t(c) * scale) >> 8) + ((c && scale) ? 1 : 0);
+}
+} // namespace
+
+bool WS2815Driver::begin(uint8_t pin, uint16_t count) {
+  numPixels = (count < config::LED_MAX_OUTPUT_PIXELS)
+                  ? count
+                  : config::LED_MAX_OUTPUT_PIXELS;
+
+  // arduino-pico may already use a PIO block (SerialPIO, tone...), take
+  // whichever one still has room. every output on a block shares one copy of
+  // the program
+  static int programOffset[2] = {-1, -1};
+  PIO candidates[] = {pio0, pio1};
+  int claimed = -1;
+  uint offset = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    if (programOffset[i] < 0 &&
+        !pio_can_add_program(candidates[i], &ws2815Program))
+      continue;
+    claimed = pio_claim_unused_sm(candidates[i], false);
+    if (claimed < 0)
+      continue;
+    pio = candidates[i];
+    if (programOffset[i] < 0)
+      programOffset[i] = pio_add_program(pio, &ws2815Program);
+    offset = programOffset[i];
+    break;
+  }
+  if (claimed < 0) {
+    Serial.println("WS2815Driver: no free PIO state machine");
+    return false;
+  }
+  sm = claimed;
+
+  pio_gpio_init(pio, pin);
+  pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, true);
+
+  pio_sm_config c = pio_get_default_sm_config();
+  sm_config_set_wrap(&c, offset, offset + 3);
+  sm_config_set_sideset(&c, 1, false, false);
+  sm_config_set_sideset_pins(&c, pin);
+  sm_config_set_out_shift(&c, false, true, 24); // MSB first, autopull 24 bits
+  sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX); // 8 deep TX FIFO
+  sm_config_set_clkdiv(&c, float(clock_get_hz(clk_sys)) /
+                               (config::WS2815_BIT_HZ * WS2815_CYCLES_PER_BIT));
+  pio_sm_init(pio, sm, offset, &c);
+  pio_sm_set_enabled(pio, sm, true);
+
+  // one word per pixel, paced by the state machine's TX FIFO
+  dmaChannel = dma_claim_unused_channel(true);
+  dma_channel_config dc = dma_channel_get_default_config(dmaChannel);
+  channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+  channel_config_set_read_increment(&dc, true);
+  channel_config_set_write_increment(&dc, false);
+  channel_config_set_dreq(&dc, pio_get_dreq(pio, sm, true));
+  dma_channel_configure(dmaChannel, &dc, &pio->txf[sm], frames[0], numPixels,
+                        false);
+
+  readyAtUs = micros();
+  return true;
+}
+
+bool WS2815Driver::busy() const {
+  return dma_channel_is_busy(dmaChannel) || (long)(micros() - readyAtUs) < 0;
+}
+
+/*
+ * @brief Queues a frame for output and returns as soon as the DMA is running
+ *
+ * @param pixels numPixels CRGB values, copied so the caller can start on the
+ * next frame straight away
+ * @param scale global brightness, 0-255
+ */
+void WS2815Driver::show(const CRGB *pixels, uint8_t scale) {
+  if (dmaChannel < 0)
+    return;
+
+  // the back buffer went out two frames ago, safe to overwrite while the
+  // front one is still being clocked
+  uint32_t *out = frames[backIndex];
+  for (uint16_t i = 0; i < numPixels; i++) {
+    out[i] = (scaleChannel(pixels[i].g, scale) << 24) |
+             (scaleChannel(pixels[i].r, scale) << 16) |
+             (scaleChannel(pixels[i].b, scale) << 8);
+  }
+
+  // the DMA finishes while the last words are still in the FIFO, so the real
+  // gate is the wire time + reset gap worked out when the transfer started
+  unsigned long waitStartUs = micros();
+  while (busy()) {
+  }
+  uint32_t waitedUs = micros() - waitStartUs;
+  stats.waitUs += waitedUs;
+  if (waitedUs > stats.maxWaitUs)
+    stats.maxWaitUs = waitedUs;
+
+  dma_channel_set_trans_count(dmaChannel, numPixels, false);
+  dma_channel_set_read_addr(dmaChannel, out, true);
+  readyAtUs = micros() + frameSlotUs();
+  backIndex ^= 1;
+  stats.shows++;
+}
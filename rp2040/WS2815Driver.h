@@ -0,0 +1,64 @@
+#pragma once
+/**
+ * WS2815Driver.h
+ *
+ * Strip output for the WS2815 using one PIO state machine fed by DMA, so the
+ * CPU never bit-bangs the data line.
+ *
+ * - show() converts the CRGB frame (with brightness applied) into whichever of
+ *   the two word buffers is not being clocked out, then starts the DMA and
+ *   returns. the next frame is rendered while this one goes out on the wire
+ * - the only wait left is when show() is called again before the previous
+ *   frame + the WS2815 reset gap have finished, that time is counted in
+ *   getStats() so the headroom can be measured
+ *
+ * Several drivers can run side by side (one per output), each claims its own
+ * state machine and DMA channel so their transfers overlap.
+ *
+ * Usage (core1 only, not thread safe):
+ *   WS2815Driver strip;
+ *   strip.begin(config::LED_DATA_PIN, 300);
+ *   strip.show(pixels, 25);
+ */
+
+#include "Config.h"
+#include <Arduino.h>
+#include <FastLED.h>
+#include <hardware/dma.h>
+#include <hardware/pio.h>
+
+struct StripOutputStats {
+  uint32_t shows;
+  uint32_t waitUs;    // show() blocked on the previous transfer / reset gap
+  uint32_t maxWaitUs;
+};
+
+class WS2815Driver {
+public:
+  bool begin(uint8_t pin, uint16_t count);
+  void show(const CRGB *pixels, uint8_t scale); // scale 0-255, like setBrightness
+  bool busy() const; // previous frame still on the wire
+
+  // time one frame occupies the data line (bits + reset gap), the floor on
+  // frame period no matter how fast rendering gets
+  uint32_t frameSlotUs() const {
+    return numPixels * config::WS2815_BIT_US_X100 * 24 / 100 +
+           config::WS2815_RESET_US;
+  }
+
+  const StripOutputStats &getStats() const { return stats; }
+  void resetStats() { stats = {}; }
+
+private:
+  PIO pio = nullptr;
+  uint sm = 0;
+  int dmaChannel = -1;
+  uint16_t numPixels = 0;
+
+  // GRB packed into the top 24 bits, the PIO shifts out MSB first
+  uint32_t frames[2][config::LED_MAX_OUTPUT_PIXELS];
+  uint8_t backIndex = 0;
+  unsigned long readyAtUs = 0; // earliest time the next transfer may start
+
+  StripOutputStats stats{};
+};
@@ -1,49 +1,557 @@
 #include <Wire.h>
+#include <atomic>
 #include "LEDController.h"
+#include "PixelOps.h"
+#include "ProgramStore.h"
+#include "ClipData.h"
 #include "Config.h"
+#include "Marker.h"
 
-LEDController ledController;
+// core0: I2C slave (receiveEvent/requestEvent) + animation bookkeeping
+// core1: LED engine (render + PIO/DMA strip output), never blocks core0
+LEDController ledController;  // only touched from core1
+
+// ----- I2C slave: register file + command ring -----
+// the I2C ISR (producer) pushes accepted commands, loop() (consumer) takes
+// them in order. free running uint8_t indices, each written by one side only
+struct QueuedCommand {
+  uint8_t cmd;
+  uint8_t startDelayMs;  // optional param: start in N ms
+  unsigned long receivedUs;
+  uint8_t sequence;  // LED_REG_ACK_SEQ it was acked with, for the start report
+};
+static_assert(256 % config::LED_COMMAND_QUEUE_LEN == 0, "LED_COMMAND_QUEUE_LEN must be a power of two");
+QueuedCommand commandRing[config::LED_COMMAND_QUEUE_LEN];
+std::atomic<uint8_t> commandHead{ 0 };  // loop() only
+std::atomic<uint8_t> commandTail{ 0 };  // ISR only
+
+// LED_REG_BASE.. image served by requestEvent. ack bytes are written by the
+// ISR, everything else by loop() with interrupts off
+uint8_t regFile[config::LED_REG_COUNT] = {};
+volatile uint8_t regPointer = config::LED_REG_ACK_CMD;
 
-volatile uint8_t currentAnimation = 0xFF;
-volatile bool gotNewCommand = false;
 uint8_t animation = 0xFF;
 uint8_t lastPlayedAnimation = 0xFF;  // Track last animation to detect changes
 unsigned long animationEndTimestamp = 0;
 
+// reaction timeline: the MKR Zero tells us when the sound will be heard, the
+// new animation starts at that moment and we report how close we got
+uint8_t pendingAnimation = 0xFF;
+uint8_t pendingSequence = 0;
+bool animationStartPending = false;
+unsigned long animationStartUs = 0;
+uint8_t restartCount = 0;
+
+// ----- core0 -> core1 mailbox -----
+// one 32-bit word so it is published/read atomically without a lock:
+// bits 0-7 = animation to render, bits 8-15 = restart counter (bumped when
+// core1 should push the first frame of a new animation right away)
+std::atomic<uint32_t> ledMailbox{ config::CMD_DEFAULT_ANIMATION };
+volatile unsigned long mailboxStartUs = 0;  // written before the mailbox word
+volatile uint8_t mailboxSequence = 0;       // same
+
+// restart counter whose first frame core1 has pushed, core0 holds the next
+// queued command back until it catches up with restartCount
+std::atomic<uint8_t> shownRestart{ 0 };
+
+// ----- core1 -> core0 start report -----
+// bits 0-7 = sequence # of the last started command, bits 8-23 = its first
+// frame - start target (us, saturated), copied to LED_REG_START_SEQ.. by core0
+std::atomic<uint32_t> startReport{ 0 };
+
+// ----- per-core stats, printed by core0 every STATS_REPORT_MS -----
+struct FrameStats {
+  uint32_t frames;
+  uint32_t minFrameUs;
+  uint32_t maxFrameUs;
+  uint32_t totalFrameUs;
+  uint32_t busyUs;    // core1 time spent rendering/pushing frames
+  uint32_t windowUs;  // length of the window the numbers cover
+  uint32_t lastStartErrorUs;
+  uint32_t maxStartErrorUs;
+  uint32_t showWaitUs;     // part of busyUs spent waiting on the strip transfer
+  uint32_t maxShowWaitUs;
+  uint32_t frameSlotUs;    // wire time + reset gap of one frame
+  uint32_t pushes;         // frames actually clocked out (DMA + PIO activity)
+  uint32_t lastWakeUs;     // command due (arrival + start delay) -> core1 pickup, at idle rate
+  uint32_t maxWakeUs;
+  FrameTimingStats timing;  // scheduler histograms, dumped on 'h'
+  VMStats vm;               // uploaded program cost (instructions per frame)
+  ModeShowStats modeShows[MODE_STATS_SLOTS];  // strip pushes skipped as unchanged
+  PowerStats power;                           // estimated strip current
+};
+FrameStats publishedFrameStats = {};         // written by core1 only
+std::atomic<uint32_t> frameStatsVersion{ 0 };  // seqlock, odd while core1 copies
+uint32_t core0BusyUs = 0;
+unsigned long core0WindowStartUs = 0;
+FrameStats lastReport = {};  // core0's copy of the latest snapshot
+
+// ----- golden frame runs ("g"/"G" on USB serial) -----
+// core0 fills the request and sets the flag, core1 renders + prints and
+// clears it. core0 waits meanwhile so the two never print at once
+struct GoldenRequest {
+  uint8_t mode;
+  uint16_t frames;
+  uint32_t seed;
+  bool dumpPixels;
+};
+GoldenRequest goldenRequest = {};
+std::atomic<bool> goldenPending{ false };
+
+bool isProgramCommand(uint8_t cmd) {
+  return cmd >= config::CMD_PROGRAM_BASE && cmd < config::CMD_PROGRAM_BASE + config::PROGRAM_SLOTS;
+}
+
+bool isClipCommand(uint8_t cmd) {
+  return cmd >= config::CMD_CLIP_BASE && cmd < config::CMD_CLIP_BASE + clips::NUM_CLIPS;
+}
+
+// program upload over I2C: BEGIN, DATA chunks (<= 30 bytes each), COMMIT
+bool receiveProgramChunk(uint8_t cmd) {
+  uint8_t buf[32];
+  uint8_t n = 0;
+  while (Wire.available() && n < sizeof(buf)) {
+    buf[n++] = Wire.read();
+  }
+  switch (cmd) {
+    case config::CMD_PROGRAM_BEGIN:
+      return n >= 3 && programStore.beginUpload(buf[0], buf[1] | (buf[2] << 8));
+    case config::CMD_PROGRAM_DATA:
+      return n >= 2 && programStore.writeChunk(buf[0] | (buf[1] << 8), buf + 2, n - 2);
+    case config::CMD_PROGRAM_COMMIT:
+      return n >= 1 && programStore.commit(buf[0]);
+  }
+  return false;
+}
+
+void acceptCommand(uint8_t cmd) {
+  regFile[config::LED_REG_ACK_CMD - config::LED_REG_BASE] = cmd;
+  regFile[config::LED_REG_ACK_SEQ - config::LED_REG_BASE]++;
+}
+
+// producer side, only ever called from the I2C ISR (or with interrupts off)
+bool pushCommand(uint8_t cmd, uint8_t startDelayMs, unsigned long receivedUs, uint8_t sequence) {
+  uint8_t tail = commandTail.load(std::memory_order_relaxed);
+  uint8_t head = commandHead.load(std::memory_order_acquire);
+  if ((uint8_t)(tail - head) >= config::LED_COMMAND_QUEUE_LEN) {
+    uint8_t &dropped = regFile[config::LED_REG_QUEUE_DROPPED - config::LED_REG_BASE];
+    if (dropped < 0xFF) dropped++;
+    return false;
+  }
+  commandRing[tail % config::LED_COMMAND_QUEUE_LEN] = { cmd, startDelayMs, receivedUs, sequence };
+  commandTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
 void receiveEvent(int numBytes) {
   if (numBytes <= 0) return;
-  uint8_t cmd = Wire.read();
-  if (cmd == config::CMD_6V_ANIMATION || cmd == config::CMD_12V_ANIMATION || cmd == config::CMD_16V_ANIMATION || cmd == config::CMD_WRONG_ANIMATION) {
-    currentAnimation = cmd;
-    gotNewCommand = true;
-  } else if (cmd == config::CMD_DEFAULT_ANIMATION) {
-    currentAnimation = cmd;
+  unsigned long receivedUs = micros();
+  uint8_t first = Wire.read();
+
+  // register address only: move the read pointer (read only registers ignore data)
+  if (first >= config::LED_REG_BASE && first != config::LED_REG_COMMAND) {
+    regPointer = first;
+    while (Wire.available()) {
+      Wire.read();
+    }
+    return;
+  }
+
+  // [cmd, params...], either legacy (cmd < 0x80) or via LED_REG_COMMAND
+  regPointer = config::LED_REG_ACK_CMD;
+  uint8_t cmd = first;
+  if (first == config::LED_REG_COMMAND) {
+    if (!Wire.available()) return;
+    cmd = Wire.read();
+  }
+
+  if (cmd == config::CMD_PROGRAM_BEGIN || cmd == config::CMD_PROGRAM_DATA || cmd == config::CMD_PROGRAM_COMMIT) {
+    // a rejected chunk is not acked, the uploader restarts from BEGIN
+    if (receiveProgramChunk(cmd)) {
+      acceptCommand(cmd);
+    }
+  } else {
+    uint8_t startDelayMs = Wire.available() ? Wire.read() : 0;
+    bool known = cmd == config::CMD_6V_ANIMATION || cmd == config::CMD_12V_ANIMATION || cmd == config::CMD_16V_ANIMATION
+                 || cmd == config::CMD_WRONG_ANIMATION || cmd == config::CMD_DEFAULT_ANIMATION
+                 || (isProgramCommand(cmd) && programStore.valid(cmd - config::CMD_PROGRAM_BASE)) || isClipCommand(cmd);
+    // unknown command or full ring: no ack, the MKR Zero will retry/give up
+    uint8_t sequence = regFile[config::LED_REG_ACK_SEQ - config::LED_REG_BASE] + 1;  // what acceptCommand makes it
+    if (known && pushCommand(cmd, startDelayMs, receivedUs, sequence)) {
+      acceptCommand(cmd);
+    }
   }
+
   while (Wire.available()) {
     Wire.read();
   }
 }
 
+void requestEvent() {
+  uint8_t index = regPointer - config::LED_REG_BASE;
+  if (index >= config::LED_REG_COUNT) index = 0;
+  Wire.write(regFile + index, config::LED_REG_COUNT - index);
+  regPointer = config::LED_REG_ACK_CMD;
+}
+
 void setup() {
   Serial.begin(115200);
   delay(50);
   Serial.println("RP2040 booting...");
 
+  regFile[config::LED_REG_ACK_CMD - config::LED_REG_BASE] = 0xFF;
+  regFile[config::LED_REG_FW_MAJOR - config::LED_REG_BASE] = config::FW_VERSION_MAJOR;
+  regFile[config::LED_REG_FW_MINOR - config::LED_REG_BASE] = config::FW_VERSION_MINOR;
   Wire.begin(config::LED_CONTROLLER_ADDR);
   Wire.onReceive(receiveEvent);
+  Wire.onRequest(requestEvent);
 
+  core0WindowStartUs = micros();
+}
+
+void setup1() {
   ledController.initialize();
-  Serial.println("LEDController initialized");
+  MARKER_INIT(config::MARKER_FIRST_FRAME_PIN);
+  Serial.println("LEDController initialized (core1)");
+}
+
+void printHistogram(const char *name, const TimingHistogram &h) {
+  Serial.print(name);
+  Serial.print(" max=");
+  Serial.print(h.maxUs);
+  for (uint8_t bin = 0; bin < TimingHistogram::BINS; bin++) {
+    if (h.counts[bin] == 0) continue;
+    Serial.print(" ");
+    Serial.print(TimingHistogram::binLowUs(bin));
+    Serial.print(bin + 1 < TimingHistogram::BINS ? "-" : "+");
+    if (bin + 1 < TimingHistogram::BINS) Serial.print(TimingHistogram::binLowUs(bin + 1) - 1);
+    Serial.print(":");
+    Serial.print(h.counts[bin]);
+  }
+  Serial.println();
+}
+
+// "h" on USB serial: per-frame cost histograms from the last stats window
+void dumpFrameHistograms() {
+  const FrameTimingStats &t = lastReport.timing;
+  Serial.print("frame histograms (us), frames=");
+  Serial.print(t.frames);
+  Serial.print(" dropped=");
+  Serial.println(t.droppedFrames);
+  printHistogram("  compute", t.computeUs);
+  printHistogram("  show   ", t.showUs);
+  printHistogram("  jitter ", t.jitterUs);
+}
+
+void printAnimationName(uint8_t mode) {
+  switch (mode) {
+    case config::CMD_DEFAULT_ANIMATION:
+      Serial.print("DEFAULT");
+      break;
+    case config::CMD_6V_ANIMATION:
+      Serial.print("6V");
+      break;
+    case config::CMD_12V_ANIMATION:
+      Serial.print("12V");
+      break;
+    case config::CMD_16V_ANIMATION:
+      Serial.print("16V");
+      break;
+    case config::CMD_WRONG_ANIMATION:
+      Serial.print("WRONG");
+      break;
+    default:
+      if (isProgramCommand(mode)) {
+        Serial.print("PROGRAM ");
+        Serial.print(mode - config::CMD_PROGRAM_BASE);
+        break;
+      }
+      if (isClipCommand(mode)) {
+        Serial.print("CLIP ");
+        Serial.print(mode - config::CMD_CLIP_BASE);
+        break;
+      }
+      Serial.print("UNKNOWN (");
+      Serial.print(mode);
+      Serial.print(")");
+      break;
+  }
+}
+
+int8_t hexNibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// "P<slot> <hex bytes>": upload a program over USB (spaces between bytes ok)
+void uploadProgramFromSerial(const char *args) {
+  uint8_t slot = args[0] - '0';
+  uint8_t program[config::PROGRAM_MAX_BYTES];
+  uint16_t len = 0;
+  uint8_t checksum = 0;
+  int8_t high = -1;
+  for (const char *c = args + 1; *c; c++) {
+    int8_t nibble = hexNibble(*c);
+    if (nibble < 0) continue;
+    if (high < 0) {
+      high = nibble;
+      continue;
+    }
+    if (len >= sizeof(program)) {
+      Serial.println("program too long");
+      return;
+    }
+    program[len] = (high << 4) | nibble;
+    checksum ^= program[len++];
+    high = -1;
+  }
+
+  // the I2C handler uses the same staging buffer, keep it out while we write
+  noInterrupts();
+  bool ok = programStore.beginUpload(slot, len);
+  for (uint16_t offset = 0; ok && offset < len; offset += 128) {
+    uint16_t n = (len - offset < 128) ? len - offset : 128;
+    ok = programStore.writeChunk(offset, program + offset, n);
+  }
+  ok = ok && programStore.commit(checksum);
+  interrupts();
+
+  Serial.print(ok ? "program loaded, slot " : "program upload failed, slot ");
+  Serial.print(slot);
+  Serial.print(" bytes ");
+  Serial.println(len);
+}
+
+// "R<slot>": play a program as if the command came in over I2C
+void runProgramFromSerial(const char *args) {
+  uint8_t slot = args[0] - '0';
+  if (!programStore.valid(slot)) {
+    Serial.println("no program in that slot");
+    return;
+  }
+  noInterrupts();
+  // not acked, so it reports under the last acked sequence #
+  bool queued = pushCommand(config::CMD_PROGRAM_BASE + slot, 0, micros(), regFile[config::LED_REG_ACK_SEQ - config::LED_REG_BASE]);
+  interrupts();
+  if (!queued) Serial.println("command queue full");
+}
+
+// g<mode hex> [frames] [seed]: deterministic render + hashes, G also dumps pixels
+void goldenFromSerial(const char *args, bool dumpPixels) {
+  char *end;
+  goldenRequest.mode = strtoul(args, &end, 16);
+  if (end == args) {
+    Serial.println("usage: g<mode hex> [frames] [seed]");
+    return;
+  }
+  const char *next = end;
+  uint32_t frames = strtoul(next, &end, 10);
+  goldenRequest.frames = (end == next || frames == 0) ? 2 * config::FPS : (frames > 0xFFFF ? 0xFFFF : frames);
+  next = end;
+  uint32_t seed = strtoul(next, &end, 10);
+  goldenRequest.seed = (end == next) ? 1 : seed;
+  goldenRequest.dumpPixels = dumpPixels;
+
+  goldenPending.store(true, std::memory_order_release);
+  while (goldenPending.load(std::memory_order_acquire)) {
+  }
+}
+
+char serialLine[2 * config::PROGRAM_MAX_BYTES + 8];
+uint16_t serialLineLen = 0;
+
+void pollSerialCommands() {
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (serialLineLen < sizeof(serialLine) - 1) serialLine[serialLineLen++] = c;
+      continue;
+    }
+    serialLine[serialLineLen] = '\0';
+    serialLineLen = 0;
+    switch (serialLine[0]) {
+      case 'h':
+        dumpFrameHistograms();
+        break;
+      case 'b':
+        benchPixelOps();
+        break;
+      case 'P':
+        uploadProgramFromSerial(serialLine + 1);
+        break;
+      case 'R':
+        runProgramFromSerial(serialLine + 1);
+        break;
+      case 'g':
+      case 'G':
+        goldenFromSerial(serialLine + 1, serialLine[0] == 'G');
+        break;
+    }
+  }
+}
+
+void putU16(uint8_t reg, uint32_t value) {
+  if (value > 0xFFFF) value = 0xFFFF;
+  regFile[reg - config::LED_REG_BASE] = value & 0xFF;
+  regFile[reg - config::LED_REG_BASE + 1] = value >> 8;
+}
+
+// refresh the readable registers from loop() state + the last stats snapshot
+void updateRegisters(uint8_t activeAnimation) {
+  uint8_t depth = commandTail.load(std::memory_order_acquire) - commandHead.load(std::memory_order_relaxed);
+  uint8_t status = 0;
+  if (animationStartPending) status |= config::LED_STATUS_START_PENDING;
+  if (animationEndTimestamp != 0) status |= config::LED_STATUS_SPECIAL_ACTIVE;
+  if (depth >= config::LED_COMMAND_QUEUE_LEN) status |= config::LED_STATUS_QUEUE_FULL;
+  if (lastReport.vm.faults) status |= config::LED_STATUS_VM_FAULT;
+  const FrameStats &fs = lastReport;
+  uint32_t report = startReport.load(std::memory_order_acquire);
+
+  noInterrupts();
+  regFile[config::LED_REG_STATUS - config::LED_REG_BASE] = status;
+  regFile[config::LED_REG_QUEUE_DEPTH - config::LED_REG_BASE] = depth;
+  regFile[config::LED_REG_ANIMATION - config::LED_REG_BASE] = activeAnimation;
+  putU16(config::LED_REG_FRAMES, fs.frames);
+  putU16(config::LED_REG_MAX_FRAME_US, fs.maxFrameUs);
+  putU16(config::LED_REG_DROPPED_FRAMES, fs.timing.droppedFrames);
+  regFile[config::LED_REG_MAX_CURRENT - config::LED_REG_BASE] = fs.power.maxMa / 10 > 0xFF ? 0xFF : fs.power.maxMa / 10;
+  regFile[config::LED_REG_IDLE_PCT - config::LED_REG_BASE] = fs.windowUs >= 100 ? 100 - fs.busyUs / (fs.windowUs / 100) : 100;
+  regFile[config::LED_REG_START_SEQ - config::LED_REG_BASE] = report & 0xFF;
+  putU16(config::LED_REG_START_ERROR_US, report >> 8);
+  interrupts();
+}
+
+void reportStats() {
+  static uint32_t lastVersion = 0;
+  // same seqlock read as ProgramStore::read(): copy, then retry if core1
+  // published (or was mid publish) while we copied
+  uint32_t before, after;
+  do {
+    before = frameStatsVersion.load(std::memory_order_acquire);
+    if (before == lastVersion) return;
+    lastReport = publishedFrameStats;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = frameStatsVersion.load(std::memory_order_relaxed);
+  } while ((before & 1) || before != after);
+  lastVersion = before;
+
+  const FrameStats &fs = lastReport;
+  unsigned long now = micros();
+  unsigned long core0WindowUs = now - core0WindowStartUs;
+
+  Serial.print("core0 util %: ");
+  Serial.print(core0WindowUs ? (100.0f * core0BusyUs) / core0WindowUs : 0.0f, 1);
+  Serial.print(" | core1 util %: ");
+  Serial.print(fs.windowUs ? (100.0f * fs.busyUs) / fs.windowUs : 0.0f, 1);
+  Serial.print(" (idle %: ");
+  Serial.print(fs.windowUs ? 100.0f - (100.0f * fs.busyUs) / fs.windowUs : 100.0f, 1);
+  Serial.print(")");
+  Serial.print(" | frames: ");
+  Serial.print(fs.frames);
+  Serial.print(" frame us min/avg/max: ");
+  Serial.print(fs.frames ? fs.minFrameUs : 0);
+  Serial.print("/");
+  Serial.print(fs.frames ? fs.totalFrameUs / fs.frames : 0);
+  Serial.print("/");
+  Serial.print(fs.maxFrameUs);
+  // max sustainable fps: limited by whichever is slower, rendering+converting
+  // a frame or clocking it out (the two overlap with the DMA driver)
+  uint32_t computeUs = fs.frames ? (fs.totalFrameUs - fs.showWaitUs) / fs.frames : 0;
+  uint32_t periodUs = computeUs > fs.frameSlotUs ? computeUs : fs.frameSlotUs;
+  Serial.print(" | show wait us total/max: ");
+  Serial.print(fs.showWaitUs);
+  Serial.print("/");
+  Serial.print(fs.maxShowWaitUs);
+  Serial.print(" | max fps: ");
+  Serial.print(periodUs ? 1000000UL / periodUs : 0);
+  Serial.print(" | dropped: ");
+  Serial.print(fs.timing.droppedFrames);
+  Serial.print(" jitter us max: ");
+  Serial.print(fs.timing.jitterUs.maxUs);
+  Serial.print(" | vm ops last/max: ");
+  Serial.print(fs.vm.lastOps);
+  Serial.print("/");
+  Serial.print(fs.vm.maxOps);
+  Serial.print(" faults: ");
+  Serial.print(fs.vm.faults);
+  Serial.print(" | current mA last/max: ");
+  Serial.print(fs.power.lastMa);
+  Serial.print("/");
+  Serial.print(fs.power.maxMa);
+  Serial.print(" (budget ");
+  Serial.print(config::LED_POWER_BUDGET_MA);
+  Serial.print(") limited frames: ");
+  Serial.print(fs.power.limitedFrames);
+  Serial.print(" min scale: ");
+  Serial.print(fs.power.minScale);
+  Serial.print(" | shows saved/min:");
+  const uint8_t modes[] = { config::CMD_DEFAULT_ANIMATION, config::CMD_6V_ANIMATION, config::CMD_12V_ANIMATION,
+                            config::CMD_16V_ANIMATION, config::CMD_WRONG_ANIMATION };
+  for (uint8_t i = 0; i < MODE_STATS_SLOTS; i++) {
+    uint8_t mode = i < sizeof(modes)                          ? modes[i]
+                   : i < sizeof(modes) + config::PROGRAM_SLOTS ? config::CMD_PROGRAM_BASE + (i - sizeof(modes))
+                                                               : config::CMD_CLIP_BASE + (i - sizeof(modes) - config::PROGRAM_SLOTS);
+    const ModeShowStats &ms = fs.modeShows[modeStatsIndex(mode)];
+    if (ms.frames == 0) continue;
+    Serial.print(" ");
+    printAnimationName(mode);
+    Serial.print("=");
+    Serial.print(fs.windowUs ? (uint32_t)((60000000ULL * ms.skipped) / fs.windowUs) : 0);
+  }
+  Serial.print(" | start error us last/max: ");
+  Serial.print(fs.lastStartErrorUs);
+  Serial.print("/");
+  Serial.print(fs.maxStartErrorUs);
+  // idle rate: frames at IDLE_FPS, strip pushes/s as the power proxy (each one
+  // is a DMA + PIO transfer and a frame's worth of core1 work)
+  Serial.print(" | idle rate frames: ");
+  Serial.print(fs.timing.idleRateFrames);
+  Serial.print("/");
+  Serial.print(fs.frames);
+  Serial.print(" pushes/s: ");
+  Serial.print(fs.windowUs ? (float)fs.pushes * 1000000.0f / fs.windowUs : 0.0f, 1);
+  Serial.print(" wake us last/max: ");
+  Serial.print(fs.lastWakeUs);
+  Serial.print("/");
+  Serial.println(fs.maxWakeUs);
+
+  core0BusyUs = 0;
+  core0WindowStartUs = now;
 }
 
 void loop() {
-  // check if we got a new command to process
-  if (gotNewCommand) {
-    gotNewCommand = false;
+  unsigned long busyStartUs = micros();
+
+  // take the next queued command only once the previous one has started and
+  // core1 has pushed its first frame, so back to back commands each reach
+  // the strip in order. a later command still cuts the earlier one short, so
+  // a burst plays one frame of each and then runs the last one
+  uint8_t head = commandHead.load(std::memory_order_relaxed);
+  bool previousShown = shownRestart.load(std::memory_order_acquire) == restartCount;
+  if (!animationStartPending && previousShown && head != commandTail.load(std::memory_order_acquire)) {
+    QueuedCommand c = commandRing[head % config::LED_COMMAND_QUEUE_LEN];
+    commandHead.store(head + 1, std::memory_order_release);
+    // DEFAULT is only acked, the special animations run out on their timer
+    if (c.cmd != config::CMD_DEFAULT_ANIMATION) {
+      pendingAnimation = c.cmd;
+      pendingSequence = c.sequence;
+      animationStartUs = c.receivedUs + (unsigned long)c.startDelayMs * 1000UL;
+      animationStartPending = true;
+    }
+  }
+
+  // hold the new animation back until its scheduled start, then push the
+  // first frame right away instead of waiting for the next frame slot
+  if (animationStartPending && (long)(micros() - animationStartUs) >= 0) {
+    animationStartPending = false;
+    animation = pendingAnimation;
     animationEndTimestamp = millis() + config::ANIMATION_DURATION_MS;
-    noInterrupts();
-    animation = currentAnimation;
-    interrupts();
+    restartCount++;
+    mailboxStartUs = animationStartUs;
+    mailboxSequence = pendingSequence;
   }
 
   // determine which animation to play (default or 6V,12V,16V for specified amnt of time)
@@ -62,27 +570,117 @@ void loop() {
   // Print debug message only when animation changes
   if (activeAnimation != lastPlayedAnimation) {
     Serial.print("Animation changed to: ");
-    switch (activeAnimation) {
-      case config::CMD_DEFAULT_ANIMATION:
-        Serial.println("DEFAULT");
-        break;
-      case config::CMD_6V_ANIMATION:
-        Serial.println("6V");
-        break;
-      case config::CMD_12V_ANIMATION:
-        Serial.println("12V");
-        break;
-      case config::CMD_16V_ANIMATION:
-        Serial.println("16V");
-        break;
-      default:
-        Serial.print("UNKNOWN (");
-        Serial.print(activeAnimation);
-        Serial.println(")");
-        break;
-    }
+    printAnimationName(activeAnimation);
+    Serial.println();
     lastPlayedAnimation = activeAnimation;
   }
 
-  ledController.update(activeAnimation);
+  updateRegisters(activeAnimation);
+
+  // hand the decision to core1 (plain store, core1 picks it up next pass)
+  ledMailbox.store((uint32_t)activeAnimation | ((uint32_t)restartCount << 8), std::memory_order_release);
+
+  core0BusyUs += micros() - busyStartUs;
+  reportStats();
+
+  pollSerialCommands();
+}
+
+// ---------------------------------------------------------
+// core1: LED engine
+// ---------------------------------------------------------
+uint8_t core1LastRestart = 0;
+bool core1MeasureStart = false;
+unsigned long core1StartTargetUs = 0;
+uint8_t core1StartSequence = 0;
+unsigned long core1WindowStartUs = 0;
+FrameStats core1Stats = {};
+
+void loop1() {
+  if (goldenPending.load(std::memory_order_acquire)) {
+    ledController.renderGolden(goldenRequest.mode, goldenRequest.frames, goldenRequest.seed, goldenRequest.dumpPixels);
+    goldenPending.store(false, std::memory_order_release);
+  }
+
+  uint32_t mail = ledMailbox.load(std::memory_order_acquire);
+  uint8_t activeAnimation = mail & 0xFF;
+  uint8_t restart = (mail >> 8) & 0xFF;
+
+  if (restart != core1LastRestart) {
+    unsigned long pickupUs = micros();
+    core1LastRestart = restart;
+    core1StartTargetUs = mailboxStartUs;
+    core1StartSequence = mailboxSequence;
+    core1MeasureStart = true;
+    // wake: receiveEvent's arrival stamp + the requested start delay (the
+    // waiting on purpose) -> core1 taking the command. kept apart from the
+    // start error, which also has the first frame's render + push in it
+    if (ledController.idleRate()) {
+      uint32_t wakeUs = pickupUs - core1StartTargetUs;
+      core1Stats.lastWakeUs = wakeUs;
+      if (wakeUs > core1Stats.maxWakeUs) core1Stats.maxWakeUs = wakeUs;
+    }
+    ledController.restartFrameClock();
+  }
+
+  unsigned long frameStartUs = micros();
+  bool frameShown = ledController.update(activeAnimation);
+  unsigned long frameEndUs = micros();
+
+  if (frameShown) {
+    uint32_t frameUs = frameEndUs - frameStartUs;
+    if (core1Stats.frames == 0 || frameUs < core1Stats.minFrameUs) core1Stats.minFrameUs = frameUs;
+    if (frameUs > core1Stats.maxFrameUs) core1Stats.maxFrameUs = frameUs;
+    core1Stats.totalFrameUs += frameUs;
+    core1Stats.busyUs += frameUs;
+    core1Stats.frames++;
+
+    if (core1MeasureStart) {
+      core1MeasureStart = false;
+      MARKER_PULSE(config::MARKER_FIRST_FRAME_PIN);
+      uint32_t startErrorUs = frameEndUs - core1StartTargetUs;
+      core1Stats.lastStartErrorUs = startErrorUs;
+      if (startErrorUs > core1Stats.maxStartErrorUs) core1Stats.maxStartErrorUs = startErrorUs;
+      shownRestart.store(core1LastRestart, std::memory_order_release);
+      startReport.store(core1StartSequence | ((startErrorUs > 0xFFFF ? 0xFFFF : startErrorUs) << 8), std::memory_order_release);
+    }
+  }
+
+  // publish a snapshot for core0 to print, then start a new window
+  if (frameEndUs - core1WindowStartUs >= config::STATS_REPORT_MS * 1000UL) {
+    core1Stats.windowUs = frameEndUs - core1WindowStartUs;
+    // outputs clock out in parallel: waits add up, the longest strip sets the slot
+    for (uint8_t o = 0; o < config::NUM_LED_OUTPUTS; o++) {
+      WS2815Driver &strip = ledController.output(o);
+      const StripOutputStats &out = strip.getStats();
+      core1Stats.showWaitUs += out.waitUs;
+      if (out.maxWaitUs > core1Stats.maxShowWaitUs) core1Stats.maxShowWaitUs = out.maxWaitUs;
+      if (strip.frameSlotUs() > core1Stats.frameSlotUs) core1Stats.frameSlotUs = strip.frameSlotUs();
+      if (out.shows > core1Stats.pushes) core1Stats.pushes = out.shows;
+      strip.resetStats();
+    }
+    core1Stats.timing = ledController.timing();
+    ledController.resetTiming();
+    core1Stats.vm = ledController.program().getStats();
+    ledController.program().resetStats();
+    memcpy(core1Stats.modeShows, ledController.showStats(), sizeof(core1Stats.modeShows));
+    ledController.resetShowStats();
+    core1Stats.power = ledController.power();
+    ledController.resetPowerStats();
+    // only core1 writes the version, so a plain load+store is enough (no RMW on M0+)
+    uint32_t version = frameStatsVersion.load(std::memory_order_relaxed);
+    frameStatsVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    publishedFrameStats = core1Stats;
+    frameStatsVersion.store(version + 2, std::memory_order_release);
+
+    uint32_t keepMaxStartError = core1Stats.maxStartErrorUs;
+    uint32_t keepLastWake = core1Stats.lastWakeUs;
+    uint32_t keepMaxWake = core1Stats.maxWakeUs;
+    core1Stats = {};
+    core1Stats.maxStartErrorUs = keepMaxStartError;
+    core1Stats.lastWakeUs = keepLastWake;
+    core1Stats.maxWakeUs = keepMaxWake;
+    core1WindowStartUs = frameEndUs;
+  }
 }
@@ -0,0 +1,269 @@
+#include "Assembler.h"
+#include "Config.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include <map>
+#include <sstream>
+
+namespace {
+// operand kinds: b = u8, r = register, c = colour (3 bytes), w = imm16,
+// a = address16. sizes have to add up to AnimationVM's OPERAND_BYTES
+struct OpInfo {
+  const char *name;
+  uint8_t opcode;
+  const char *operands;
+};
+
+const OpInfo OPS[] = {
+    {"END", 0x00, ""},
+    {"FILL", 0x01, "c"},
+    {"FILL_HSV", 0x02, "bbb"},
+    {"HUE_REG", 0x03, "rbb"},
+    {"GRADIENT", 0x04, "bbcc"},
+    {"BAR", 0x05, "rbc"},
+    {"SPARKS", 0x06, "bbbb"},
+    {"FADE", 0x07, "b"},
+    {"SET", 0x08, "rw"},
+    {"ADD", 0x09, "rw"},
+    {"JMP", 0x0A, "a"},
+    {"JLT", 0x0B, "rwa"},
+    {"JGE", 0x0C, "rwa"},
+    {"DJNZ", 0x0D, "ra"},
+    {"YIELD", 0x0E, ""},
+};
+
+const OpInfo *findOp(const std::string &name) {
+  for (const OpInfo &op : OPS) {
+    if (strcasecmp(op.name, name.c_str()) == 0)
+      return &op;
+  }
+  return nullptr;
+}
+
+const OpInfo *findOpcode(uint8_t opcode) {
+  for (const OpInfo &op : OPS) {
+    if (op.opcode == opcode)
+      return &op;
+  }
+  return nullptr;
+}
+
+uint8_t operandBytes(const char *kinds) {
+  uint8_t n = 0;
+  for (const char *k = kinds; *k; k++)
+    n += (*k == 'c') ? 3 : (*k == 'w' || *k == 'a') ? 2 : 1;
+  return n;
+}
+
+struct Line {
+  int number;
+  const OpInfo *op;
+  std::vector<std::string> args;
+};
+
+bool parseNumber(const std::string &s, long lo, long hi, long &value) {
+  if (s.empty())
+    return false;
+  char *end;
+  value = strtol(s.c_str(), &end, 0);
+  return *end == '\0' && value >= lo && value <= hi;
+}
+
+std::string lineError(int line, const std::string &what) {
+  return "line " + std::to_string(line) + ": " + what;
+}
+
+// splits on whitespace and commas, drops the comment
+std::vector<std::string> tokenize(const std::string &text) {
+  std::vector<std::string> tokens;
+  std::string token;
+  for (char c : text) {
+    if (c == ';')
+      break;
+    if (isspace(static_cast<unsigned char>(c)) || c == ',') {
+      if (!token.empty())
+        tokens.push_back(token);
+      token.clear();
+    } else {
+      token += c;
+    }
+  }
+  if (!token.empty())
+    tokens.push_back(token);
+  return tokens;
+}
+} // namespace
+
+bool assemble(const std::string &source, std::vector<uint8_t> &code,
+              std::string &error) {
+  std::vector<Line> lines;
+  std::map<std::string, uint16_t> labels;
+  uint32_t addr = 0;
+
+  // pass 1: labels and addresses (every instruction has a fixed size)
+  std::istringstream in(source);
+  std::string text;
+  for (int number = 1; std::getline(in, text); number++) {
+    std::vector<std::string> tokens = tokenize(text);
+    size_t t = 0;
+    while (t < tokens.size() && tokens[t].back() == ':') {
+      std::string label = tokens[t].substr(0, tokens[t].size() - 1);
+      if (label.empty() || labels.count(label)) {
+        error = lineError(number, "bad or duplicate label '" + label + "'");
+        return false;
+      }
+      labels[label] = addr;
+      t++;
+    }
+    if (t == tokens.size())
+      continue;
+
+    const OpInfo *op = findOp(tokens[t]);
+    if (!op) {
+      error = lineError(number, "unknown instruction '" + tokens[t] + "'");
+      return false;
+    }
+    lines.push_back({number, op, {tokens.begin() + t + 1, tokens.end()}});
+    addr += 1 + operandBytes(op->operands);
+  }
+  if (addr > config::PROGRAM_MAX_BYTES) {
+    error = "program is " + std::to_string(addr) + " bytes, max " +
+            std::to_string(config::PROGRAM_MAX_BYTES);
+    return false;
+  }
+
+  // pass 2: encode
+  code.clear();
+  for (const Line &line : lines) {
+    code.push_back(line.op->opcode);
+    size_t a = 0;
+    auto next = [&](std::string &arg) {
+      if (a >= line.args.size())
+        return false;
+      arg = line.args[a++];
+      return true;
+    };
+
+    for (const char *k = line.op->operands; *k; k++) {
+      std::string arg;
+      long v;
+      if (!next(arg)) {
+        error = lineError(line.number, std::string("missing operands for ") +
+                                           line.op->name);
+        return false;
+      }
+      switch (*k) {
+      case 'b':
+        if (!parseNumber(arg, -128, 255, v)) {
+          error = lineError(line.number, "'" + arg + "' is not a byte");
+          return false;
+        }
+        code.push_back(uint8_t(v));
+        break;
+      case 'r':
+        if ((arg[0] != 'r' && arg[0] != 'R') ||
+            !parseNumber(arg.substr(1), 0, 7, v)) {
+          error = lineError(line.number, "'" + arg + "' is not r0-r7");
+          return false;
+        }
+        code.push_back(uint8_t(v));
+        break;
+      case 'c':
+        if (arg[0] == '#') {
+          if (arg.size() != 7 || !parseNumber("0x" + arg.substr(1), 0,
+                                               0xFFFFFF, v)) {
+            error = lineError(line.number, "'" + arg + "' is not #RRGGBB");
+            return false;
+          }
+          code.push_back(uint8_t(v >> 16));
+          code.push_back(uint8_t(v >> 8));
+          code.push_back(uint8_t(v));
+        } else {
+          for (int i = 0; i < 3; i++) {
+            if ((i > 0 && !next(arg)) || !parseNumber(arg, 0, 255, v)) {
+              error = lineError(line.number, "colour is r g b or #RRGGBB");
+              return false;
+            }
+            code.push_back(uint8_t(v));
+          }
+        }
+        break;
+      case 'w':
+        if (!parseNumber(arg, -32768, 65535, v)) {
+          error = lineError(line.number, "'" + arg + "' is not 16 bit");
+          return false;
+        }
+        code.push_back(uint8_t(v & 0xFF));
+        code.push_back(uint8_t((v >> 8) & 0xFF));
+        break;
+      case 'a':
+        if (labels.count(arg)) {
+          v = labels[arg];
+        } else if (!parseNumber(arg, 0, addr - 1, v)) {
+          error = lineError(line.number, "unknown label or address '" + arg +
+                                             "'");
+          return false;
+        }
+        code.push_back(uint8_t(v & 0xFF));
+        code.push_back(uint8_t(v >> 8));
+        break;
+      }
+    }
+    if (a != line.args.size()) {
+      error = lineError(line.number, std::string("too many operands for ") +
+                                         line.op->name);
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string disassemble(const std::vector<uint8_t> &code) {
+  std::string out;
+  char buf[96];
+  size_t pc = 0;
+  while (pc < code.size()) {
+    const OpInfo *op = findOpcode(code[pc]);
+    if (!op || pc + 1 + operandBytes(op->operands) > code.size()) {
+      snprintf(buf, sizeof(buf), "%04zx: .byte 0x%02x\n", pc, code[pc]);
+      out += buf;
+      pc++;
+      continue;
+    }
+    int n = snprintf(buf, sizeof(buf), "%04zx: %s", pc, op->name);
+    size_t p = pc + 1;
+    for (const char *k = op->operands; *k; k++) {
+      switch (*k) {
+      case 'b':
+        n += snprintf(buf + n, sizeof(buf) - n, " %u", code[p++]);
+        break;
+      case 'r':
+        n += snprintf(buf + n, sizeof(buf) - n, " r%u", code[p++] % 8);
+        break;
+      case 'c':
+        n += snprintf(buf + n, sizeof(buf) - n, " #%02X%02X%02X", code[p],
+                      code[p + 1], code[p + 2]);
+        p += 3;
+        break;
+      case 'w':
+        n += snprintf(buf + n, sizeof(buf) - n, " 0x%04x",
+                      code[p] | (code[p + 1] << 8));
+        p += 2;
+        break;
+      case 'a':
+        n += snprintf(buf + n, sizeof(buf) - n, " %u",
+                      code[p] | (code[p + 1] << 8));
+        p += 2;
+        break;
+      }
+    }
+    out += buf;
+    out += '\n';
+    pc = p;
+  }
+  return out;
+}
@@ -0,0 +1,33 @@
+#pragma once
+/**
+ * Assembler.h
+ *
+ * Text -> AnimationVM bytecode (encoding in rp2040/AnimationVM.h). One
+ * instruction per line, mnemonics as in the opcode table there:
+ *
+ *   ; green bar running up the strip with a fading trail
+ *           SET r0 0
+ *   loop:   FADE 96
+ *           BAR r0 3 #00FF00
+ *           ADD r0 0x0080
+ *           YIELD
+ *           JLT r0 0x4600 loop
+ *           JMP 0
+ *
+ * - registers r0-r7, numbers decimal, 0x hex or negative
+ * - a colour is `r g b` or `#RRGGBB`
+ * - jump targets are labels or byte addresses
+ * - `;` starts a comment
+ */
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// false with `error` set to "line N: ..." on the first problem
+bool assemble(const std::string &source, std::vector<uint8_t> &code,
+              std::string &error);
+
+// one instruction per line, addresses first, for listings and error output
+std::string disassemble(const std::vector<uint8_t> &code);
@@ -0,0 +1,201 @@
+/**
+ * animvm.cpp
+ *
+ * Assembler and simulator for AnimationVM programs. `run` links the board's
+ * AnimationVM.cpp and PixelOps.cpp against the FastLED shim, so frames and
+ * instruction counts are the RP2040's (before the compositor's brightness
+ * and crossfade).
+ *
+ *   animvm asm prog.s               hex bytes
+ *   animvm asm prog.s --serial 0    "P0 <hex>" line for the RP2040's USB
+ *                                   serial (then "R0" plays it)
+ *   animvm asm prog.s --c NAME      C array for mkrzero-rx/src/LEDPrograms.h
+ *   animvm asm prog.s -o prog.bin   raw bytes
+ *   animvm dis prog.bin             listing
+ *   animvm run prog.s [--frames N] [--seed S] [--ppm out.ppm] [--trace]
+ *
+ * `run` prints one summary line:
+ *   animvm bytes= frames= ops_min= ops_avg= ops_max= step_limit= faults=
+ *   hash=<FNV-1a over every frame>
+ * and with --trace a `frame= ops= hash=` line per frame. Inputs ending in
+ * .s are assembled, anything else is read as raw bytes.
+ */
+
+#include "AnimationVM.h"
+#include "Assembler.h"
+#include "Config.h"
+#include "FrameImage.h"
+#include "HostBoard.h"
+#include "PixelOps.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+int usage() {
+  fprintf(stderr,
+          "usage: animvm asm <prog.s> [--serial SLOT | --c NAME | -o OUT]\n"
+          "       animvm dis <prog.s|prog.bin>\n"
+          "       animvm run <prog.s|prog.bin> [--frames N] [--seed S]"
+          " [--ppm OUT] [--scale N] [--trace]\n");
+  return 2;
+}
+
+bool endsWith(const std::string &s, const char *suffix) {
+  size_t n = strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+bool loadProgram(const std::string &path, std::vector<uint8_t> &code) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    fprintf(stderr, "animvm: can't open %s\n", path.c_str());
+    return false;
+  }
+  std::stringstream buf;
+  buf << in.rdbuf();
+
+  if (!endsWith(path, ".s")) {
+    std::string raw = buf.str();
+    code.assign(raw.begin(), raw.end());
+    return true;
+  }
+  std::string error;
+  if (!assemble(buf.str(), code, error)) {
+    fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+    return false;
+  }
+  return true;
+}
+
+int runAsm(const std::vector<uint8_t> &code, int argc, char **argv) {
+  const char *serialSlot = nullptr;
+  const char *cName = nullptr;
+  const char *outPath = nullptr;
+  for (int i = 0; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--serial"))
+      serialSlot = argv[i + 1];
+    else if (!strcmp(argv[i], "--c"))
+      cName = argv[i + 1];
+    else if (!strcmp(argv[i], "-o"))
+      outPath = argv[i + 1];
+    else
+      return usage();
+  }
+
+  if (outPath) {
+    FILE *f = fopen(outPath, "wb");
+    if (!f || fwrite(code.data(), 1, code.size(), f) != code.size()) {
+      fprintf(stderr, "animvm: can't write %s\n", outPath);
+      return 1;
+    }
+    fclose(f);
+    return 0;
+  }
+
+  if (cName) {
+    printf("static const uint8_t %s[] = {", cName);
+    for (size_t i = 0; i < code.size(); i++)
+      printf("%s0x%02X,", i % 12 ? " " : "\n    ", code[i]);
+    printf("\n};\n");
+    return 0;
+  }
+
+  if (serialSlot)
+    printf("P%s ", serialSlot);
+  for (size_t i = 0; i < code.size(); i++)
+    printf("%s%02X", i ? " " : "", code[i]);
+  printf("\n");
+  return 0;
+}
+
+int runSim(const std::vector<uint8_t> &code, int argc, char **argv) {
+  uint32_t frames = 2 * config::FPS;
+  uint32_t seed = 1;
+  uint8_t scale = 4;
+  const char *ppmPath = nullptr;
+  bool trace = false;
+  for (int i = 0; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--trace"))
+      trace = true;
+    else if (!strcmp(argv[i], "--frames") && hasValue)
+      frames = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--seed") && hasValue)
+      seed = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--scale") && hasValue)
+      scale = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--ppm") && hasValue)
+      ppmPath = argv[++i];
+    else
+      return usage();
+  }
+
+  // VM faults print on the board's USB serial
+  Serial.echo = true;
+  random16_set_seed(seed);
+
+  alignas(4) static CRGB frame[config::NUM_LEDS];
+  fill_solid(frame, config::NUM_LEDS, CRGB::Black);
+  FrameImage image(config::NUM_LEDS, scale);
+
+  AnimationVM vm;
+  vm.load(code.data(), code.size());
+  uint32_t hash = FNV_OFFSET;
+  uint32_t opsTotal = 0;
+  uint16_t opsMin = 0xFFFF;
+  uint32_t ran = 0;
+  for (; ran < frames; ran++) {
+    vm.run(frame, config::NUM_LEDS);
+    if (vm.faulted())
+      break;
+    uint16_t ops = vm.getStats().lastOps;
+    opsTotal += ops;
+    if (ops < opsMin)
+      opsMin = ops;
+    uint32_t frameHash = hashPixels(frame, sizeof(frame));
+    hash = hashPixels(frame, sizeof(frame), hash);
+    image.addFrame(frame);
+    if (trace)
+      printf("frame=%u ops=%u hash=%08x\n", ran, ops, frameHash);
+  }
+
+  const VMStats &stats = vm.getStats();
+  printf("animvm bytes=%zu frames=%u ops_min=%u ops_avg=%u ops_max=%u "
+         "step_limit=%u faults=%u hash=%08x\n",
+         code.size(), ran, ran ? opsMin : 0, ran ? opsTotal / ran : 0,
+         stats.maxOps, config::VM_MAX_STEPS_PER_FRAME, stats.faults, hash);
+
+  if (ppmPath && !image.writePpm(ppmPath)) {
+    fprintf(stderr, "animvm: can't write %s\n", ppmPath);
+    return 1;
+  }
+  return stats.faults ? 1 : 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3)
+    return usage();
+
+  std::string command = argv[1];
+  std::vector<uint8_t> code;
+  if (!loadProgram(argv[2], code))
+    return 1;
+
+  if (command == "asm")
+    return runAsm(code, argc - 3, argv + 3);
+  if (command == "dis") {
+    fputs(disassemble(code).c_str(), stdout);
+    return 0;
+  }
+  if (command == "run")
+    return runSim(code, argc - 3, argv + 3);
+  return usage();
+}
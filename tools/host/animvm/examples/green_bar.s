@@ -0,0 +1,9 @@
+; green bar running up the strip with a fading trail (the AnimationVM.h
+; example), half a pixel per frame until pixel 70, then from the bottom again
+        SET r0 0
+loop:   FADE 96
+        BAR r0 3 #00FF00
+        ADD r0 0x0080         ; Q8.8, 0.5 pixel
+        YIELD
+        JLT r0 0x4600 loop
+        JMP 0
@@ -0,0 +1,11 @@
+; slow rainbow fill with white-ish sparks, r1 counts frames between hue steps
+        SET r0 0
+frame:  HUE_REG r0 200 60
+        SPARKS 64 3 0 40
+        ADD r0 0x0100         ; next hue (r0 >> 8)
+        SET r1 4
+hold:   YIELD
+        FADE 40
+        SPARKS 32 1 0 40
+        DJNZ r1 hold
+        JMP frame
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+bench_diff.py
+
+Compares `make bench` output with the committed baseline (bench/baseline.txt)
+line by line, matched on name=:
+
+  - host timings (ns_per_op) may move with the machine and the compiler; a
+    rise past --threshold (default 25%) is a regression, unless it is under
+    --min-ns (default 5ns, the noise floor of the nanosecond benches)
+  - every other field (iters, hashes, simulated board time, I2C transaction
+    counts, ...) comes from the simulated boards and has to match exactly
+  - a bench missing from either side is reported too
+
+total_us and the fields derived from host time (block_budget_pct,
+realtime_x) are shown but not judged, ns_per_op already says it.
+
+Usage:
+  make bench | bench/bench_diff.py bench/baseline.txt
+  bench/bench_diff.py bench/baseline.txt current.txt [--threshold 0.10]
+  bench/bench_diff.py bench/baseline.txt current.txt --update
+
+Exit code 1 on any regression or mismatch. --update rewrites the baseline
+with the current lines (after reviewing the diff). Standard library only.
+"""
+
+import argparse
+import sys
+
+TIMING = "ns_per_op"
+UNJUDGED = {"total_us", "block_budget_pct", "realtime_x"}
+
+
+def parse(lines):
+    """name -> (fields dict, raw line) for every `bench ... name=` line"""
+    benches = {}
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("bench "):
+            continue
+        fields = dict(
+            tok.split("=", 1) for tok in line.split()[1:] if "=" in tok)
+        if "name" in fields:
+            benches[fields["name"]] = (fields, line)
+    return benches
+
+
+def compare(base, current, threshold, min_ns):
+    """list of (ok, message) for every bench, in baseline order"""
+    results = []
+    for name, (want, _) in base.items():
+        if name not in current:
+            results.append((False, f"{name}: missing"))
+            continue
+        got = current[name][0]
+        problems = []
+        notes = []
+        for key, value in want.items():
+            if key in UNJUDGED:
+                continue
+            if key not in got:
+                problems.append(f"{key} missing")
+            elif key == TIMING:
+                old, new = int(value), int(got[key])
+                change = (new - old) / old if old else 0.0
+                notes.append(f"{key} {old} -> {new} ({change:+.0%})")
+                if change > threshold and new - old >= min_ns:
+                    problems.append(f"{key} regressed {change:+.0%}")
+            elif got[key] != value:
+                problems.append(f"{key} {value} -> {got[key]}")
+        for key in got:
+            if key not in want and key not in UNJUDGED:
+                problems.append(f"{key} new")
+        message = f"{name}: " + ", ".join(problems or notes or ["same"])
+        results.append((not problems, message))
+    for name in current:
+        if name not in base:
+            results.append((False, f"{name}: not in the baseline"))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("baseline")
+    parser.add_argument("current", nargs="?", help="default: stdin")
+    parser.add_argument("--threshold", type=float, default=0.25,
+                        help="allowed ns_per_op rise, 0.25 = 25%%")
+    parser.add_argument("--min-ns", type=int, default=5,
+                        help="ns_per_op rises smaller than this always pass")
+    parser.add_argument("--update", action="store_true",
+                        help="write the current results to the baseline")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        base_lines = f.read().splitlines()
+    if args.current:
+        with open(args.current) as f:
+            current_lines = f.read().splitlines()
+    else:
+        current_lines = sys.stdin.read().splitlines()
+    base, current = parse(base_lines), parse(current_lines)
+
+    if args.update:
+        # keeps the baseline's comments, replaces the results
+        with open(args.baseline, "w") as f:
+            for line in base_lines:
+                if line.startswith("#"):
+                    f.write(line + "\n")
+            for _, line in current.values():
+                f.write(line + "\n")
+        print(f"bench_diff: {len(current)} benches written to {args.baseline}")
+        return 0
+
+    results = compare(base, current, args.threshold, args.min_ns)
+    failed = 0
+    for ok, message in results:
+        print(("ok   " if ok else "FAIL ") + message)
+        failed += not ok
+    print(f"bench_diff: {len(results)} benches, {failed} failed")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,131 @@
+/**
+ * led_bench.cpp
+ *
+ * Host timings for the RP2040's frame path: LEDController::update() in every
+ * animation mode, built against the FastLED shim and the host WS2815Driver,
+ * with the board clock stepped 1ms per loop() pass. Each op is one rendered
+ * frame, so ns_per_op covers the mode's stepAnimation*() / program / clip
+ * step, composing, the power limiter and the push, plus the loop passes
+ * between frames that only poll the scheduler.
+ *
+ * Besides the host timings every line carries the run's deterministic
+ * results, which must not move unless the animation does:
+ *   frames  frames rendered in the simulated time
+ *   pushes  frames that went out to a strip (unchanged ones are skipped)
+ *   hash    FNV-1a over every pushed frame as latched, all outputs
+ *   max_ma  highest estimated strip current
+ *
+ * Programs for modes 0x20/0x21 are the animvm examples, assembled at start
+ * (run from tools/host, like `make bench` does).
+ */
+
+#include "Assembler.h"
+#include "Config.h"
+#include "HostBoard.h"
+#include "LEDController.h"
+#include "PixelOps.h"
+#include "ProgramStore.h"
+#include "StripCapture.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t SIM_SECONDS = 600;
+
+struct BenchMode {
+  const char *name;
+  uint8_t mode;
+};
+
+const BenchMode MODES[] = {
+    {"led_6v", 0x01},      {"led_12v", 0x02},     {"led_16v", 0x03},
+    {"led_default", 0x04}, {"led_wrong", 0x05},   {"led_program_0", 0x20},
+    {"led_program_1", 0x21}, {"led_clip_0", 0x30},
+};
+
+const char *PROGRAMS[] = {"animvm/examples/green_bar.s",
+                          "animvm/examples/rainbow_sparks.s"};
+
+uint64_t elapsedUs(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               start)
+      .count();
+}
+
+bool loadProgram(uint8_t slot, const char *path) {
+  std::ifstream in(path);
+  std::stringstream source;
+  source << in.rdbuf();
+  std::vector<uint8_t> code;
+  std::string error;
+  if (!in || !assemble(source.str(), code, error)) {
+    fprintf(stderr, "led_bench: %s: %s\n", path,
+            in ? error.c_str() : "can't read");
+    return false;
+  }
+  uint8_t checksum = 0;
+  for (uint8_t b : code)
+    checksum ^= b;
+  return programStore.beginUpload(slot, code.size()) &&
+         programStore.writeChunk(0, code.data(), code.size()) &&
+         programStore.commit(checksum);
+}
+
+void benchMode(const BenchMode &bench) {
+  host::Board board("rp2040");
+  host::select(board);
+  random16_set_seed(1);
+  randomSeed(1);
+
+  uint32_t pushes = 0;
+  uint32_t hash = FNV_OFFSET;
+  host::onStripShow([&](const host::StripFrame &frame) {
+    pushes++;
+    hash = hashPixels(frame.pixels.data(), frame.pixels.size() * sizeof(CRGB),
+                      hash);
+  });
+
+  LEDController controller;
+  controller.initialize();
+  controller.restartFrameClock();
+  controller.resetPowerStats();
+  pushes = 0;
+  hash = FNV_OFFSET;
+
+  uint32_t frames = 0;
+  Clock::time_point start = Clock::now();
+  for (uint32_t ms = 0; ms < SIM_SECONDS * 1000; ms++) {
+    frames += controller.update(bench.mode);
+    host::advanceUs(1000);
+  }
+  uint64_t totalUs = elapsedUs(start);
+  host::onStripShow(nullptr);
+
+  printf("bench board=host name=%s iters=%u total_us=%llu ns_per_op=%llu "
+         "frames=%u pushes=%u hash=%08x max_ma=%u\n",
+         bench.name, frames, (unsigned long long)totalUs,
+         (unsigned long long)(frames ? totalUs * 1000 / frames : 0), frames,
+         pushes, hash, controller.power().maxMa);
+}
+} // namespace
+
+int main() {
+  for (uint8_t slot = 0; slot < 2; slot++) {
+    if (!loadProgram(slot, PROGRAMS[slot]))
+      return 1;
+  }
+
+  printf("bench board=host begin\n");
+  for (const BenchMode &bench : MODES)
+    benchMode(bench);
+  printf("bench board=host end\n");
+  return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * pcm_bench.cpp
+ *
+ * Host timings for the I2S backend's hot path, same line format as the
+ * boards' benches (board=host). Host numbers are only good for comparing
+ * builds of the same code on the same machine, not for the SAMD21 budget.
+ *
+ *   mix_block_<n>v   one AUDIO_BLOCK_FRAMES block with n voices playing,
+ *                    block_budget_pct = share of the block's play time
+ *   parse_wav_header one parseWavHeader() over a LIST + data header
+ *   decode_clip      header parse + every block of a 1s clip, mixed with a
+ *                    second voice, realtime_x = audio seconds per cpu second
+ */
+
+#include "Config.h"
+#include "PcmMixer.h"
+#include "WavFormat.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// keeps the optimizer from dropping the work
+volatile int32_t sink;
+
+uint64_t elapsedUs(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               start)
+      .count();
+}
+
+void printResult(const char *name, uint32_t iters, uint64_t totalUs) {
+  printf("bench board=host name=%s iters=%u total_us=%llu ns_per_op=%llu",
+         name, iters, (unsigned long long)totalUs,
+         (unsigned long long)(iters ? totalUs * 1000 / iters : 0));
+}
+
+std::vector<int16_t> tone(size_t frames, int step) {
+  std::vector<int16_t> v(frames);
+  for (size_t i = 0; i < frames; i++)
+    v[i] = int16_t((int32_t(i * step) & 0xFFFF) - 32768);
+  return v;
+}
+
+void benchMix(uint8_t voicesPlaying) {
+  const uint16_t frames = config::AUDIO_BLOCK_FRAMES;
+  const uint32_t iters = 200000;
+  std::vector<int16_t> a = tone(frames, 37), b = tone(frames, 91);
+  const int16_t *voices[config::AUDIO_NUM_VOICES] = {};
+  uint16_t gains[config::AUDIO_NUM_VOICES];
+  for (uint8_t v = 0; v < config::AUDIO_NUM_VOICES; v++) {
+    voices[v] = v < voicesPlaying ? (v & 1 ? b.data() : a.data()) : nullptr;
+    gains[v] = percentToGainQ15(config::AUDIO_VOLUME_PERCENT);
+  }
+  int16_t out[2 * frames];
+
+  Clock::time_point start = Clock::now();
+  for (uint32_t i = 0; i < iters; i++) {
+    mixPcmBlock(out, frames, voices, gains, config::AUDIO_NUM_VOICES);
+    sink = out[i % (2 * frames)];
+  }
+  uint64_t totalUs = elapsedUs(start);
+
+  char name[24];
+  snprintf(name, sizeof(name), "mix_block_%uv", voicesPlaying);
+  printResult(name, iters, totalUs);
+  double blockUs = 1e6 * frames / config::AUDIO_SAMPLE_RATE;
+  printf(" block_budget_pct=%.4f\n", 100.0 * totalUs / iters / blockUs);
+}
+
+std::vector<uint8_t> wavFile(uint32_t dataBytes) {
+  std::vector<uint8_t> f;
+  auto put = [&](const char *s) { f.insert(f.end(), s, s + 4); };
+  auto le = [&](uint32_t v, int n) {
+    for (int i = 0; i < n; i++)
+      f.push_back((v >> (8 * i)) & 0xFF);
+  };
+  put("RIFF");
+  le(36 + dataBytes, 4);
+  put("WAVE");
+  put("fmt ");
+  le(16, 4);
+  le(1, 2);
+  le(1, 2);
+  le(config::AUDIO_SAMPLE_RATE, 4);
+  le(config::AUDIO_SAMPLE_RATE * 2, 4);
+  le(2, 2);
+  le(16, 2);
+  put("LIST");
+  le(26, 4);
+  f.insert(f.end(), 26, 'x');
+  put("data");
+  le(dataBytes, 4);
+  std::vector<int16_t> samples = tone(dataBytes / 2, 53);
+  const uint8_t *raw = reinterpret_cast<const uint8_t *>(samples.data());
+  f.insert(f.end(), raw, raw + dataBytes);
+  return f;
+}
+
+void benchParse() {
+  const uint32_t iters = 2000000;
+  std::vector<uint8_t> f = wavFile(64);
+  WavInfo info{};
+  Clock::time_point start = Clock::now();
+  for (uint32_t i = 0; i < iters; i++) {
+    sink = parseWavHeader(f.data(), WAV_HEADER_SCAN_BYTES < f.size()
+                                         ? WAV_HEADER_SCAN_BYTES
+                                         : f.size(),
+                          info);
+  }
+  printResult("parse_wav_header", iters, elapsedUs(start));
+  printf("\n");
+}
+
+void benchDecodeClip() {
+  const uint16_t frames = config::AUDIO_BLOCK_FRAMES;
+  const uint32_t clipFrames = config::AUDIO_SAMPLE_RATE; // 1s
+  const uint32_t iters = 200;
+  std::vector<uint8_t> f = wavFile(clipFrames * 2);
+  std::vector<int16_t> other = tone(frames, 91);
+  std::vector<int16_t> block(frames);
+  int16_t out[2 * frames];
+  uint32_t blocks = 0;
+
+  Clock::time_point start = Clock::now();
+  for (uint32_t i = 0; i < iters; i++) {
+    WavInfo info{};
+    if (!parseWavHeader(f.data(), WAV_HEADER_SCAN_BYTES, info))
+      return;
+    uint16_t gains[2] = {PCM_GAIN_UNITY_Q15, PCM_GAIN_UNITY_Q15 / 2};
+    for (uint32_t off = 0; off + frames * 2 <= info.dataLength;
+         off += frames * 2) {
+      // the SD read lands raw little endian bytes in the voice buffer
+      memcpy(block.data(), f.data() + info.dataOffset + off, frames * 2);
+      const int16_t *voices[2] = {block.data(), other.data()};
+      mixPcmBlock(out, frames, voices, gains, 2);
+      blocks++;
+    }
+    sink = out[0];
+  }
+  uint64_t totalUs = elapsedUs(start);
+  printResult("decode_clip", blocks, totalUs);
+  double audioS = double(blocks) * frames / config::AUDIO_SAMPLE_RATE;
+  printf(" realtime_x=%.1f\n", totalUs ? audioS / (totalUs / 1e6) : 0.0);
+}
+} // namespace
+
+int main() {
+  printf("bench board=host begin\n");
+  for (uint8_t v = 1; v <= config::AUDIO_NUM_VOICES; v++)
+    benchMix(v);
+  benchParse();
+  benchDecodeClip();
+  printf("bench board=host end\n");
+  return 0;
+}
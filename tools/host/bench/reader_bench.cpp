@@ -0,0 +1,202 @@
+/**
+ * reader_bench.cpp
+ *
+ * Host timings for the toy car's RFID path: TerminalReader::update()
+ * (mkrzero-rx) through the MFRC522 shim, the TCA9548A and WS1850S
+ * stand-ins, every probe the way ToyCarSystem::update() runs it (mux
+ * channel, PCD_Init, update, mux off) once per 100ms pass.
+ *
+ *   probe_no_tag    one probe of an empty reader (REQA times out)
+ *   probe_tag       one probe of a reader with a confirmed tag on it
+ *   arrival         tag placed -> TAG_PRESENT with its data read
+ *   removal         tag taken away -> TAG_ABSENT
+ *   pass_3          ToyCarSystem's whole pass, clamps on + and -, frame empty
+ *
+ * ns_per_op is host time, good for comparing builds on one machine. The
+ * rest comes off the simulated board and is deterministic:
+ *   sim_us_per_op   board time per op (PCD_Init's 50ms reset, I2C at 100kHz,
+ *                   the reader's 25ms timeout; not the wait for the next pass)
+ *   i2c_tx_per_op   I2C transactions per op
+ *   polls_per_op    probes per op (arrival, removal)
+ */
+
+#include "Config.h"
+#include "HostBoard.h"
+#include "I2CBus.h"
+#include "Tca9548a.h"
+#include "TerminalReader.h"
+#include "Ws1850s.h"
+
+#include <chrono>
+#include <stdio.h>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr unsigned long PASS_MS = 100; // ToyCarSystem::rfidCheckIntervalMs
+
+const uint8_t UID_POS[Ntag203::UID_SIZE] = {0x04, 0xA1, 0x5C, 0x22,
+                                            0x6B, 0x41, 0x80};
+const uint8_t UID_NEG[Ntag203::UID_SIZE] = {0x04, 0x3E, 0x91, 0x0A,
+                                            0x7C, 0x52, 0x81};
+
+Ntag203 cableTag(const uint8_t (&uid)[Ntag203::UID_SIZE], const char *type,
+                 uint8_t id) {
+  Ntag203 tag(uid);
+  uint8_t data[8] = {};
+  memcpy(data, type, 3);
+  data[4] = id;
+  for (uint8_t i = 0; i < 5; i++)
+    data[5] ^= data[i];
+  tag.writePage(config::TAG_START_READ_PAGE, &data[0]);
+  tag.writePage(config::TAG_START_READ_PAGE + 1, &data[4]);
+  return tag;
+}
+
+struct Rig {
+  host::Board board{"mkrzero"};
+  TwoWire &wire = (host::select(board), Wire);
+  Tca9548a mux;
+  Ws1850s chips[3]; // by channel
+  I2CBus bus{config::MUX_ADDR};
+  MFRC522DriverI2C driver{config::RFID2_WS1850S_ADDR, wire};
+  MFRC522 reader{driver};
+  TerminalReader terminals[3] = {
+      {config::RFID2_WS1850S_ADDR, "Frame", config::GND_FRAME_CHANNEL},
+      {config::RFID2_WS1850S_ADDR, "Negative",
+       config::NEGATIVE_TERMINAL_CHANNEL},
+      {config::RFID2_WS1850S_ADDR, "Positive",
+       config::POSITIVE_TERMINAL_CHANNEL},
+  };
+  Ntag203 posTag = cableTag(UID_POS, "POS", 1);
+  Ntag203 negTag = cableTag(UID_NEG, "NEG", 2);
+
+  uint64_t hostNs = 0; // spent in the probes
+  uint64_t simUs = 0;
+  uint32_t transactions = 0;
+
+  Rig() {
+    wire.attach(config::MUX_ADDR, &mux);
+    for (uint8_t ch = 0; ch < 3; ch++)
+      mux.attach(ch, config::RFID2_WS1850S_ADDR, &chips[ch]);
+    bus.begin();
+    for (TerminalReader &terminal : terminals) {
+      bus.selectReader(terminal.getChannel());
+      terminal.init(reader);
+    }
+    bus.release();
+  }
+  ~Rig() { wire.detach(config::MUX_ADDR); }
+
+  // one ToyCarSystem pass over `count` terminals from `first`, measured,
+  // then idle until the next one is due
+  void pass(uint8_t first, uint8_t count) {
+    uint64_t startUs = host::nowUs();
+    uint32_t startTx = wire.stats.transactions;
+    Clock::time_point start = Clock::now();
+    for (uint8_t i = first; i < first + count; i++) {
+      bus.selectReader(terminals[i].getChannel());
+      reader.PCD_Init();
+      terminals[i].update(reader);
+    }
+    bus.release();
+    hostNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  Clock::now() - start)
+                  .count();
+    simUs += host::nowUs() - startUs;
+    transactions += wire.stats.transactions - startTx;
+    host::advanceTo(startUs + PASS_MS * 1000);
+  }
+  void probe(uint8_t channel) { pass(channel, 1); }
+
+  void print(const char *name, uint32_t iters, uint32_t polls = 0) {
+    printf("bench board=host name=reader_%s iters=%u total_us=%llu "
+           "ns_per_op=%llu sim_us_per_op=%llu i2c_tx_per_op=%u",
+           name, iters, (unsigned long long)(hostNs / 1000),
+           (unsigned long long)(hostNs / iters),
+           (unsigned long long)(simUs / iters), transactions / iters);
+    if (polls)
+      printf(" polls_per_op=%u", polls / iters);
+    printf("\n");
+  }
+  void resetCounters() {
+    hostNs = 0;
+    simUs = 0;
+    transactions = 0;
+  }
+};
+
+void benchProbeNoTag() {
+  Rig rig;
+  const uint32_t iters = 20000;
+  for (uint32_t i = 0; i < iters; i++)
+    rig.probe(config::GND_FRAME_CHANNEL);
+  rig.print("probe_no_tag", iters);
+}
+
+void benchProbeTag() {
+  Rig rig;
+  rig.chips[config::POSITIVE_TERMINAL_CHANNEL].place(&rig.posTag);
+  TerminalReader &positive = rig.terminals[config::POSITIVE_TERMINAL_CHANNEL];
+  while (positive.getTagState() != TAG_PRESENT)
+    rig.probe(config::POSITIVE_TERMINAL_CHANNEL);
+  rig.resetCounters();
+
+  const uint32_t iters = 20000;
+  for (uint32_t i = 0; i < iters; i++)
+    rig.probe(config::POSITIVE_TERMINAL_CHANNEL);
+  rig.print("probe_tag", iters);
+}
+
+// tag on and off the positive clamp, measured from the change to `until`
+void benchTransition(const char *name, bool arriving, TagState until) {
+  Rig rig;
+  Ws1850s &chip = rig.chips[config::POSITIVE_TERMINAL_CHANNEL];
+  TerminalReader &positive = rig.terminals[config::POSITIVE_TERMINAL_CHANNEL];
+  const uint32_t iters = 2000;
+  uint32_t polls = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    // settle into the starting state unmeasured
+    chip.place(arriving ? nullptr : &rig.posTag);
+    uint64_t hostNs = rig.hostNs, simUs = rig.simUs;
+    uint32_t transactions = rig.transactions;
+    while (positive.getTagState() != (arriving ? TAG_ABSENT : TAG_PRESENT))
+      rig.probe(config::POSITIVE_TERMINAL_CHANNEL);
+    rig.hostNs = hostNs;
+    rig.simUs = simUs;
+    rig.transactions = transactions;
+
+    chip.place(arriving ? &rig.posTag : nullptr);
+    do {
+      rig.probe(config::POSITIVE_TERMINAL_CHANNEL);
+      polls++;
+    } while (positive.getTagState() != until);
+  }
+  rig.print(name, iters, polls);
+}
+
+void benchPass() {
+  Rig rig;
+  rig.chips[config::POSITIVE_TERMINAL_CHANNEL].place(&rig.posTag);
+  rig.chips[config::NEGATIVE_TERMINAL_CHANNEL].place(&rig.negTag);
+  for (int i = 0; i < 10; i++)
+    rig.pass(0, 3);
+  rig.resetCounters();
+
+  const uint32_t iters = 10000;
+  for (uint32_t i = 0; i < iters; i++)
+    rig.pass(0, 3);
+  rig.print("pass_3", iters);
+}
+} // namespace
+
+int main() {
+  printf("bench board=host begin\n");
+  benchProbeNoTag();
+  benchProbeTag();
+  benchTransition("arrival", true, TAG_PRESENT);
+  benchTransition("removal", false, TAG_ABSENT);
+  benchPass();
+  printf("bench board=host end\n");
+  return 0;
+}
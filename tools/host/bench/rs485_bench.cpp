@@ -0,0 +1,290 @@
+/**
+ * rs485_bench.cpp
+ *
+ * RS485Receiver (mkrzero-rx) against noisy, truncated and interleaved byte
+ * streams, at full speed through feed(). Every stream is good frames from
+ * the Leonardo with damage in between, generated from a fixed seed:
+ *
+ *   clean        frames back to back
+ *   noise        line noise bursts between frames
+ *   payload_aa   frames whose payload holds 0xAA and 0x55 bytes
+ *   truncated    frames cut short, the next one follows at once
+ *   bitflip      one bit flipped in a frame
+ *   interleaved  two senders talking over each other, bytes mixed
+ *   mixed        all of the above
+ *
+ * ns_per_op is host time per byte. The rest is deterministic:
+ *   bytes / frames        stream length, good frames in it
+ *   damaged               damaged stretches
+ *   delivered             packets handed to the handler
+ *   lost                  good frames that were not (damaged ones don't count)
+ *   false                 packets that were no good frame: damage that still
+ *                         passed the XOR checksum, about 1 in 256
+ *   late_max_us           worst delay, after a damaged stretch, between the
+ *                         first good frame's last byte and the next packet
+ *                         handed over, at RS485_BAUD_RATE. 0 when the parser
+ *                         is back in sync for that frame; a parser that only
+ *                         recovered through PACKET_READ_TIMEOUT_MS would show
+ *                         the 100ms here
+ *
+ *   rs485_bench                     the scenarios above
+ *   rs485_bench capture.bin...      recorded streams (raw bytes off the
+ *                                   UART): bytes, packets, resyncs, errors
+ *   rs485_bench --corpus DIR        writes each scenario's first 256 bytes
+ *                                   as a fuzz seed (fuzz/corpus/rs485)
+ */
+
+#include "CommPacket.h"
+#include "Config.h"
+#include "HostBoard.h"
+#include "RS485Receiver.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t FRAMES = 20000;
+constexpr uint8_t FRAME = sizeof(WallStatusPacket);
+
+enum Damage : uint8_t {
+  NOISE = 1,
+  PAYLOAD_AA = 2,
+  TRUNCATED = 4,
+  BITFLIP = 8,
+  INTERLEAVED = 16,
+};
+
+struct Scenario {
+  const char *name;
+  uint8_t damage;
+};
+
+const Scenario SCENARIOS[] = {
+    {"clean", 0},
+    {"noise", NOISE},
+    {"payload_aa", PAYLOAD_AA},
+    {"truncated", TRUNCATED},
+    {"bitflip", BITFLIP},
+    {"interleaved", INTERLEAVED},
+    {"mixed", NOISE | PAYLOAD_AA | TRUNCATED | BITFLIP | INTERLEAVED},
+};
+
+uint32_t rngState;
+uint32_t rng(uint32_t bound) {
+  rngState = rngState * 1103515245 + 12345;
+  return (rngState >> 8) % bound;
+}
+
+struct Stream {
+  std::vector<uint8_t> bytes;
+  std::vector<size_t> goodEnds;   // one past the last byte of every good frame
+  std::vector<size_t> damageEnds; // one past every damaged stretch
+};
+
+WallStatusPacket frame(bool aaPayload) {
+  WallStatusPacket pkt = {config::PACKET_START1, config::PACKET_START2, 0, 0,
+                          0, 0, 0, 0};
+  uint8_t *payload = &pkt.BAT_ID;
+  for (uint8_t i = 0; i < 5; i++)
+    payload[i] = aaPayload && rng(2) ? (rng(2) ? 0xAA : 0x55) : rng(4);
+  pkt.CHK = xorChecksum(pkt);
+  return pkt;
+}
+
+void append(std::vector<uint8_t> &bytes, const WallStatusPacket &pkt) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(&pkt);
+  bytes.insert(bytes.end(), p, p + FRAME);
+}
+
+Stream generate(uint8_t damage, uint32_t frames) {
+  rngState = 1;
+  Stream s;
+  for (uint32_t f = 0; f < frames; f++) {
+    // one in four slots is damaged, when the scenario has damage
+    uint8_t kinds[5];
+    uint8_t n = 0;
+    for (uint8_t bit = NOISE; bit <= INTERLEAVED; bit <<= 1) {
+      if ((damage & bit) && bit != PAYLOAD_AA)
+        kinds[n++] = bit;
+    }
+    bool damaged = n && rng(4) == 0;
+    uint8_t kind = damaged ? kinds[rng(n)] : 0;
+    WallStatusPacket pkt = frame((damage & PAYLOAD_AA) && rng(2));
+
+    switch (kind) {
+    case NOISE: {
+      uint8_t len = 1 + rng(12);
+      for (uint8_t i = 0; i < len; i++)
+        s.bytes.push_back(rng(3) ? rng(256) : config::PACKET_START1);
+      break;
+    }
+    case TRUNCATED:
+      append(s.bytes, pkt);
+      s.bytes.resize(s.bytes.size() - 1 - rng(FRAME - 1));
+      break;
+    case BITFLIP:
+      append(s.bytes, pkt);
+      // never the start pair: that frame would just be noise
+      s.bytes[s.bytes.size() - 1 - rng(FRAME - 2)] ^= 1 << rng(8);
+      break;
+    case INTERLEAVED: {
+      // runs of 1-3 bytes taking turns, so neither frame stays whole
+      WallStatusPacket other = frame(false);
+      const uint8_t *from[2] = {reinterpret_cast<const uint8_t *>(&pkt),
+                                reinterpret_cast<const uint8_t *>(&other)};
+      uint8_t used[2] = {0, 0};
+      for (uint8_t turn = 0; used[0] < FRAME || used[1] < FRAME; turn ^= 1) {
+        for (uint8_t run = 1 + rng(3); run && used[turn] < FRAME; run--)
+          s.bytes.push_back(from[turn][used[turn]++]);
+      }
+      break;
+    }
+    }
+    if (kind)
+      s.damageEnds.push_back(s.bytes.size());
+    if (kind && kind != NOISE)
+      continue; // noise comes before an intact frame, the rest replace it
+    append(s.bytes, pkt);
+    s.goodEnds.push_back(s.bytes.size());
+  }
+  return s;
+}
+
+// the position in the stream of every packet handed over
+struct Delivery {
+  size_t position = 0;
+  std::vector<size_t> ends;
+};
+
+void record(const WallStatusPacket &, void *context) {
+  Delivery *d = static_cast<Delivery *>(context);
+  d->ends.push_back(d->position + 1);
+}
+
+Delivery deliver(const std::vector<uint8_t> &bytes, RS485Receiver &rx) {
+  Delivery d;
+  rx.setPacketHandler(record, &d);
+  for (d.position = 0; d.position < bytes.size(); d.position++)
+    rx.feed(&bytes[d.position], 1);
+  return d;
+}
+
+void runScenario(const Scenario &scenario) {
+  Stream s = generate(scenario.damage, FRAMES);
+
+  RS485Receiver rx(Serial1);
+  rx.begin(config::RS485_BAUD_RATE);
+  Delivery d = deliver(s.bytes, rx);
+
+  // a good frame is lost if no packet was handed over at its last byte
+  uint32_t lost = 0;
+  size_t k = 0;
+  for (size_t end : s.goodEnds) {
+    while (k < d.ends.size() && d.ends[k] < end)
+      k++;
+    if (k == d.ends.size() || d.ends[k] != end)
+      lost++;
+  }
+  uint32_t falsePackets = d.ends.size() - (s.goodEnds.size() - lost);
+
+  size_t lateMaxBytes = 0;
+  size_t g = 0;
+  k = 0;
+  for (size_t end : s.damageEnds) {
+    while (g < s.goodEnds.size() && s.goodEnds[g] <= end)
+      g++;
+    if (g == s.goodEnds.size())
+      break;
+    while (k < d.ends.size() && d.ends[k] < s.goodEnds[g])
+      k++;
+    size_t delivered = k < d.ends.size() ? d.ends[k] : s.bytes.size();
+    if (delivered - s.goodEnds[g] > lateMaxBytes)
+      lateMaxBytes = delivered - s.goodEnds[g];
+  }
+  uint64_t byteUs = 10000000ULL / config::RS485_BAUD_RATE; // 8N1
+
+  // timing: the whole stream in feed() sized pieces, a few times over
+  const uint32_t reps = 10;
+  Clock::time_point start = Clock::now();
+  for (uint32_t r = 0; r < reps; r++) {
+    RS485Receiver timed(Serial1);
+    for (size_t offset = 0; offset < s.bytes.size(); offset += 0xFFFF) {
+      size_t n = s.bytes.size() - offset;
+      timed.feed(&s.bytes[offset], n < 0xFFFF ? n : 0xFFFF);
+    }
+  }
+  uint64_t totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         Clock::now() - start)
+                         .count();
+  uint64_t iters = uint64_t(reps) * s.bytes.size();
+
+  printf("bench board=host name=rs485_%s iters=%llu total_us=%llu "
+         "ns_per_op=%llu bytes=%zu frames=%zu damaged=%zu delivered=%zu "
+         "lost=%u false=%u late_max_us=%llu\n",
+         scenario.name, (unsigned long long)iters,
+         (unsigned long long)(totalNs / 1000),
+         (unsigned long long)(totalNs / iters), s.bytes.size(),
+         s.goodEnds.size(), s.damageEnds.size(), d.ends.size(), lost,
+         falsePackets, (unsigned long long)(lateMaxBytes * byteUs));
+}
+
+int replayCapture(const char *path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    fprintf(stderr, "rs485_bench: can't read %s\n", path);
+    return 1;
+  }
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                             std::istreambuf_iterator<char>());
+  RS485Receiver rx(Serial1);
+  rx.begin(config::RS485_BAUD_RATE);
+  Delivery d = deliver(bytes, rx);
+  const RS485RxStats &stats = rx.getStats();
+  printf("capture %s bytes=%zu packets=%zu resyncs=%u checksum_errors=%u\n",
+         path, bytes.size(), d.ends.size(), stats.resyncs,
+         stats.checksumErrors);
+  return 0;
+}
+
+int writeCorpus(const std::string &dir) {
+  for (const Scenario &scenario : SCENARIOS) {
+    Stream s = generate(scenario.damage, 32);
+    if (s.bytes.size() > 256)
+      s.bytes.resize(256);
+    std::string path = dir + "/" + scenario.name + ".bin";
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(s.bytes.data()), s.bytes.size());
+    if (!out) {
+      fprintf(stderr, "rs485_bench: can't write %s\n", path.c_str());
+      return 1;
+    }
+  }
+  return 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !strcmp(argv[1], "--corpus"))
+    return writeCorpus(argv[2]);
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      if (replayCapture(argv[i]))
+        return 1;
+    }
+    return 0;
+  }
+
+  printf("bench board=host begin\n");
+  for (const Scenario &scenario : SCENARIOS)
+    runScenario(scenario);
+  printf("bench board=host end\n");
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include "ClipEncoder.h"
+
+#include <stdio.h>
+
+namespace {
+constexpr uint8_t CLIP_VERSION = 1;
+}
+
+ClipEncoder::ClipEncoder(uint8_t fps, uint16_t pixels) : pixels(pixels) {
+  data = {'L', 'C', CLIP_VERSION, fps, uint8_t(pixels & 0xFF),
+          uint8_t(pixels >> 8), 0, 0};
+}
+
+void ClipEncoder::addFrame(const CRGB *frame) {
+  size_t lengthAt = data.size();
+  data.push_back(0);
+  data.push_back(0);
+
+  uint16_t i = 0;
+  while (i < pixels) {
+    uint8_t count = 1;
+    while (i + count < pixels && count < 255 && frame[i + count] == frame[i])
+      count++;
+    data.push_back(count);
+    data.push_back(frame[i].r);
+    data.push_back(frame[i].g);
+    data.push_back(frame[i].b);
+    i += count;
+  }
+
+  size_t length = data.size() - lengthAt - 2;
+  data[lengthAt] = length & 0xFF;
+  data[lengthAt + 1] = length >> 8;
+  frameCount++;
+  data[6] = frameCount & 0xFF;
+  data[7] = frameCount >> 8;
+}
+
+std::string ClipEncoder::toCArray(const std::string &name) const {
+  std::string out = "inline constexpr uint8_t " + name + "[] = {";
+  char hex[8];
+  for (size_t i = 0; i < data.size(); i++) {
+    snprintf(hex, sizeof(hex), "0x%02X,", data[i]);
+    out += (i % 12) ? " " : "\n    ";
+    out += hex;
+  }
+  out += "\n};\n";
+  return out;
+}
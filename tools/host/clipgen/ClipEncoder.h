@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * ClipEncoder.h
+ *
+ * Frames -> the RLE clip format ClipPlayer plays (rp2040/ClipPlayer.h):
+ * 'L' 'C' version fps pixels frames, then per frame its byte length and
+ * [count, r, g, b] runs. Runs longer than 255 pixels are split.
+ */
+
+#include <FastLED.h>
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+class ClipEncoder {
+public:
+  ClipEncoder(uint8_t fps, uint16_t pixels);
+
+  void addFrame(const CRGB *frame);
+  uint16_t frames() const { return frameCount; }
+  const std::vector<uint8_t> &bytes() const { return data; }
+
+  // `inline constexpr uint8_t NAME[] = {...};`, as laid out in ClipData.h
+  std::string toCArray(const std::string &name) const;
+
+private:
+  uint16_t pixels;
+  uint16_t frameCount = 0;
+  std::vector<uint8_t> data;
+};
@@ -0,0 +1,40 @@
+#include "Effects.h"
+#include "Config.h"
+
+#include <string.h>
+
+namespace {
+// ClipData.h's COMET: head at 2 pixels per frame, 11 pixel tail fading
+// linearly from 11/12 to 1/12 of the tail colour, wraps around the strip
+constexpr uint8_t COMET_LENGTH = 12; // head + tail
+constexpr uint8_t COMET_STEP = 2;
+const CRGB COMET_HEAD(200, 220, 255);
+const CRGB COMET_TAIL(40, 120, 255);
+
+void renderComet(uint16_t frame, CRGB *leds, uint16_t numLEDs) {
+  fill_solid(leds, numLEDs, CRGB::Black);
+  uint16_t head = (uint32_t(frame) * COMET_STEP) % numLEDs;
+  leds[head] = COMET_HEAD;
+  for (uint8_t j = 1; j < COMET_LENGTH; j++) {
+    uint8_t level = 255 * j / COMET_LENGTH;
+    uint16_t pos = (head + numLEDs - (COMET_LENGTH - j)) % numLEDs;
+    leds[pos] = CRGB(COMET_TAIL.r * level / 255, COMET_TAIL.g * level / 255,
+                     COMET_TAIL.b * level / 255);
+  }
+}
+} // namespace
+
+const Effect EFFECTS[] = {
+    {"comet", "blue-white comet with a 12 pixel tail, 2 pixels per frame, "
+              "loops",
+     60, config::NUM_LEDS / COMET_STEP, renderComet},
+};
+const uint8_t NUM_EFFECTS = sizeof(EFFECTS) / sizeof(EFFECTS[0]);
+
+const Effect *findEffect(const char *name) {
+  for (uint8_t i = 0; i < NUM_EFFECTS; i++) {
+    if (strcmp(EFFECTS[i].name, name) == 0)
+      return &EFFECTS[i];
+  }
+  return nullptr;
+}
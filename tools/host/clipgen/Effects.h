@@ -0,0 +1,26 @@
+#pragma once
+/**
+ * Effects.h
+ *
+ * Procedural effects clipgen renders into clips. Each one draws a single
+ * frame from its index alone, so a clip is just frames 0..frames-1 and
+ * loops cleanly. Integer maths only, the bytes come out the same on every
+ * machine.
+ */
+
+#include <FastLED.h>
+
+#include <stdint.h>
+
+struct Effect {
+  const char *name;
+  const char *description; // the comment above the clip in ClipData.h
+  uint8_t fps;
+  uint16_t frames; // for a NUM_LEDS wide strip
+  void (*render)(uint16_t frame, CRGB *leds, uint16_t numLEDs);
+};
+
+extern const Effect EFFECTS[];
+extern const uint8_t NUM_EFFECTS;
+
+const Effect *findEffect(const char *name);
@@ -0,0 +1,157 @@
+/**
+ * clipgen.cpp
+ *
+ * Renders clips for rp2040/ClipData.h offline.
+ *
+ *   clipgen list                        procedural effects
+ *   clipgen effect comet [--name COMET] [--ppm out.ppm] [-o out.bin]
+ *   clipgen ppm in.ppm --fps 60 [--scale 4] [--name NAME] [-o out.bin]
+ *
+ * `effect` renders one of Effects.cpp frame by frame, `ppm` converts a
+ * picture with one row per frame (animvm run --ppm, or anything drawn by
+ * hand at NUM_LEDS x frames). Without -o the clip is printed as the C array
+ * to paste into ClipData.h; its pointer then goes into CLIPS.
+ */
+
+#include "ClipEncoder.h"
+#include "Config.h"
+#include "Effects.h"
+#include "FrameImage.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+namespace {
+int usage() {
+  fprintf(stderr,
+          "usage: clipgen list\n"
+          "       clipgen effect <name> [--name NAME] [--ppm OUT] [-o OUT]\n"
+          "       clipgen ppm <in.ppm> --fps N [--scale S] [--name NAME]"
+          " [-o OUT]\n");
+  return 2;
+}
+
+struct Options {
+  std::string name;
+  const char *outPath = nullptr;
+  const char *ppmPath = nullptr;
+  uint8_t fps = 0;
+  uint8_t scale = 4;
+};
+
+bool parseOptions(int argc, char **argv, Options &opt) {
+  for (int i = 0; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--name"))
+      opt.name = argv[i + 1];
+    else if (!strcmp(argv[i], "-o"))
+      opt.outPath = argv[i + 1];
+    else if (!strcmp(argv[i], "--ppm"))
+      opt.ppmPath = argv[i + 1];
+    else if (!strcmp(argv[i], "--fps"))
+      opt.fps = strtoul(argv[i + 1], nullptr, 10);
+    else if (!strcmp(argv[i], "--scale"))
+      opt.scale = strtoul(argv[i + 1], nullptr, 10);
+    else
+      return false;
+  }
+  return argc % 2 == 0;
+}
+
+int emit(const ClipEncoder &clip, const Options &opt,
+         const char *description) {
+  if (opt.outPath) {
+    FILE *f = fopen(opt.outPath, "wb");
+    const std::vector<uint8_t> &bytes = clip.bytes();
+    if (!f || fwrite(bytes.data(), 1, bytes.size(), f) != bytes.size()) {
+      fprintf(stderr, "clipgen: can't write %s\n", opt.outPath);
+      return 1;
+    }
+    fclose(f);
+  } else {
+    printf("// %s\n%s", description, clip.toCArray(opt.name).c_str());
+  }
+  fprintf(stderr, "clipgen: %u frames, %zu bytes\n", clip.frames(),
+          clip.bytes().size());
+  return 0;
+}
+
+int runEffect(const char *effectName, const Options &opt) {
+  const Effect *effect = findEffect(effectName);
+  if (!effect) {
+    fprintf(stderr, "clipgen: no effect '%s' (clipgen list)\n", effectName);
+    return 1;
+  }
+
+  CRGB leds[config::NUM_LEDS];
+  ClipEncoder clip(effect->fps, config::NUM_LEDS);
+  FrameImage image(config::NUM_LEDS, opt.scale);
+  for (uint16_t f = 0; f < effect->frames; f++) {
+    effect->render(f, leds, config::NUM_LEDS);
+    clip.addFrame(leds);
+    image.addFrame(leds);
+  }
+  if (opt.ppmPath && !image.writePpm(opt.ppmPath)) {
+    fprintf(stderr, "clipgen: can't write %s\n", opt.ppmPath);
+    return 1;
+  }
+  return emit(clip, opt, effect->description);
+}
+
+int runPpm(const char *inPath, const Options &opt) {
+  if (opt.fps == 0)
+    return usage();
+  FrameImage image(config::NUM_LEDS, opt.scale);
+  if (!image.readPpm(inPath)) {
+    fprintf(stderr, "clipgen: can't read %s as a scale %u PPM\n", inPath,
+            opt.scale);
+    return 1;
+  }
+  // ClipPlayer refuses a clip that isn't exactly the strip
+  if (image.width() != config::NUM_LEDS || image.frames() == 0 ||
+      image.frames() > 0xFFFF) {
+    fprintf(stderr, "clipgen: %s is %u x %u, need %u pixels wide\n", inPath,
+            image.width(), image.frames(), config::NUM_LEDS);
+    return 1;
+  }
+
+  ClipEncoder clip(opt.fps, image.width());
+  for (uint32_t f = 0; f < image.frames(); f++)
+    clip.addFrame(image.frame(f));
+  return emit(clip, opt, inPath);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 2 && !strcmp(argv[1], "list")) {
+    for (uint8_t i = 0; i < NUM_EFFECTS; i++)
+      printf("%-10s %u frames @ %ufps  %s\n", EFFECTS[i].name,
+             EFFECTS[i].frames, EFFECTS[i].fps, EFFECTS[i].description);
+    return 0;
+  }
+  if (argc < 3)
+    return usage();
+
+  Options opt;
+  if (!parseOptions(argc - 3, argv + 3, opt))
+    return usage();
+  if (opt.name.empty()) {
+    // COMET from comet, FOO from foo.ppm
+    std::string base = argv[2];
+    size_t slash = base.find_last_of('/');
+    if (slash != std::string::npos)
+      base = base.substr(slash + 1);
+    base = base.substr(0, base.find('.'));
+    for (char c : base)
+      opt.name += isalnum(static_cast<unsigned char>(c)) ? toupper(c) : '_';
+  }
+
+  if (!strcmp(argv[1], "effect"))
+    return runEffect(argv[2], opt);
+  if (!strcmp(argv[1], "ppm"))
+    return runPpm(argv[2], opt);
+  return usage();
+}
@@ -0,0 +1,101 @@
+/**
+ * rs485_fuzz.cpp
+ *
+ * Fuzz target for RS485Receiver's framing (mkrzero-rx). The input is the
+ * byte stream off the UART. Whatever the receiver hands to its packet
+ * handler has to be exactly what a reference parser finds in the same bytes:
+ * try every 0xAA 0x55 in order, take the first 8 bytes with a good checksum,
+ * carry on after them. That is the resync rule RS485Receiver.h promises (a
+ * bad frame costs only itself), so any difference is a desync: a good frame
+ * lost behind a bad one, or a frame made up of bytes from two.
+ *
+ * The stream goes through twice, once with feed() and once through Serial1
+ * and update() in UART-sized chunks. Both have to agree with the reference;
+ * the clock doesn't move, so the read timeout never fires.
+ *
+ * Entry point is libFuzzer's; `make fuzz` builds it with clang, without clang
+ * replay_main.cpp drives the same function over a corpus (`make test` runs
+ * the committed one).
+ */
+
+#include "CommPacket.h"
+#include "Config.h"
+#include "HostBoard.h"
+#include "RS485Receiver.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+namespace {
+std::vector<WallStatusPacket> reference(const uint8_t *data, size_t size) {
+  std::vector<WallStatusPacket> packets;
+  size_t p = 0;
+  while (p + sizeof(WallStatusPacket) <= size) {
+    WallStatusPacket pkt;
+    memcpy(&pkt, data + p, sizeof(pkt));
+    if (pkt.START1 == config::PACKET_START1 &&
+        pkt.START2 == config::PACKET_START2 && pkt.CHK == xorChecksum(pkt)) {
+      packets.push_back(pkt);
+      p += sizeof(pkt);
+    } else {
+      p++;
+    }
+  }
+  return packets;
+}
+
+void collect(const WallStatusPacket &pkt, void *context) {
+  static_cast<std::vector<WallStatusPacket> *>(context)->push_back(pkt);
+}
+
+void check(const char *path, const std::vector<WallStatusPacket> &want,
+           const std::vector<WallStatusPacket> &got, size_t size) {
+  bool same = want.size() == got.size();
+  for (size_t i = 0; same && i < want.size(); i++)
+    same = memcmp(&want[i], &got[i], sizeof(WallStatusPacket)) == 0;
+  if (same)
+    return;
+  fprintf(stderr,
+          "rs485_fuzz: %s desync on a %zu byte stream: %zu packets, "
+          "reference %zu\n",
+          path, size, got.size(), want.size());
+  abort();
+}
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  std::vector<WallStatusPacket> want = reference(data, size);
+
+  std::vector<WallStatusPacket> got;
+  RS485Receiver rx(Serial1);
+  rx.begin(config::RS485_BAUD_RATE);
+  rx.setPacketHandler(collect, &got);
+  // feed() takes a uint16_t count
+  for (size_t offset = 0; offset < size; offset += 0xFFFF) {
+    size_t n = size - offset < 0xFFFF ? size - offset : 0xFFFF;
+    rx.feed(data + offset, n);
+  }
+  check("feed()", want, got, size);
+
+  // SAMD's Serial1 RX ring is 64 bytes, update() drains it
+  got.clear();
+  RS485Receiver uart(Serial1);
+  uart.begin(config::RS485_BAUD_RATE);
+  uart.setPacketHandler(collect, &got);
+  for (size_t offset = 0; offset < size; offset += 64) {
+    size_t n = size - offset < 64 ? size - offset : 64;
+    Serial1.inject(data + offset, n);
+    uart.update();
+  }
+  check("update()", want, got, size);
+
+  const RS485RxStats &stats = rx.getStats();
+  if (stats.packets != want.size()) {
+    fprintf(stderr, "rs485_fuzz: stats.packets %u, handed over %zu\n",
+            stats.packets, want.size());
+    abort();
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * golden.cpp
+ *
+ * The RP2040's golden runs on the host: LEDController.cpp built against the
+ * FastLED shim and the host WS2815Driver, renderGolden() called the way
+ * "g<mode> <frames> <seed>" on the board's USB serial calls it, and its
+ * output read back from the shim's Serial.
+ *
+ *   golden expected.txt            run every case, exit 1 on a changed hash
+ *   golden expected.txt --write    rewrite the hashes in the file
+ *   golden expected.txt --ppm DIR  also write every case's frames to
+ *                                  DIR/mode_<mode>_<frames>_<seed>.ppm
+ *
+ * The file holds the cases and their expected results:
+ *   program <slot> <prog.s>   assembled and put in the ProgramStore slot
+ *                             before any case runs (modes 0x20 + slot)
+ *   golden mode=0x.. frames=N seed=S fps=F hash=H
+ *                             renderGolden's summary line, minus the us_
+ *                             timings (those are host numbers)
+ * `#` lines are comments. The same summary from the board means the host
+ * build and the board agree.
+ */
+
+#include "Assembler.h"
+#include "Config.h"
+#include "FrameImage.h"
+#include "LEDController.h"
+#include "ProgramStore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+int usage() {
+  fprintf(stderr, "usage: golden <expected.txt> [--write] [--ppm DIR]\n");
+  return 2;
+}
+
+bool loadProgram(const std::string &line) {
+  unsigned slot;
+  char path[256];
+  if (sscanf(line.c_str(), "program %u %255s", &slot, path) != 2)
+    return false;
+
+  std::ifstream in(path);
+  std::stringstream source;
+  source << in.rdbuf();
+  std::vector<uint8_t> code;
+  std::string error;
+  if (!in || !assemble(source.str(), code, error)) {
+    fprintf(stderr, "golden: %s: %s\n", path,
+            in ? error.c_str() : "can't read");
+    return false;
+  }
+
+  // what the I2C / USB upload does, in one go
+  uint8_t checksum = 0;
+  for (uint8_t b : code)
+    checksum ^= b;
+  bool ok = programStore.beginUpload(slot, code.size());
+  for (size_t offset = 0; ok && offset < code.size(); offset += 128) {
+    size_t n = code.size() - offset < 128 ? code.size() - offset : 128;
+    ok = programStore.writeChunk(offset, code.data() + offset, n);
+  }
+  return ok && programStore.commit(checksum);
+}
+
+// everything the board printed since the last call, line by line
+std::vector<std::string> takeSerialLines() {
+  std::vector<std::string> lines;
+  std::string line;
+  while (!Serial.output.empty()) {
+    char c = Serial.output.front();
+    Serial.output.pop_front();
+    if (c == '\n') {
+      lines.push_back(line);
+      line.clear();
+    } else if (c != '\r') {
+      line += c;
+    }
+  }
+  return lines;
+}
+
+struct GoldenRun {
+  std::string summary; // without us_avg / us_max
+  FrameImage image{config::NUM_LEDS};
+};
+
+GoldenRun run(LEDController &controller, uint8_t mode, uint16_t frames,
+              uint32_t seed, bool pixels) {
+  takeSerialLines();
+  controller.renderGolden(mode, frames, seed, pixels);
+
+  GoldenRun result;
+  CRGB frame[config::NUM_LEDS];
+  for (const std::string &line : takeSerialLines()) {
+    if (line.rfind("golden mode=", 0) == 0) {
+      result.summary = line.substr(0, line.find(" us_avg="));
+    } else if (line.rfind("golden pixels=", 0) == 0) {
+      const char *hex = line.c_str() + strlen("golden pixels=");
+      uint8_t *bytes = reinterpret_cast<uint8_t *>(frame);
+      for (size_t i = 0; i < sizeof(frame) && hex[2 * i]; i++)
+        sscanf(hex + 2 * i, "%2hhx", &bytes[i]);
+      result.image.addFrame(frame);
+    }
+  }
+  return result;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2)
+    return usage();
+  const char *path = argv[1];
+  bool write = false;
+  const char *ppmDir = nullptr;
+  for (int i = 2; i < argc; i++) {
+    if (!strcmp(argv[i], "--write"))
+      write = true;
+    else if (!strcmp(argv[i], "--ppm") && i + 1 < argc)
+      ppmDir = argv[++i];
+    else
+      return usage();
+  }
+
+  std::ifstream in(path);
+  if (!in) {
+    fprintf(stderr, "golden: can't read %s\n", path);
+    return 1;
+  }
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);)
+    lines.push_back(line);
+
+  // boots like the board: startup colours go to the (host) strip
+  static LEDController controller;
+  controller.initialize();
+
+  for (const std::string &line : lines) {
+    if (line.rfind("program ", 0) == 0 && !loadProgram(line)) {
+      fprintf(stderr, "golden: bad line '%s'\n", line.c_str());
+      return 1;
+    }
+  }
+
+  int cases = 0;
+  int failed = 0;
+  for (std::string &line : lines) {
+    unsigned mode, frames;
+    unsigned long seed;
+    if (sscanf(line.c_str(), "golden mode=0x%x frames=%u seed=%lu", &mode,
+               &frames, &seed) != 3)
+      continue;
+
+    GoldenRun result = run(controller, mode, frames, seed, ppmDir);
+    cases++;
+    if (result.summary != line) {
+      if (!write) {
+        failed++;
+        printf("golden: FAIL\n  want %s\n  got  %s\n", line.c_str(),
+               result.summary.c_str());
+      }
+      line = result.summary;
+    }
+    if (ppmDir) {
+      char ppm[512];
+      snprintf(ppm, sizeof(ppm), "%s/mode_%02x_%u_%lu.ppm", ppmDir, mode,
+               frames, seed);
+      if (!result.image.writePpm(ppm)) {
+        fprintf(stderr, "golden: can't write %s\n", ppm);
+        return 1;
+      }
+    }
+  }
+
+  if (write) {
+    std::ofstream out(path);
+    for (const std::string &line : lines)
+      out << line << '\n';
+  }
+  printf("golden: %d cases, %d failed\n", cases, failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+#include "HostBoard.h"
+
+#include <stdarg.h>
+
+namespace host {
+namespace {
+Board defaultBoard("host");
+Board *current = &defaultBoard;
+} // namespace
+
+Board &board() { return *current; }
+void select(Board &b) { current = &b; }
+HardwareSerial &serialPort(uint8_t index) { return current->serial[index]; }
+} // namespace host
+
+// ========== TIME ==========
+unsigned long millis() {
+  return static_cast<unsigned long>(host::nowUs() / 1000);
+}
+
+unsigned long micros() { return static_cast<unsigned long>(host::nowUs()); }
+
+void delay(unsigned long ms) { host::advanceUs(uint64_t(ms) * 1000); }
+
+void delayMicroseconds(unsigned int us) { host::advanceUs(us); }
+
+void yield() {}
+
+// ========== GPIO ==========
+void pinMode(uint8_t pin, uint8_t mode) {
+  host::Board &b = host::board();
+  if (pin >= host::Board::NUM_PINS)
+    return;
+  b.pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP)
+    b.pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  host::Board &b = host::board();
+  if (pin >= host::Board::NUM_PINS)
+    return;
+  b.pinLevel[pin] = level ? HIGH : LOW;
+  if (b.onPinWrite)
+    b.onPinWrite(b, pin, b.pinLevel[pin]);
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= host::Board::NUM_PINS)
+    return LOW;
+  return host::board().pinLevel[pin];
+}
+
+// ========== RANDOM (newlib rand/srand) ==========
+static long newlibRand() {
+  uint64_t &next = host::board().randomNext;
+  next = next * 6364136223846793005ULL + 1;
+  return static_cast<long>((next >> 32) & 0x7FFFFFFF);
+}
+
+long random(long howbig) {
+  if (howbig == 0)
+    return 0;
+  return newlibRand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig)
+    return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0)
+    host::board().randomNext = seed;
+}
+
+// ========== PRINT ==========
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--)
+    n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printSigned(long n, int base) {
+  if (base == DEC && n < 0) {
+    size_t t = print('-');
+    return t + printNumber(0UL - static_cast<unsigned long>(n), DEC);
+  }
+  return printNumber(static_cast<unsigned long>(n), base);
+}
+
+size_t Print::printNumber(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2)
+    base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(double number, int digits) {
+  if (isnan(number))
+    return print("nan");
+  if (isinf(number))
+    return print("inf");
+
+  size_t n = 0;
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+
+  double rounding = 0.5;
+  for (int i = 0; i < digits; ++i)
+    rounding /= 10.0;
+  number += rounding;
+
+  unsigned long intPart = static_cast<unsigned long>(number);
+  double remainder = number - static_cast<double>(intPart);
+  n += print(intPart);
+  if (digits > 0)
+    n += print('.');
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int digit = static_cast<unsigned int>(remainder);
+    n += print(digit);
+    remainder -= digit;
+  }
+  return n;
+}
+
+size_t Print::printf(const char *format, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0)
+    return 0;
+  if (static_cast<size_t>(len) < sizeof(buf))
+    return write(reinterpret_cast<const uint8_t *>(buf), len);
+
+  char *big = static_cast<char *>(malloc(len + 1));
+  va_start(args, format);
+  vsnprintf(big, len + 1, format, args);
+  va_end(args);
+  size_t n = write(reinterpret_cast<const uint8_t *>(big), len);
+  free(big);
+  return n;
+}
+
+// ========== STREAM ==========
+size_t Stream::readBytes(uint8_t *buffer, size_t length) {
+  size_t n = 0;
+  unsigned long start = millis();
+  while (n < length) {
+    if (available()) {
+      buffer[n++] = static_cast<uint8_t>(read());
+    } else if (millis() - start >= timeoutMs) {
+      break;
+    } else {
+      delayMicroseconds(10);
+    }
+  }
+  return n;
+}
+
+// ========== HARDWARE SERIAL ==========
+int HardwareSerial::available() {
+  uint64_t now = host::nowUs();
+  int n = 0;
+  for (const RxByte &b : rx) {
+    if (b.atUs > now)
+      break;
+    n++;
+  }
+  return n;
+}
+
+int HardwareSerial::read() {
+  if (rx.empty() || rx.front().atUs > host::nowUs())
+    return -1;
+  uint8_t value = rx.front().value;
+  rx.pop_front();
+  return value;
+}
+
+int HardwareSerial::peek() {
+  if (rx.empty() || rx.front().atUs > host::nowUs())
+    return -1;
+  return rx.front().value;
+}
+
+size_t HardwareSerial::write(uint8_t b) {
+  if (!peer) {
+    output.push_back(b);
+    if (echo)
+      fputc(b, stdout);
+    return 1;
+  }
+
+  // the byte lands at the far end once it has been shifted out, after
+  // anything still queued ahead of it
+  uint64_t now = host::nowUs();
+  uint64_t start = lineFreeUs > now ? lineFreeUs : now;
+  lineFreeUs = start + byteTimeUs();
+  peer->receive(b, lineFreeUs);
+  return 1;
+}
+
+void HardwareSerial::flush() { host::advanceTo(lineFreeUs); }
+
+void HardwareSerial::receive(uint8_t b, uint64_t atUs) {
+  rx.push_back({b, atUs});
+}
+
+void HardwareSerial::inject(const uint8_t *data, size_t len) {
+  uint64_t now = host::nowUs();
+  for (size_t i = 0; i < len; i++)
+    rx.push_back({data[i], now});
+}
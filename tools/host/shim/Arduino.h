@@ -0,0 +1,177 @@
+#pragma once
+/**
+ * Arduino.h (host shim)
+ *
+ * Just enough of the Arduino core for the firmware sources to build and run
+ * on Linux under tools/host. Time is simulated: millis()/micros() read the
+ * current board's clock (HostBoard.h) and delay() advances it, so a test or
+ * simulator decides exactly how long everything takes.
+ *
+ * - Serial, Serial1 are macros for the current board's ports (the SAMD core
+ *   does the same with `#define Serial SerialUSB`)
+ * - a HardwareSerial paces its output at the configured baud rate and hands
+ *   each byte to whatever is connected to it (another port, a device model)
+ * - random()/randomSeed() follow newlib's rand(), like arduino-pico and the
+ *   SAMD core, not the host libc
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <deque>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define PI 3.1415926535897932384626433832795
+#define TWO_PI 6.283185307179586476925286766559
+#define DEC 10
+#define HEX 16
+
+#define F(x) x
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#ifndef F_CPU
+#define F_CPU 48000000L
+#endif
+
+enum { A0 = 14, A1, A2, A3, A4, A5, A6 };
+enum { D0 = 0, D1, D2, D3, D4, D5, D6, D7, D8, D9, D10 }; // XIAO RP2040
+
+template <class T> T min(T a, T b) { return a < b ? a : b; }
+template <class T> T max(T a, T b) { return a > b ? a : b; }
+
+// ----- TIME -----
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// ----- GPIO -----
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// ----- RANDOM -----
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ----- PRINT / STREAM -----
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) {
+    return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+  }
+  virtual void flush() {}
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write(uint8_t(c)); }
+  size_t print(unsigned char n, int base = DEC) {
+    return printNumber(n, base);
+  }
+  size_t print(int n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned int n, int base = DEC) { return printNumber(n, base); }
+  size_t print(long n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned long n, int base = DEC) {
+    return printNumber(n, base);
+  }
+  size_t print(double n, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(T value) {
+    size_t n = print(value);
+    return n + println();
+  }
+  template <class T> size_t println(T value, int format) {
+    size_t n = print(value, format);
+    return n + println();
+  }
+
+  size_t printf(const char *format, ...)
+      __attribute__((format(printf, 2, 3)));
+
+private:
+  size_t printSigned(long n, int base);
+  size_t printNumber(unsigned long n, int base);
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long ms) { timeoutMs = ms; }
+  size_t readBytes(uint8_t *buffer, size_t length);
+
+protected:
+  unsigned long timeoutMs = 1000;
+};
+
+namespace host {
+// anything a serial port can be wired to: another port, a device model
+struct SerialPeer {
+  virtual ~SerialPeer() {}
+  virtual void receive(uint8_t b, uint64_t atUs) = 0;
+};
+} // namespace host
+
+class HardwareSerial : public Stream, public host::SerialPeer {
+public:
+  virtual void begin(unsigned long baud) { baudRate = baud; }
+  virtual void end() {}
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t b) override;
+  using Print::write;
+  void flush() override; // blocks (advances the clock) until the line is idle
+  int availableForWrite() { return 64; }
+  operator bool() const { return true; }
+
+  // ----- host side -----
+  // bytes written go to `peer` (nothing connected: kept in `output`)
+  void connect(host::SerialPeer *to) { peer = to; }
+  void receive(uint8_t b, uint64_t atUs) override;
+  void inject(const uint8_t *data, size_t len); // arrives now
+  uint64_t byteTimeUs() const { return baudRate ? 10000000ULL / baudRate : 0; }
+  bool echo = false; // copy unconnected output to stdout
+  std::deque<uint8_t> output;
+
+private:
+  struct RxByte {
+    uint8_t value;
+    uint64_t atUs;
+  };
+  unsigned long baudRate = 0;
+  uint64_t lineFreeUs = 0; // end of the last byte still being shifted out
+  host::SerialPeer *peer = nullptr;
+  std::deque<RxByte> rx;
+};
+
+// SAMD SERCOM UART, only constructed by the UART audio backend
+class Uart : public HardwareSerial {};
+
+namespace host {
+HardwareSerial &serialPort(uint8_t index);
+}
+
+#define Serial (::host::serialPort(0))
+#define Serial1 (::host::serialPort(1))
@@ -0,0 +1,168 @@
+#include "FastLED.h"
+
+uint16_t rand16seed = 1337; // RAND16_SEED
+CFastLED FastLED;
+
+// FASTLED_BLEND_FIXED: exact, no rounding loss at either end
+uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+  uint16_t partial = uint16_t(a << 8) | b;
+  partial += uint16_t(b * amountOfB);
+  partial -= uint16_t(a * amountOfB);
+  return partial >> 8;
+}
+
+// sin8_C: piecewise linear, 4 segments per quarter wave
+uint8_t sin8(uint8_t theta) {
+  static const uint8_t b_m16_interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+
+  uint8_t offset = theta;
+  if (theta & 0x40)
+    offset = uint8_t(255) - offset;
+  offset &= 0x3F;
+
+  uint8_t secoffset = offset & 0x0F;
+  if (theta & 0x40)
+    ++secoffset;
+
+  uint8_t section = offset >> 4;
+  const uint8_t *p = b_m16_interleave + section * 2;
+  uint8_t b = p[0];
+  uint8_t m16 = p[1];
+
+  uint8_t mx = (m16 * secoffset) >> 4;
+  int8_t y = int8_t(mx + b);
+  if (theta & 0x80)
+    y = -y;
+  y += 128;
+  return uint8_t(y);
+}
+
+// hsv2rgb_rainbow with Y1 (moderate yellow boost), no green scaling, the
+// 2021 desaturation curve
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+  const uint8_t K255 = 255, K171 = 171, K170 = 170, K85 = 85;
+
+  uint8_t hue = hsv.hue;
+  uint8_t sat = hsv.sat;
+  uint8_t val = hsv.val;
+
+  uint8_t offset8 = uint8_t((hue & 0x1F) << 3);
+  uint8_t third = scale8(offset8, 256 / 3);
+  uint8_t r, g, b;
+
+  if (!(hue & 0x80)) {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { // R -> O
+        r = K255 - third;
+        g = third;
+        b = 0;
+      } else { // O -> Y
+        r = K171;
+        g = K85 + third;
+        b = 0;
+      }
+    } else {
+      if (!(hue & 0x20)) { // Y -> G
+        uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+        r = K171 - twothirds;
+        g = K170 + third;
+        b = 0;
+      } else { // G -> A
+        r = 0;
+        g = K255 - third;
+        b = third;
+      }
+    }
+  } else {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { // A -> B
+        uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+        r = 0;
+        g = K171 - twothirds;
+        b = K85 + twothirds;
+      } else { // B -> P
+        r = third;
+        g = 0;
+        b = K255 - third;
+      }
+    } else {
+      if (!(hue & 0x20)) { // P -> K
+        r = K85 + third;
+        g = 0;
+        b = K171 - third;
+      } else { // K -> R
+        r = K170 + third;
+        g = 0;
+        b = K85 - third;
+      }
+    }
+  }
+
+  if (sat != 255) {
+    if (sat == 0) {
+      r = 255;
+      g = 255;
+      b = 255;
+    } else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      r = scale8(r, satscale);
+      g = scale8(g, satscale);
+      b = scale8(b, satscale);
+      r += desat;
+      g += desat;
+      b += desat;
+    }
+  }
+
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) {
+      r = 0;
+      g = 0;
+      b = 0;
+    } else {
+      r = scale8(r, val);
+      g = scale8(g, val);
+      b = scale8(b, val);
+    }
+  }
+
+  rgb.r = r;
+  rgb.g = g;
+  rgb.b = b;
+}
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color) {
+  for (int i = 0; i < numToFill; i++)
+    leds[i] = color;
+}
+
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale) {
+  for (uint16_t i = 0; i < numLeds; i++)
+    leds[i].nscale8(scale);
+}
+
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy) {
+  nscale8(leds, numLeds, 255 - fadeBy);
+}
+
+CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay) {
+  if (amountOfOverlay == 0)
+    return existing;
+  if (amountOfOverlay == 255) {
+    existing = overlay;
+    return existing;
+  }
+  existing.r = blend8(existing.r, overlay.r, amountOfOverlay);
+  existing.g = blend8(existing.g, overlay.g, amountOfOverlay);
+  existing.b = blend8(existing.b, overlay.b, amountOfOverlay);
+  return existing;
+}
+
+CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2) {
+  CRGB nu(p1);
+  nblend(nu, p2, amountOfP2);
+  return nu;
+}
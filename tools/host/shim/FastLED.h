@@ -0,0 +1,148 @@
+#pragma once
+/**
+ * FastLED.h (host shim)
+ *
+ * The slice of FastLED the rp2040 sketch uses, reimplemented so a host render
+ * gives the same bytes as the board: FastLED 3.6 with FASTLED_SCALE8_FIXED=1
+ * and FASTLED_BLEND_FIXED=1 (its defaults), C versions of the lib8tion math
+ * (what an ARM build uses), hsv2rgb_rainbow for CHSV -> CRGB.
+ *
+ * Output is the shim's business (WS2815Driver on the board), so CFastLED is
+ * only here for code that still mentions it.
+ */
+
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+
+// ----- lib8tion -----
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+  return (uint16_t(i) * (1 + uint16_t(scale))) >> 8;
+}
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+  return ((int(i) * int(scale)) >> 8) + ((i && scale) ? 1 : 0);
+}
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+  unsigned int t = i + j;
+  return t > 255 ? 255 : t;
+}
+inline uint8_t qsub8(uint8_t i, uint8_t j) { return i > j ? i - j : 0; }
+uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB);
+uint8_t sin8(uint8_t theta);
+inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+// ----- random (FastLED's own 16 bit LCG, not Arduino random()) -----
+extern uint16_t rand16seed;
+inline uint16_t random16() {
+  rand16seed = uint16_t(rand16seed * 2053) + 13849;
+  return rand16seed;
+}
+inline uint16_t random16(uint16_t lim) {
+  return uint16_t((uint32_t(lim) * random16()) >> 16);
+}
+inline uint8_t random8() {
+  random16();
+  return uint8_t(uint8_t(rand16seed & 0xFF) + uint8_t(rand16seed >> 8));
+}
+inline uint8_t random8(uint8_t lim) { return (random8() * lim) >> 8; }
+inline uint8_t random8(uint8_t min, uint8_t lim) {
+  return random8(uint8_t(lim - min)) + min;
+}
+inline void random16_set_seed(uint16_t seed) { rand16seed = seed; }
+inline void random16_add_entropy(uint16_t entropy) { rand16seed += entropy; }
+
+// ----- colours -----
+struct CHSV {
+  union {
+    struct {
+      uint8_t hue;
+      uint8_t sat;
+      uint8_t val;
+    };
+    uint8_t raw[3];
+  };
+  CHSV() {}
+  CHSV(uint8_t h, uint8_t s, uint8_t v) : hue(h), sat(s), val(v) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB {
+  union {
+    struct {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+    };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode : uint32_t {
+    Black = 0x000000,
+    Blue = 0x0000FF,
+    Green = 0x008000,
+    Red = 0xFF0000,
+    White = 0xFFFFFF,
+  };
+
+  CRGB() {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode)
+      : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF),
+        b(colorcode & 0xFF) {}
+  CRGB(HTMLColorCode colorcode) : CRGB(uint32_t(colorcode)) {}
+  CRGB(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); }
+  CRGB &operator=(const CHSV &rhs) {
+    hsv2rgb_rainbow(rhs, *this);
+    return *this;
+  }
+
+  uint8_t &operator[](uint8_t x) { return raw[x]; }
+  const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+  CRGB &operator+=(const CRGB &rhs) {
+    r = qadd8(r, rhs.r);
+    g = qadd8(g, rhs.g);
+    b = qadd8(b, rhs.b);
+    return *this;
+  }
+  CRGB &nscale8(uint8_t scale) {
+    // FASTLED_SCALE8_FIXED: scale + 1
+    uint16_t s = uint16_t(scale) + 1;
+    r = (r * s) >> 8;
+    g = (g * s) >> 8;
+    b = (b * s) >> 8;
+    return *this;
+  }
+  CRGB &fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+  uint8_t getAverageLight() const {
+    return scale8(r, 85) + scale8(g, 85) + scale8(b, 85);
+  }
+
+  bool operator==(const CRGB &o) const {
+    return r == o.r && g == o.g && b == o.b;
+  }
+  bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+// ----- frame helpers -----
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color);
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale);
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy);
+CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay);
+CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2);
+
+// ----- controller (unused on the host) -----
+enum EOrder { RGB = 0012, GRB = 0102 };
+class CFastLED {
+public:
+  void setBrightness(uint8_t scale) { brightness = scale; }
+  uint8_t getBrightness() const { return brightness; }
+  void show() {}
+  void clear() {}
+
+private:
+  uint8_t brightness = 255;
+};
+extern CFastLED FastLED;
@@ -0,0 +1,56 @@
+#pragma once
+/**
+ * HostBoard.h
+ *
+ * Host side control of the Arduino shim. A Board is one simulated
+ * microcontroller: its clock, pin levels and serial ports. Everything the
+ * firmware calls (millis(), digitalWrite(), Serial1...) acts on the current
+ * board, select() switches it. Single board tools just use the default one.
+ *
+ * Usage:
+ *   host::Board car("mkrzero");
+ *   host::select(car);
+ *   host::advanceUs(250);    // time passes without the firmware running
+ *   Serial1.inject(bytes, n); // bytes arriving at the board right now
+ */
+
+#include <Arduino.h>
+
+namespace host {
+
+class Board {
+public:
+  static constexpr uint8_t NUM_PINS = 64;
+  static constexpr uint8_t NUM_SERIAL = 2;
+
+  explicit Board(const char *name) : name(name) {}
+
+  const char *name;
+  uint64_t nowUs = 0;
+  uint8_t pinLevel[NUM_PINS] = {};
+  uint8_t pinModes[NUM_PINS] = {};
+  HardwareSerial serial[NUM_SERIAL];
+  uint64_t randomNext = 1; // newlib rand() state
+
+  // optional, called on every digitalWrite() (markers, LEDs, triggers)
+  void (*onPinWrite)(Board &board, uint8_t pin, uint8_t level) = nullptr;
+};
+
+Board &board();
+void select(Board &b);
+
+inline uint64_t nowUs() { return board().nowUs; }
+inline void advanceUs(uint64_t us) { board().nowUs += us; }
+// jump forward to `us` if the board is behind it (never goes back)
+inline void advanceTo(uint64_t us) {
+  if (board().nowUs < us)
+    board().nowUs = us;
+}
+
+// connects two ports both ways, like a cable (or an RS-485 pair)
+inline void wire(HardwareSerial &a, HardwareSerial &b) {
+  a.connect(&b);
+  b.connect(&a);
+}
+
+} // namespace host
@@ -0,0 +1,334 @@
+/**
+ * MFRC522.cpp (host shim)
+ *
+ * Arduino_MFRC522v2 2.0.x, the calls in MFRC522v2.h, following the library
+ * line for line where it touches registers so transaction counts and waits
+ * match the board. Debug printing and the reset pin path are left out.
+ */
+
+#include <MFRC522DriverI2C.h>
+#include <MFRC522v2.h>
+
+// ========== I2C DRIVER ==========
+bool MFRC522DriverI2C::init() {
+  wire.begin();
+  return true;
+}
+
+void MFRC522DriverI2C::PCD_WriteRegister(const PCD_Register reg,
+                                         const byte value) {
+  wire.beginTransmission(slaveAddr);
+  wire.write(reg);
+  wire.write(value);
+  wire.endTransmission();
+}
+
+void MFRC522DriverI2C::PCD_WriteRegister(const PCD_Register reg,
+                                         const byte count,
+                                         byte *const values) {
+  wire.beginTransmission(slaveAddr);
+  wire.write(reg);
+  for (byte i = 0; i < count; i++)
+    wire.write(values[i]);
+  wire.endTransmission();
+}
+
+byte MFRC522DriverI2C::PCD_ReadRegister(const PCD_Register reg) {
+  byte value;
+  PCD_ReadRegister(reg, 1, &value);
+  return value;
+}
+
+void MFRC522DriverI2C::PCD_ReadRegister(const PCD_Register reg,
+                                        const byte count, byte *const values,
+                                        const byte rxAlign) {
+  if (count == 0)
+    return;
+  wire.beginTransmission(slaveAddr);
+  wire.write(reg);
+  wire.endTransmission();
+
+  byte index = 0;
+  wire.requestFrom(slaveAddr, count);
+  while (wire.available()) {
+    byte value = wire.read();
+    if (index == 0 && rxAlign) {
+      // only update bit positions rxAlign..7 in values[0]
+      byte mask = byte(0xFF << rxAlign);
+      values[0] = (values[0] & ~mask) | (value & mask);
+    } else if (index < count) {
+      values[index] = value;
+    }
+    index++;
+  }
+}
+
+// ========== PCD ==========
+void MFRC522::setBits(PCD_Register reg, byte mask) {
+  byte tmp = driver.PCD_ReadRegister(reg);
+  driver.PCD_WriteRegister(reg, tmp | mask);
+}
+
+void MFRC522::clearBits(PCD_Register reg, byte mask) {
+  byte tmp = driver.PCD_ReadRegister(reg);
+  driver.PCD_WriteRegister(reg, tmp & (~mask));
+}
+
+bool MFRC522::PCD_Init() {
+  bool result = driver.init();
+  PCD_Reset();
+
+  // reset baud rates and modulation width
+  driver.PCD_WriteRegister(TxModeReg, 0x00);
+  driver.PCD_WriteRegister(RxModeReg, 0x00);
+  driver.PCD_WriteRegister(ModWidthReg, 0x26);
+
+  // timer: TAuto, f_timer = 13.56MHz / (2 * 169 + 1) = 40kHz, 1000 ticks = 25ms
+  driver.PCD_WriteRegister(TModeReg, 0x80);
+  driver.PCD_WriteRegister(TPrescalerReg, 0xA9);
+  driver.PCD_WriteRegister(TReloadRegH, 0x03);
+  driver.PCD_WriteRegister(TReloadRegL, 0xE8);
+
+  driver.PCD_WriteRegister(TxASKReg, 0x40); // 100% ASK
+  driver.PCD_WriteRegister(ModeReg, 0x3D);  // CRC preset 0x6363
+  PCD_AntennaOn();
+  return result;
+}
+
+void MFRC522::PCD_Reset() {
+  driver.PCD_WriteRegister(CommandReg, PCD_SoftReset);
+  // the oscillator start-up time is not specified, give it up to 3 x 50ms
+  uint8_t count = 0;
+  do {
+    delay(50);
+  } while ((driver.PCD_ReadRegister(CommandReg) & (1 << 4)) && (++count) < 3);
+}
+
+void MFRC522::PCD_AntennaOn() {
+  byte value = driver.PCD_ReadRegister(TxControlReg);
+  if ((value & 0x03) != 0x03)
+    driver.PCD_WriteRegister(TxControlReg, value | 0x03);
+}
+
+void MFRC522::PCD_AntennaOff() { clearBits(TxControlReg, 0x03); }
+
+void MFRC522::PCD_StopCrypto1() { clearBits(Status2Reg, 0x08); }
+
+MFRC522::StatusCode MFRC522::PCD_CalculateCRC(byte *data, byte length,
+                                              byte *result) {
+  driver.PCD_WriteRegister(CommandReg, PCD_Idle);
+  driver.PCD_WriteRegister(DivIrqReg, 0x04);     // clear CRCIRq
+  driver.PCD_WriteRegister(FIFOLevelReg, 0x80);  // flush the FIFO
+  driver.PCD_WriteRegister(FIFODataReg, length, data);
+  driver.PCD_WriteRegister(CommandReg, PCD_CalcCRC);
+
+  const uint32_t deadline = millis() + 89;
+  do {
+    byte n = driver.PCD_ReadRegister(DivIrqReg);
+    if (n & 0x04) {
+      driver.PCD_WriteRegister(CommandReg, PCD_Idle);
+      result[0] = driver.PCD_ReadRegister(CRCResultRegL);
+      result[1] = driver.PCD_ReadRegister(CRCResultRegH);
+      return STATUS_OK;
+    }
+    yield();
+  } while (static_cast<uint32_t>(millis()) < deadline);
+  return STATUS_TIMEOUT;
+}
+
+MFRC522::StatusCode MFRC522::PCD_TransceiveData(byte *sendData, byte sendLen,
+                                                byte *backData, byte *backLen,
+                                                byte *validBits, byte rxAlign,
+                                                bool checkCRC) {
+  return PCD_CommunicateWithPICC(PCD_Transceive, 0x30, sendData, sendLen,
+                                 backData, backLen, validBits, rxAlign,
+                                 checkCRC);
+}
+
+MFRC522::StatusCode
+MFRC522::PCD_CommunicateWithPICC(byte command, byte waitIRq, byte *sendData,
+                                 byte sendLen, byte *backData, byte *backLen,
+                                 byte *validBits, byte rxAlign, bool checkCRC) {
+  byte txLastBits = validBits ? *validBits : 0;
+  byte bitFraming = (rxAlign << 4) + txLastBits;
+
+  driver.PCD_WriteRegister(CommandReg, PCD_Idle);
+  driver.PCD_WriteRegister(ComIrqReg, 0x7F);    // clear all interrupts
+  driver.PCD_WriteRegister(FIFOLevelReg, 0x80); // flush the FIFO
+  driver.PCD_WriteRegister(FIFODataReg, sendLen, sendData);
+  driver.PCD_WriteRegister(BitFramingReg, bitFraming);
+  driver.PCD_WriteRegister(CommandReg, command);
+  if (command == PCD_Transceive)
+    setBits(BitFramingReg, 0x80); // StartSend
+
+  // the timer (TAuto) raises TimerIRq 25ms after the frame went out
+  const uint32_t deadline = millis() + 36;
+  bool completed = false;
+  do {
+    byte n = driver.PCD_ReadRegister(ComIrqReg);
+    if (n & waitIRq) {
+      completed = true;
+      break;
+    }
+    if (n & 0x01)
+      return STATUS_TIMEOUT;
+    yield();
+  } while (static_cast<uint32_t>(millis()) < deadline);
+  if (!completed)
+    return STATUS_TIMEOUT;
+
+  byte errorRegValue = driver.PCD_ReadRegister(ErrorReg);
+  if (errorRegValue & 0x13) // BufferOvfl ParityErr ProtocolErr
+    return STATUS_ERROR;
+
+  byte rxValidBits = 0;
+  if (backData && backLen) {
+    byte n = driver.PCD_ReadRegister(FIFOLevelReg);
+    if (n > *backLen)
+      return STATUS_NO_ROOM;
+    *backLen = n;
+    driver.PCD_ReadRegister(FIFODataReg, n, backData, rxAlign);
+    rxValidBits = driver.PCD_ReadRegister(ControlReg) & 0x07;
+    if (validBits)
+      *validBits = rxValidBits;
+  }
+
+  if (errorRegValue & 0x08) // CollErr
+    return STATUS_COLLISION;
+
+  if (backData && backLen && checkCRC) {
+    // a MIFARE NAK is 4 bits, not a CRC'd frame
+    if (*backLen == 1 && rxValidBits == 4)
+      return STATUS_MIFARE_NACK;
+    if (*backLen < 2 || rxValidBits != 0)
+      return STATUS_CRC_WRONG;
+    byte controlBuffer[2];
+    StatusCode status =
+        PCD_CalculateCRC(&backData[0], *backLen - 2, &controlBuffer[0]);
+    if (status != STATUS_OK)
+      return status;
+    if (backData[*backLen - 2] != controlBuffer[0] ||
+        backData[*backLen - 1] != controlBuffer[1])
+      return STATUS_CRC_WRONG;
+  }
+  return STATUS_OK;
+}
+
+// ========== PICC ==========
+bool MFRC522::PICC_IsNewCardPresent() {
+  byte bufferATQA[2];
+  byte bufferSize = sizeof(bufferATQA);
+
+  driver.PCD_WriteRegister(TxModeReg, 0x00);
+  driver.PCD_WriteRegister(RxModeReg, 0x00);
+  driver.PCD_WriteRegister(ModWidthReg, 0x26);
+
+  StatusCode result = PICC_RequestA(bufferATQA, &bufferSize);
+  return result == STATUS_OK || result == STATUS_COLLISION;
+}
+
+bool MFRC522::PICC_ReadCardSerial() { return PICC_Select(&uid) == STATUS_OK; }
+
+MFRC522::StatusCode MFRC522::PICC_RequestA(byte *bufferATQA,
+                                           byte *bufferSize) {
+  if (bufferATQA == nullptr || *bufferSize < 2)
+    return STATUS_NO_ROOM;
+  clearBits(CollReg, 0x80); // ValuesAfterColl
+  byte command = PICC_CMD_REQA;
+  byte validBits = 7; // REQA is a short frame
+  StatusCode status = PCD_TransceiveData(&command, 1, bufferATQA, bufferSize,
+                                         &validBits);
+  if (status != STATUS_OK)
+    return status;
+  if (*bufferSize != 2 || validBits != 0)
+    return STATUS_ERROR;
+  return STATUS_OK;
+}
+
+// anticollision + select for every cascade level, without the library's
+// bit-by-bit collision resolution (one tag per reader)
+MFRC522::StatusCode MFRC522::PICC_Select(Uid *uid) {
+  static const byte SEL[] = {PICC_CMD_SEL_CL1, PICC_CMD_SEL_CL2,
+                             PICC_CMD_SEL_CL3};
+  byte uidIndex = 0;
+  clearBits(CollReg, 0x80);
+
+  for (byte level = 0; level < 3; level++) {
+    byte buffer[9];
+    buffer[0] = SEL[level];
+
+    // ANTICOLLISION: NVB 0x20, the tag answers its 4 bytes + BCC
+    buffer[1] = 0x20;
+    byte txLastBits = 0;
+    byte responseLength = 5;
+    StatusCode result = PCD_TransceiveData(buffer, 2, &buffer[2],
+                                           &responseLength, &txLastBits);
+    if (result != STATUS_OK)
+      return result;
+    if (responseLength != 5 ||
+        (buffer[2] ^ buffer[3] ^ buffer[4] ^ buffer[5]) != buffer[6])
+      return STATUS_ERROR;
+
+    // SELECT: NVB 0x70, the 4 bytes + BCC + CRC, the tag answers SAK + CRC
+    buffer[1] = 0x70;
+    result = PCD_CalculateCRC(buffer, 7, &buffer[7]);
+    if (result != STATUS_OK)
+      return result;
+    txLastBits = 0;
+    byte sak[3];
+    responseLength = sizeof(sak);
+    result = PCD_TransceiveData(buffer, 9, sak, &responseLength, &txLastBits);
+    if (result != STATUS_OK)
+      return result;
+    if (responseLength != 3 || txLastBits != 0)
+      return STATUS_ERROR;
+    byte crc[2];
+    result = PCD_CalculateCRC(sak, 1, crc);
+    if (result != STATUS_OK)
+      return result;
+    if (crc[0] != sak[1] || crc[1] != sak[2])
+      return STATUS_CRC_WRONG;
+
+    // a cascade tag means the UID goes on at the next level
+    bool more = (sak[0] & 0x04) != 0;
+    byte first = (more && buffer[2] == PICC_CMD_CT) ? 3 : 2;
+    for (byte i = first; i < 6; i++)
+      uid->uidByte[uidIndex++] = buffer[i];
+    if (!more) {
+      uid->size = uidIndex;
+      uid->sak = sak[0];
+      return STATUS_OK;
+    }
+  }
+  return STATUS_INTERNAL_ERROR;
+}
+
+MFRC522::StatusCode MFRC522::PICC_HaltA() {
+  byte buffer[4];
+  buffer[0] = PICC_CMD_HLTA;
+  buffer[1] = 0;
+  StatusCode result = PCD_CalculateCRC(buffer, 2, &buffer[2]);
+  if (result != STATUS_OK)
+    return result;
+
+  // a halted tag doesn't answer, so the timeout is the success case
+  result = PCD_TransceiveData(buffer, sizeof(buffer), nullptr, 0);
+  if (result == STATUS_TIMEOUT)
+    return STATUS_OK;
+  if (result == STATUS_OK)
+    return STATUS_ERROR;
+  return result;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Read(byte blockAddr, byte *buffer,
+                                         byte *bufferSize) {
+  if (buffer == nullptr || *bufferSize < 18)
+    return STATUS_NO_ROOM;
+
+  buffer[0] = PICC_CMD_MF_READ;
+  buffer[1] = blockAddr;
+  StatusCode result = PCD_CalculateCRC(buffer, 2, &buffer[2]);
+  if (result != STATUS_OK)
+    return result;
+  return PCD_TransceiveData(buffer, 4, buffer, bufferSize, nullptr, 0, true);
+}
@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * MFRC522Constants.h (host shim)
+ *
+ * Register, command and status names of Arduino_MFRC522v2 (2.0.x), the
+ * subset the sketches and the host models use. Values are the MFRC522
+ * datasheet's; the WS1850S on the M5Stack RFID2 has the same map.
+ */
+
+#include <Arduino.h>
+
+class MFRC522Constants {
+public:
+  enum PCD_Register : uint8_t {
+    CommandReg = 0x01,
+    ComIEnReg = 0x02,
+    DivIEnReg = 0x03,
+    ComIrqReg = 0x04,
+    DivIrqReg = 0x05,
+    ErrorReg = 0x06,
+    Status1Reg = 0x07,
+    Status2Reg = 0x08,
+    FIFODataReg = 0x09,
+    FIFOLevelReg = 0x0A,
+    WaterLevelReg = 0x0B,
+    ControlReg = 0x0C,
+    BitFramingReg = 0x0D,
+    CollReg = 0x0E,
+    ModeReg = 0x11,
+    TxModeReg = 0x12,
+    RxModeReg = 0x13,
+    TxControlReg = 0x14,
+    TxASKReg = 0x15,
+    CRCResultRegH = 0x21,
+    CRCResultRegL = 0x22,
+    ModWidthReg = 0x24,
+    TModeReg = 0x2A,
+    TPrescalerReg = 0x2B,
+    TReloadRegH = 0x2C,
+    TReloadRegL = 0x2D,
+    VersionReg = 0x37,
+  };
+
+  enum PCD_Command : uint8_t {
+    PCD_Idle = 0x00,
+    PCD_Mem = 0x01,
+    PCD_GenerateRandomID = 0x02,
+    PCD_CalcCRC = 0x03,
+    PCD_Transmit = 0x04,
+    PCD_NoCmdChange = 0x07,
+    PCD_Receive = 0x08,
+    PCD_Transceive = 0x0C,
+    PCD_MFAuthent = 0x0E,
+    PCD_SoftReset = 0x0F,
+  };
+
+  enum PICC_Command : uint8_t {
+    PICC_CMD_REQA = 0x26,
+    PICC_CMD_WUPA = 0x52,
+    PICC_CMD_CT = 0x88, // cascade tag, first byte of an incomplete UID part
+    PICC_CMD_SEL_CL1 = 0x93,
+    PICC_CMD_SEL_CL2 = 0x95,
+    PICC_CMD_SEL_CL3 = 0x97,
+    PICC_CMD_HLTA = 0x50,
+    PICC_CMD_MF_READ = 0x30,
+  };
+
+  enum StatusCode : uint8_t {
+    STATUS_OK,
+    STATUS_ERROR,
+    STATUS_COLLISION,
+    STATUS_TIMEOUT,
+    STATUS_NO_ROOM,
+    STATUS_INTERNAL_ERROR,
+    STATUS_INVALID,
+    STATUS_CRC_WRONG,
+    STATUS_MIFARE_NACK = 0xff,
+  };
+
+  struct Uid {
+    byte size; // 4, 7 or 10
+    byte uidByte[10];
+    byte sak;
+  };
+};
@@ -0,0 +1,8 @@
+#pragma once
+/**
+ * MFRC522Debug.h (host shim)
+ *
+ * The sketches include it but call nothing from it.
+ */
+
+#include "MFRC522v2.h"
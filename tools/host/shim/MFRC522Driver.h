@@ -0,0 +1,23 @@
+#pragma once
+/**
+ * MFRC522Driver.h (host shim)
+ *
+ * Arduino_MFRC522v2's transport interface: everything the library does is
+ * register reads and writes through one of these.
+ */
+
+#include "MFRC522Constants.h"
+
+class MFRC522Driver {
+public:
+  using PCD_Register = MFRC522Constants::PCD_Register;
+
+  virtual ~MFRC522Driver() {}
+  virtual bool init() = 0;
+  virtual void PCD_WriteRegister(const PCD_Register reg, const byte value) = 0;
+  virtual void PCD_WriteRegister(const PCD_Register reg, const byte count,
+                                 byte *const values) = 0;
+  virtual byte PCD_ReadRegister(const PCD_Register reg) = 0;
+  virtual void PCD_ReadRegister(const PCD_Register reg, const byte count,
+                                byte *const values, const byte rxAlign = 0) = 0;
+};
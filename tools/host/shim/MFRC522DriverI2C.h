@@ -0,0 +1,31 @@
+#pragma once
+/**
+ * MFRC522DriverI2C.h (host shim)
+ *
+ * Register access over Wire, one transaction per write and two per read
+ * (register address, then requestFrom), like the library's driver. With
+ * the host Wire that is what the WS1850S model (sim/) sees and what the
+ * bus time is charged for.
+ */
+
+#include "MFRC522Driver.h"
+
+#include <Wire.h>
+
+class MFRC522DriverI2C : public MFRC522Driver {
+public:
+  MFRC522DriverI2C(const uint8_t slaveAddr, TwoWire &wire)
+      : slaveAddr(slaveAddr), wire(wire) {}
+
+  bool init() override;
+  void PCD_WriteRegister(const PCD_Register reg, const byte value) override;
+  void PCD_WriteRegister(const PCD_Register reg, const byte count,
+                         byte *const values) override;
+  byte PCD_ReadRegister(const PCD_Register reg) override;
+  void PCD_ReadRegister(const PCD_Register reg, const byte count,
+                        byte *const values, const byte rxAlign = 0) override;
+
+private:
+  uint8_t slaveAddr;
+  TwoWire &wire;
+};
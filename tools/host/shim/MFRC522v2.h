@@ -0,0 +1,52 @@
+#pragma once
+/**
+ * MFRC522v2.h (host shim)
+ *
+ * The part of Arduino_MFRC522v2's MFRC522 class the sketches call, with the
+ * library's register sequences (PCD_Init, REQA, the select cascade, CRC,
+ * MIFARE_Read) so the reader model in sim/ is driven the way the real chip
+ * is: same transactions, same polling of ComIrqReg until the reply or the
+ * 25ms timer, same 50ms soft reset wait in PCD_Init().
+ *
+ * Only ISO 14443A without collisions: one tag in the field at a time, which
+ * is all a terminal reader ever has.
+ */
+
+#include "MFRC522Constants.h"
+#include "MFRC522Driver.h"
+
+class MFRC522 : public MFRC522Constants {
+public:
+  explicit MFRC522(MFRC522Driver &driver) : driver(driver) {}
+
+  Uid uid{};
+
+  bool PCD_Init();
+  void PCD_Reset();
+  void PCD_AntennaOn();
+  void PCD_AntennaOff();
+  void PCD_StopCrypto1();
+
+  bool PICC_IsNewCardPresent();
+  bool PICC_ReadCardSerial();
+  StatusCode PICC_RequestA(byte *bufferATQA, byte *bufferSize);
+  StatusCode PICC_Select(Uid *uid);
+  StatusCode PICC_HaltA();
+  StatusCode MIFARE_Read(byte blockAddr, byte *buffer, byte *bufferSize);
+
+  StatusCode PCD_CalculateCRC(byte *data, byte length, byte *result);
+  StatusCode PCD_TransceiveData(byte *sendData, byte sendLen, byte *backData,
+                                byte *backLen, byte *validBits = nullptr,
+                                byte rxAlign = 0, bool checkCRC = false);
+
+private:
+  StatusCode PCD_CommunicateWithPICC(byte command, byte waitIRq,
+                                     byte *sendData, byte sendLen,
+                                     byte *backData, byte *backLen,
+                                     byte *validBits, byte rxAlign,
+                                     bool checkCRC);
+  void setBits(PCD_Register reg, byte mask);
+  void clearBits(PCD_Register reg, byte mask);
+
+  MFRC522Driver &driver;
+};
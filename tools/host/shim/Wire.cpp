@@ -0,0 +1,135 @@
+#include "HostBoard.h"
+
+#include <Wire.h>
+
+namespace {
+// wire time of one transaction: start, `bytes` of 8 data bits + ack, stop
+constexpr uint32_t START_STOP_BITS = 2;
+} // namespace
+
+TwoWire &host::wireBus() {
+  static std::map<const Board *, TwoWire> buses;
+  return buses[&board()];
+}
+
+void TwoWire::attach(uint8_t address, host::I2CDevice *device) {
+  devices[address] = device;
+}
+
+host::I2CDevice *TwoWire::resolve(uint8_t address) const {
+  auto it = devices.find(address);
+  if (it != devices.end())
+    return it->second;
+  for (const auto &entry : devices) {
+    if (host::I2CDevice *behind = entry.second->route(address))
+      return behind;
+  }
+  return nullptr;
+}
+
+void TwoWire::spend(size_t bytes) {
+  uint64_t bits = uint64_t(bytes) * 9 + START_STOP_BITS;
+  uint64_t us = (bits * 1000000ULL + clockHz - 1) / clockHz;
+  stats.transactions++;
+  stats.busyUs += us;
+  host::advanceUs(us);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  tx.clear();
+}
+
+size_t TwoWire::write(uint8_t b) {
+  if (inRequest) {
+    rx.push_back(b); // slave reply, handed back by slaveRead()
+    return 1;
+  }
+  tx.push_back(b);
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    write(data[i]);
+  return len;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  if (tx.size() > bufferSize)
+    return 1;
+  host::I2CDevice *device = resolve(txAddress);
+  if (!device) {
+    spend(1);
+    stats.nacks++;
+    return 2;
+  }
+  spend(1 + tx.size());
+  if (!device->write(tx.data(), tx.size())) {
+    stats.nacks++;
+    return 3;
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool sendStop) {
+  rx.clear();
+  rxPos = 0;
+  if (quantity > bufferSize)
+    quantity = bufferSize;
+  host::I2CDevice *device = resolve(address);
+  if (!device) {
+    spend(1);
+    stats.nacks++;
+    return 0;
+  }
+  rx.resize(quantity);
+  size_t n = device->read(rx.data(), quantity);
+  rx.resize(n);
+  spend(1 + quantity); // the master clocks out every byte it asked for
+  return n;
+}
+
+bool TwoWire::slaveWrite(const uint8_t *data, size_t len) {
+  rx.assign(data, data + len);
+  rxPos = 0;
+  if (receiveHandler)
+    receiveHandler(int(len));
+  return true;
+}
+
+size_t TwoWire::slaveRead(uint8_t *data, size_t len) {
+  rx.clear();
+  rxPos = 0;
+  inRequest = true;
+  if (requestHandler)
+    requestHandler();
+  inRequest = false;
+  size_t n = rx.size() < len ? rx.size() : len;
+  memcpy(data, rx.data(), n);
+  rx.clear();
+  return n;
+}
+
+namespace host {
+namespace {
+// runs `fn` as the slave board, at the master's time
+template <class Fn> auto asBoard(Board &slave, Fn fn) -> decltype(fn()) {
+  Board &master = board();
+  uint64_t at = master.nowUs;
+  select(slave);
+  advanceTo(at);
+  auto result = fn();
+  select(master);
+  return result;
+}
+} // namespace
+
+bool WireSlave::write(const uint8_t *data, size_t len) {
+  return asBoard(slave, [&] { return wireBus().slaveWrite(data, len); });
+}
+
+size_t WireSlave::read(uint8_t *data, size_t len) {
+  return asBoard(slave, [&] { return wireBus().slaveRead(data, len); });
+}
+} // namespace host
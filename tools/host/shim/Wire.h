@@ -0,0 +1,111 @@
+#pragma once
+/**
+ * Wire.h (host shim)
+ *
+ * I2C on the simulated clock. Every board has its own bus (`Wire` is the
+ * current board's, like Serial), and the parts on it are host::I2CDevice
+ * models attached at an address (sim/: WS1850S reader, TCA9548A mux).
+ *
+ * - a transaction costs its wire time at setClock() speed: 9 bits per byte
+ *   including the address, plus start/stop, the master blocks for it
+ * - endTransmission() returns what the cores return: 0 ok, 1 too long for
+ *   the buffer, 2 NACK on address, 3 NACK on data
+ * - requestFrom() returns the bytes the device sent, 0 on a NACK
+ * - a mux hands addresses it doesn't own on to its open channels (route())
+ */
+
+#include <Arduino.h>
+
+#include <map>
+#include <vector>
+
+namespace host {
+struct I2CDevice {
+  virtual ~I2CDevice() {}
+  // the bytes after the address byte, false = NACK on data
+  virtual bool write(const uint8_t *data, size_t len) = 0;
+  // fill up to len bytes, return how many the device sent
+  virtual size_t read(uint8_t *data, size_t len) = 0;
+  // a switch returns the device at `address` behind its open channels
+  virtual I2CDevice *route(uint8_t address) { return nullptr; }
+};
+
+struct WireStats {
+  uint32_t transactions; // address phases, acked or not
+  uint32_t nacks;
+  uint64_t busyUs; // wire time
+};
+} // namespace host
+
+class TwoWire : public Stream {
+public:
+  void begin() {}
+  void begin(uint8_t address) { slaveAddress = address; }
+  void end() {}
+  void setClock(uint32_t hz) { clockHz = hz; }
+  uint32_t getClock() const { return clockHz; }
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t *data, size_t len) override;
+  using Print::write;
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, size_t quantity, bool sendStop = true);
+
+  int available() override { return int(rx.size() - rxPos); }
+  int read() override { return rxPos < rx.size() ? rx[rxPos++] : -1; }
+  int peek() override { return rxPos < rx.size() ? rx[rxPos] : -1; }
+
+  // slave side (the RP2040), see host::WireSlave
+  void onReceive(void (*handler)(int)) { receiveHandler = handler; }
+  void onRequest(void (*handler)()) { requestHandler = handler; }
+
+  // ----- host side -----
+  void attach(uint8_t address, host::I2CDevice *device);
+  void detach(uint8_t address) { devices.erase(address); }
+  host::I2CDevice *resolve(uint8_t address) const; // through muxes
+  size_t bufferSize = 256; // SAMD / RP2040; the AVR core has 32
+  host::WireStats stats{};
+
+  // a master on another bus reaching this board as a slave
+  bool slaveWrite(const uint8_t *data, size_t len);
+  size_t slaveRead(uint8_t *data, size_t len);
+  uint8_t getSlaveAddress() const { return slaveAddress; }
+
+private:
+  void spend(size_t bytes);
+
+  uint32_t clockHz = 100000;
+  std::map<uint8_t, host::I2CDevice *> devices;
+
+  uint8_t txAddress = 0;
+  std::vector<uint8_t> tx;
+  std::vector<uint8_t> rx;
+  size_t rxPos = 0;
+
+  uint8_t slaveAddress = 0;
+  void (*receiveHandler)(int) = nullptr;
+  void (*requestHandler)() = nullptr;
+  bool inRequest = false; // onRequest() is writing the reply
+};
+
+namespace host {
+class Board;
+
+TwoWire &wireBus(); // the current board's
+
+// puts a board's Wire (slave mode) on another board's bus: the master's
+// transfers run that board's onReceive/onRequest on its own clock, moved up
+// to the master's time first
+class WireSlave : public I2CDevice {
+public:
+  explicit WireSlave(Board &slave) : slave(slave) {}
+  bool write(const uint8_t *data, size_t len) override;
+  size_t read(uint8_t *data, size_t len) override;
+
+private:
+  Board &slave;
+};
+} // namespace host
+
+#define Wire (::host::wireBus())
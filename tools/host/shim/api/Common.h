@@ -0,0 +1,4 @@
+#pragma once
+// api/Common.h (host shim): ArduinoCore-API's pin and time declarations,
+// which AudioPlayer.cpp includes directly. Arduino.h has all of them
+#include <Arduino.h>
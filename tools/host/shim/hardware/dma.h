@@ -0,0 +1,2 @@
+#pragma once
+// hardware/dma.h (host shim): nothing, see hardware/pio.h
@@ -0,0 +1,11 @@
+#pragma once
+// hardware/pio.h (host shim): only the types WS2815Driver.h names, the host
+// driver (sim/WS2815Driver.cpp) never touches a PIO
+
+#include <stdint.h>
+
+typedef unsigned int uint;
+struct pio_hw_t {
+  uint32_t txf[4];
+};
+typedef pio_hw_t *PIO;
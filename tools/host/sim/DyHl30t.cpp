@@ -0,0 +1,100 @@
+#include "DyHl30t.h"
+
+namespace {
+constexpr uint8_t FRAME_START = 0xAA;
+constexpr uint8_t CMD_QUERY_STATUS = 0x01;
+constexpr uint8_t CMD_STOP = 0x04;
+constexpr uint8_t CMD_PLAY_TRACK = 0x07;
+constexpr uint8_t CMD_SET_VOLUME = 0x13;
+constexpr uint8_t STATUS_STOPPED = 0x00;
+constexpr uint8_t STATUS_PLAYING = 0x01;
+} // namespace
+
+DyHl30t::DyHl30t(HardwareSerial &port) : port(port) {
+  port.begin(BAUD);
+  port.connect(this);
+}
+
+bool DyHl30t::playingAt(uint64_t us) const { return us < playUntilUs; }
+
+void DyHl30t::receive(uint8_t b, uint64_t atUs) {
+  if (frameLen == 0 && b != FRAME_START)
+    return; // idle line noise, the module waits for a header too
+
+  frame[frameLen++] = b;
+  if (frameLen < 3)
+    return;
+
+  uint8_t dataLen = frame[2];
+  if (dataLen > sizeof(frame) - 4) {
+    badFrames++;
+    frameLen = 0;
+    return;
+  }
+  if (frameLen == dataLen + 4) {
+    handleFrame(atUs);
+    frameLen = 0;
+  }
+}
+
+void DyHl30t::handleFrame(uint64_t atUs) {
+  uint8_t dataLen = frame[2];
+  uint8_t sum = 0;
+  for (uint8_t i = 0; i < dataLen + 3; i++)
+    sum += frame[i];
+  if (sum != frame[dataLen + 3]) {
+    badFrames++;
+    return;
+  }
+  frames++;
+
+  const uint8_t *data = &frame[3];
+  switch (frame[1]) {
+  case CMD_PLAY_TRACK: {
+    if (dataLen != 2) {
+      badFrames++;
+      return;
+    }
+    uint16_t track = uint16_t(data[0]) << 8 | data[1];
+    uint32_t lengthMs = track < MAX_TRACKS && trackMs[track] ? trackMs[track]
+                                                             : defaultTrackMs;
+    // a new play interrupts whatever is playing
+    onsets.push_back({track, atUs, atUs + onsetUs});
+    playUntilUs = atUs + onsetUs + uint64_t(lengthMs) * 1000;
+    break;
+  }
+  case CMD_STOP:
+    stops++;
+    playUntilUs = 0;
+    break;
+  case CMD_SET_VOLUME:
+    if (dataLen == 1)
+      volume = data[0];
+    break;
+  case CMD_QUERY_STATUS:
+    queries++;
+    reply(CMD_QUERY_STATUS,
+          playingAt(atUs) ? STATUS_PLAYING : STATUS_STOPPED, atUs);
+    break;
+  default:
+    break;
+  }
+}
+
+void DyHl30t::reply(uint8_t cmd, uint8_t value, uint64_t atUs) {
+  if (!replies)
+    return;
+
+  uint8_t out[5] = {FRAME_START, cmd, 1, value, 0};
+  for (uint8_t i = 0; i < 4; i++)
+    out[4] += out[i];
+  if (corruptReplies)
+    out[4] ^= 0xFF;
+
+  uint64_t byteUs = 10000000ULL / BAUD;
+  uint64_t t = atUs + replyDelayUs;
+  for (uint8_t b : out) {
+    t += byteUs;
+    port.receive(b, t);
+  }
+}
@@ -0,0 +1,69 @@
+#pragma once
+/**
+ * DyHl30t.h
+ *
+ * Stand-in for the DY-HL30T sound module in UART mode, for host tests of
+ * UartAudioPlayer and the toy car simulator. Speaks the module's framing
+ * (0xAA | cmd | len | data... | sum) on a HardwareSerial from the shim:
+ *   - play track (0x07), stop (0x04), set volume (0x13) change its state
+ *   - query status (0x01) is answered with 0xAA 0x01 0x01 <status> <sum>,
+ *     status 0x00 stopped / 0x01 playing, like the real module
+ *   - a clip plays for trackMs[track] (defaultTrackMs if unset), sound starts
+ *     onsetUs after the play frame's last byte arrived
+ *
+ * Fault knobs: `replies` false models an unwired module TX line,
+ * `corruptReplies` sends status frames with a bad checksum.
+ *
+ * Usage:
+ *   DyHl30t module(AudioSerialPort); // the firmware's port
+ *   module.trackMs[3] = 1200;
+ *   ... run the firmware, then check module.played / module.onsets
+ */
+
+#include <Arduino.h>
+
+#include <vector>
+
+class DyHl30t : public host::SerialPeer {
+public:
+  static constexpr uint16_t MAX_TRACKS = 16;
+  static constexpr uint32_t BAUD = 9600;
+
+  explicit DyHl30t(HardwareSerial &port);
+
+  // called by the port for every byte the firmware writes
+  void receive(uint8_t b, uint64_t atUs) override;
+
+  bool playingAt(uint64_t us) const;
+
+  struct Onset {
+    uint16_t track;
+    uint64_t frameUs; // last byte of the play frame arrived
+    uint64_t soundUs; // audible
+  };
+
+  // ----- configuration -----
+  uint32_t defaultTrackMs = 2000;
+  uint32_t trackMs[MAX_TRACKS] = {};
+  uint32_t onsetUs = 20000;     // frame -> audible (AUDIO_START_LATENCY_MS)
+  uint32_t replyDelayUs = 3000; // frame -> first byte of a status reply
+  bool replies = true;
+  bool corruptReplies = false;
+
+  // ----- observed -----
+  std::vector<Onset> onsets;
+  uint32_t frames = 0;
+  uint32_t badFrames = 0; // checksum or length errors
+  uint32_t stops = 0;
+  uint32_t queries = 0;
+  uint8_t volume = 0;
+
+private:
+  void handleFrame(uint64_t atUs);
+  void reply(uint8_t cmd, uint8_t value, uint64_t atUs);
+
+  HardwareSerial &port;
+  uint8_t frame[8];
+  uint8_t frameLen = 0;
+  uint64_t playUntilUs = 0;
+};
@@ -0,0 +1,58 @@
+#include "FrameImage.h"
+
+#include <stdio.h>
+
+void FrameImage::addFrame(const CRGB *frame) {
+  rows.insert(rows.end(), frame, frame + pixels);
+}
+
+bool FrameImage::writePpm(const std::string &path) const {
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f)
+    return false;
+
+  fprintf(f, "P6\n%u %u\n255\n", unsigned(pixels) * scale, frames() * scale);
+  std::vector<uint8_t> line(size_t(pixels) * scale * 3);
+  for (uint32_t row = 0; row < frames(); row++) {
+    const CRGB *frame = &rows[size_t(row) * pixels];
+    for (uint16_t p = 0; p < pixels; p++) {
+      for (uint8_t s = 0; s < scale; s++) {
+        uint8_t *px = &line[(size_t(p) * scale + s) * 3];
+        px[0] = frame[p].r;
+        px[1] = frame[p].g;
+        px[2] = frame[p].b;
+      }
+    }
+    for (uint8_t s = 0; s < scale; s++)
+      fwrite(line.data(), 1, line.size(), f);
+  }
+  return fclose(f) == 0;
+}
+
+bool FrameImage::readPpm(const std::string &path) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+
+  unsigned w, h, maxval;
+  bool ok = fscanf(f, "P6 %u %u %u", &w, &h, &maxval) == 3 &&
+            fgetc(f) != EOF && maxval == 255 && w % scale == 0 &&
+            h % scale == 0 && w > 0;
+  std::vector<uint8_t> pixelData(size_t(w) * h * 3);
+  ok = ok && fread(pixelData.data(), 1, pixelData.size(), f) ==
+                 pixelData.size();
+  fclose(f);
+  if (!ok)
+    return false;
+
+  // top left corner of every scale x scale block
+  pixels = w / scale;
+  rows.clear();
+  for (unsigned y = 0; y < h; y += scale) {
+    for (unsigned x = 0; x < w; x += scale) {
+      const uint8_t *px = &pixelData[(size_t(y) * w + x) * 3];
+      rows.push_back(CRGB(px[0], px[1], px[2]));
+    }
+  }
+  return true;
+}
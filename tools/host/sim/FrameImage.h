@@ -0,0 +1,35 @@
+#pragma once
+/**
+ * FrameImage.h
+ *
+ * Strip frames over time as a picture: one row per frame, one column per
+ * pixel, written as a binary PPM (any image viewer, or `convert out.ppm
+ * out.png`). `scale` blows each pixel up to scale x scale so a 70 pixel strip
+ * is still visible. readPpm() takes such a picture back apart (clipgen turns
+ * animvm/golden renders into clips that way).
+ */
+
+#include <FastLED.h>
+
+#include <string>
+#include <vector>
+
+class FrameImage {
+public:
+  FrameImage(uint16_t pixels, uint8_t scale = 4)
+      : pixels(pixels), scale(scale) {}
+
+  void addFrame(const CRGB *frame);
+  bool writePpm(const std::string &path) const;
+  // replaces everything, `scale` must be the one it was written with
+  bool readPpm(const std::string &path);
+
+  uint16_t width() const { return pixels; }
+  uint32_t frames() const { return pixels ? rows.size() / pixels : 0; }
+  const CRGB *frame(uint32_t index) const { return &rows[index * pixels]; }
+
+private:
+  uint16_t pixels;
+  uint8_t scale;
+  std::vector<CRGB> rows;
+};
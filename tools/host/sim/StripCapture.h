@@ -0,0 +1,27 @@
+#pragma once
+/**
+ * StripCapture.h
+ *
+ * What the host WS2815Driver (WS2815Driver.cpp here, in place of the PIO +
+ * DMA one) puts on the wire: every show() as the bytes the strip would
+ * latch, after brightness, with the pin and the simulated time the transfer
+ * started.
+ */
+
+#include <FastLED.h>
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+namespace host {
+struct StripFrame {
+  uint8_t pin;
+  uint64_t atUs;
+  std::vector<CRGB> pixels;
+};
+
+// one callback for every output, replaced by the next call (nullptr: none)
+void onStripShow(std::function<void(const StripFrame &)> callback);
+} // namespace host
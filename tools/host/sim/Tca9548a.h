@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * Tca9548a.h
+ *
+ * Stand-in for the TCA9548A I2C switch: a control register with one bit per
+ * channel, and devices behind the channels that are only reachable while
+ * their channel is open. The Wire shim asks route() for addresses nobody on
+ * the main bus answers, so the firmware's mux writes and the same address on
+ * several channels (the three readers at 0x28) work as on the board.
+ *
+ * Usage:
+ *   Tca9548a mux;
+ *   Wire.attach(config::MUX_ADDR, &mux);
+ *   mux.attach(config::GND_FRAME_CHANNEL, 0x28, &frameReader);
+ */
+
+#include <Wire.h>
+
+#include <map>
+
+class Tca9548a : public host::I2CDevice {
+public:
+  static constexpr uint8_t NUM_CHANNELS = 8;
+
+  void attach(uint8_t channel, uint8_t address, host::I2CDevice *device) {
+    channels[channel][address] = device;
+  }
+
+  bool write(const uint8_t *data, size_t len) override {
+    if (len > 0) {
+      mask = data[len - 1];
+      writes++;
+    }
+    return true;
+  }
+  size_t read(uint8_t *data, size_t len) override {
+    for (size_t i = 0; i < len; i++)
+      data[i] = mask;
+    return len;
+  }
+  host::I2CDevice *route(uint8_t address) override {
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+      if (!(mask & (1 << ch)))
+        continue;
+      auto it = channels[ch].find(address);
+      if (it != channels[ch].end())
+        return it->second;
+    }
+    return nullptr;
+  }
+
+  uint8_t mask = 0;    // open channels
+  uint32_t writes = 0; // control register writes
+
+private:
+  std::map<uint8_t, host::I2CDevice *> channels[NUM_CHANNELS];
+};
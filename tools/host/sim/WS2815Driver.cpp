@@ -0,0 +1,85 @@
+/**
+ * WS2815Driver.cpp (host)
+ *
+ * Replaces rp2040/WS2815Driver.cpp behind the same header: no PIO or DMA,
+ * the frame is converted exactly like the board does (GRB words, brightness
+ * with scale8_video rounding) and handed to StripCapture. Wire time is
+ * simulated: a show() before the previous frame + reset gap is over waits
+ * out the rest on the board clock and counts it in getStats(), like the
+ * real one.
+ */
+
+#include "WS2815Driver.h"
+#include "Config.h"
+#include "HostBoard.h"
+#include "StripCapture.h"
+#include <Arduino.h>
+
+#include <map>
+
+namespace {
+std::function<void(const host::StripFrame &)> &callback() {
+  static std::function<void(const host::StripFrame &)> cb;
+  return cb;
+}
+
+// the class has no pin member, so the host keeps it on the side
+std::map<const WS2815Driver *, uint8_t> &pins() {
+  static std::map<const WS2815Driver *, uint8_t> p;
+  return p;
+}
+
+inline uint32_t scaleChannel(uint8_t c, uint8_t scale) {
+  return ((uint16_t(c) * scale) >> 8) + ((c && scale) ? 1 : 0);
+}
+} // namespace
+
+void host::onStripShow(std::function<void(const StripFrame &)> cb) {
+  callback() = cb;
+}
+
+bool WS2815Driver::begin(uint8_t pin, uint16_t count) {
+  numPixels = (count < config::LED_MAX_OUTPUT_PIXELS)
+                  ? count
+                  : config::LED_MAX_OUTPUT_PIXELS;
+  pins()[this] = pin;
+  dmaChannel = int(pins().size()) - 1;
+  readyAtUs = micros();
+  return true;
+}
+
+bool WS2815Driver::busy() const { return (long)(micros() - readyAtUs) < 0; }
+
+void WS2815Driver::show(const CRGB *pixels, uint8_t scale) {
+  if (dmaChannel < 0)
+    return;
+
+  uint32_t *out = frames[backIndex];
+  for (uint16_t i = 0; i < numPixels; i++) {
+    out[i] = (scaleChannel(pixels[i].g, scale) << 24) |
+             (scaleChannel(pixels[i].r, scale) << 16) |
+             (scaleChannel(pixels[i].b, scale) << 8);
+  }
+
+  unsigned long waitStartUs = micros();
+  if (busy())
+    delayMicroseconds(readyAtUs - waitStartUs);
+  uint32_t waitedUs = micros() - waitStartUs;
+  stats.waitUs += waitedUs;
+  if (waitedUs > stats.maxWaitUs)
+    stats.maxWaitUs = waitedUs;
+
+  if (callback()) {
+    host::StripFrame frame{pins()[this], host::board().nowUs, {}};
+    frame.pixels.reserve(numPixels);
+    for (uint16_t i = 0; i < numPixels; i++) {
+      frame.pixels.push_back(
+          CRGB((out[i] >> 16) & 0xFF, out[i] >> 24, (out[i] >> 8) & 0xFF));
+    }
+    callback()(frame);
+  }
+
+  readyAtUs = micros() + frameSlotUs();
+  backIndex ^= 1;
+  stats.shows++;
+}
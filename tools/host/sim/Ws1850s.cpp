@@ -0,0 +1,311 @@
+#include "Ws1850s.h"
+
+#include "HostBoard.h"
+
+#include <MFRC522Constants.h>
+
+namespace {
+using R = MFRC522Constants;
+
+constexpr uint8_t IRQ_TIMER = 0x01;
+constexpr uint8_t IRQ_RX = 0x20;
+constexpr uint8_t IRQ_CRC = 0x04; // DivIrqReg
+constexpr uint8_t ERR_BUFFER_OVFL = 0x10;
+constexpr uint8_t FIFO_SIZE = 64;
+
+constexpr uint8_t ATQA[] = {0x44, 0x00}; // NTAG: 7 byte UID, no anticollision
+constexpr uint8_t SAK_MORE = 0x04;       // UID not complete
+constexpr uint8_t SAK_DONE = 0x00;
+constexpr uint8_t NAK = 0x00;
+
+// 106 kbit/s: one bit is 128 carrier cycles of 13.56MHz, bytes carry parity
+uint64_t airUs(uint32_t bits) { return (uint64_t(bits) * 12800 + 1355) / 1356; }
+uint32_t frameBits(size_t bytes, uint8_t lastBits) {
+  return lastBits ? uint32_t(bytes - 1) * 9 + lastBits : uint32_t(bytes) * 9;
+}
+constexpr uint32_t FDT_US = 91; // PCD frame end -> PICC frame start
+
+uint16_t crcA(const uint8_t *data, size_t len) {
+  uint16_t crc = 0x6363;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t b = data[i] ^ uint8_t(crc);
+    b ^= b << 4;
+    crc = (crc >> 8) ^ (uint16_t(b) << 8) ^ (uint16_t(b) << 3) ^ (b >> 4);
+  }
+  return crc;
+}
+
+bool crcOk(const std::vector<uint8_t> &frame) {
+  if (frame.size() < 3)
+    return false;
+  uint16_t crc = crcA(frame.data(), frame.size() - 2);
+  return frame[frame.size() - 2] == uint8_t(crc) &&
+         frame[frame.size() - 1] == uint8_t(crc >> 8);
+}
+
+void appendCrc(std::vector<uint8_t> &frame) {
+  uint16_t crc = crcA(frame.data(), frame.size());
+  frame.push_back(uint8_t(crc));
+  frame.push_back(uint8_t(crc >> 8));
+}
+} // namespace
+
+// ========== TAG ==========
+Ntag203::Ntag203(const uint8_t (&id)[UID_SIZE]) {
+  memcpy(uid, id, UID_SIZE);
+  pages[0][0] = uid[0];
+  pages[0][1] = uid[1];
+  pages[0][2] = uid[2];
+  pages[0][3] = R::PICC_CMD_CT ^ uid[0] ^ uid[1] ^ uid[2];
+  memcpy(pages[1], &uid[3], 4);
+  pages[2][0] = uid[3] ^ uid[4] ^ uid[5] ^ uid[6];
+}
+
+void Ntag203::writePage(uint8_t page, const uint8_t data[4]) {
+  if (page < NUM_PAGES)
+    memcpy(pages[page], data, 4);
+}
+
+// ========== READER ==========
+void Ws1850s::reset() {
+  memset(regs, 0, sizeof(regs));
+  regs[R::CommandReg] = 0x20; // receiver off
+  regs[R::ModeReg] = 0x3F;
+  regs[R::TxModeReg] = 0x00;
+  regs[R::TxControlReg] = 0x80; // antenna off
+  regs[R::ModWidthReg] = 0x26;
+  fifo.clear();
+  pending = false;
+  rxLastBits = 0;
+  resets++;
+  powerTag();
+}
+
+bool Ws1850s::fieldOn() const {
+  return (regs[R::TxControlReg] & 0x03) != 0;
+}
+
+void Ws1850s::place(const Ntag203 *t) {
+  tag = t;
+  tagState = TAG_OFF;
+  powerTag();
+}
+
+void Ws1850s::powerTag() {
+  if (!tag || !fieldOn())
+    tagState = TAG_OFF;
+  else if (tagState == TAG_OFF)
+    tagState = TAG_IDLE;
+}
+
+uint64_t Ws1850s::timeoutUs() const {
+  uint32_t prescaler =
+      (uint32_t(regs[R::TModeReg] & 0x0F) << 8) | regs[R::TPrescalerReg];
+  uint32_t reload = (uint32_t(regs[R::TReloadRegH]) << 8) |
+                    regs[R::TReloadRegL];
+  return (uint64_t(2 * prescaler + 1) * (reload + 1) * 100 + 1355) / 1356;
+}
+
+bool Ws1850s::write(const uint8_t *data, size_t len) {
+  if (len == 0)
+    return true;
+  address = data[0] & 0x3F;
+  for (size_t i = 1; i < len; i++)
+    writeRegister(address, data[i]);
+  return true;
+}
+
+size_t Ws1850s::read(uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    data[i] = readRegister(address);
+  return len;
+}
+
+void Ws1850s::writeRegister(uint8_t reg, uint8_t value) {
+  settle();
+  switch (reg) {
+  case R::CommandReg:
+    regs[reg] = value;
+    switch (value & 0x0F) {
+    case R::PCD_SoftReset:
+      reset();
+      break;
+    case R::PCD_Idle:
+      pending = false;
+      break;
+    case R::PCD_CalcCRC: {
+      std::vector<uint8_t> data(fifo.begin(), fifo.end());
+      fifo.clear();
+      uint16_t crc = crcA(data.data(), data.size());
+      regs[R::CRCResultRegL] = uint8_t(crc);
+      regs[R::CRCResultRegH] = uint8_t(crc >> 8);
+      regs[R::DivIrqReg] |= IRQ_CRC;
+      break;
+    }
+    }
+    break;
+  case R::ComIrqReg:
+  case R::DivIrqReg:
+    // bit 7 says whether the marked bits are set or cleared
+    if (value & 0x80)
+      regs[reg] |= value & 0x7F;
+    else
+      regs[reg] &= ~value;
+    break;
+  case R::FIFOLevelReg:
+    if (value & 0x80) {
+      fifo.clear();
+      regs[R::ErrorReg] &= ~ERR_BUFFER_OVFL;
+    }
+    break;
+  case R::FIFODataReg:
+    if (fifo.size() < FIFO_SIZE)
+      fifo.push_back(value);
+    else
+      regs[R::ErrorReg] |= ERR_BUFFER_OVFL;
+    break;
+  case R::BitFramingReg:
+    regs[reg] = value & 0x7F; // StartSend reads back 0 once the frame is out
+    if ((value & 0x80) && (regs[R::CommandReg] & 0x0F) == R::PCD_Transceive)
+      startTransceive();
+    break;
+  case R::TxControlReg:
+    regs[reg] = value;
+    powerTag();
+    break;
+  default:
+    regs[reg] = value;
+    break;
+  }
+}
+
+uint8_t Ws1850s::readRegister(uint8_t reg) {
+  settle();
+  switch (reg) {
+  case R::FIFODataReg: {
+    if (fifo.empty())
+      return 0;
+    uint8_t b = fifo.front();
+    fifo.pop_front();
+    return b;
+  }
+  case R::FIFOLevelReg:
+    return uint8_t(fifo.size());
+  case R::ControlReg:
+    return rxLastBits;
+  case R::VersionReg:
+    return VERSION;
+  default:
+    return regs[reg];
+  }
+}
+
+void Ws1850s::startTransceive() {
+  std::vector<uint8_t> frame(fifo.begin(), fifo.end());
+  fifo.clear();
+  uint8_t txLastBits = regs[R::BitFramingReg] & 0x07;
+  frames++;
+
+  reply = answer(frame, txLastBits, replyLastBits);
+  uint64_t txUs = airUs(frameBits(frame.size(), txLastBits));
+  if (reply.empty()) {
+    doneUs = host::nowUs() + txUs + timeoutUs();
+  } else {
+    answered++;
+    doneUs = host::nowUs() + txUs + FDT_US +
+             airUs(frameBits(reply.size(), replyLastBits));
+  }
+  pending = true;
+}
+
+void Ws1850s::settle() {
+  if (!pending || host::nowUs() < doneUs)
+    return;
+  pending = false;
+  regs[R::ErrorReg] = 0;
+  if (reply.empty()) {
+    regs[R::ComIrqReg] |= IRQ_TIMER;
+    return;
+  }
+  fifo.assign(reply.begin(), reply.end());
+  rxLastBits = replyLastBits;
+  regs[R::ComIrqReg] |= IRQ_RX;
+}
+
+std::vector<uint8_t> Ws1850s::answer(const std::vector<uint8_t> &frame,
+                                     uint8_t txLastBits, uint8_t &lastBits) {
+  lastBits = 0;
+  if (tagState == TAG_OFF || frame.empty())
+    return {};
+  if (dropPercent) {
+    dropState = dropState * 1103515245 + 12345;
+    if ((dropState >> 16) % 100 < dropPercent)
+      return {};
+  }
+
+  // short frame: REQA / WUPA
+  if (frame.size() == 1 && txLastBits == 7) {
+    bool wakes = frame[0] == R::PICC_CMD_WUPA
+                     ? (tagState == TAG_IDLE || tagState == TAG_HALT)
+                     : (frame[0] == R::PICC_CMD_REQA && tagState == TAG_IDLE);
+    if (wakes) {
+      tagState = TAG_READY1;
+      return {ATQA[0], ATQA[1]};
+    }
+    if (tagState != TAG_HALT)
+      tagState = TAG_IDLE;
+    return {};
+  }
+
+  const uint8_t *uid = tag->uid;
+  bool cl1 = frame[0] == R::PICC_CMD_SEL_CL1 && tagState == TAG_READY1;
+  bool cl2 = frame[0] == R::PICC_CMD_SEL_CL2 && tagState == TAG_READY2;
+  std::vector<uint8_t> part;
+  if (cl1)
+    part = {R::PICC_CMD_CT, uid[0], uid[1], uid[2]};
+  else if (cl2)
+    part = {uid[3], uid[4], uid[5], uid[6]};
+  if (!part.empty())
+    part.push_back(part[0] ^ part[1] ^ part[2] ^ part[3]);
+
+  // ANTICOLLISION, nobody else in the field so the whole part comes back
+  if (frame.size() == 2 && frame[1] == 0x20 && !part.empty())
+    return part;
+
+  // SELECT
+  if (frame.size() == 9 && frame[1] == 0x70 && !part.empty() &&
+      crcOk(frame) && std::equal(part.begin(), part.end(), &frame[2])) {
+    tagState = cl1 ? TAG_READY2 : TAG_ACTIVE;
+    std::vector<uint8_t> sak = {cl1 ? SAK_MORE : SAK_DONE};
+    appendCrc(sak);
+    return sak;
+  }
+
+  if (tagState == TAG_ACTIVE && frame.size() == 4 && crcOk(frame)) {
+    if (frame[0] == R::PICC_CMD_MF_READ) {
+      uint8_t page = frame[1];
+      if (page >= Ntag203::NUM_PAGES) {
+        tagState = TAG_IDLE;
+        lastBits = 4;
+        return {NAK};
+      }
+      // 16 bytes, rolling over to page 0 at the end of memory
+      std::vector<uint8_t> data;
+      for (uint8_t i = 0; i < 4; i++) {
+        const uint8_t *p = tag->pages[(page + i) % Ntag203::NUM_PAGES];
+        data.insert(data.end(), p, p + 4);
+      }
+      appendCrc(data);
+      return data;
+    }
+    if (frame[0] == R::PICC_CMD_HLTA && frame[1] == 0x00) {
+      tagState = TAG_HALT;
+      return {};
+    }
+  }
+
+  // anything unexpected: back to IDLE (a halted tag stays halted)
+  if (tagState != TAG_HALT)
+    tagState = TAG_IDLE;
+  return {};
+}
@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * Ws1850s.h
+ *
+ * Stand-in for the M5Stack RFID2 unit (WS1850S, MFRC522 register map) on the
+ * host Wire bus, with an NTAG203 that can be put in its field. Driven by the
+ * MFRC522 shim the way the library drives the chip:
+ *   - a register write is <reg> <value...> (FIFODataReg takes them all), a
+ *     read is <reg> then requestFrom
+ *   - CalcCRC computes CRC_A over the FIFO at once (CRCIRq)
+ *   - Transceive sends the FIFO on StartSend; the tag's answer lands in the
+ *     FIFO with RxIRq after the air time at 106 kbit/s, no answer raises
+ *     TimerIRq after the TPrescaler/TReload timeout (25ms after PCD_Init)
+ *   - SoftReset or the antenna going off powers the tag down, so it comes back
+ *     IDLE when the field returns
+ *
+ * The tag follows ISO 14443-3: REQA only wakes an IDLE tag, a 7 byte UID
+ * takes two cascade levels, READ returns 4 pages, HLTA halts it (then only
+ * WUPA wakes it), anything it doesn't expect sends it back to IDLE. That
+ * last rule is why an ACTIVE tag misses every other REQA unless the reader
+ * is reset between polls, which is what the sketches do.
+ *
+ * Fault knob: `dropPercent` loses that share of frames in the field (a tag at
+ * the edge of range), from a fixed-seed generator so runs repeat.
+ *
+ * Usage:
+ *   Ws1850s positive;
+ *   mux.attach(config::POSITIVE_TERMINAL_CHANNEL, 0x28, &positive);
+ *   Ntag203 cable(uid);
+ *   cable.writePage(4, data);
+ *   positive.place(&cable); // nullptr takes it away again
+ */
+
+#include <Wire.h>
+
+#include <deque>
+#include <vector>
+
+struct Ntag203 {
+  static constexpr uint8_t UID_SIZE = 7;
+  static constexpr uint8_t NUM_PAGES = 42;
+
+  // pages 0-2 get the UID and its check bytes like the factory does
+  explicit Ntag203(const uint8_t (&uid)[UID_SIZE]);
+  void writePage(uint8_t page, const uint8_t data[4]);
+
+  uint8_t uid[UID_SIZE];
+  uint8_t pages[NUM_PAGES][4] = {};
+};
+
+class Ws1850s : public host::I2CDevice {
+public:
+  static constexpr uint8_t VERSION = 0x15; // what the RFID2 units report
+
+  Ws1850s() { reset(); }
+
+  bool write(const uint8_t *data, size_t len) override;
+  size_t read(uint8_t *data, size_t len) override;
+
+  void place(const Ntag203 *tag);
+  bool fieldOn() const;
+
+  // ----- configuration -----
+  uint8_t dropPercent = 0;
+
+  // ----- observed -----
+  uint32_t resets = 0;
+  uint32_t frames = 0;   // transceives started
+  uint32_t answered = 0; // ... the tag replied to
+
+private:
+  enum TagState { TAG_OFF, TAG_IDLE, TAG_READY1, TAG_READY2, TAG_ACTIVE,
+                  TAG_HALT };
+
+  void reset();
+  void writeRegister(uint8_t reg, uint8_t value);
+  uint8_t readRegister(uint8_t reg);
+  void settle(); // completes a transceive whose time has come
+  void startTransceive();
+  // the tag's answer to a frame, empty for none
+  std::vector<uint8_t> answer(const std::vector<uint8_t> &frame,
+                              uint8_t txLastBits, uint8_t &rxLastBits);
+  uint64_t timeoutUs() const;
+  void powerTag();
+
+  uint8_t regs[64];
+  uint8_t address = 0; // register pointer, set by the first byte of a write
+  std::deque<uint8_t> fifo;
+
+  bool pending = false;
+  uint64_t doneUs = 0;
+  std::vector<uint8_t> reply;
+  uint8_t replyLastBits = 0;
+  uint8_t rxLastBits = 0;
+
+  const Ntag203 *tag = nullptr;
+  TagState tagState = TAG_OFF;
+  uint32_t dropState = 1;
+};
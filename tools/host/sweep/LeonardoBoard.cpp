@@ -0,0 +1,23 @@
+/**
+ * LeonardoBoard.cpp
+ *
+ * WallBatterySystem::updateSystem() for tag_sweep: every POLL_INTERVAL_MS
+ * one battery, its positive then negative reader, then its mux off
+ * (Battery::updateReaders), round-robin over NUM_BATTERIES.
+ */
+
+#include "Config.h"
+#include "TagSweep.h"
+
+const BoardModel &boardModel() {
+  static const BoardModel board = {
+      "leonardo",
+      config::NUM_BATTERIES * 2,
+      2,
+      config::I2C_CLOCK_SPEED,
+      config::POLL_INTERVAL_MS,
+      config::CHANNEL_SWITCH_SETTLE_MS,
+      {25, 50, 100, 200, 400},
+  };
+  return board;
+}
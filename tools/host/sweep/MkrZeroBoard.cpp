@@ -0,0 +1,27 @@
+/**
+ * MkrZeroBoard.cpp
+ *
+ * ToyCarSystem::update() for tag_sweep: every rfidCheckIntervalMs all three
+ * readers (positive, negative, frame), then the mux off.
+ */
+
+#include "Config.h"
+#include "TagSweep.h"
+
+namespace {
+constexpr uint16_t RFID_CHECK_INTERVAL_MS = 100; // ToyCarSystem.h
+constexpr uint32_t WIRE_DEFAULT_HZ = 100000;     // ToyCarSystem never sets it
+} // namespace
+
+const BoardModel &boardModel() {
+  static const BoardModel board = {
+      "mkrzero",
+      3,
+      3,
+      WIRE_DEFAULT_HZ,
+      RFID_CHECK_INTERVAL_MS,
+      config::CHANNEL_SWITCH_SETTLE_MS,
+      {25, 50, 100, 200, 400},
+  };
+  return board;
+}
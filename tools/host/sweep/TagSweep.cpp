@@ -0,0 +1,473 @@
+#include "TagSweep.h"
+#include "Config.h"
+#include "HostBoard.h"
+#include "Tca9548a.h"
+#include "Ws1850s.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+
+// ========== TRACES ==========
+bool ReaderTrace::tagOn() const {
+  size_t seen = 0;
+  for (const Sighting &s : polls)
+    seen += s.seen;
+  return seen * 2 > polls.size();
+}
+
+namespace {
+// value of ` key=value` in a bench line, false if it isn't there
+bool field(const std::string &line, const char *key, std::string &value) {
+  std::string needle = std::string(" ") + key + "=";
+  size_t at = line.find(needle);
+  if (at == std::string::npos)
+    return false;
+  at += needle.size();
+  value = line.substr(at, line.find(' ', at) - at);
+  return true;
+}
+} // namespace
+
+bool parseTraces(std::istream &in, std::vector<ReaderTrace> &traces,
+                 std::string &error) {
+  std::string line;
+  for (int number = 1; std::getline(in, line); number++) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.find(" name=tag_trace ") == std::string::npos)
+      continue;
+
+    std::string reader, poll, seen, uid;
+    if (!field(line, "reader", reader) || !field(line, "poll", poll) ||
+        !field(line, "seen", seen) || !field(line, "uid", uid) ||
+        (seen != "0" && seen != "1")) {
+      error = "line " + std::to_string(number) + ": bad tag_trace line";
+      return false;
+    }
+
+    // a poll=0 starts a new recording of that reader
+    unsigned long index = strtoul(poll.c_str(), nullptr, 10);
+    ReaderTrace *trace = nullptr;
+    for (ReaderTrace &t : traces) {
+      if (t.reader == reader)
+        trace = &t; // the last one of that name
+    }
+    if (!trace || index == 0) {
+      traces.push_back({reader, {}});
+      trace = &traces.back();
+    }
+    if (index != trace->polls.size()) {
+      error = "line " + std::to_string(number) + ": " + reader + " poll " +
+              poll + " after " + std::to_string(trace->polls.size() - 1);
+      return false;
+    }
+    bool sawTag = seen == "1";
+    trace->polls.push_back({sawTag, sawTag ? uid : std::string()});
+  }
+  return true;
+}
+
+TagEvent TagReplay::step(const Sighting &sighting, unsigned long nowMs) {
+  bool sameTag = sighting.seen && !lastUid.empty() && sighting.uid == lastUid;
+  if (sighting.seen)
+    lastUid = sighting.uid;
+
+  TagEvent event = tags.step(sighting.seen, sameTag, nowMs);
+  if (event == TAG_EVENT_DIFFERENT || event == TAG_EVENT_DETECT_FAILED ||
+      event == TAG_EVENT_REMOVED)
+    lastUid.clear();
+  return event;
+}
+
+void NoiseModel::fit(const std::vector<ReaderTrace> &traces) {
+  // [0] after a sighting, [1] after a miss
+  uint32_t polls[2] = {}, misses[2] = {};
+  uint32_t emptyPolls = 0, phantoms = 0;
+  for (const ReaderTrace &trace : traces) {
+    if (!trace.tagOn()) {
+      emptyPolls += trace.polls.size();
+      for (const Sighting &s : trace.polls)
+        phantoms += s.seen;
+      continue;
+    }
+    for (size_t i = 1; i < trace.polls.size(); i++) {
+      int after = trace.polls[i - 1].seen ? 0 : 1;
+      polls[after]++;
+      misses[after] += !trace.polls[i].seen;
+    }
+  }
+  if (polls[0])
+    missAfterSeen = double(misses[0]) / polls[0];
+  if (polls[1])
+    missAfterMiss = double(misses[1]) / polls[1];
+  if (emptyPolls)
+    phantom = double(phantoms) / emptyPolls;
+}
+
+// ========== PROBE COST ==========
+ProbeCost measureProbeCost(uint32_t i2cHz) {
+  const uint8_t uid[Ntag203::UID_SIZE] = {0x04, 0xA1, 0x5C, 0x22,
+                                          0x6B, 0x41, 0x80};
+  host::Board &caller = host::board();
+  host::Board board("probe");
+  host::select(board);
+  Wire.begin();
+  Wire.setClock(i2cHz);
+  Tca9548a mux;
+  Ws1850s chip;
+  Ntag203 tag(uid);
+  Wire.attach(0x70, &mux);
+  Wire.attach(config::RFID2_WS1850S_ADDR, &chip);
+  MFRC522DriverI2C driver{config::RFID2_WS1850S_ADDR, Wire};
+  MFRC522 reader{driver};
+  TerminalReader terminal(config::RFID2_WS1850S_ADDR, "probe",
+                          config::POSITIVE_TERMINAL_CHANNEL);
+  terminal.init(reader);
+
+  ProbeCost cost;
+  uint64_t start = host::nowUs();
+  Wire.beginTransmission(0x70);
+  Wire.write(uint8_t(1));
+  Wire.endTransmission();
+  cost.muxWriteUs = host::nowUs() - start;
+
+  start = host::nowUs();
+  reader.PCD_Init();
+  cost.initUs = host::nowUs() - start;
+  start = host::nowUs();
+  terminal.update(reader);
+  cost.emptyUs = host::nowUs() - start;
+
+  // the confirming poll also reads the tag's pages, a steady one doesn't
+  chip.place(&tag);
+  for (int poll = 0; poll < 8; poll++) {
+    reader.PCD_Init();
+    start = host::nowUs();
+    terminal.update(reader);
+    cost.tagUs = host::nowUs() - start;
+    host::advanceUs(100000);
+  }
+
+  Wire.detach(config::RFID2_WS1850S_ADDR);
+  Wire.detach(0x70);
+  host::select(caller);
+  return cost;
+}
+
+// ========== GRID ==========
+namespace {
+// around the Config.h values (150, 450, 3, 2, 2), which are in every list
+const unsigned long DEBOUNCE_MS[] = {0, 50, 100, 150, 250, 400};
+const unsigned long ABSENCE_MS[] = {150, 300, 450, 700, 1000};
+const uint8_t PRESENCE_N[] = {1, 2, 3, 4, 6};
+const uint8_t DETECT_FAIL_N[] = {1, 2, 3};
+const uint8_t CONFIRM_X[] = {1, 2, 3};
+const uint8_t SETTLE_MS[] = {1, 2, 5, 10};
+} // namespace
+
+bool Candidate::isDefault(const BoardModel &board) const {
+  TagTimingConfig d = defaultTagTiming();
+  return pollIntervalMs == board.pollIntervalMs &&
+         settleMs == board.settleMs && timing.debounceMs == d.debounceMs &&
+         timing.absenceTimeoutMs == d.absenceTimeoutMs &&
+         timing.presenceThreshold == d.presenceThreshold &&
+         timing.detectFailThreshold == d.detectFailThreshold &&
+         timing.removalConfirmFactor == d.removalConfirmFactor;
+}
+
+std::vector<Candidate> candidateGrid(const BoardModel &board) {
+  std::vector<Candidate> grid;
+  for (uint16_t poll : board.pollGrid)
+    for (uint8_t settle : SETTLE_MS)
+      for (unsigned long debounce : DEBOUNCE_MS)
+        for (unsigned long absence : ABSENCE_MS)
+          for (uint8_t presence : PRESENCE_N)
+            for (uint8_t detectFail : DETECT_FAIL_N)
+              for (uint8_t confirm : CONFIRM_X)
+                grid.push_back({poll,
+                                settle,
+                                {debounce, absence, presence, detectFail,
+                                 confirm}});
+  return grid;
+}
+
+// ========== SIMULATION ==========
+namespace {
+// splitmix64, one stream per reader and purpose so candidates that poll at
+// other times still get the same visits
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  bool chance(double p) { return (next() >> 11) * 0x1.0p-53 < p; }
+  uint64_t between(uint64_t lo, uint64_t hi) { return lo + next() % (hi - lo); }
+};
+
+// one clamp on the terminal, times in board us
+struct Visit {
+  uint64_t startUs;
+  uint64_t endUs;
+  std::string uid;
+  uint32_t presentMs = NEVER_MS;
+  uint32_t removedMs = NEVER_MS;
+  bool confirmed = false;
+};
+
+constexpr uint8_t UIDS_PER_READER = 4; // clamps that get put on it
+constexpr double SWAP_CHANCE = 0.2;    // next clamp goes on right away
+
+std::vector<Visit> visitScript(uint32_t visits, uint64_t seed, uint8_t reader,
+                               uint64_t &endUs) {
+  Rng rng(seed * 1000003 + reader);
+  std::vector<Visit> script;
+  uint64_t t = rng.between(1000, 5000) * 1000;
+  int lastUid = -1;
+  bool swap = false;
+  for (uint32_t v = 0; v < visits; v++) {
+    int uid = rng.next() % UIDS_PER_READER;
+    if (swap && uid == lastUid)
+      uid = (uid + 1) % UIDS_PER_READER;
+    char text[8];
+    snprintf(text, sizeof(text), "%02X%02X", reader, uid);
+    uint64_t onUs = rng.between(2000, 20000) * 1000;
+    script.push_back({t, t + onUs, text});
+    t += onUs;
+    lastUid = uid;
+    // the last clamp stays off long enough to be noticed gone
+    swap = v + 1 < visits && rng.chance(SWAP_CHANCE);
+    t += (swap ? rng.between(150, 600) : rng.between(2000, 10000)) * 1000;
+  }
+  endUs = t;
+  return script;
+}
+
+// one TerminalReader in the poll loop, fed a visit script or a recording
+struct ReaderSim {
+  TagReplay replay;
+  Rng noise;
+  bool lastSeen = true;
+
+  // synthetic
+  std::vector<Visit> visits;
+  size_t next = 0; // first visit not over yet
+  uint64_t endUs = 0;
+
+  // recorded
+  const ReaderTrace *trace = nullptr;
+  size_t poll = 0;
+
+  uint32_t falseTransitions = 0;
+
+  ReaderSim(const TagTimingConfig &timing, uint64_t seed)
+      : replay(timing), noise(seed) {}
+
+  bool done(uint64_t nowUs) const {
+    return trace ? poll >= trace->polls.size() : nowUs >= endUs;
+  }
+
+  // the visit going on at nowUs, if any. a visit that ended while the
+  // board already thought the clamp gone was noticed at once
+  Visit *current(uint64_t nowUs) {
+    while (next < visits.size() && visits[next].endUs <= nowUs) {
+      Visit &v = visits[next++];
+      if (v.confirmed && replay.getState() != TAG_PRESENT)
+        v.removedMs = 0;
+    }
+    if (next < visits.size() && visits[next].startUs <= nowUs)
+      return &visits[next];
+    return nullptr;
+  }
+
+  // the last visit over, if the board hasn't noticed yet
+  Visit *pendingRemoval() {
+    if (next == 0)
+      return nullptr;
+    Visit &v = visits[next - 1];
+    return v.confirmed && v.removedMs == NEVER_MS ? &v : nullptr;
+  }
+
+  Sighting sight(uint64_t nowUs, const NoiseModel &model) {
+    if (trace)
+      return trace->polls[poll++];
+
+    Visit *v = current(nowUs);
+    if (!v) {
+      lastSeen = true; // a clamp going on starts out in range
+      if (model.phantom > 0 && noise.chance(model.phantom))
+        return {true, "phantom"};
+      return {false, std::string()};
+    }
+    uint64_t edgeUs = uint64_t(model.edgeMs) * 1000;
+    bool seen;
+    if (nowUs - v->startUs < edgeUs || v->endUs - nowUs < edgeUs)
+      seen = noise.chance(0.5);
+    else
+      seen = !noise.chance(lastSeen ? model.missAfterSeen
+                                    : model.missAfterMiss);
+    lastSeen = seen;
+    return {seen, seen ? v->uid : std::string()};
+  }
+
+  void score(TagEvent event, uint64_t nowUs) {
+    if (trace) {
+      bool tagOn = trace->tagOn();
+      if ((tagOn && (event == TAG_EVENT_REMOVED ||
+                     event == TAG_EVENT_DIFFERENT)) ||
+          (!tagOn && event == TAG_EVENT_CONFIRMED))
+        falseTransitions++;
+      return;
+    }
+
+    Visit *v = current(nowUs);
+    switch (event) {
+    case TAG_EVENT_CONFIRMED:
+      if (!v) {
+        falseTransitions++;
+      } else if (!v->confirmed) {
+        v->confirmed = true;
+        v->presentMs = (nowUs - v->startUs) / 1000;
+      }
+      break;
+    case TAG_EVENT_REMOVED:
+    case TAG_EVENT_DIFFERENT:
+      // the clamp before this one going, or one still there
+      if (Visit *gone = pendingRemoval())
+        gone->removedMs = (nowUs - gone->endUs) / 1000;
+      else if (v)
+        falseTransitions++;
+      break;
+    default:
+      break;
+    }
+  }
+};
+
+// the board's poll loop over `readers` until every one is done, returns the
+// board time it took
+uint64_t runPollLoop(const BoardModel &board, const ProbeCost &cost,
+                     const Candidate &c, const NoiseModel &model,
+                     std::vector<ReaderSim> &readers) {
+  uint64_t t = 0;
+  uint8_t nextReader = 0;
+  const uint64_t switchUs = cost.muxWriteUs + uint64_t(c.settleMs) * 1000;
+  for (;;) {
+    bool allDone = true;
+    for (const ReaderSim &r : readers)
+      allDone = allDone && r.done(t);
+    if (allDone)
+      return t;
+
+    uint64_t pollStart = t;
+    for (uint8_t n = 0; n < board.readersPerPoll; n++) {
+      ReaderSim &r = readers[nextReader];
+      nextReader = (nextReader + 1) % board.readers;
+      t += switchUs + cost.initUs;
+      // TerminalReader::update() reads millis() before it probes
+      bool active = !r.done(t);
+      Sighting s = active ? r.sight(t, model) : Sighting{false, {}};
+      if (active) {
+        TagEvent event = r.replay.step(s, t / 1000);
+        if (event != TAG_EVENT_NONE)
+          r.score(event, t);
+      }
+      t += s.seen ? cost.tagUs : cost.emptyUs;
+    }
+    t += switchUs; // mux off
+    t = std::max(t, pollStart + uint64_t(c.pollIntervalMs) * 1000);
+  }
+}
+
+uint32_t percentile(std::vector<uint32_t> values, double q) {
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  size_t rank = size_t(q * values.size() + 0.999999);
+  return values[rank ? rank - 1 : 0];
+}
+} // namespace
+
+SweepResult simulate(const SweepInput &input, const Candidate &candidate) {
+  const BoardModel &board = *input.board;
+  SweepResult result = {};
+  std::vector<uint32_t> present, removed;
+
+  // synthetic visits, every reader at once
+  if (input.visits) {
+    std::vector<ReaderSim> readers;
+    for (uint8_t r = 0; r < board.readers; r++) {
+      readers.emplace_back(candidate.timing, input.seed * 7919 + r);
+      ReaderSim &sim = readers.back();
+      sim.visits = visitScript(input.visits, input.seed, r, sim.endUs);
+    }
+    runPollLoop(board, input.cost, candidate, input.noise, readers);
+    for (ReaderSim &r : readers) {
+      result.falseTransitions += r.falseTransitions;
+      result.readerHours += r.endUs / 3.6e9;
+      for (const Visit &v : r.visits) {
+        result.visits++;
+        present.push_back(v.presentMs);
+        if (v.confirmed)
+          removed.push_back(v.removedMs);
+        result.missed += (v.presentMs == NEVER_MS) ||
+                         (v.confirmed && v.removedMs == NEVER_MS);
+      }
+    }
+  }
+
+  // recordings, as many at a time as the board has readers
+  for (size_t first = 0; first < input.traces.size(); first += board.readers) {
+    std::vector<ReaderSim> readers;
+    for (uint8_t r = 0; r < board.readers; r++) {
+      readers.emplace_back(candidate.timing, 0);
+      if (first + r < input.traces.size())
+        readers.back().trace = &input.traces[first + r];
+      else
+        readers.back().endUs = 0; // nothing recorded, done at once
+    }
+    uint64_t us = runPollLoop(board, input.cost, candidate, input.noise,
+                              readers);
+    for (ReaderSim &r : readers) {
+      if (!r.trace)
+        continue;
+      result.traceFalse += r.falseTransitions;
+      result.falseTransitions += r.falseTransitions;
+      result.readerHours += us / 3.6e9;
+    }
+  }
+
+  result.presentP50Ms = percentile(present, 0.5);
+  result.presentP95Ms = percentile(present, 0.95);
+  result.removedP95Ms = percentile(removed, 0.95);
+  return result;
+}
+
+std::vector<size_t> paretoFront(const std::vector<SweepResult> &results) {
+  std::vector<size_t> order(results.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  // by latency, then false transitions, then grid order: a result is on the
+  // front if it has fewer false transitions than everything before it
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (results[a].latencyMs() != results[b].latencyMs())
+      return results[a].latencyMs() < results[b].latencyMs();
+    return results[a].falsePerHour() < results[b].falsePerHour();
+  });
+
+  std::vector<size_t> front;
+  for (size_t i : order) {
+    if (results[i].latencyMs() == NEVER_MS)
+      break; // missed visits, whatever it saves in false transitions
+    if (front.empty() ||
+        results[i].falsePerHour() < results[front.back()].falsePerHour())
+      front.push_back(i);
+  }
+  return front;
+}
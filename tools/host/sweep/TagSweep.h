@@ -0,0 +1,157 @@
+#pragma once
+/**
+ * TagSweep.h
+ *
+ * Runs a board's TagStateMachine (TerminalReader.h) headlessly under other
+ * timing constants and scores each candidate. This is the engine behind
+ * tag_sweep.cpp. The board comes from whichever TerminalReader.h and
+ * Config.h are on the include path, plus a BoardModel (LeonardoBoard.cpp or
+ * MkrZeroBoard.cpp).
+ *
+ * A candidate sets the poll loop's interval (POLL_INTERVAL_MS on the
+ * Leonardo, ToyCarSystem::rfidCheckIntervalMs on the MKR Zero), the mux
+ * CHANNEL_SWITCH_SETTLE_MS and every TagTimingConfig field. The poll loop is
+ * replayed on a simulated clock. Each poll costs a mux write plus the settle
+ * time, PCD_Init and TerminalReader::update(). Those costs are measured once
+ * on the WS1850S stand-in (measureProbeCost). Every reader is fed sightings
+ * from two sources:
+ *   - synthetic visits: a clamp goes on for a while, then comes off or is
+ *     swapped for another one. Sightings are noisy: misses follow a chain on
+ *     the last outcome, the clamp flickers for edgeMs while it moves, and an
+ *     empty reader can see a phantom tag. The noise can be fitted from
+ *     recordings.
+ *   - recorded traces, ReaderBench's name=tag_trace lines. These are replayed
+ *     probe by probe, with the candidate's timing deciding when each probe
+ *     happens. A trace with mostly sightings had a tag on all along, one with
+ *     mostly misses had none.
+ *
+ * Sightings carry the UID, and TagReplay keeps TerminalReader's lastUID
+ * bookkeeping, so a swapped clamp goes through TAG_EVENT_DIFFERENT like it
+ * does on the board.
+ */
+
+#include "TerminalReader.h"
+
+#include <istream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// one probe: did the reader see a tag, and which (hex UID, empty if not)
+struct Sighting {
+  bool seen;
+  std::string uid;
+};
+
+struct ReaderTrace {
+  std::string reader;
+  std::vector<Sighting> polls;
+
+  bool tagOn() const; // more sightings than misses: a clamp was left on
+};
+
+// every name=tag_trace line of a bench capture, one trace per reader in the
+// order they first appear. anything else in the capture is skipped
+bool parseTraces(std::istream &in, std::vector<ReaderTrace> &traces,
+                 std::string &error);
+
+// TerminalReader::update()'s bookkeeping around the state machine: sameTag
+// compares with the UID seen last, which is forgotten where TerminalReader
+// calls clearTagData()
+class TagReplay {
+public:
+  explicit TagReplay(const TagTimingConfig &timing) : tags(timing) {}
+
+  TagEvent step(const Sighting &sighting, unsigned long nowMs);
+  TagState getState() const { return tags.getState(); }
+
+private:
+  TagStateMachine tags;
+  std::string lastUid;
+};
+
+struct NoiseModel {
+  double missAfterSeen = 0.02; // a clamp that was seen on the last probe
+  double missAfterMiss = 0.3;  // ... that was missed (misses come in bursts)
+  double phantom = 0;          // a tag seen on an empty reader
+  unsigned long edgeMs = 300;  // a clamp going on or off: 50/50 sightings
+
+  // the miss chain from tag-on traces, the phantom rate from tag-off ones
+  // (parameters without data keep their values)
+  void fit(const std::vector<ReaderTrace> &traces);
+};
+
+// board time of one poll, without the mux
+struct ProbeCost {
+  uint32_t muxWriteUs; // one TCA9548A mask write
+  uint32_t initUs;     // PCD_Init
+  uint32_t emptyUs;    // TerminalReader::update(), no tag
+  uint32_t tagUs;      // ... a present tag answering
+};
+
+ProbeCost measureProbeCost(uint32_t i2cHz);
+
+// the board's poll loop: every pollIntervalMs (or when the last poll is done,
+// if later) the next readersPerPoll readers are probed back to back, then the
+// mux is switched off
+struct BoardModel {
+  const char *name;
+  uint8_t readers;
+  uint8_t readersPerPoll;
+  uint32_t i2cHz;
+  uint16_t pollIntervalMs; // the firmware's values
+  uint8_t settleMs;
+  std::vector<uint16_t> pollGrid; // values to sweep
+};
+
+const BoardModel &boardModel();
+
+struct Candidate {
+  uint16_t pollIntervalMs;
+  uint8_t settleMs;
+  TagTimingConfig timing;
+
+  bool isDefault(const BoardModel &board) const;
+};
+
+// the board's poll grid x settle times x timing values, the firmware's own
+// values among them
+std::vector<Candidate> candidateGrid(const BoardModel &board);
+
+struct SweepInput {
+  const BoardModel *board;
+  ProbeCost cost;
+  NoiseModel noise;
+  std::vector<ReaderTrace> traces;
+  uint32_t visits; // synthetic visits per reader
+  uint32_t seed;
+};
+
+constexpr uint32_t NEVER_MS = UINT32_MAX; // latency of a missed visit
+
+struct SweepResult {
+  uint32_t presentP50Ms; // clamp on -> TAG_EVENT_CONFIRMED
+  uint32_t presentP95Ms;
+  uint32_t removedP95Ms; // clamp off -> TAG_EVENT_REMOVED (or DIFFERENT)
+  uint32_t falseTransitions; // REMOVED or DIFFERENT with the clamp still
+                             // on, CONFIRMED with nothing there
+  uint32_t traceFalse;       // ... of those, in the recorded traces
+  uint32_t visits;
+  uint32_t missed; // visits never confirmed, or never noticed gone
+  double readerHours;
+
+  uint32_t latencyMs() const {
+    return presentP95Ms > removedP95Ms ? presentP95Ms : removedP95Ms;
+  }
+  double falsePerHour() const {
+    return readerHours > 0 ? falseTransitions / readerHours : 0;
+  }
+};
+
+// the same input gives the same result, whatever else runs alongside
+SweepResult simulate(const SweepInput &input, const Candidate &candidate);
+
+// indices of the results no other one beats on both latencyMs() and
+// falsePerHour(), by latency. of equal results only the first is kept, and
+// one that misses visits (latency NEVER_MS) is never on it
+std::vector<size_t> paretoFront(const std::vector<SweepResult> &results);
@@ -0,0 +1,68 @@
+#include "WorkPool.h"
+
+#include <thread>
+#include <vector>
+
+WorkPool::WorkPool(unsigned threads)
+    : threads(threads ? threads : std::thread::hardware_concurrency()) {
+  if (this->threads == 0)
+    this->threads = 1;
+  blocks.reset(new Block[this->threads]);
+}
+
+void WorkPool::run(size_t count, const std::function<void(size_t)> &job) {
+  for (unsigned t = 0; t < threads; t++) {
+    blocks[t].begin = count * t / threads;
+    blocks[t].end = count * (t + 1) / threads;
+  }
+
+  // the calling thread is worker 0
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < threads; t++)
+    workers.emplace_back([this, t, &job] { work(t, job); });
+  work(0, job);
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+void WorkPool::work(unsigned self, const std::function<void(size_t)> &job) {
+  size_t index;
+  for (;;) {
+    if (take(self, index))
+      job(index);
+    else if (!steal(self))
+      return; // nothing left anywhere, jobs never add work
+  }
+}
+
+bool WorkPool::take(unsigned self, size_t &index) {
+  Block &own = blocks[self];
+  std::lock_guard<std::mutex> guard(own.lock);
+  if (own.begin == own.end)
+    return false;
+  index = own.begin++;
+  return true;
+}
+
+bool WorkPool::steal(unsigned self) {
+  for (unsigned n = 1; n < threads; n++) {
+    Block &victim = blocks[(self + n) % threads];
+    size_t begin, end;
+    {
+      std::lock_guard<std::mutex> guard(victim.lock);
+      if (victim.begin == victim.end)
+        continue;
+      // the back half, or the last job if only one is left
+      begin = victim.begin + (victim.end - victim.begin) / 2;
+      end = victim.end;
+      victim.end = begin;
+    }
+    Block &own = blocks[self];
+    std::lock_guard<std::mutex> guard(own.lock);
+    own.begin = begin;
+    own.end = end;
+    stealCount++;
+    return true;
+  }
+  return false;
+}
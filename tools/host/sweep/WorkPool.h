@@ -0,0 +1,48 @@
+#pragma once
+/**
+ * WorkPool.h
+ *
+ * Work-stealing thread pool for tag_sweep. run() hands every thread a
+ * contiguous block of job indices. A thread works through its block from the
+ * front, and once it is empty takes the back half of another thread's block.
+ * That keeps all cores busy even when some candidates cost many more polls
+ * than others. The jobs must not share state; each one writes its own slot of
+ * a result vector, so the results don't depend on the thread count.
+ *
+ * Usage:
+ *   WorkPool pool(0); // one thread per core
+ *   pool.run(results.size(), [&](size_t i) { results[i] = simulate(i); });
+ */
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+class WorkPool {
+public:
+  explicit WorkPool(unsigned threads); // 0: std::thread::hardware_concurrency
+
+  // calls job(i) for every i in [0, count), returns when all have run
+  void run(size_t count, const std::function<void(size_t)> &job);
+
+  unsigned size() const { return threads; }
+  uint64_t steals() const { return stealCount; } // since construction
+
+private:
+  struct Block {
+    std::mutex lock;
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  void work(unsigned self, const std::function<void(size_t)> &job);
+  bool take(unsigned self, size_t &index);
+  bool steal(unsigned self);
+
+  unsigned threads;
+  std::unique_ptr<Block[]> blocks;
+  std::atomic<uint64_t> stealCount{0};
+};
@@ -0,0 +1,136 @@
+/**
+ * tag_sweep.cpp
+ *
+ * Sweeps the tag timing constants of one board over a grid and prints the
+ * Pareto front of latency against false transitions (TagSweep.h has the
+ * model). Built once per board, against that board's TerminalReader.cpp:
+ *
+ *   tag_sweep_leonardo [capture.txt...] [--visits N] [--threads N]
+ *                      [--seed S] [--all]
+ *   tag_sweep_mkrzero  ...
+ *
+ * Captures are reader bench output (ReaderBench.h, name=tag_trace lines).
+ * They are replayed as recorded, and their misses and phantom sightings set
+ * the noise of the synthetic visits (--visits per reader, default 100,
+ * 0 for recordings only). Candidates run on a work-stealing pool, one thread
+ * per core unless --threads. The output doesn't depend on the thread count.
+ *
+ *   sweep board= candidates= threads= steals= visits= traces=
+ *     mux_us= init_us= empty_us= tag_us= miss_after_seen= miss_after_miss=
+ *     phantom=
+ *   sweep board= default=1 <candidate> <result>   the firmware's values
+ *   sweep board= front=1 <candidate> <result>     the Pareto front, by latency
+ *
+ * (--all: every candidate with front=0|1), where
+ *   <candidate> = poll_ms= settle_ms= debounce_ms= absence_ms= presence_n=
+ *                 detect_fail_n= confirm_x=
+ *   <result>    = latency_ms= present_p50_ms= present_p95_ms=
+ *                 removed_p95_ms= false_per_hour= trace_false= missed=
+ *
+ * latency_ms is the worse of present_p95_ms (clamp on -> PRESENT) and
+ * removed_p95_ms (clamp off -> noticed), -1 if visits were missed.
+ * false_per_hour counts REMOVED/DIFFERENT with a clamp still on and
+ * CONFIRMED with none, per reader and hour.
+ */
+
+#include "TagSweep.h"
+#include "WorkPool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+
+namespace {
+int usage() {
+  fprintf(stderr, "usage: tag_sweep [capture.txt...] [--visits N] "
+                  "[--threads N] [--seed S] [--all]\n");
+  return 2;
+}
+
+long ms(uint32_t value) { return value == NEVER_MS ? -1 : long(value); }
+
+void printResult(const char *board, const char *kind, const Candidate &c,
+                 const SweepResult &r) {
+  printf("sweep board=%s %s poll_ms=%u settle_ms=%u debounce_ms=%lu "
+         "absence_ms=%lu presence_n=%u detect_fail_n=%u confirm_x=%u "
+         "latency_ms=%ld present_p50_ms=%ld present_p95_ms=%ld "
+         "removed_p95_ms=%ld false_per_hour=%.2f trace_false=%u missed=%u\n",
+         board, kind, c.pollIntervalMs, c.settleMs, c.timing.debounceMs,
+         c.timing.absenceTimeoutMs, c.timing.presenceThreshold,
+         c.timing.detectFailThreshold, c.timing.removalConfirmFactor,
+         ms(r.latencyMs()), ms(r.presentP50Ms), ms(r.presentP95Ms),
+         ms(r.removedP95Ms), r.falsePerHour(), r.traceFalse, r.missed);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const BoardModel &board = boardModel();
+  SweepInput input = {&board, {}, {}, {}, 100, 1};
+  unsigned threads = 0;
+  bool all = false;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--visits") && hasValue) {
+      input.visits = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--threads") && hasValue) {
+      threads = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--seed") && hasValue) {
+      input.seed = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--all")) {
+      all = true;
+    } else if (argv[i][0] == '-') {
+      return usage();
+    } else {
+      std::ifstream in(argv[i]);
+      std::string error;
+      if (!in) {
+        fprintf(stderr, "tag_sweep: can't open %s\n", argv[i]);
+        return 1;
+      }
+      if (!parseTraces(in, input.traces, error)) {
+        fprintf(stderr, "%s: %s\n", argv[i], error.c_str());
+        return 1;
+      }
+    }
+  }
+  if (input.visits == 0 && input.traces.empty())
+    return usage();
+
+  input.noise.fit(input.traces);
+  input.cost = measureProbeCost(board.i2cHz);
+
+  std::vector<Candidate> grid = candidateGrid(board);
+  std::vector<SweepResult> results(grid.size());
+  WorkPool pool(threads);
+  pool.run(grid.size(),
+           [&](size_t i) { results[i] = simulate(input, grid[i]); });
+
+  printf("sweep board=%s candidates=%zu threads=%u steals=%llu visits=%u "
+         "traces=%zu mux_us=%u init_us=%u empty_us=%u tag_us=%u "
+         "miss_after_seen=%.3f miss_after_miss=%.3f phantom=%.4f\n",
+         board.name, grid.size(), pool.size(),
+         (unsigned long long)pool.steals(), input.visits, input.traces.size(),
+         input.cost.muxWriteUs, input.cost.initUs, input.cost.emptyUs,
+         input.cost.tagUs, input.noise.missAfterSeen,
+         input.noise.missAfterMiss, input.noise.phantom);
+
+  std::vector<size_t> front = paretoFront(results);
+  for (size_t i = 0; i < grid.size(); i++) {
+    if (grid[i].isDefault(board))
+      printResult(board.name, "default=1", grid[i], results[i]);
+  }
+  if (all) {
+    std::vector<bool> onFront(grid.size());
+    for (size_t i : front)
+      onFront[i] = true;
+    for (size_t i = 0; i < grid.size(); i++)
+      printResult(board.name, onFront[i] ? "front=1" : "front=0", grid[i],
+                  results[i]);
+  } else {
+    for (size_t i : front)
+      printResult(board.name, "front=1", grid[i], results[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * LeonardoNode.cpp
+ *
+ * leonardo-tx.ino for the system simulator: the real WallBatterySystem on
+ * the Leonardo's bus (three TCA9548A, two readers each) and RS-485 line.
+ * Without the reader bench and the watchdog, which the shim doesn't have.
+ * Status packets going out are reported as they cross the line.
+ */
+
+#include "CommPacket.h"
+#include "Config.h"
+#include "Node.h"
+#include "WallBatterySystem.h"
+
+#include <MFRC522DriverI2C.h>
+#include <Wire.h>
+
+#include <memory>
+
+namespace {
+constexpr size_t AVR_WIRE_BUFFER = 32;
+
+// sits on Serial1, hands every byte on and reports whole packets
+class PacketTap : public host::SerialPeer {
+public:
+  PacketTap(host::SerialPeer &far, const Node &node, uint64_t byteUs)
+      : far(far), node(node), byteUs(byteUs) {}
+
+  void receive(uint8_t b, uint64_t atUs) override {
+    far.receive(b, atUs);
+    if (fill == 0 && b != config::PACKET_START1)
+      return;
+    if (fill == 0)
+      firstUs = atUs - byteUs;
+    bytes[fill++] = b;
+    if (fill == 2 && b != config::PACKET_START2)
+      fill = 0;
+    if (fill < sizeof(bytes))
+      return;
+    fill = 0;
+
+    WallStatusPacket packet;
+    memcpy(&packet, bytes, sizeof(packet));
+    if (!node.onMark || packet.CHK != xorChecksum(packet))
+      return;
+    bool complete = packet.POS_PRESENT && packet.NEG_PRESENT;
+    node.onMark({MARK_PACKET_SENT, packet.BAT_ID, complete, firstUs});
+    node.onMark({MARK_PACKET_ARRIVED, packet.BAT_ID, complete, atUs});
+  }
+
+private:
+  host::SerialPeer &far;
+  const Node &node;
+  uint64_t byteUs;
+  uint8_t bytes[sizeof(WallStatusPacket)];
+  size_t fill = 0;
+  uint64_t firstUs = 0;
+};
+
+class LeonardoNode : public Node {
+public:
+  void setup() override {
+    Serial.begin(9600);
+    delay(10);
+    Wire.bufferSize = AVR_WIRE_BUFFER;
+    wallSystem.initializeSystem(reader);
+    // the line runs at the baud rate initializeSystem() set
+    if (far) {
+      tap.reset(new PacketTap(*far, *this, Serial1.byteTimeUs()));
+      Serial1.connect(tap.get());
+    }
+  }
+
+  void loop() override {
+    wallSystem.updateSystem(reader);
+    wallSystem.processSystemLogic();
+    delay(5);
+  }
+
+  std::vector<ReaderSlot> readers() const override {
+    const uint8_t muxes[config::NUM_BATTERIES] = {config::TCA9548A_6V_ADDR,
+                                                  config::TCA9548A_12V_ADDR,
+                                                  config::TCA9548A_16V_ADDR};
+    std::vector<ReaderSlot> slots;
+    for (uint8_t b = 0; b < config::NUM_BATTERIES; b++) {
+      slots.push_back({b, TERMINAL_POS, muxes[b],
+                       config::POSITIVE_TERMINAL_CHANNEL,
+                       config::RFID2_WS1850S_ADDR});
+      slots.push_back({b, TERMINAL_NEG, muxes[b],
+                       config::NEGATIVE_TERMINAL_CHANNEL,
+                       config::RFID2_WS1850S_ADDR});
+    }
+    return slots;
+  }
+
+  void connectRs485(host::SerialPeer &peer) override { far = &peer; }
+
+private:
+  MFRC522DriverI2C driver{config::RFID2_WS1850S_ADDR, Wire};
+  MFRC522 reader{driver};
+  WallBatterySystem wallSystem;
+  host::SerialPeer *far = nullptr;
+  std::unique_ptr<PacketTap> tap;
+};
+} // namespace
+
+Node *makeLeonardo() { return new LeonardoNode(); }
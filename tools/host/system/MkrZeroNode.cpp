@@ -0,0 +1,80 @@
+/**
+ * MkrZeroNode.cpp
+ *
+ * mkrzero-rx.ino for the system simulator: the real ToyCarSystem with the
+ * audio backend Config.h picks, on the MKR Zero's bus (one TCA9548A, three
+ * readers, the RP2040 at LED_CONTROLLER_ADDR) and RS-485 line. Without the
+ * benches and the watchdog. Trigger pins being pulled are reported as sound
+ * triggers (trigger backend).
+ */
+
+#include "Config.h"
+#include "Node.h"
+#include "ToyCarSystem.h"
+
+#include <MFRC522DriverI2C.h>
+#include <Wire.h>
+
+namespace {
+Node *instance = nullptr; // the board's pin hook has no context pointer
+
+Outcome outcomeForTrigger(uint8_t pin) {
+  switch (pin) {
+  case config::SPUTTER_AUDIO_TRIGGER:
+    return OUTCOME_6V;
+  case config::ENGINE_START_AUDIO_TRIGGER:
+    return OUTCOME_12V;
+  case config::ZAP_AUDIO_TRIGGER:
+    return OUTCOME_16V;
+  case config::WRONG_CHOICE_AUDIO_TRIGGER:
+    return OUTCOME_WRONG;
+  }
+  return OUTCOME_NONE;
+}
+
+// the trigger inputs are active low (AudioPlayer pulses them)
+void onPinWrite(host::Board &board, uint8_t pin, uint8_t level) {
+  Outcome outcome = outcomeForTrigger(pin);
+  if (level == LOW && outcome != OUTCOME_NONE && instance->onMark)
+    instance->onMark({MARK_SOUND_TRIGGER, outcome, false, board.nowUs});
+}
+
+class MkrZeroNode : public Node {
+public:
+  MkrZeroNode() : board(host::board()) {
+    soundDelayUs = config::AUDIO_START_LATENCY_MS * 1000UL;
+  }
+
+  void setup() override {
+    instance = this;
+    board.onPinWrite = onPinWrite;
+    Serial.begin(115200);
+    delay(100);
+    Wire.begin();
+    toyCar.initialize(reader);
+  }
+
+  void loop() override { toyCar.update(reader); }
+
+  std::vector<ReaderSlot> readers() const override {
+    return {
+        {0, TERMINAL_POS, config::MUX_ADDR, config::POSITIVE_TERMINAL_CHANNEL,
+         config::RFID2_WS1850S_ADDR},
+        {0, TERMINAL_NEG, config::MUX_ADDR, config::NEGATIVE_TERMINAL_CHANNEL,
+         config::RFID2_WS1850S_ADDR},
+        {0, TERMINAL_FRAME, config::MUX_ADDR, config::GND_FRAME_CHANNEL,
+         config::RFID2_WS1850S_ADDR},
+    };
+  }
+
+  host::SerialPeer *rs485() override { return &board.serial[1]; }
+
+private:
+  host::Board &board;
+  MFRC522DriverI2C driver{config::RFID2_WS1850S_ADDR, Wire};
+  MFRC522 reader{driver};
+  ToyCarSystem toyCar{Serial1};
+};
+} // namespace
+
+Node *makeMkrZero() { return new MkrZeroNode(); }
@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * Node.h
+ *
+ * One board of the system simulator (System.h), made from that board's own
+ * sources. Every board is built into its own shared library with its
+ * symbols hidden (Makefile), so the Leonardo's and the MKR Zero's
+ * TerminalReader, BatteryState and config:: don't collide. All of them link
+ * the same shim (libhost.so), so they share the clocks, buses and serial
+ * lines. Only this interface and the shim's types cross between them.
+ *
+ * A node is made, set up and run with its board selected (host::select()),
+ * like the sketch on that board: `Wire` and `Serial1` are the current
+ * board's when the firmware objects take them.
+ *
+ * Usage:
+ *   host::select(leonardoBoard);
+ *   Node *wall = makeLeonardo();
+ *   wall->setup();
+ *   wall->loop(); // one pass, then whichever board is furthest behind
+ */
+
+#include <HostBoard.h>
+
+#include <functional>
+#include <vector>
+
+#define NODE_API __attribute__((visibility("default")))
+
+// what a connection triggers, in terms every board can map to its own
+// (audio trigger pins, animation commands)
+enum Outcome : uint8_t {
+  OUTCOME_NONE,
+  OUTCOME_6V,
+  OUTCOME_12V,
+  OUTCOME_16V,
+  OUTCOME_WRONG,
+};
+
+// where an end-to-end latency is measured to, reported as it happens
+enum MarkKind : uint8_t {
+  MARK_PACKET_SENT,    // Leonardo: first bit of a status packet on RS-485
+  MARK_PACKET_ARRIVED, // ... its last byte in the MKR Zero's UART
+  MARK_SOUND_TRIGGER,  // MKR Zero: audio trigger pulled
+  MARK_FIRST_FRAME,    // RP2040: first frame of a new animation to the strip
+};
+
+struct Mark {
+  MarkKind kind;
+  uint8_t value;  // packets: battery id, otherwise a Outcome
+  bool complete;  // packets: both terminals present
+  uint64_t atUs;  // board time, may be ahead of the reporting board's now
+};
+
+enum Terminal : uint8_t { TERMINAL_POS, TERMINAL_NEG, TERMINAL_FRAME };
+
+// one RFID reader on the board's bus, behind a mux channel
+struct ReaderSlot {
+  uint8_t battery; // Leonardo: wall battery index, MKR Zero: 0
+  Terminal terminal;
+  uint8_t muxAddr;
+  uint8_t channel;
+  uint8_t readerAddr;
+};
+
+class NODE_API Node {
+public:
+  virtual ~Node() {}
+
+  virtual void setup() = 0;
+  virtual void loop() = 0; // one pass of the sketch's loop()
+
+  // readers the firmware expects, attached by the simulator before setup()
+  virtual std::vector<ReaderSlot> readers() const { return {}; }
+  // RS-485 out, Leonardo only
+  virtual void connectRs485(host::SerialPeer &far) {}
+  // RS-485 in, MKR Zero only
+  virtual host::SerialPeer *rs485() { return nullptr; }
+
+  // the firmware's own estimate of trigger -> audible, MKR Zero only
+  uint32_t soundDelayUs = 0;
+  // board time one loop() pass takes at least. the shim runs the firmware's
+  // code in no time, so this is what an idle pass costs on the board
+  uint32_t loopUs = 50;
+
+  std::function<void(const Mark &)> onMark;
+};
+
+// one per library, each board's sources only
+NODE_API Node *makeLeonardo();
+NODE_API Node *makeMkrZero();
+NODE_API Node *makeRp2040Core0(); // I2C slave, command queue (loop())
+NODE_API Node *makeRp2040Core1(); // LEDController (loop1())
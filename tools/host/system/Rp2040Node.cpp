@@ -0,0 +1,69 @@
+/**
+ * Rp2040Node.cpp
+ *
+ * rp2040.ino itself for the system simulator, as two nodes on two boards
+ * (one per core) so each core has its own clock: core0 runs setup()/loop()
+ * (the I2C slave the MKR Zero talks to, host::WireSlave), core1 runs
+ * setup1()/loop1() (LEDController, the host WS2815Driver from sim/). The
+ * sketch's globals are shared between them like the two cores share RAM.
+ *
+ * The first frame of every new animation is reported when core1 publishes
+ * it (shownRestart), at the time that frame started going out on the strip.
+ */
+
+#include "Node.h"
+#include "StripCapture.h"
+
+#include "rp2040.ino"
+
+namespace {
+Outcome outcomeForAnimation(uint8_t cmd) {
+  switch (cmd) {
+  case config::CMD_6V_ANIMATION:
+    return OUTCOME_6V;
+  case config::CMD_12V_ANIMATION:
+    return OUTCOME_12V;
+  case config::CMD_16V_ANIMATION:
+    return OUTCOME_16V;
+  case config::CMD_WRONG_ANIMATION:
+    return OUTCOME_WRONG;
+  }
+  return OUTCOME_NONE;
+}
+
+class Core0Node : public Node {
+public:
+  void setup() override { ::setup(); }
+  void loop() override { ::loop(); }
+};
+
+class Core1Node : public Node {
+public:
+  ~Core1Node() { host::onStripShow(nullptr); }
+
+  void setup() override {
+    host::onStripShow([this](const host::StripFrame &frame) {
+      if (firstShowUs == 0)
+        firstShowUs = frame.atUs;
+    });
+    ::setup1();
+  }
+
+  void loop() override {
+    uint8_t shown = shownRestart.load();
+    firstShowUs = 0;
+    ::loop1();
+    if (shownRestart.load() == shown || !onMark)
+      return;
+    Outcome outcome = outcomeForAnimation(ledMailbox.load() & 0xFF);
+    uint64_t atUs = firstShowUs ? firstShowUs : host::nowUs();
+    onMark({MARK_FIRST_FRAME, outcome, false, atUs});
+  }
+
+private:
+  uint64_t firstShowUs = 0; // of the strip pushes in this pass
+};
+} // namespace
+
+Node *makeRp2040Core0() { return new Core0Node(); }
+Node *makeRp2040Core1() { return new Core1Node(); }
@@ -0,0 +1,173 @@
+#include "System.h"
+
+#include <HostBoard.h>
+
+#include <algorithm>
+
+namespace {
+// the RP2040 as the MKR Zero's bus sees it: every board still behind the
+// master runs up to its time first, so the transfer lands between the
+// RP2040's passes where it would on the bench instead of after a jump
+class CatchUpSlave : public host::I2CDevice {
+public:
+  CatchUpSlave(System &system, host::Board &slave)
+      : system(system), slave(slave) {}
+
+  bool write(const uint8_t *data, size_t len) override {
+    system.runUntil(host::nowUs());
+    return slave.write(data, len);
+  }
+  size_t read(uint8_t *data, size_t len) override {
+    system.runUntil(host::nowUs());
+    return slave.read(data, len);
+  }
+
+private:
+  System &system;
+  host::WireSlave slave;
+};
+
+uint32_t readerKey(Side side, uint8_t battery, Terminal terminal) {
+  return (uint32_t(side) << 16) | (uint32_t(battery) << 8) | terminal;
+}
+} // namespace
+
+// ----- ScriptedReader -----
+
+void ScriptedReader::schedule(uint64_t atUs, const Ntag203 *tag) {
+  auto at = std::upper_bound(
+      timeline.begin() + next, timeline.end(), atUs,
+      [](uint64_t us, const std::pair<uint64_t, const Ntag203 *> &entry) {
+        return us < entry.first;
+      });
+  timeline.insert(at, {atUs, tag});
+}
+
+// the polling board's now: the reader only changes while that board uses it
+void ScriptedReader::catchUp() {
+  while (next < timeline.size() && timeline[next].first <= host::nowUs())
+    chip.place(timeline[next++].second);
+}
+
+bool ScriptedReader::write(const uint8_t *data, size_t len) {
+  catchUp();
+  return chip.write(data, len);
+}
+
+size_t ScriptedReader::read(uint8_t *data, size_t len) {
+  catchUp();
+  return chip.read(data, len);
+}
+
+// ----- System -----
+
+System::System() {
+  // the RP2040 first, the MKR Zero uploads its LED programs in setup()
+  host::select(ledCore0.board);
+  ledCore0.node.reset(makeRp2040Core0());
+  host::select(ledCore1.board);
+  ledCore1.node.reset(makeRp2040Core1());
+  host::select(ledCore0.board);
+  ledCore0.node->setup();
+  uint8_t ledAddr = Wire.getSlaveAddress();
+  host::select(ledCore1.board);
+  ledCore1.node->setup();
+
+  host::select(car.board);
+  car.node.reset(makeMkrZero());
+  attachReaders(SIDE_CAR, car);
+  ledSlave.reset(new CatchUpSlave(*this, ledCore0.board));
+  Wire.attach(ledAddr, ledSlave.get());
+
+  host::select(wall.board);
+  wall.node.reset(makeLeonardo());
+  attachReaders(SIDE_WALL, wall);
+  wall.node->connectRs485(*car.node->rs485());
+
+  for (Unit *unit : units)
+    unit->node->onMark = [this](const Mark &m) { marks.push_back(m); };
+
+  host::select(wall.board);
+  wall.node->setup();
+  // its setup() talks to the RP2040, which runs up to it meanwhile
+  host::select(car.board);
+  car.running = true;
+  car.node->setup();
+  car.running = false;
+
+  // everyone starts the scene together, after the slowest boot
+  uint64_t start = 0;
+  for (Unit *unit : units)
+    start = std::max(start, unit->board.nowUs);
+  for (Unit *unit : units)
+    unit->board.nowUs = start;
+}
+
+System::~System() {
+  // the nodes' firmware objects still point into the boards and buses
+  for (Unit *unit : units) {
+    host::select(unit->board);
+    unit->node.reset();
+  }
+}
+
+void System::attachReaders(Side side, Unit &unit) {
+  std::map<uint8_t, Tca9548a *> byAddr;
+  for (const ReaderSlot &slot : unit.node->readers()) {
+    Tca9548a *&mux = byAddr[slot.muxAddr];
+    if (!mux) {
+      muxes.emplace_back(new Tca9548a());
+      mux = muxes.back().get();
+      Wire.attach(slot.muxAddr, mux);
+    }
+    std::unique_ptr<ScriptedReader> &reader =
+        readers[readerKey(side, slot.battery, slot.terminal)];
+    reader.reset(new ScriptedReader());
+    mux->attach(slot.channel, slot.readerAddr, reader.get());
+  }
+}
+
+ScriptedReader *System::reader(Side side, uint8_t battery,
+                               Terminal terminal) {
+  auto it = readers.find(readerKey(side, battery, terminal));
+  return it == readers.end() ? nullptr : it->second.get();
+}
+
+void System::schedule(Side side, uint8_t battery, Terminal terminal,
+                      uint64_t atUs, const Ntag203 *tag) {
+  ScriptedReader *r = reader(side, battery, terminal);
+  if (r)
+    r->schedule(atUs, tag);
+}
+
+uint64_t System::now() const {
+  uint64_t lowest = UINT64_MAX;
+  for (const Unit *unit : units)
+    lowest = std::min(lowest, unit->board.nowUs);
+  return lowest;
+}
+
+void System::runUntil(uint64_t us) {
+  host::Board &current = host::board();
+  for (;;) {
+    // a board in the middle of its pass (the I2C master) waits for it
+    Unit *behind = nullptr;
+    for (Unit *unit : units)
+      if (!unit->running &&
+          (!behind || unit->board.nowUs < behind->board.nowUs))
+        behind = unit;
+    if (!behind || behind->board.nowUs >= us)
+      break;
+
+    host::select(behind->board);
+    uint64_t start = host::nowUs();
+    behind->running = true;
+    behind->node->loop();
+    behind->running = false;
+    host::advanceTo(start + behind->node->loopUs);
+    // debug prints go nowhere, a long run would keep them all
+    behind->board.serial[0].output.clear();
+    passes++;
+  }
+  host::select(current);
+}
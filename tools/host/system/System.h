@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * System.h
+ *
+ * The whole exhibit on the host: the Leonardo (wall), the MKR Zero (toy car)
+ * and the RP2040 (LEDs, one board per core), each running its own firmware
+ * (Node.h) on its own clock, joined the way they are on the bench:
+ *   - Leonardo Serial1 -> MKR Zero Serial1, 9600 baud RS-485
+ *   - the RP2040 on the MKR Zero's I2C bus at LED_CONTROLLER_ADDR
+ *   - TCA9548A + WS1850S stand-ins (sim/) for every reader the firmware polls,
+ *     with clamps put on and taken off by schedule()
+ *
+ * Discrete-event loop: the board whose clock is furthest behind runs one
+ * pass of its loop() next, so no board gets more than one pass ahead of
+ * another. A pass costs what the firmware blocks for (I2C and UART wire
+ * time, delay()) and at least Node::loopUs. UART bytes carry the time they
+ * finish arriving, the boards behind an I2C master run up to its time
+ * before the slave answers, and a reader takes a scheduled clamp change
+ * once the polling board's clock reaches it.
+ *
+ * One per process: rp2040.ino's globals live in its library and aren't
+ * reset between instances.
+ *
+ * Usage:
+ *   System system;  // boards built, wired and through setup()
+ *   system.schedule(SIDE_WALL, 1, TERMINAL_POS, system.now() + 1000000, &tag);
+ *   system.runUntil(system.now() + 5000000);
+ *   for (const Mark &m : system.marks) ...
+ */
+
+#include "Node.h"
+#include "Tca9548a.h"
+#include "Ws1850s.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+enum Side : uint8_t { SIDE_WALL, SIDE_CAR };
+
+// a reader whose tag follows a timeline, each change applied when the board
+// polling it gets there
+class ScriptedReader : public host::I2CDevice {
+public:
+  bool write(const uint8_t *data, size_t len) override;
+  size_t read(uint8_t *data, size_t len) override;
+
+  void schedule(uint64_t atUs, const Ntag203 *tag);
+
+  Ws1850s chip;
+
+private:
+  void catchUp();
+
+  std::vector<std::pair<uint64_t, const Ntag203 *>> timeline; // by time
+  size_t next = 0;
+};
+
+class System {
+public:
+  System();
+  ~System();
+
+  // puts `tag` on the reader (nullptr takes it off) at `atUs`
+  void schedule(Side side, uint8_t battery, Terminal terminal, uint64_t atUs,
+                const Ntag203 *tag);
+  // runs the boards up to `us` (those in a pass of their own wait)
+  void runUntil(uint64_t us);
+
+  uint64_t now() const; // the board furthest behind
+  uint32_t soundDelayUs() const { return car.node->soundDelayUs; }
+  void setSoundDelayUs(uint32_t us) { car.node->soundDelayUs = us; }
+  ScriptedReader *reader(Side side, uint8_t battery, Terminal terminal);
+
+  std::vector<Mark> marks; // as reported, sound triggers not yet delayed
+  uint64_t passes = 0;
+
+private:
+  struct Unit {
+    explicit Unit(const char *name) : board(name) {}
+    host::Board board;
+    std::unique_ptr<Node> node;
+    bool running = false; // in a loop() pass
+  };
+
+  void attachReaders(Side side, Unit &unit);
+
+  Unit wall{"leonardo"};
+  Unit car{"mkrzero"};
+  Unit ledCore0{"rp2040"};
+  Unit ledCore1{"rp2040-core1"};
+  Unit *units[4] = {&wall, &car, &ledCore0, &ledCore1};
+
+  std::unique_ptr<host::I2CDevice> ledSlave;
+  std::vector<std::unique_ptr<Tca9548a>> muxes;
+  std::map<uint32_t, std::unique_ptr<ScriptedReader>> readers;
+};
@@ -0,0 +1,175 @@
+#include "Visitors.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace {
+// TAG_START_READ_PAGE on both boards
+constexpr uint8_t TAG_DATA_PAGE = 4;
+
+constexpr uint64_t MS = 1000;
+constexpr uint64_t CLAMP_GAP_MIN_US = 500 * MS;
+constexpr uint64_t CLAMP_GAP_MAX_US = 3000 * MS;
+constexpr uint64_t HOLD_MIN_US = 4000 * MS;
+constexpr uint64_t HOLD_MAX_US = 10000 * MS;
+constexpr uint64_t REMOVE_SPREAD_US = 500 * MS;
+constexpr uint64_t NEXT_VISIT_MIN_US = 3000 * MS;
+constexpr uint64_t NEXT_VISIT_MAX_US = 12000 * MS;
+
+// splitmix64, same as the tag sweep's
+struct Rng {
+  uint64_t state;
+  explicit Rng(uint64_t seed) : state(seed) {}
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  uint64_t between(uint64_t lo, uint64_t hi) { return lo + next() % (hi - lo); }
+};
+
+Ntag203 cableEnd(uint8_t uidLast, const char *type, uint8_t id) {
+  const uint8_t uid[Ntag203::UID_SIZE] = {0x04, 0x5A, 0x31, 0x7C,
+                                          0x12, 0x80, uidLast};
+  Ntag203 tag(uid);
+  uint8_t data[8] = {};
+  memcpy(data, type, 3);
+  data[4] = id;
+  for (uint8_t i = 0; i < 5; i++)
+    data[5] ^= data[i];
+  tag.writePage(TAG_DATA_PAGE, &data[0]);
+  tag.writePage(TAG_DATA_PAGE + 1, &data[4]);
+  return tag;
+}
+
+const Mark *firstMark(const std::vector<Mark> &marks, MarkKind kind,
+                      uint64_t fromUs, uint64_t toUs, int battery = -1) {
+  for (const Mark &m : marks) {
+    if (m.kind != kind || m.atUs < fromUs || m.atUs >= toUs)
+      continue;
+    if (battery >= 0 && (m.value != battery || !m.complete))
+      continue;
+    return &m;
+  }
+  return nullptr;
+}
+} // namespace
+
+Cables::Cables()
+    : wallPos(cableEnd(0x01, "POS", 1)), wallNeg(cableEnd(0x03, "NEG", 3)),
+      carPos(cableEnd(0x02, "POS", 2)), carNeg(cableEnd(0x04, "NEG", 4)) {}
+
+std::vector<Visit> planVisits(const VisitorConfig &config, const Cables &cables,
+                              uint64_t startUs) {
+  Rng rng(config.seed);
+  std::vector<Visit> visits;
+  uint64_t t = startUs;
+  for (uint32_t v = 0; v < config.visits; v++) {
+    Visit visit = {};
+    visit.battery = rng.between(0, 3);
+    visit.kind = rng.between(0, 100) < config.reversedPercent ? VISIT_REVERSED
+                                                              : VISIT_CORRECT;
+    visit.expected = visit.kind == VISIT_REVERSED
+                         ? OUTCOME_WRONG
+                         : Outcome(OUTCOME_6V + visit.battery);
+    bool reversed = visit.kind == VISIT_REVERSED;
+    visit.clamps = {
+        {SIDE_WALL, TERMINAL_POS, reversed ? &cables.wallNeg : &cables.wallPos,
+         0, 0},
+        {SIDE_WALL, TERMINAL_NEG, reversed ? &cables.wallPos : &cables.wallNeg,
+         0, 0},
+        {SIDE_CAR, TERMINAL_POS, &cables.carPos, 0, 0},
+        {SIDE_CAR, TERMINAL_FRAME, &cables.carNeg, 0, 0},
+    };
+    for (size_t i = visit.clamps.size() - 1; i > 0; i--)
+      std::swap(visit.clamps[i], visit.clamps[rng.between(0, i + 1)]);
+
+    for (size_t i = 0; i < visit.clamps.size(); i++) {
+      if (i > 0)
+        t += rng.between(CLAMP_GAP_MIN_US, CLAMP_GAP_MAX_US);
+      ClampStep &clamp = visit.clamps[i];
+      clamp.onUs = t;
+      uint64_t &done =
+          clamp.side == SIDE_WALL ? visit.wallDoneUs : visit.carDoneUs;
+      done = std::max(done, t);
+    }
+    visit.completeUs = t;
+
+    uint64_t leaveUs = t + rng.between(HOLD_MIN_US, HOLD_MAX_US);
+    uint64_t lastOffUs = leaveUs;
+    for (ClampStep &clamp : visit.clamps) {
+      clamp.offUs = leaveUs + rng.between(0, REMOVE_SPREAD_US);
+      lastOffUs = std::max(lastOffUs, clamp.offUs);
+    }
+    t = lastOffUs + rng.between(NEXT_VISIT_MIN_US, NEXT_VISIT_MAX_US);
+    visit.endUs = t;
+    visits.push_back(visit);
+  }
+  return visits;
+}
+
+void scheduleVisits(System &system, const std::vector<Visit> &visits) {
+  for (const Visit &visit : visits) {
+    for (const ClampStep &clamp : visit.clamps) {
+      uint8_t battery = clamp.side == SIDE_WALL ? visit.battery : 0;
+      system.schedule(clamp.side, battery, clamp.terminal, clamp.onUs,
+                      clamp.tag);
+      system.schedule(clamp.side, battery, clamp.terminal, clamp.offUs,
+                      nullptr);
+    }
+  }
+}
+
+std::vector<VisitResult> scoreVisits(const std::vector<Visit> &visits,
+                                     const std::vector<Mark> &marks,
+                                     uint32_t soundDelayUs) {
+  std::vector<Mark> byTime = marks;
+  std::stable_sort(byTime.begin(), byTime.end(),
+                   [](const Mark &a, const Mark &b) { return a.atUs < b.atUs; });
+
+  std::vector<VisitResult> results;
+  for (const Visit &visit : visits) {
+    VisitResult r = {};
+    const Mark *trigger = firstMark(byTime, MARK_SOUND_TRIGGER,
+                                    visit.completeUs, visit.endUs);
+    const Mark *frame =
+        firstMark(byTime, MARK_FIRST_FRAME, visit.completeUs, visit.endUs);
+    if (trigger) {
+      r.sound = true;
+      r.soundOutcome = Outcome(trigger->value);
+      r.soundUs = int64_t(trigger->atUs + soundDelayUs - visit.completeUs);
+    }
+    if (frame) {
+      r.frame = true;
+      r.frameOutcome = Outcome(frame->value);
+      r.frameUs = int64_t(frame->atUs - visit.completeUs);
+    }
+
+    const Mark *sent = firstMark(byTime, MARK_PACKET_SENT, visit.wallDoneUs,
+                                 visit.endUs, visit.battery);
+    const Mark *arrived =
+        sent ? firstMark(byTime, MARK_PACKET_ARRIVED, sent->atUs, visit.endUs,
+                         visit.battery)
+             : nullptr;
+    if (arrived) {
+      r.packet = true;
+      r.leonardoUs = int64_t(sent->atUs - visit.wallDoneUs);
+      r.rs485Us = int64_t(arrived->atUs - sent->atUs);
+      if (trigger)
+        r.mkrZeroUs = int64_t(trigger->atUs) -
+                      int64_t(std::max(arrived->atUs, visit.carDoneUs));
+    }
+    results.push_back(r);
+  }
+  return results;
+}
+
+int64_t percentile(std::vector<int64_t> values, double q) {
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  size_t rank = size_t(q * values.size() + 0.999999);
+  return values[rank ? rank - 1 : 0];
+}
@@ -0,0 +1,87 @@
+#pragma once
+/**
+ * Visitors.h
+ *
+ * Scripted visitors for the system simulator (System.h) and what the
+ * exhibit did for each of them. A visit picks a wall battery and puts the
+ * four cable ends on one at a time, in any order, 0.5-3s apart:
+ *   - CORRECT: wall POS on the battery's +, wall NEG on its -, car POS on
+ *     the car's +, car NEG on the frame -> that battery's reaction
+ *   - REVERSED: the two wall ends swapped -> WRONG
+ * It holds them 4-10s, takes them off within half a second and the next
+ * visitor comes 3-12s later.
+ *
+ * Scoring goes from the last clamp on ("complete") to the first sound
+ * trigger and the first animation frame after it, before the next visitor.
+ * Sound onset is the trigger plus the MKR Zero's own estimate of the module
+ * delay (AUDIO_START_LATENCY_MS). Stages, where they apply:
+ *   - leonardo: last wall clamp on -> first bit of its complete packet
+ *   - rs485:    first bit -> last byte at the MKR Zero
+ *   - mkrzero:  the later of packet arrival and last car clamp -> trigger
+ */
+
+#include "System.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+enum VisitKind : uint8_t { VISIT_CORRECT, VISIT_REVERSED };
+
+struct ClampStep {
+  Side side;
+  Terminal terminal;
+  const Ntag203 *tag;
+  uint64_t onUs;
+  uint64_t offUs;
+};
+
+struct Visit {
+  uint8_t battery;
+  VisitKind kind;
+  Outcome expected;
+  std::vector<ClampStep> clamps; // in the order they go on
+  uint64_t wallDoneUs; // both wall ends on
+  uint64_t carDoneUs;  // both car ends on
+  uint64_t completeUs; // the later of the two
+  uint64_t endUs;      // the next visitor's first clamp (or the run's end)
+
+  bool wallLast() const { return wallDoneUs > carDoneUs; }
+};
+
+// the four tagged cable ends, ids as on the exhibit (1-4)
+struct Cables {
+  Cables();
+  Ntag203 wallPos, wallNeg, carPos, carNeg;
+};
+
+struct VisitorConfig {
+  uint32_t visits;
+  uint64_t seed;
+  uint8_t reversedPercent; // share of REVERSED visits
+};
+
+// visits from startUs on, the last one ends at its endUs
+std::vector<Visit> planVisits(const VisitorConfig &config, const Cables &cables,
+                              uint64_t startUs);
+void scheduleVisits(System &system, const std::vector<Visit> &visits);
+
+struct VisitResult {
+  bool sound;         // a trigger after complete
+  bool frame;         // a first frame after complete
+  Outcome soundOutcome;
+  Outcome frameOutcome;
+  int64_t soundUs;    // complete -> sound onset
+  int64_t frameUs;    // complete -> first frame
+  bool packet;        // a complete packet for the battery
+  int64_t leonardoUs; // valid if packet
+  int64_t rs485Us;    // valid if packet
+  int64_t mkrZeroUs;  // valid if packet and sound
+};
+
+std::vector<VisitResult> scoreVisits(const std::vector<Visit> &visits,
+                                     const std::vector<Mark> &marks,
+                                     uint32_t soundDelayUs);
+
+// nearest rank, 0 for none
+int64_t percentile(std::vector<int64_t> values, double q);
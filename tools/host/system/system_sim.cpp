@@ -0,0 +1,178 @@
+/**
+ * system_sim.cpp
+ *
+ * Runs scripted visitors through the whole exhibit (System.h, Visitors.h)
+ * and prints how long it takes from the last clamp going on to the sound
+ * and the first animation frame:
+ *
+ *   system_sim [--visits N] [--seed S] [--reversed PCT] [--drop PCT]
+ *              [--sound-ms MS] [--trace]
+ *
+ * --reversed is the share of visitors who swap the wall ends (default 20),
+ * --drop loses that share of RFID frames on every reader, --sound-ms
+ * replaces the firmware's trigger -> audible estimate. The run is
+ * deterministic for a seed.
+ *
+ *   system visits= seed= reversed_pct= drop_pct= sound_ms= sim_s= passes=
+ *   system path=all|wall_last|car_last metric=sound|frame n= missed=
+ *     wrong= p50_ms= p95_ms= p99_ms= max_ms=
+ *   system stage=leonardo|rs485|mkrzero|skew n= p50_ms= p95_ms= p99_ms=
+ *     max_ms=
+ *   system visit= battery= kind= last= expected= sound= frame= sound_ms=
+ *     frame_ms=                                        (--trace, per visit)
+ *
+ * missed: no reaction before the next visitor, wrong: a reaction other than
+ * the expected one. skew is first frame - sound onset, negative if the LEDs
+ * lead.
+ */
+
+#include "System.h"
+#include "Visitors.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+int usage() {
+  fprintf(stderr, "usage: system_sim [--visits N] [--seed S] "
+                  "[--reversed PCT] [--drop PCT] [--sound-ms MS] [--trace]\n");
+  return 2;
+}
+
+const char *outcomeName(Outcome r) {
+  switch (r) {
+  case OUTCOME_6V:
+    return "6V";
+  case OUTCOME_12V:
+    return "12V";
+  case OUTCOME_16V:
+    return "16V";
+  case OUTCOME_WRONG:
+    return "WRONG";
+  default:
+    return "-";
+  }
+}
+
+double ms(int64_t us) { return us / 1000.0; }
+
+void printSpread(const char *what, const std::vector<int64_t> &us,
+                 const char *extra = "") {
+  int64_t max = us.empty() ? 0 : percentile(us, 1.0);
+  printf("system %s n=%zu%s p50_ms=%.1f p95_ms=%.1f p99_ms=%.1f "
+         "max_ms=%.1f\n",
+         what, us.size(), extra, ms(percentile(us, 0.5)),
+         ms(percentile(us, 0.95)), ms(percentile(us, 0.99)), ms(max));
+}
+
+void printPath(const char *path, const std::vector<Visit> &visits,
+               const std::vector<VisitResult> &results, int wallLast) {
+  for (int metric = 0; metric < 2; metric++) {
+    bool sound = metric == 0;
+    std::vector<int64_t> us;
+    unsigned missed = 0, wrong = 0;
+    for (size_t i = 0; i < visits.size(); i++) {
+      if (wallLast >= 0 && visits[i].wallLast() != bool(wallLast))
+        continue;
+      const VisitResult &r = results[i];
+      if (!(sound ? r.sound : r.frame)) {
+        missed++;
+        continue;
+      }
+      if ((sound ? r.soundOutcome : r.frameOutcome) != visits[i].expected)
+        wrong++;
+      us.push_back(sound ? r.soundUs : r.frameUs);
+    }
+    char what[64], extra[64];
+    snprintf(what, sizeof(what), "path=%s metric=%s", path,
+             sound ? "sound" : "frame");
+    snprintf(extra, sizeof(extra), " missed=%u wrong=%u", missed, wrong);
+    printSpread(what, us, extra);
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  VisitorConfig config = {100, 1, 20};
+  unsigned dropPercent = 0;
+  long soundMs = -1;
+  bool trace = false;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--visits") && hasValue) {
+      config.visits = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--seed") && hasValue) {
+      config.seed = strtoull(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--reversed") && hasValue) {
+      config.reversedPercent = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--drop") && hasValue) {
+      dropPercent = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--sound-ms") && hasValue) {
+      soundMs = strtol(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--trace")) {
+      trace = true;
+    } else {
+      return usage();
+    }
+  }
+  if (config.visits == 0 || config.reversedPercent > 100 || dropPercent > 100)
+    return usage();
+
+  System system;
+  if (soundMs >= 0)
+    system.setSoundDelayUs(soundMs * 1000);
+  const Side sides[] = {SIDE_WALL, SIDE_CAR};
+  const Terminal terminals[] = {TERMINAL_POS, TERMINAL_NEG, TERMINAL_FRAME};
+  for (Side side : sides)
+    for (uint8_t b = 0; b < 3; b++)
+      for (Terminal t : terminals)
+        if (ScriptedReader *reader = system.reader(side, b, t))
+          reader->chip.dropPercent = dropPercent;
+
+  Cables cables;
+  uint64_t startUs = system.now();
+  std::vector<Visit> visits = planVisits(config, cables, startUs);
+  scheduleVisits(system, visits);
+  system.runUntil(visits.back().endUs);
+  std::vector<VisitResult> results =
+      scoreVisits(visits, system.marks, system.soundDelayUs());
+
+  printf("system visits=%u seed=%llu reversed_pct=%u drop_pct=%u "
+         "sound_ms=%.1f sim_s=%.1f passes=%llu\n",
+         config.visits, (unsigned long long)config.seed,
+         config.reversedPercent, dropPercent, ms(system.soundDelayUs()),
+         (system.now() - startUs) / 1e6, (unsigned long long)system.passes);
+  printPath("all", visits, results, -1);
+  printPath("wall_last", visits, results, 1);
+  printPath("car_last", visits, results, 0);
+
+  std::vector<int64_t> leonardo, rs485, mkrZero, skew;
+  for (const VisitResult &r : results) {
+    if (r.packet) {
+      leonardo.push_back(r.leonardoUs);
+      rs485.push_back(r.rs485Us);
+    }
+    if (r.packet && r.sound)
+      mkrZero.push_back(r.mkrZeroUs);
+    if (r.sound && r.frame)
+      skew.push_back(r.frameUs - r.soundUs);
+  }
+  printSpread("stage=leonardo", leonardo);
+  printSpread("stage=rs485", rs485);
+  printSpread("stage=mkrzero", mkrZero);
+  printSpread("stage=skew", skew);
+
+  for (size_t i = 0; trace && i < visits.size(); i++) {
+    const Visit &v = visits[i];
+    const VisitResult &r = results[i];
+    printf("system visit=%zu battery=%u kind=%s last=%s expected=%s "
+           "sound=%s frame=%s sound_ms=%.1f frame_ms=%.1f\n",
+           i, v.battery, v.kind == VISIT_REVERSED ? "reversed" : "correct",
+           v.wallLast() ? "wall" : "car", outcomeName(v.expected),
+           outcomeName(r.sound ? r.soundOutcome : OUTCOME_NONE),
+           outcomeName(r.frame ? r.frameOutcome : OUTCOME_NONE),
+           r.sound ? ms(r.soundUs) : -1.0, r.frame ? ms(r.frameUs) : -1.0);
+  }
+  return 0;
+}
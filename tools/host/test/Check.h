@@ -0,0 +1,50 @@
+#pragma once
+/**
+ * Check.h
+ *
+ * Minimal assertions for the host tests: CHECK() records a failure with its
+ * line and keeps going, checkSummary() prints the result and gives main()
+ * its exit code. Each test binary is one main() that calls its test
+ * functions in order.
+ */
+
+#include <stdio.h>
+
+namespace check {
+inline int &failures() {
+  static int n = 0;
+  return n;
+}
+inline int &passes() {
+  static int n = 0;
+  return n;
+}
+} // namespace check
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (cond) {                                                                \
+      check::passes()++;                                                       \
+    } else {                                                                   \
+      check::failures()++;                                                     \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long va_ = (long long)(a), vb_ = (long long)(b);                      \
+    if (va_ == vb_) {                                                          \
+      check::passes()++;                                                       \
+    } else {                                                                   \
+      check::failures()++;                                                     \
+      fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n",        \
+              __FILE__, __LINE__, #a, #b, va_, vb_);                           \
+    }                                                                          \
+  } while (0)
+
+inline int checkSummary(const char *name) {
+  printf("%s: %d checks, %d failed\n", name,
+         check::passes() + check::failures(), check::failures());
+  return check::failures() ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * animvm_test.cpp
+ *
+ * The host assembler against the encoding documented in
+ * rp2040/AnimationVM.h, and the board's AnimationVM run against the FastLED
+ * shim: a program draws what it says, a runaway loop faults instead of
+ * hanging the frame.
+ */
+
+#include "AnimationVM.h"
+#include "Assembler.h"
+#include "Check.h"
+#include "Config.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+const char *GREEN_BAR = "        SET r0 0\n"
+                        "loop:   FADE 96\n"
+                        "        BAR r0 3 #00FF00\n"
+                        "        ADD r0 0x0080 ; half a pixel\n"
+                        "        YIELD\n"
+                        "        JLT r0 0x4600 loop\n"
+                        "        JMP 0\n";
+
+std::vector<uint8_t> assembleOk(const char *source) {
+  std::vector<uint8_t> code;
+  std::string error;
+  CHECK(assemble(source, code, error));
+  if (!error.empty())
+    fprintf(stderr, "assemble: %s\n", error.c_str());
+  return code;
+}
+
+bool assembleFails(const char *source, const char *expected) {
+  std::vector<uint8_t> code;
+  std::string error;
+  return !assemble(source, code, error) &&
+         error.find(expected) != std::string::npos;
+}
+
+void testDocExample() {
+  // bytes as listed in AnimationVM.h
+  const uint8_t expected[] = {0x08, 0x00, 0x00, 0x00, 0x07, 0x60, 0x05,
+                              0x00, 0x03, 0x00, 0xFF, 0x00, 0x09, 0x00,
+                              0x80, 0x00, 0x0E, 0x0B, 0x00, 0x00, 0x46,
+                              0x04, 0x00, 0x0A, 0x00, 0x00};
+  std::vector<uint8_t> code = assembleOk(GREEN_BAR);
+  CHECK_EQ(code.size(), sizeof(expected));
+  CHECK(code.size() == sizeof(expected) &&
+        memcmp(code.data(), expected, sizeof(expected)) == 0);
+}
+
+void testOperandForms() {
+  std::vector<uint8_t> a = assembleOk("FILL 255 128 0\nGRADIENT 0 69 1 2 3 "
+                                      "#040506\nSET r7 -1\n");
+  const uint8_t expected[] = {0x01, 0xFF, 0x80, 0x00, 0x04, 0x00, 0x45,
+                              0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08,
+                              0x07, 0xFF, 0xFF};
+  CHECK(a.size() == sizeof(expected) &&
+        memcmp(a.data(), expected, sizeof(expected)) == 0);
+
+  // the listing assembles back to the same bytes
+  std::vector<uint8_t> code = assembleOk(GREEN_BAR);
+  std::string listing = disassemble(code);
+  std::string source;
+  size_t start = 0;
+  while (start < listing.size()) {
+    size_t end = listing.find('\n', start);
+    source += listing.substr(start + 6, end - start - 6) + "\n"; // "0000: "
+    start = end + 1;
+  }
+  CHECK(assembleOk(source.c_str()) == code);
+}
+
+void testErrors() {
+  CHECK(assembleFails("FROB 1\n", "line 1: unknown instruction"));
+  CHECK(assembleFails("FILL 1 2\n", "colour"));
+  CHECK(assembleFails("FADE 256\n", "not a byte"));
+  CHECK(assembleFails("SET r8 0\n", "not r0-r7"));
+  CHECK(assembleFails("YIELD\nJMP nowhere\n", "line 2: unknown label"));
+  CHECK(assembleFails("a: YIELD\na: YIELD\n", "duplicate label"));
+  CHECK(assembleFails("YIELD 1\n", "too many operands"));
+
+  std::string big;
+  for (int i = 0; i <= config::PROGRAM_MAX_BYTES / 4; i++)
+    big += "SET r0 0\n";
+  CHECK(assembleFails(big.c_str(), "max"));
+}
+
+void testRunGreenBar() {
+  std::vector<uint8_t> code = assembleOk(GREEN_BAR);
+  static CRGB leds[config::NUM_LEDS];
+  fill_solid(leds, config::NUM_LEDS, CRGB::Black);
+
+  AnimationVM vm;
+  vm.load(code.data(), code.size());
+  vm.run(leds, config::NUM_LEDS);
+  CHECK(!vm.faulted());
+  CHECK_EQ(vm.getStats().lastOps, 5); // SET FADE BAR ADD YIELD
+  CHECK_EQ(leds[0].g, 255);
+  CHECK_EQ(leds[0].r, 0);
+  CHECK_EQ(leds[3].g, 0);
+
+  // 140 frames: bar wraps at pixel 70, every frame stays inside the budget
+  for (int f = 1; f < 141; f++)
+    vm.run(leds, config::NUM_LEDS);
+  CHECK(!vm.faulted());
+  CHECK_EQ(vm.getStats().maxOps, 7); // JLT JMP SET FADE BAR ADD YIELD
+}
+
+void testRunawayFaults() {
+  std::vector<uint8_t> code = assembleOk("spin: ADD r0 1\nJMP spin\n");
+  static CRGB leds[config::NUM_LEDS];
+  AnimationVM vm;
+  vm.load(code.data(), code.size());
+  vm.run(leds, config::NUM_LEDS);
+  CHECK(vm.faulted());
+  CHECK_EQ(vm.getStats().faults, 1);
+}
+
+void testShim() {
+  // values from FastLED 3.6 on the board
+  CHECK_EQ(scale8(255, 255), 255);
+  CHECK_EQ(scale8(128, 128), 64);
+  CHECK_EQ(scale8_video(1, 1), 1);
+  CHECK_EQ(sin8(0), 128);
+  CHECK_EQ(sin8(64), 255);
+  CRGB red = CHSV(0, 255, 255);
+  CHECK(red == CRGB(255, 0, 0));
+  CRGB green = CHSV(96, 255, 255);
+  CHECK(green == CRGB(0, 255, 0));
+}
+} // namespace
+
+int main() {
+  testDocExample();
+  testOperandForms();
+  testErrors();
+  testRunGreenBar();
+  testRunawayFaults();
+  testShim();
+  return checkSummary("animvm_test");
+}
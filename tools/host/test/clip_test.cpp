@@ -0,0 +1,116 @@
+/**
+ * clip_test.cpp
+ *
+ * clipgen against the clips the RP2040 ships: the procedural comet has to
+ * encode to ClipData.h's COMET byte for byte, and whatever ClipEncoder
+ * writes has to play back through the board's ClipPlayer unchanged.
+ */
+
+#include "Check.h"
+#include "ClipData.h"
+#include "ClipEncoder.h"
+#include "ClipPlayer.h"
+#include "Config.h"
+#include "Effects.h"
+#include "FrameImage.h"
+
+#include <string.h>
+
+#include <vector>
+
+namespace {
+std::vector<uint8_t> renderEffect(const Effect &effect,
+                                  std::vector<CRGB> &frames) {
+  CRGB leds[config::NUM_LEDS];
+  ClipEncoder clip(effect.fps, config::NUM_LEDS);
+  for (uint16_t f = 0; f < effect.frames; f++) {
+    effect.render(f, leds, config::NUM_LEDS);
+    clip.addFrame(leds);
+    frames.insert(frames.end(), leds, leds + config::NUM_LEDS);
+  }
+  return clip.bytes();
+}
+
+void testCometMatchesClipData() {
+  const Effect *comet = findEffect("comet");
+  CHECK(comet != nullptr);
+  if (!comet)
+    return;
+  std::vector<CRGB> frames;
+  std::vector<uint8_t> bytes = renderEffect(*comet, frames);
+  CHECK_EQ(bytes.size(), sizeof(clips::COMET));
+  CHECK(bytes.size() == sizeof(clips::COMET) &&
+        memcmp(bytes.data(), clips::COMET, bytes.size()) == 0);
+}
+
+// every frame, stepping the player's clock one clip frame at a time
+void testPlaysBack() {
+  const Effect *comet = findEffect("comet");
+  std::vector<CRGB> frames;
+  std::vector<uint8_t> bytes = renderEffect(*comet, frames);
+
+  ClipPlayer player;
+  CHECK(player.open(bytes.data(), config::NUM_LEDS, 0));
+  CRGB out[config::NUM_LEDS];
+  int mismatched = 0;
+  for (uint16_t f = 0; f < 2 * comet->frames; f++) {
+    unsigned long ms = (f * 1000UL + comet->fps - 1) / comet->fps;
+    player.render(out, ms);
+    const CRGB *want = &frames[(f % comet->frames) * config::NUM_LEDS];
+    for (uint16_t i = 0; i < config::NUM_LEDS; i++)
+      mismatched += !(out[i] == want[i]);
+  }
+  CHECK_EQ(mismatched, 0);
+}
+
+void testLongRuns() {
+  // 600 identical pixels: 255 + 255 + 90
+  const uint16_t wide = 600;
+  std::vector<CRGB> solid(wide, CRGB(1, 2, 3));
+  ClipEncoder clip(30, wide);
+  clip.addFrame(solid.data());
+  const std::vector<uint8_t> &bytes = clip.bytes();
+  CHECK_EQ(bytes.size(), 8u + 2 + 3 * 4);
+  CHECK_EQ(bytes[8], 12);
+  CHECK_EQ(bytes[10], 255);
+  CHECK_EQ(bytes[14], 255);
+  CHECK_EQ(bytes[18], 90);
+
+  ClipPlayer player;
+  CHECK(player.open(bytes.data(), wide, 0));
+  std::vector<CRGB> out(wide);
+  player.render(out.data(), 0);
+  CHECK(out == solid);
+  CHECK(!player.open(bytes.data(), wide - 1, 0)); // wrong strip width
+}
+
+void testPpmRoundTrip() {
+  const Effect *comet = findEffect("comet");
+  std::vector<CRGB> frames;
+  std::vector<uint8_t> bytes = renderEffect(*comet, frames);
+
+  FrameImage image(config::NUM_LEDS, 3);
+  for (uint16_t f = 0; f < comet->frames; f++)
+    image.addFrame(&frames[f * config::NUM_LEDS]);
+  const char *path = "build/clip_test.ppm";
+  CHECK(image.writePpm(path));
+
+  FrameImage back(config::NUM_LEDS, 3);
+  CHECK(back.readPpm(path));
+  CHECK_EQ(back.width(), config::NUM_LEDS);
+  CHECK_EQ(back.frames(), comet->frames);
+  ClipEncoder clip(comet->fps, back.width());
+  for (uint32_t f = 0; f < back.frames(); f++)
+    clip.addFrame(back.frame(f));
+  CHECK(clip.bytes() == bytes);
+  remove(path);
+}
+} // namespace
+
+int main() {
+  testCometMatchesClipData();
+  testPlaysBack();
+  testLongRuns();
+  testPpmRoundTrip();
+  return checkSummary("clip_test");
+}
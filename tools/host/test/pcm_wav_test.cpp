@@ -0,0 +1,276 @@
+/**
+ * pcm_wav_test.cpp
+ *
+ * PcmMixer and WavFormat (mkrzero-rx, I2S backend). Neither depends on
+ * Arduino, so they build as is. The mixer is checked against a 64-bit
+ * reference, the header parser against good, odd and corrupt files and
+ * every truncation of them (build runs this under ASan/UBSan).
+ */
+
+#include "Check.h"
+#include "PcmMixer.h"
+#include "WavFormat.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+// ========== MIXER ==========
+int16_t referenceMix(const int16_t *const *voices, const uint16_t *gains,
+                     uint8_t numVoices, uint16_t i) {
+  int64_t acc = 0;
+  for (uint8_t v = 0; v < numVoices; v++) {
+    if (voices[v])
+      acc += (int64_t(voices[v][i]) * gains[v]) >> 15; // floor, like the mixer
+  }
+  if (acc > INT16_MAX)
+    return INT16_MAX;
+  if (acc < INT16_MIN)
+    return INT16_MIN;
+  return int16_t(acc);
+}
+
+void testMixUnity() {
+  int16_t voice[4] = {0, 1234, -32768, 32767};
+  const int16_t *voices[1] = {voice};
+  uint16_t gains[1] = {PCM_GAIN_UNITY_Q15};
+  int16_t out[8];
+  mixPcmBlock(out, 4, voices, gains, 1);
+  for (int i = 0; i < 4; i++) {
+    CHECK_EQ(out[2 * i], voice[i]);
+    CHECK_EQ(out[2 * i + 1], voice[i]);
+  }
+}
+
+void testMixSilentAndSaturate() {
+  int16_t loud[2] = {30000, -30000};
+  const int16_t *voices[3] = {loud, nullptr, loud};
+  uint16_t gains[3] = {PCM_GAIN_UNITY_Q15, PCM_GAIN_UNITY_Q15,
+                       PCM_GAIN_UNITY_Q15};
+  int16_t out[4];
+  mixPcmBlock(out, 2, voices, gains, 3);
+  CHECK_EQ(out[0], INT16_MAX);
+  CHECK_EQ(out[2], INT16_MIN);
+
+  const int16_t *idle[2] = {nullptr, nullptr};
+  mixPcmBlock(out, 2, idle, gains, 2);
+  CHECK_EQ(out[0], 0);
+  CHECK_EQ(out[3], 0);
+}
+
+void testGains() {
+  CHECK_EQ(percentToGainQ15(0), 0);
+  CHECK_EQ(percentToGainQ15(50), 16384);
+  CHECK_EQ(percentToGainQ15(100), PCM_GAIN_UNITY_Q15);
+  CHECK_EQ(percentToGainQ15(200), PCM_GAIN_UNITY_Q15);
+
+  int16_t voice[2] = {1000, -3};
+  const int16_t *voices[1] = {voice};
+  uint16_t gains[1] = {percentToGainQ15(50)};
+  int16_t out[4];
+  mixPcmBlock(out, 2, voices, gains, 1);
+  CHECK_EQ(out[0], 500);
+  CHECK_EQ(out[2], -2); // arithmetic shift rounds toward -inf
+}
+
+void testMixRandom() {
+  std::mt19937 rng(26);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  std::uniform_int_distribution<int> gain(0, PCM_GAIN_UNITY_Q15);
+  const uint16_t frames = 64;
+  int mismatches = 0;
+
+  for (int round = 0; round < 2000; round++) {
+    std::vector<int16_t> a(frames), b(frames), c(frames);
+    for (uint16_t i = 0; i < frames; i++) {
+      a[i] = sample(rng);
+      b[i] = sample(rng);
+      c[i] = sample(rng);
+    }
+    const int16_t *voices[3] = {a.data(), round & 1 ? nullptr : b.data(),
+                                c.data()};
+    uint16_t gains[3] = {uint16_t(gain(rng)), uint16_t(gain(rng)),
+                         uint16_t(gain(rng))};
+    int16_t out[2 * frames];
+    mixPcmBlock(out, frames, voices, gains, 3);
+    for (uint16_t i = 0; i < frames; i++) {
+      int16_t expected = referenceMix(voices, gains, 3, i);
+      if (out[2 * i] != expected || out[2 * i + 1] != expected)
+        mismatches++;
+    }
+  }
+  CHECK_EQ(mismatches, 0);
+}
+
+// ========== WAV HEADER ==========
+class WavBuilder {
+public:
+  WavBuilder &riff() {
+    put("RIFF");
+    le32(0); // overall size, the parser does not need it
+    put("WAVE");
+    return *this;
+  }
+  WavBuilder &fmt(uint16_t format, uint16_t channels, uint32_t rate,
+                  uint16_t bits) {
+    put("fmt ");
+    le32(16);
+    le16(format);
+    le16(channels);
+    le32(rate);
+    le32(rate * channels * bits / 8);
+    le16(channels * bits / 8);
+    le16(bits);
+    return *this;
+  }
+  WavBuilder &chunk(const char *id, uint32_t size, uint32_t bodyBytes) {
+    put(id);
+    le32(size);
+    bytes.insert(bytes.end(), bodyBytes, 0x5A);
+    return *this;
+  }
+  WavBuilder &data(uint32_t size) {
+    put("data");
+    le32(size);
+    return *this;
+  }
+
+  std::vector<uint8_t> bytes;
+
+private:
+  void put(const char *s) { bytes.insert(bytes.end(), s, s + 4); }
+  void le16(uint16_t v) {
+    bytes.push_back(v & 0xFF);
+    bytes.push_back(v >> 8);
+  }
+  void le32(uint32_t v) {
+    le16(v & 0xFFFF);
+    le16(v >> 16);
+  }
+};
+
+std::vector<uint8_t> goodWav() {
+  return WavBuilder().riff().fmt(1, 1, 22050, 16).data(44100).bytes;
+}
+
+// parses from a heap copy of exactly len bytes, so ASan sees any overread
+bool parse(const std::vector<uint8_t> &file, size_t len, WavInfo &info) {
+  std::vector<uint8_t> copy(file.begin(), file.begin() + len);
+  return parseWavHeader(copy.data(), copy.size(), info);
+}
+
+void testWavGood() {
+  WavInfo info{};
+  std::vector<uint8_t> wav = goodWav();
+  CHECK(parse(wav, wav.size(), info));
+  CHECK_EQ(info.channels, 1);
+  CHECK_EQ(info.sampleRate, 22050);
+  CHECK_EQ(info.bitsPerSample, 16);
+  CHECK_EQ(info.dataOffset, 44);
+  CHECK_EQ(info.dataLength, 44100);
+
+  // Audacity puts a LIST chunk in front of data, odd sizes are padded
+  std::vector<uint8_t> list = WavBuilder()
+                                  .riff()
+                                  .fmt(1, 1, 22050, 16)
+                                  .chunk("LIST", 27, 28)
+                                  .data(100)
+                                  .bytes;
+  CHECK(parse(list, list.size(), info));
+  CHECK_EQ(info.dataOffset, 36 + 8 + 28 + 8); // fmt, LIST + pad, data
+  CHECK_EQ(info.dataLength, 100);
+}
+
+void testWavRejects() {
+  WavInfo info{};
+  std::vector<uint8_t> stereo =
+      WavBuilder().riff().fmt(1, 2, 22050, 16).data(4).bytes;
+  CHECK(!parse(stereo, stereo.size(), info));
+  std::vector<uint8_t> eightBit =
+      WavBuilder().riff().fmt(1, 1, 22050, 8).data(4).bytes;
+  CHECK(!parse(eightBit, eightBit.size(), info));
+  std::vector<uint8_t> floatPcm =
+      WavBuilder().riff().fmt(3, 1, 22050, 32).data(4).bytes;
+  CHECK(!parse(floatPcm, floatPcm.size(), info));
+  std::vector<uint8_t> noFmt = WavBuilder().riff().data(4).bytes;
+  CHECK(!parse(noFmt, noFmt.size(), info));
+
+  std::vector<uint8_t> notRiff = goodWav();
+  notRiff[0] = 'X';
+  CHECK(!parse(notRiff, notRiff.size(), info));
+}
+
+void testWavCorruptSizes() {
+  WavInfo info{};
+  // sizes that run past the buffer or wrap the position back
+  const uint32_t sizes[] = {0xFFFFFFFF, 0xFFFFFFF8, 0xFFFFFFF0, 0x80000000,
+                            1000, 29};
+  for (uint32_t size : sizes) {
+    std::vector<uint8_t> wav = WavBuilder()
+                                   .riff()
+                                   .fmt(1, 1, 22050, 16)
+                                   .chunk("LIST", size, 28)
+                                   .data(100)
+                                   .bytes;
+    CHECK(!parse(wav, wav.size(), info));
+  }
+}
+
+void testWavTruncated() {
+  std::vector<uint8_t> wav = WavBuilder()
+                                 .riff()
+                                 .fmt(1, 1, 22050, 16)
+                                 .chunk("LIST", 27, 28)
+                                 .data(100)
+                                 .bytes;
+  int accepted = 0;
+  for (size_t len = 0; len <= wav.size(); len++) {
+    WavInfo info{};
+    if (parse(wav, len, info)) {
+      accepted++;
+      CHECK(info.dataOffset <= len);
+    }
+  }
+  CHECK_EQ(accepted, 1); // only the complete header
+}
+
+void testWavMutations() {
+  std::mt19937 rng(27);
+  std::vector<uint8_t> base = WavBuilder()
+                                  .riff()
+                                  .fmt(1, 1, 22050, 16)
+                                  .chunk("LIST", 27, 28)
+                                  .data(100)
+                                  .bytes;
+  int bad = 0;
+  for (int round = 0; round < 20000; round++) {
+    std::vector<uint8_t> wav = base;
+    int flips = 1 + rng() % 4;
+    for (int i = 0; i < flips; i++)
+      wav[rng() % wav.size()] = rng() & 0xFF;
+    size_t len = rng() % (wav.size() + 1);
+    WavInfo info{};
+    if (parse(wav, len, info) && info.dataOffset > len)
+      bad++;
+  }
+  CHECK_EQ(bad, 0);
+}
+} // namespace
+
+int main() {
+  alarm(60); // a chunk size that wraps the parser back makes it spin forever
+  testMixUnity();
+  testMixSilentAndSaturate();
+  testGains();
+  testMixRandom();
+  testWavGood();
+  testWavRejects();
+  testWavCorruptSizes();
+  testWavTruncated();
+  testWavMutations();
+  return checkSummary("pcm_wav_test");
+}
@@ -0,0 +1,251 @@
+/**
+ * rfid_test.cpp
+ *
+ * The MFRC522 shim against the WS1850S and TCA9548A stand-ins, then the toy
+ * car's TerminalReader (mkrzero-rx) on top: select cascade, page reads, why
+ * the sketches PCD_Init() before every poll, and the tag states a cable
+ * clamp goes through.
+ */
+
+#include "Check.h"
+#include "HostBoard.h"
+#include "I2CBus.h"
+#include "Tca9548a.h"
+#include "TerminalReader.h"
+#include "Ws1850s.h"
+
+namespace {
+const uint8_t UID[Ntag203::UID_SIZE] = {0x04, 0xA1, 0x5C, 0x22, 0x6B, 0x41,
+                                        0x80};
+const uint8_t OTHER_UID[Ntag203::UID_SIZE] = {0x04, 0x3E, 0x91, 0x0A,
+                                              0x7C, 0x52, 0x81};
+
+// what the tag writer sketch puts on a clamp (JumperCableTagData)
+Ntag203 cableTag(const uint8_t (&uid)[Ntag203::UID_SIZE], const char *type,
+                 uint8_t id, bool goodChecksum = true) {
+  Ntag203 tag(uid);
+  uint8_t data[8] = {};
+  memcpy(data, type, 3);
+  data[4] = id;
+  for (uint8_t i = 0; i < 5; i++)
+    data[5] ^= data[i];
+  if (!goodChecksum)
+    data[5] ^= 0xFF;
+  tag.writePage(config::TAG_START_READ_PAGE, &data[0]);
+  tag.writePage(config::TAG_START_READ_PAGE + 1, &data[4]);
+  return tag;
+}
+
+struct Rig {
+  host::Board board{"mkrzero"};
+  TwoWire &wire = (host::select(board), Wire); // before anything takes Wire
+  Tca9548a mux;
+  Ws1850s readers[3]; // by channel
+  I2CBus bus{config::MUX_ADDR};
+  MFRC522DriverI2C driver{config::RFID2_WS1850S_ADDR, wire};
+  MFRC522 reader{driver};
+
+  Rig() {
+    wire.attach(config::MUX_ADDR, &mux);
+    for (uint8_t ch = 0; ch < 3; ch++)
+      mux.attach(ch, config::RFID2_WS1850S_ADDR, &readers[ch]);
+    bus.begin();
+  }
+  ~Rig() { wire.detach(config::MUX_ADDR); }
+
+  // one of ToyCarSystem::update()'s probes, then the rest of its 100ms pass
+  void poll(TerminalReader &terminal) {
+    unsigned long start = millis();
+    bus.selectReader(terminal.getChannel());
+    reader.PCD_Init();
+    terminal.update(reader);
+    bus.release();
+    host::advanceTo(uint64_t(start + 100) * 1000);
+  }
+};
+
+void testNoTag() {
+  Rig rig;
+  rig.bus.selectReader(config::POSITIVE_TERMINAL_CHANNEL);
+  uint64_t start = host::nowUs();
+  rig.reader.PCD_Init();
+  // soft reset waits 50ms
+  CHECK(host::nowUs() - start >= 50000);
+  CHECK(rig.readers[config::POSITIVE_TERMINAL_CHANNEL].fieldOn());
+  CHECK(!rig.readers[config::GND_FRAME_CHANNEL].fieldOn());
+
+  // nothing answers REQA, the 25ms timer ends the wait (plus ~4ms of
+  // register traffic at 100kHz)
+  start = host::nowUs();
+  CHECK(!rig.reader.PICC_IsNewCardPresent());
+  uint64_t waitedUs = host::nowUs() - start;
+  CHECK(waitedUs >= 25000);
+  CHECK(waitedUs < 30000);
+}
+
+void testSelectAndRead() {
+  Rig rig;
+  Ntag203 tag = cableTag(UID, "POS", 3);
+  Ws1850s &chip = rig.readers[config::POSITIVE_TERMINAL_CHANNEL];
+  chip.place(&tag);
+  rig.bus.selectReader(config::POSITIVE_TERMINAL_CHANNEL);
+  rig.reader.PCD_Init();
+
+  CHECK(rig.reader.PICC_IsNewCardPresent());
+  CHECK(rig.reader.PICC_ReadCardSerial());
+  // REQA, then anticollision + select for both cascade levels
+  CHECK_EQ(chip.frames, 5);
+  CHECK_EQ(chip.answered, 5);
+  CHECK_EQ(rig.reader.uid.size, 7);
+  CHECK(memcmp(rig.reader.uid.uidByte, UID, 7) == 0);
+  CHECK_EQ(rig.reader.uid.sak, 0x00);
+
+  byte buffer[18];
+  byte size = sizeof(buffer);
+  CHECK_EQ(rig.reader.MIFARE_Read(config::TAG_START_READ_PAGE, buffer, &size),
+           MFRC522::STATUS_OK);
+  CHECK_EQ(size, 18);
+  CHECK(memcmp(buffer, "POS", 3) == 0);
+  CHECK_EQ(buffer[4], 3);
+
+  // past the end of memory the tag NAKs and drops back to IDLE
+  size = sizeof(buffer);
+  CHECK_EQ(rig.reader.MIFARE_Read(Ntag203::NUM_PAGES, buffer, &size),
+           MFRC522::STATUS_MIFARE_NACK);
+  CHECK(rig.reader.PICC_IsNewCardPresent());
+}
+
+void testActiveTagMissesReqa() {
+  Rig rig;
+  Ntag203 tag(UID);
+  rig.readers[config::GND_FRAME_CHANNEL].place(&tag);
+  rig.bus.selectReader(config::GND_FRAME_CHANNEL);
+  rig.reader.PCD_Init();
+
+  CHECK(rig.reader.PICC_IsNewCardPresent());
+  CHECK(rig.reader.PICC_ReadCardSerial());
+  // ACTIVE: REQA is unexpected, the tag goes IDLE without answering...
+  CHECK(!rig.reader.PICC_IsNewCardPresent());
+  // ...and answers the next one
+  CHECK(rig.reader.PICC_IsNewCardPresent());
+
+  // halted, only WUPA or a power cycle (PCD_Init) bring it back
+  CHECK(rig.reader.PICC_ReadCardSerial());
+  CHECK_EQ(rig.reader.PICC_HaltA(), MFRC522::STATUS_OK);
+  CHECK(!rig.reader.PICC_IsNewCardPresent());
+  CHECK(!rig.reader.PICC_IsNewCardPresent());
+  rig.reader.PCD_Init();
+  CHECK(rig.reader.PICC_IsNewCardPresent());
+}
+
+void testTerminalStates() {
+  Rig rig;
+  Ntag203 posTag = cableTag(UID, "POS", 1);
+  Ntag203 negTag = cableTag(OTHER_UID, "NEG", 2);
+  Ws1850s &chip = rig.readers[config::POSITIVE_TERMINAL_CHANNEL];
+  TerminalReader positive(config::RFID2_WS1850S_ADDR, "Positive",
+                          config::POSITIVE_TERMINAL_CHANNEL);
+  rig.bus.selectReader(config::POSITIVE_TERMINAL_CHANNEL);
+  positive.init(rig.reader);
+  rig.bus.release();
+  CHECK(positive.getReaderStatus());
+
+  rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_ABSENT);
+
+  chip.place(&posTag);
+  rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_DETECTED);
+  // debounce is 150ms: still detecting 100ms in, confirmed at 200ms
+  rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_DETECTED);
+  rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_PRESENT);
+  CHECK(positive.polarityOK());
+  CHECK_EQ(positive.getTagData().id, 1);
+
+  // the same tag stays put: selected again, its data not re-read
+  uint32_t frames = chip.frames;
+  rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_PRESENT);
+  CHECK_EQ(chip.frames - frames, 5);
+
+  // swapped for the other clamp: a different UID starts over
+  chip.place(&negTag);
+  for (int i = 0; i < 5; i++)
+    rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_PRESENT);
+  CHECK_EQ(positive.getTagData().id, 2);
+  CHECK(!positive.polarityOK());
+
+  // gone: REMOVED after three missed polls, ABSENT after 2 x 450ms unseen
+  chip.place(nullptr);
+  for (int i = 0; i < 3; i++)
+    rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_REMOVED);
+  for (int i = 0; i < 7; i++)
+    rig.poll(positive);
+  CHECK_EQ(positive.getTagState(), TAG_ABSENT);
+}
+
+void testChecksumError() {
+  Rig rig;
+  Ntag203 tag = cableTag(UID, "POS", 4, false);
+  rig.readers[config::NEGATIVE_TERMINAL_CHANNEL].place(&tag);
+  TerminalReader negative(config::RFID2_WS1850S_ADDR, "Negative",
+                          config::NEGATIVE_TERMINAL_CHANNEL);
+  rig.bus.selectReader(config::NEGATIVE_TERMINAL_CHANNEL);
+  negative.init(rig.reader);
+  for (int i = 0; i < 5; i++)
+    rig.poll(negative);
+  // present, but the data is thrown away
+  CHECK_EQ(negative.getTagState(), TAG_PRESENT);
+  CHECK_EQ(negative.getTagData().id, 0);
+  CHECK(!negative.polarityOK());
+}
+
+void testMissingReader() {
+  Rig rig;
+  TerminalReader frame(config::RFID2_WS1850S_ADDR, "Frame", 5);
+  rig.bus.selectReader(5); // nothing on that channel
+  frame.init(rig.reader);
+  CHECK(!frame.getReaderStatus());
+
+  // the mux itself gone
+  rig.wire.detach(config::MUX_ADDR);
+  CHECK(!rig.bus.begin());
+}
+
+void testWeakCoupling() {
+  Rig rig;
+  Ntag203 tag(UID);
+  Ws1850s &chip = rig.readers[config::GND_FRAME_CHANNEL];
+  chip.place(&tag);
+  chip.dropPercent = 100;
+  rig.bus.selectReader(config::GND_FRAME_CHANNEL);
+  rig.reader.PCD_Init();
+  CHECK(!rig.reader.PICC_IsNewCardPresent());
+
+  // half the frames lost: some polls see it, some don't
+  chip.dropPercent = 50;
+  int seen = 0;
+  for (int i = 0; i < 40; i++) {
+    rig.reader.PCD_Init();
+    seen += rig.reader.PICC_IsNewCardPresent() &&
+            rig.reader.PICC_ReadCardSerial();
+  }
+  CHECK(seen > 0);
+  CHECK(seen < 40);
+}
+} // namespace
+
+int main() {
+  testNoTag();
+  testSelectAndRead();
+  testActiveTagMissesReqa();
+  testTerminalStates();
+  testChecksumError();
+  testMissingReader();
+  testWeakCoupling();
+  return checkSummary("rfid_test");
+}
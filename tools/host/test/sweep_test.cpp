@@ -0,0 +1,281 @@
+/**
+ * sweep_test.cpp
+ *
+ * tag_sweep's pieces (sweep/): the toy car's reader bench (mkrzero-rx) run on
+ * the reader and mux stand-ins, its tag_trace dump read back by
+ * parseTraces(), UID identity through TagReplay, the noise fit, the
+ * work-stealing pool, simulate() and the Pareto front.
+ */
+
+#include "Check.h"
+#include "HostBoard.h"
+#include "ReaderBench.h"
+#include "Tca9548a.h"
+#include "TagSweep.h"
+#include "WorkPool.h"
+#include "Ws1850s.h"
+
+#include <atomic>
+#include <sstream>
+
+namespace {
+const uint8_t UID[Ntag203::UID_SIZE] = {0x04, 0xA1, 0x5C, 0x22, 0x6B, 0x41,
+                                        0x80};
+
+Sighting seen(const char *uid) { return {true, uid}; }
+Sighting miss() { return {false, std::string()}; }
+
+void testBenchTrace() {
+  host::Board board("mkrzero");
+  host::select(board);
+  Tca9548a mux;
+  Ws1850s chips[3]; // by channel
+  Ntag203 pos(UID), frame(UID);
+  Wire.attach(config::MUX_ADDR, &mux);
+  for (uint8_t ch = 0; ch < 3; ch++)
+    mux.attach(ch, config::RFID2_WS1850S_ADDR, &chips[ch]);
+  chips[config::POSITIVE_TERMINAL_CHANNEL].place(&pos);
+  chips[config::GND_FRAME_CHANNEL].place(&frame);
+  chips[config::GND_FRAME_CHANNEL].dropPercent = 10;
+
+  runReaderBench();
+  Wire.detach(config::MUX_ADDR);
+
+  std::string out(Serial.output.begin(), Serial.output.end());
+  CHECK(out.find("bench board=mkrzero end") != std::string::npos);
+  std::istringstream in(out);
+  std::vector<ReaderTrace> traces;
+  std::string error;
+  CHECK(parseTraces(in, traces, error));
+  CHECK_EQ(traces.size(), 3);
+  if (traces.size() != 3)
+    return;
+
+  CHECK(traces[0].reader == "pos");
+  CHECK(traces[1].reader == "neg");
+  CHECK(traces[2].reader == "frame");
+  for (const ReaderTrace &t : traces)
+    CHECK_EQ(t.polls.size(), config::TAG_TRACE_POLLS);
+
+  // every probe resets the chip, so a clamp in range answers every time
+  CHECK(traces[0].tagOn());
+  size_t posSeen = 0;
+  for (const Sighting &s : traces[0].polls)
+    posSeen += s.seen && s.uid == "04A15C226B4180";
+  CHECK_EQ(posSeen, config::TAG_TRACE_POLLS);
+  CHECK(!traces[1].tagOn());
+  for (const Sighting &s : traces[1].polls)
+    CHECK(!s.seen && s.uid.empty());
+
+  // a lost frame anywhere in REQA + select is a miss
+  size_t frameSeen = 0;
+  for (const Sighting &s : traces[2].polls)
+    frameSeen += s.seen;
+  CHECK(frameSeen > 0 && frameSeen < config::TAG_TRACE_POLLS);
+}
+
+void testParse() {
+  std::vector<ReaderTrace> traces;
+  std::string error;
+  std::istringstream two(
+      "bench board=leonardo begin cpu_hz=16000000\r\n"
+      "bench board=leonardo name=tag_trace reader=6V_pos poll=0 t_ms=0 "
+      "seen=1 uid=04A1\r\n"
+      "bench board=leonardo name=tag_trace reader=6V_pos poll=1 t_ms=700 "
+      "seen=0 uid=-\r\n"
+      "bench board=leonardo name=tag_trace reader=6V_pos poll=0 t_ms=0 "
+      "seen=0 uid=-\r\n");
+  CHECK(parseTraces(two, traces, error));
+  CHECK_EQ(traces.size(), 2); // poll=0 starts another recording
+  CHECK_EQ(traces[0].polls.size(), 2);
+  CHECK(traces[0].polls[0].uid == "04A1");
+  CHECK(traces[0].polls[1].uid.empty());
+
+  std::istringstream gap("x name=tag_trace reader=a poll=0 seen=1 uid=01\n"
+                         "x name=tag_trace reader=a poll=2 seen=1 uid=01\n");
+  traces.clear();
+  CHECK(!parseTraces(gap, traces, error));
+  CHECK(error.find("line 2") == 0);
+
+  std::istringstream bad("x name=tag_trace reader=a poll=0 seen=yes uid=-\n");
+  CHECK(!parseTraces(bad, traces, error));
+}
+
+void testSwapNeedsUid() {
+  // clamp A, then B put on without a poll in between (debounce 150 ms)
+  std::vector<Sighting> polls;
+  for (int i = 0; i < 5; i++)
+    polls.push_back(seen("0A"));
+  for (int i = 0; i < 5; i++)
+    polls.push_back(seen("0B"));
+
+  TagReplay replay(defaultTagTiming());
+  std::vector<TagEvent> events;
+  for (size_t i = 0; i < polls.size(); i++) {
+    TagEvent e = replay.step(polls[i], i * 100);
+    if (e != TAG_EVENT_NONE)
+      events.push_back(e);
+  }
+  CHECK_EQ(events.size(), 4);
+  if (events.size() == 4) {
+    CHECK_EQ(events[0], TAG_EVENT_NEW);
+    CHECK_EQ(events[1], TAG_EVENT_CONFIRMED);
+    CHECK_EQ(events[2], TAG_EVENT_DIFFERENT);
+    CHECK_EQ(events[3], TAG_EVENT_CONFIRMED);
+  }
+  CHECK_EQ(replay.getState(), TAG_PRESENT);
+
+  // without the UID every sighting looks like the same clamp, B is never read
+  TagStateMachine blind(defaultTagTiming());
+  int blindEvents = 0;
+  for (size_t i = 0; i < polls.size(); i++)
+    blindEvents += blind.step(true, true, i * 100) != TAG_EVENT_NONE;
+  CHECK_EQ(blindEvents, 2);
+
+  // a clamp that was taken off counts as new when it comes back
+  TagReplay again(defaultTagTiming());
+  unsigned long t = 0;
+  for (int i = 0; i < 3; i++, t += 100)
+    again.step(seen("0A"), t);
+  CHECK_EQ(again.getState(), TAG_PRESENT);
+  TagEvent e = TAG_EVENT_NONE;
+  while (e != TAG_EVENT_REMOVED) {
+    e = again.step(miss(), t);
+    t += 100;
+  }
+  CHECK_EQ(again.step(seen("0A"), t), TAG_EVENT_RETURNED);
+}
+void testNoiseFit() {
+  ReaderTrace on = {"pos", {}}, off = {"neg", {}};
+  // seen, seen, miss, miss, seen, seen, seen, miss, seen, seen
+  const char *pattern = "ssmmsssmss";
+  for (const char *p = pattern; *p; p++)
+    on.polls.push_back(*p == 's' ? seen("0A") : miss());
+  for (int i = 0; i < 10; i++)
+    off.polls.push_back(i == 4 ? seen("0C") : miss());
+
+  NoiseModel noise;
+  noise.fit({on, off});
+  CHECK(noise.missAfterSeen > 0.33 && noise.missAfterSeen < 0.34); // 2 of 6
+  CHECK(noise.missAfterMiss > 0.33 && noise.missAfterMiss < 0.34); // 1 of 3
+  CHECK(noise.phantom > 0.09 && noise.phantom < 0.11);             // 1 of 10
+
+  NoiseModel untouched;
+  untouched.fit({});
+  CHECK(untouched.missAfterSeen == NoiseModel().missAfterSeen);
+  CHECK(untouched.phantom == 0);
+}
+
+void testWorkPool() {
+  const size_t count = 5000;
+  std::vector<std::atomic<int>> runs(count);
+  for (std::atomic<int> &r : runs)
+    r = 0;
+  WorkPool pool(4);
+  CHECK_EQ(pool.size(), 4);
+  // the first block costs far more, so the others run out and steal from it
+  pool.run(count, [&](size_t i) {
+    volatile uint32_t spin = 0;
+    for (uint32_t n = i < count / 4 ? 20000 : 10; n; n--)
+      spin += n;
+    runs[i]++;
+  });
+  size_t once = 0;
+  for (std::atomic<int> &r : runs)
+    once += r == 1;
+  CHECK_EQ(once, count);
+
+  pool.run(0, [&](size_t) { CHECK(false); });
+}
+
+void testSimulate() {
+  const BoardModel &board = boardModel();
+  SweepInput input = {&board, measureProbeCost(board.i2cHz), {}, {}, 20, 3};
+  CHECK(input.cost.initUs > input.cost.tagUs);
+  CHECK(input.cost.tagUs > input.cost.emptyUs);
+
+  // a clean reader: every visit noticed both ways, nothing false
+  input.noise.missAfterSeen = 0;
+  input.noise.missAfterMiss = 0;
+  input.noise.edgeMs = 0;
+  Candidate firmware = {board.pollIntervalMs, board.settleMs,
+                        defaultTagTiming()};
+  CHECK(firmware.isDefault(board));
+  SweepResult clean = simulate(input, firmware);
+  CHECK_EQ(clean.visits, 20 * board.readers);
+  CHECK_EQ(clean.missed, 0);
+  CHECK_EQ(clean.falseTransitions, 0);
+  CHECK(clean.presentP50Ms > firmware.timing.debounceMs);
+  CHECK(clean.presentP95Ms < 2000);
+  CHECK(clean.removedP95Ms >= firmware.timing.absenceTimeoutMs / 2);
+
+  // the same numbers on one thread or several
+  input.noise = NoiseModel();
+  std::vector<Candidate> grid = candidateGrid(board);
+  grid.resize(60);
+  std::vector<SweepResult> one(grid.size()), four(grid.size());
+  WorkPool serial(1), parallel(4);
+  serial.run(grid.size(), [&](size_t i) { one[i] = simulate(input, grid[i]); });
+  parallel.run(grid.size(),
+               [&](size_t i) { four[i] = simulate(input, grid[i]); });
+  size_t same = 0;
+  for (size_t i = 0; i < grid.size(); i++)
+    same += one[i].latencyMs() == four[i].latencyMs() &&
+            one[i].presentP50Ms == four[i].presentP50Ms &&
+            one[i].falseTransitions == four[i].falseTransitions &&
+            one[i].missed == four[i].missed;
+  CHECK_EQ(same, grid.size());
+
+  // a trace of a clamp left on: anything but PRESENT all along is false
+  ReaderTrace on = {"pos", {}};
+  for (int i = 0; i < 100; i++)
+    on.polls.push_back(i % 10 == 9 ? miss() : seen("0A"));
+  input.visits = 0;
+  input.traces = {on};
+  SweepResult steady = simulate(input, firmware);
+  CHECK_EQ(steady.traceFalse, 0);
+  firmware.timing.presenceThreshold = 1;
+  firmware.timing.absenceTimeoutMs = 50;
+  SweepResult jumpy = simulate(input, firmware);
+  CHECK(jumpy.traceFalse > 0);
+  CHECK_EQ(jumpy.traceFalse, jumpy.falseTransitions);
+}
+
+void testParetoFront() {
+  auto result = [](uint32_t latency, uint32_t falses) {
+    SweepResult r = {};
+    r.presentP95Ms = latency;
+    r.falseTransitions = falses;
+    r.readerHours = 1;
+    return r;
+  };
+  std::vector<SweepResult> results = {
+      result(500, 4),      // 0: front
+      result(300, 9),      // 1: front, fastest
+      result(500, 4),      // 2: same as 0
+      result(600, 4),      // 3: beaten by 0
+      result(800, 0),      // 4: front
+      result(NEVER_MS, 0), // 5: misses visits
+      result(400, 9),      // 6: beaten by 1
+  };
+  std::vector<size_t> front = paretoFront(results);
+  CHECK_EQ(front.size(), 3);
+  if (front.size() == 3) {
+    CHECK_EQ(front[0], 1);
+    CHECK_EQ(front[1], 0);
+    CHECK_EQ(front[2], 4);
+  }
+  CHECK(paretoFront({}).empty());
+}
+} // namespace
+
+int main() {
+  testBenchTrace();
+  testParse();
+  testSwapNeedsUid();
+  testNoiseFit();
+  testWorkPool();
+  testSimulate();
+  testParetoFront();
+  return checkSummary("sweep_test");
+}
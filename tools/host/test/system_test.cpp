@@ -0,0 +1,105 @@
+/**
+ * system_test.cpp
+ *
+ * The system simulator (system/): all three boards' firmware wired together,
+ * a handful of scripted visitors through it. Every visitor gets the reaction
+ * for what they did, sound and LEDs within the bounds the firmware's cadence
+ * allows, the first frame lands with the sound, and each status packet
+ * spends exactly its 8 bytes on the line.
+ * One System per process (System.h), so one run covers everything.
+ */
+
+#include "Check.h"
+#include "System.h"
+#include "Visitors.h"
+
+namespace {
+// 10 bits per byte at 9600 baud, as the UART shim times them
+constexpr int64_t PACKET_LINE_US = 8 * (10000000 / 9600);
+constexpr int64_t FRAME_US = 1000000 / 60; // the RP2040's FPS
+
+void testScript() {
+  Cables cables;
+  VisitorConfig config = {20, 7, 30};
+  std::vector<Visit> visits = planVisits(config, cables, 1000);
+  CHECK_EQ(visits.size(), 20);
+  size_t reversed = 0;
+  for (size_t i = 0; i < visits.size(); i++) {
+    const Visit &v = visits[i];
+    CHECK(v.battery < 3);
+    CHECK_EQ(v.clamps.size(), 4);
+    CHECK_EQ(v.completeUs, std::max(v.wallDoneUs, v.carDoneUs));
+    CHECK_EQ(v.completeUs, v.clamps.back().onUs);
+    for (const ClampStep &c : v.clamps)
+      CHECK(c.onUs <= v.completeUs && c.offUs > v.completeUs &&
+            c.offUs < v.endUs);
+    if (i > 0)
+      CHECK_EQ(v.clamps.front().onUs, visits[i - 1].endUs);
+    reversed += v.kind == VISIT_REVERSED;
+    CHECK_EQ(v.expected, v.kind == VISIT_REVERSED ? OUTCOME_WRONG
+                                                  : OUTCOME_6V + v.battery);
+  }
+  CHECK(reversed > 0 && reversed < visits.size());
+
+  // the same seed, the same visitors
+  std::vector<Visit> again = planVisits(config, cables, 1000);
+  CHECK_EQ(again.back().endUs, visits.back().endUs);
+
+  CHECK_EQ(percentile({}, 0.5), 0);
+  CHECK_EQ(percentile({5, 1, 4, 2, 3}, 0.5), 3);
+  CHECK_EQ(percentile({5, 1, 4, 2, 3}, 0.99), 5);
+}
+
+void testEndToEnd() {
+  System system;
+  CHECK_EQ(system.soundDelayUs(), 20000);
+  CHECK(system.reader(SIDE_WALL, 2, TERMINAL_NEG) != nullptr);
+  CHECK(system.reader(SIDE_CAR, 0, TERMINAL_FRAME) != nullptr);
+  CHECK(system.reader(SIDE_WALL, 0, TERMINAL_FRAME) == nullptr);
+
+  Cables cables;
+  VisitorConfig config = {6, 3, 34};
+  std::vector<Visit> visits = planVisits(config, cables, system.now());
+  scheduleVisits(system, visits);
+  system.runUntil(visits.back().endUs);
+  std::vector<VisitResult> results =
+      scoreVisits(visits, system.marks, system.soundDelayUs());
+  CHECK_EQ(results.size(), visits.size());
+
+  size_t reversed = 0, wallLast = 0;
+  for (size_t i = 0; i < visits.size(); i++) {
+    const Visit &v = visits[i];
+    const VisitResult &r = results[i];
+    reversed += v.kind == VISIT_REVERSED;
+    wallLast += v.wallLast();
+    CHECK(r.sound);
+    CHECK(r.frame);
+    CHECK_EQ(r.soundOutcome, v.expected);
+    CHECK_EQ(r.frameOutcome, v.expected);
+    CHECK(r.packet);
+    CHECK_EQ(r.rs485Us, PACKET_LINE_US);
+
+    // nothing happens before the firmware can know, and a visitor is never
+    // kept waiting for seconds: each board notices within a few of its own
+    // polls, then the reaction goes out on the next pass
+    CHECK(r.soundUs >= int64_t(system.soundDelayUs()));
+    CHECK(r.soundUs < 3000000);
+    CHECK(r.frameUs > 0 && r.frameUs < 3000000);
+    // ReactionTimeline: the first frame is due at sound onset
+    int64_t skewUs = r.frameUs - r.soundUs;
+    CHECK(skewUs > -FRAME_US && skewUs < FRAME_US);
+    if (v.wallLast())
+      CHECK(r.leonardoUs > 0 && r.soundUs > r.leonardoUs + r.rs485Us);
+    CHECK(r.mkrZeroUs >= 0);
+  }
+  CHECK(reversed > 0 && reversed < visits.size());
+  CHECK(wallLast > 0 && wallLast < visits.size());
+  CHECK(system.passes > 0);
+}
+} // namespace
+
+int main() {
+  testScript();
+  testEndToEnd();
+  return checkSummary("system_test");
+}
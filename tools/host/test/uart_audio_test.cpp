@@ -0,0 +1,169 @@
+/**
+ * uart_audio_test.cpp
+ *
+ * UartAudioPlayer (mkrzero-rx) against the DY-HL30T stand-in: frame format,
+ * priority preemption, the STOPPED reply and both fallbacks for a module
+ * that never sends one.
+ */
+
+#include "Check.h"
+#include "DyHl30t.h"
+#include "HostBoard.h"
+#include "UartAudioPlayer.h"
+
+namespace {
+// what loop() does on the toy car, one pass per millisecond
+void runFor(UartAudioPlayer &audio, unsigned long ms) {
+  unsigned long end = millis() + ms;
+  while (millis() < end) {
+    audio.update();
+    delay(1);
+  }
+}
+
+struct Rig {
+  host::Board board{"mkrzero"};
+  HardwareSerial port;
+  DyHl30t module{port};
+  UartAudioPlayer audio{port};
+
+  Rig() {
+    host::select(board);
+    audio.begin();
+    runFor(audio, 50); // volume + stop frames go out
+  }
+};
+
+void testFrames() {
+  Rig rig;
+  CHECK_EQ(rig.module.badFrames, 0);
+  CHECK_EQ(rig.module.volume, config::AUDIO_VOLUME_PERCENT *
+                                  config::AUDIO_MAX_VOLUME / 100);
+  CHECK_EQ(rig.module.stops, 1);
+
+  CHECK(rig.audio.playTrack(3, config::AUDIO_PRIORITY_SUCCESS));
+  runFor(rig.audio, 20);
+  CHECK_EQ(rig.module.onsets.size(), 1);
+  CHECK_EQ(rig.module.onsets[0].track, 3);
+  CHECK(rig.audio.playing());
+  CHECK_EQ(rig.audio.getStats().commandsSent, 1);
+
+  // legacy trigger cues map onto their tracks
+  rig.audio.play(config::ZAP_AUDIO_TRIGGER);
+  runFor(rig.audio, 20);
+  CHECK_EQ(rig.module.onsets.back().track, config::ZAP_AUDIO_TRACK);
+  CHECK_EQ(rig.module.badFrames, 0);
+}
+
+void testPreemptPlaying() {
+  Rig rig;
+  const AudioLatencyStats &stats = rig.audio.getStats();
+
+  rig.audio.playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+                      config::AUDIO_PRIORITY_WRONG_CHOICE);
+  runFor(rig.audio, 20);
+  CHECK(rig.audio.playing());
+
+  // higher priority interrupts the clip on the module
+  CHECK(rig.audio.playTrack(config::ZAP_AUDIO_TRACK,
+                            config::AUDIO_PRIORITY_SUCCESS));
+  CHECK_EQ(stats.preempted, 1);
+  runFor(rig.audio, 20);
+  CHECK_EQ(rig.module.onsets.back().track, config::ZAP_AUDIO_TRACK);
+
+  // lower priority is refused while it plays
+  CHECK(!rig.audio.playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+                             config::AUDIO_PRIORITY_WRONG_CHOICE));
+  CHECK_EQ(stats.dropped, 1);
+
+  // equal priority replaces it, but is not a preemption
+  CHECK(rig.audio.playTrack(config::ENGINE_START_AUDIO_TRACK,
+                            config::AUDIO_PRIORITY_SUCCESS));
+  CHECK_EQ(stats.preempted, 1);
+  runFor(rig.audio, 20);
+  CHECK_EQ(rig.module.onsets.back().track, config::ENGINE_START_AUDIO_TRACK);
+}
+
+void testPreemptQueued() {
+  host::Board board("mkrzero");
+  host::select(board);
+  HardwareSerial port;
+  DyHl30t module(port);
+  UartAudioPlayer audio(port);
+  audio.begin(); // volume + stop still queued, so the plays below wait
+
+  audio.playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+                  config::AUDIO_PRIORITY_WRONG_CHOICE);
+  audio.playTrack(config::SPUTTER_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+  CHECK_EQ(audio.getStats().preempted, 1);
+  audio.playTrack(config::ZAP_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+  CHECK_EQ(audio.getStats().preempted, 1);
+
+  runFor(audio, 100);
+  CHECK_EQ(module.onsets.size(), 1);
+  CHECK_EQ(module.onsets[0].track, config::ZAP_AUDIO_TRACK);
+  CHECK_EQ(audio.getStats().commandsSent, 1);
+  // queued behind volume + stop, one command gap each
+  CHECK(audio.getStats().maxLatencyUs >= 2 * config::AUDIO_UART_CMD_GAP_MS *
+                                             1000 - 1000);
+}
+
+void testStoppedReply() {
+  Rig rig;
+  rig.module.trackMs[config::ZAP_AUDIO_TRACK] = 500;
+
+  rig.audio.playTrack(config::ZAP_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+  runFor(rig.audio, 300);
+  CHECK(rig.audio.playing());
+  CHECK(rig.module.queries >= 1);
+
+  // the next status poll after the clip ends sees STOPPED
+  runFor(rig.audio, 500);
+  CHECK(!rig.audio.playing());
+  CHECK(rig.audio.playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+                            config::AUDIO_PRIORITY_WRONG_CHOICE));
+  CHECK_EQ(rig.audio.getStats().dropped, 0);
+}
+
+void testNoReply(bool unwired) {
+  Rig rig;
+  rig.module.replies = !unwired;
+  rig.module.corruptReplies = !unwired;
+
+  rig.audio.playTrack(config::ZAP_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+  runFor(rig.audio, 900);
+  CHECK(rig.audio.playing());
+
+  // AUDIO_UART_MAX_UNANSWERED_POLLS polls without a good reply
+  runFor(rig.audio, config::AUDIO_UART_MAX_UNANSWERED_POLLS *
+                            config::AUDIO_UART_STATUS_POLL_MS -
+                        900 + 50);
+  CHECK(!rig.audio.playing());
+  CHECK(rig.audio.playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+                            config::AUDIO_PRIORITY_WRONG_CHOICE));
+}
+
+void testTrackTimeout() {
+  Rig rig;
+  rig.module.defaultTrackMs = 60000; // answers PLAYING for a minute
+
+  rig.audio.playTrack(config::ZAP_AUDIO_TRACK, config::AUDIO_PRIORITY_SUCCESS);
+  runFor(rig.audio, config::AUDIO_UART_MAX_TRACK_MS - 100);
+  CHECK(rig.audio.playing());
+  runFor(rig.audio, 200);
+  CHECK(!rig.audio.playing());
+  CHECK(rig.audio.playTrack(config::WRONG_CHOICE_AUDIO_TRACK,
+                            config::AUDIO_PRIORITY_WRONG_CHOICE));
+}
+} // namespace
+
+int main() {
+  testFrames();
+  testPreemptPlaying();
+  testPreemptQueued();
+  testStoppedReply();
+  testNoReply(true);
+  testNoReply(false);
+  testTrackTimeout();
+  return checkSummary("uart_audio_test");
+}
@@ -0,0 +1,383 @@
+#!/usr/bin/env python3
+"""
+marker_latency.py
+
+Per-stage latency breakdown from a logic analyzer capture of the latency
+markers (see "Latency Markers" in the README). Reads sigrok/PulseView VCD or
+CSV exports, finds the marker edges and chains them reaction by reaction:
+
+  probe    Leonardo MARKER_PROBE_PIN, high during a reader probe
+  tx       Leonardo MARKER_PACKET_TX_PIN, high while a packet goes out
+  rx       MKR Zero MARKER_PACKET_RX_PIN, pulse per good packet
+  audio    MKR Zero MARKER_AUDIO_PIN, pulse before play()
+  ledcmd   MKR Zero MARKER_LED_CMD_PIN, high during the LED command write
+  frame    RP2040 MARKER_FIRST_FRAME_PIN, pulse after a new animation's
+           first frame
+
+Every packet (tx) starts a chain. Each later marker is matched to the first
+edge after the previous stage and before the next packet, so a packet that
+changed nothing (no audio, no LED command) just has shorter chains. Stages:
+
+  probe_to_tx     end of the last probe before the packet -> tx start
+  tx_wire         tx start -> tx end (the RS-485 write)
+  tx_to_rx        tx end -> rx pulse
+  rx_to_audio     rx -> audio pulse
+  rx_to_ledcmd    rx -> LED command write start
+  ledcmd_to_frame LED command write end -> first frame
+  probe_to_audio  end to end, sound side (trigger, not audible onset)
+  probe_to_frame  end to end, LED side
+
+Protocol decodes (RS-485 UART, I2C) in the export are ignored, the markers
+already bracket those transfers.
+
+Usage:
+  marker_latency.py capture.vcd
+  marker_latency.py capture.csv --samplerate 1000000 --map probe=D0 tx=D1 ...
+  marker_latency.py capture.vcd --hist 1
+  marker_latency.py --synthetic out.vcd [--reactions 200] [--seed 1]
+  marker_latency.py --selftest
+
+Channels are matched by name (probe, tx, rx, audio, ledcmd, frame, case
+insensitive) unless --map says otherwise. --synthetic writes a capture with
+known latencies, --selftest builds one in memory and checks that every stage
+comes back exactly as generated. Standard library only.
+"""
+
+import argparse
+import bisect
+import csv
+import random
+import sys
+
+MARKERS = ["probe", "tx", "rx", "audio", "ledcmd", "frame"]
+STAGES = [
+    "probe_to_tx",
+    "tx_wire",
+    "tx_to_rx",
+    "rx_to_audio",
+    "rx_to_ledcmd",
+    "ledcmd_to_frame",
+    "probe_to_audio",
+    "probe_to_frame",
+]
+TIMESCALE_S = {"s": 1.0, "ms": 1e-3, "us": 1e-6, "ns": 1e-9, "ps": 1e-12, "fs": 1e-15}
+
+
+# ---------- capture parsing ----------
+def parse_vcd(lines):
+    """returns ({name: [(t_seconds, level), ...]}) for every 1-bit signal"""
+    scale = 1e-9
+    ids = {}
+    changes = {}
+    now = 0
+    in_timescale = False
+    timescale_text = ""
+    for raw in lines:
+        line = raw.strip()
+        if not line:
+            continue
+        if in_timescale or line.startswith("$timescale"):
+            timescale_text += " " + line.replace("$timescale", "").replace("$end", "")
+            in_timescale = "$end" not in line
+            if not in_timescale:
+                scale = parse_timescale(timescale_text)
+            continue
+        if line.startswith("$var"):
+            parts = line.split()
+            # $var wire 1 ! name $end
+            if len(parts) >= 5 and parts[2] == "1":
+                ids[parts[3]] = parts[4]
+                changes.setdefault(parts[4], [])
+            continue
+        if line.startswith("$"):
+            continue
+        for token in line.split():
+            if token[0] == "#":
+                now = int(token[1:])
+            elif token[0] in "01" and token[1:] in ids:
+                changes[ids[token[1:]]].append((now * scale, int(token[0])))
+    return changes
+
+
+def parse_timescale(text):
+    text = text.strip().replace(" ", "")
+    digits = "".join(c for c in text if c.isdigit())
+    unit = text[len(digits):]
+    return int(digits or 1) * TIMESCALE_S[unit]
+
+
+def parse_csv(lines, samplerate):
+    """sigrok csv: optional ';' comment lines, a header row, one row per
+    sample. a time column is used if there is one, else --samplerate"""
+    rows = csv.reader(l for l in lines if not l.startswith(";"))
+    header = [h.strip() for h in next(rows)]
+    time_col = next((i for i, h in enumerate(header) if h.lower().startswith("time")), None)
+    if time_col is None and not samplerate:
+        sys.exit("csv has no time column, pass --samplerate")
+    changes = {h: [] for i, h in enumerate(header) if i != time_col}
+    last = {}
+    for n, row in enumerate(rows):
+        if not row:
+            continue
+        t = float(row[time_col]) if time_col is not None else n / samplerate
+        for i, h in enumerate(header):
+            if i == time_col or i >= len(row):
+                continue
+            try:
+                level = int(float(row[i]))
+            except ValueError:
+                continue  # protocol decode columns
+            if last.get(h) != level:
+                changes[h].append((t, level))
+                last[h] = level
+    return changes
+
+
+def edges(changes):
+    """[(t, level)] -> (rising times, falling times), the first sample of a
+    signal only counts if it starts high"""
+    rising, falling = [], []
+    prev = 0
+    for t, level in changes:
+        if level and not prev:
+            rising.append(t)
+        elif prev and not level:
+            falling.append(t)
+        prev = level
+    return rising, falling
+
+
+# ---------- chaining ----------
+# edge lists are sorted, so both are a binary search
+def first_after(times, t, before):
+    i = bisect.bisect_left(times, t)
+    if i < len(times) and times[i] < before:
+        return times[i]
+    return None
+
+
+def last_before(times, t):
+    i = bisect.bisect_right(times, t)
+    return times[i - 1] if i else None
+
+
+def chain(markers):
+    """markers: {name: (rising, falling)} -> {stage: [seconds, ...]}"""
+    out = {s: [] for s in STAGES}
+    probe_rise, probe_fall = markers.get("probe", ([], []))
+    tx_rise, tx_fall = markers.get("tx", ([], []))
+    rx = markers.get("rx", ([], []))[0]
+    audio = markers.get("audio", ([], []))[0]
+    cmd_rise, cmd_fall = markers.get("ledcmd", ([], []))
+    frame = markers.get("frame", ([], []))[0]
+
+    for n, tx_start in enumerate(tx_rise):
+        next_tx = tx_rise[n + 1] if n + 1 < len(tx_rise) else float("inf")
+        probe_end = last_before(probe_fall, tx_start)
+        if probe_end is not None:
+            out["probe_to_tx"].append(tx_start - probe_end)
+        tx_end = first_after(tx_fall, tx_start, next_tx)
+        if tx_end is None:
+            continue
+        out["tx_wire"].append(tx_end - tx_start)
+        rx_t = first_after(rx, tx_end, next_tx)
+        if rx_t is None:
+            continue
+        out["tx_to_rx"].append(rx_t - tx_end)
+        audio_t = first_after(audio, rx_t, next_tx)
+        if audio_t is not None:
+            out["rx_to_audio"].append(audio_t - rx_t)
+            if probe_end is not None:
+                out["probe_to_audio"].append(audio_t - probe_end)
+        cmd_start = first_after(cmd_rise, rx_t, next_tx)
+        if cmd_start is None:
+            continue
+        out["rx_to_ledcmd"].append(cmd_start - rx_t)
+        cmd_end = first_after(cmd_fall, cmd_start, next_tx)
+        if cmd_end is None:
+            continue
+        frame_t = first_after(frame, cmd_end, next_tx)
+        if frame_t is None:
+            continue
+        out["ledcmd_to_frame"].append(frame_t - cmd_end)
+        if probe_end is not None:
+            out["probe_to_frame"].append(frame_t - probe_end)
+    return out
+
+
+# ---------- report ----------
+def percentile(sorted_values, p):
+    """nearest rank, same as ReactionTimeline::latencyPercentileUs"""
+    rank = max(1, (p * len(sorted_values) + 99) // 100)
+    return sorted_values[rank - 1]
+
+
+def report(stages, hist_ms):
+    print("stage            n      min_ms   p50_ms   p95_ms   p99_ms   max_ms")
+    for stage in STAGES:
+        values = sorted(stages[stage])
+        if not values:
+            print(f"{stage:<16} 0")
+            continue
+        ms = [v * 1000 for v in values]
+        print(
+            f"{stage:<16} {len(ms):<6} {ms[0]:8.3f} {percentile(ms, 50):8.3f} "
+            f"{percentile(ms, 95):8.3f} {percentile(ms, 99):8.3f} {ms[-1]:8.3f}"
+        )
+    if not hist_ms:
+        return
+    for stage in STAGES:
+        if not stages[stage]:
+            continue
+        print(f"\n{stage} ({hist_ms:g} ms bins)")
+        bins = {}
+        for v in stages[stage]:
+            b = int(v * 1000 // hist_ms)
+            bins[b] = bins.get(b, 0) + 1
+        top = max(bins.values())
+        for b in range(min(bins), max(bins) + 1):
+            count = bins.get(b, 0)
+            bar = "#" * (count * 50 // top) if count else ""
+            print(f"  {b * hist_ms:8.1f} {count:5} {bar}")
+
+
+# ---------- synthetic captures ----------
+def synthesize(reactions, seed):
+    """returns (changes {name: [(t, level)]}, expected {stage: [seconds]}).
+    times are whole microseconds so a VCD at 1us keeps them exact"""
+    rng = random.Random(seed)
+    us = 1e-6
+    changes = {m: [(0.0, 0)] for m in MARKERS}
+    expected = {s: [] for s in STAGES}
+
+    def pulse(name, start, width):
+        changes[name].append((start * us, 1))
+        changes[name].append(((start + width) * us, 0))
+
+    t = 1000
+    for _ in range(reactions):
+        # a few probes before the one that changed the state
+        for _ in range(rng.randint(1, 3)):
+            width = rng.randint(50000, 60000)  # PCD_Init alone is 50ms+
+            pulse("probe", t, width)
+            probe_end = t + width
+            t = probe_end + rng.randint(200, 2000)
+        probe_to_tx = t - probe_end
+        wire = 8 * 1042 + rng.randint(0, 300)  # 8 bytes at 9600 baud
+        pulse("tx", t, wire)
+        tx_end = t + wire
+        tx_to_rx = rng.randint(50, 1500)
+        rx_t = tx_end + tx_to_rx
+        pulse("rx", rx_t, 2)
+        expected["probe_to_tx"].append(probe_to_tx * us)
+        expected["tx_wire"].append(wire * us)
+        expected["tx_to_rx"].append(tx_to_rx * us)
+        end = rx_t + 10
+
+        if rng.random() < 0.8:  # most packets start a reaction
+            rx_to_audio = rng.randint(20, 400)
+            pulse("audio", rx_t + rx_to_audio, 2)
+            rx_to_cmd = rx_to_audio + rng.randint(50, 2000)
+            cmd_width = rng.randint(300, 700)
+            pulse("ledcmd", rx_t + rx_to_cmd, cmd_width)
+            cmd_end = rx_t + rx_to_cmd + cmd_width
+            cmd_to_frame = rng.randint(20000, 90000)
+            pulse("frame", cmd_end + cmd_to_frame, 2)
+            expected["rx_to_audio"].append(rx_to_audio * us)
+            expected["rx_to_ledcmd"].append(rx_to_cmd * us)
+            expected["ledcmd_to_frame"].append(cmd_to_frame * us)
+            expected["probe_to_audio"].append((rx_t + rx_to_audio - probe_end) * us)
+            expected["probe_to_frame"].append((cmd_end + cmd_to_frame - probe_end) * us)
+            end = cmd_end + cmd_to_frame + 10
+        t = end + rng.randint(100000, 400000)
+    return changes, expected
+
+
+def write_vcd(changes, out):
+    ids = {name: chr(ord("!") + i) for i, name in enumerate(changes)}
+    out.write("$timescale 1 us $end\n$scope module markers $end\n")
+    for name, ident in ids.items():
+        out.write(f"$var wire 1 {ident} {name} $end\n")
+    out.write("$upscope $end\n$enddefinitions $end\n")
+    events = sorted(
+        (round(t * 1e6), ids[name], level)
+        for name, values in changes.items()
+        for t, level in values
+    )
+    current = None
+    for t, ident, level in events:
+        if t != current:
+            out.write(f"#{t}\n")
+            current = t
+        out.write(f"{level}{ident}\n")
+
+
+def selftest():
+    import io
+
+    changes, expected = synthesize(200, 1)
+    buf = io.StringIO()
+    write_vcd(changes, buf)
+    parsed = parse_vcd(buf.getvalue().splitlines())
+    got = chain({m: edges(parsed[m]) for m in MARKERS})
+    ok = True
+    for stage in STAGES:
+        want = [round(v * 1e6) for v in expected[stage]]
+        have = [round(v * 1e6) for v in got[stage]]
+        if want != have:
+            ok = False
+            print(f"{stage}: expected {len(want)} samples, got {len(have)} (or values differ)")
+    print("selftest " + ("ok" if ok else "FAILED"))
+    return 0 if ok else 1
+
+
+# ---------- main ----------
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1].strip())
+    ap.add_argument("capture", nargs="?", help="sigrok/PulseView .vcd or .csv export")
+    ap.add_argument("--map", nargs="*", default=[], metavar="MARKER=CHANNEL",
+                    help="capture channel for a marker, e.g. probe=D0")
+    ap.add_argument("--samplerate", type=float, help="Hz, for csv without a time column")
+    ap.add_argument("--hist", type=float, default=0, metavar="MS", help="print histograms with this bin width")
+    ap.add_argument("--synthetic", metavar="OUT.vcd", help="write a synthetic capture and exit")
+    ap.add_argument("--reactions", type=int, default=200)
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--selftest", action="store_true")
+    args = ap.parse_args()
+
+    if args.selftest:
+        return selftest()
+    if args.synthetic:
+        changes, _ = synthesize(args.reactions, args.seed)
+        with open(args.synthetic, "w") as out:
+            write_vcd(changes, out)
+        return 0
+    if not args.capture:
+        ap.error("need a capture file")
+
+    with open(args.capture) as f:
+        lines = f.read().splitlines()
+    changes = parse_csv(lines, args.samplerate) if args.capture.lower().endswith(".csv") else parse_vcd(lines)
+
+    mapping = dict(m.split("=", 1) for m in args.map)
+    by_lower = {name.lower(): name for name in changes}
+    markers = {}
+    for m in MARKERS:
+        channel = mapping.get(m, by_lower.get(m))
+        if channel is None:
+            continue
+        if channel not in changes:
+            sys.exit(f"no channel {channel} in the capture (have {', '.join(changes)})")
+        markers[m] = edges(changes[channel])
+    if not markers:
+        sys.exit("no marker channels found, name them or use --map")
+    missing = [m for m in MARKERS if m not in markers]
+    if missing:
+        print(f"not in the capture: {', '.join(missing)} (stages using them stay empty)")
+
+    report(chain(markers), args.hist)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())